@@ -22,11 +22,9 @@ static const unsigned int QUEUE_BATCH_SIZE = 128;
 // This Benchmark tests the CheckQueue with a slightly realistic workload,
 // where checks all contain a prevector that is indirect 50% of the time
 // and there is a little bit of work done between calls to Add.
-static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
+// nThreads counts the master, which joins the workers in Wait().
+static void CheckQueuePrevectorJob(benchmark::Bench& bench, int nThreads)
 {
-    // We shouldn't ever be running with the checkqueue on a single core machine.
-    if (GetNumCores() <= 1) return;
-
     const ECCVerifyHandle verify_handle;
     ECC_Start();
 
@@ -45,9 +43,7 @@ static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
     };
     CCheckQueue<PrevectorJob> queue {QUEUE_BATCH_SIZE};
     boost::thread_group tg;
-    // The main thread should be counted to prevent thread oversubscription, and
-    // to decrease the variance of benchmark results.
-    for (auto x = 0; x < GetNumCores() - 1; ++x) {
+    for (auto x = 0; x < nThreads - 1; ++x) {
        tg.create_thread([&]{queue.Thread();});
     }
 
@@ -74,4 +70,25 @@ static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
     tg.join_all();
     ECC_Stop();
 }
+
+static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
+{
+    // We shouldn't ever be running with the checkqueue on a single core machine.
+    if (GetNumCores() <= 1) return;
+
+    // The main thread should be counted to prevent thread oversubscription, and
+    // to decrease the variance of benchmark results.
+    CheckQueuePrevectorJob(bench, GetNumCores());
+}
+
+// Fixed thread counts, to see how the queue scales on many cores
+static void CCheckQueueSpeedPrevectorJob_1(benchmark::Bench& bench) { CheckQueuePrevectorJob(bench, 1); }
+static void CCheckQueueSpeedPrevectorJob_4(benchmark::Bench& bench) { CheckQueuePrevectorJob(bench, 4); }
+static void CCheckQueueSpeedPrevectorJob_16(benchmark::Bench& bench) { CheckQueuePrevectorJob(bench, 16); }
+static void CCheckQueueSpeedPrevectorJob_32(benchmark::Bench& bench) { CheckQueuePrevectorJob(bench, 32); }
+
 BENCHMARK(CCheckQueueSpeedPrevectorJob);
+BENCHMARK(CCheckQueueSpeedPrevectorJob_1);
+BENCHMARK(CCheckQueueSpeedPrevectorJob_4);
+BENCHMARK(CCheckQueueSpeedPrevectorJob_16);
+BENCHMARK(CCheckQueueSpeedPrevectorJob_32);
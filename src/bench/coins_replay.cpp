@@ -0,0 +1,60 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <coins.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <txdb.h>
+
+#include <algorithm>
+#include <vector>
+
+// Replays the coins traffic of initial block download: every block spends
+// coins created by earlier blocks through a per block view, which is flushed
+// into the tip cache, and the tip cache is written to the database whenever
+// it outgrows its budget, as FlushStateToDisk does.
+static void CoinsIBDReplay(benchmark::Bench& bench)
+{
+    TestingSetup test_setup{CBaseChainParams::REGTEST};
+    CCoinsViewDB db("coins_replay", 8 << 20, true, false);
+    CCoinsViewCache tip(&db);
+    const size_t nCacheBytes = 16 << 20;
+    tip.SetCacheBudget(nCacheBytes);
+
+    FastRandomContext rng(true);
+    std::vector<COutPoint> vUnspent;
+    int nHeight = 0;
+    bench.run([&] {
+        CCoinsViewCache view(&tip);
+        nHeight++;
+        for (int nTx = 0; nTx < 500; nTx++) {
+            // spend two older coins, mostly recent ones as in the real chain
+            for (int nIn = 0; nIn < 2 && !vUnspent.empty(); nIn++) {
+                const size_t nRecent = std::min<size_t>(vUnspent.size(), 20000);
+                const size_t i = vUnspent.size() - 1 - rng.randrange(nRecent);
+                view.SpendCoin(vUnspent[i]);
+                vUnspent[i] = vUnspent.back();
+                vUnspent.pop_back();
+            }
+            const uint256 txid = rng.rand256();
+            for (uint32_t n = 0; n < 3; n++) {
+                Coin coin;
+                coin.nHeight = nHeight;
+                coin.out.nValue = 1000;
+                coin.out.scriptPubKey.assign((uint32_t)25, 0x76);
+                view.AddCoin(COutPoint(txid, n), std::move(coin), false);
+                vUnspent.emplace_back(txid, n);
+            }
+        }
+        view.Flush();
+
+        if (tip.DynamicMemoryUsage() > nCacheBytes) {
+            tip.SetBestBlock(rng.rand256());
+            tip.Flush();
+        }
+    });
+}
+
+BENCHMARK(CoinsIBDReplay);
@@ -71,6 +71,26 @@ static void SHA256D64_1024(benchmark::Bench& bench)
     });
 }
 
+static void SHA256D_Multi_1000(benchmark::Bench& bench)
+{
+    // transaction sized messages
+    FastRandomContext rng(true);
+    std::vector<std::vector<uint8_t>> messages(1000);
+    std::vector<const uint8_t*> inputs;
+    std::vector<size_t> lengths;
+    size_t nBytes = 0;
+    for (auto& message : messages) {
+        message.resize(150 + rng.randrange(400));
+        inputs.push_back(message.data());
+        lengths.push_back(message.size());
+        nBytes += message.size();
+    }
+    std::vector<uint8_t> out(32 * messages.size());
+    bench.batch(nBytes).unit("byte").run([&] {
+        SHA256DMulti(out.data(), inputs.data(), lengths.data(), messages.size());
+    });
+}
+
 static void SHA512(benchmark::Bench& bench)
 {
     uint8_t hash[CSHA512::OUTPUT_SIZE];
@@ -114,5 +134,6 @@ BENCHMARK(SHA3_256_1M);
 BENCHMARK(SHA256_32b);
 BENCHMARK(SipHash_32b);
 BENCHMARK(SHA256D64_1024);
+BENCHMARK(SHA256D_Multi_1000);
 BENCHMARK(FastRandom_32bit);
 BENCHMARK(FastRandom_1bit);
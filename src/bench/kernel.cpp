@@ -0,0 +1,38 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <amount.h>
+#include <bench/bench.h>
+#include <pos/kernel.h>
+#include <pos/stakeminer.h>
+#include <random.h>
+#include <uint256.h>
+
+static void StakeKernelHash(benchmark::Bench& bench)
+{
+    FastRandomContext rng(true);
+    Kernel kernel(std::make_pair(rng.rand256(), 1), 10000 * COIN, rng.rand256(), 1600000000, 1600100000);
+
+    uint64_t nTime = 1600100000;
+    bench.run([&] {
+        kernel.SetStakeTime(++nTime);
+        kernel.GetStakeHash();
+    });
+}
+
+static void StakeSearchTimeSpan(benchmark::Bench& bench)
+{
+    FastRandomContext rng(true);
+    Kernel kernel(std::make_pair(rng.rand256(), 1), 10000 * COIN, rng.rand256(), 1600000000, 1600100000);
+
+    // nothing meets a zero target, so every call searches the whole span like a miss in CreateCoinStake
+    const uint256 nTarget;
+    bench.run([&] {
+        bool fFound = SearchTimeSpan(kernel, 1600100000, 1600100000 + 30, nTarget);
+        assert(!fFound);
+    });
+}
+
+BENCHMARK(StakeKernelHash);
+BENCHMARK(StakeSearchTimeSpan);
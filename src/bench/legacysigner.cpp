@@ -0,0 +1,50 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <crown/legacysigner.h>
+#include <key.h>
+
+// The message format of a masternode ping
+static const std::string strPingMessage = "CTxIn(COutPoint(4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b, 0), scriptSig=)1600000000";
+
+static void LegacySignMessage(benchmark::Bench& bench)
+{
+    const ECCVerifyHandle verify_handle;
+    ECC_Start();
+
+    CKey key;
+    key.MakeNewKey(true);
+    std::vector<unsigned char> vchSig;
+    bench.run([&] {
+        bool fSigned = legacySigner.SignMessage(strPingMessage, vchSig, key);
+        assert(fSigned);
+    });
+
+    ECC_Stop();
+}
+
+static void LegacyVerifyMessage(benchmark::Bench& bench)
+{
+    const ECCVerifyHandle verify_handle;
+    ECC_Start();
+
+    CKey key;
+    key.MakeNewKey(true);
+    const CPubKey pubkey = key.GetPubKey();
+    std::vector<unsigned char> vchSig;
+    bool fSigned = legacySigner.SignMessage(strPingMessage, vchSig, key);
+    assert(fSigned);
+
+    std::string strError;
+    bench.run([&] {
+        bool fValid = legacySigner.VerifyMessage(pubkey, vchSig, strPingMessage, strError);
+        assert(fValid);
+    });
+
+    ECC_Stop();
+}
+
+BENCHMARK(LegacySignMessage);
+BENCHMARK(LegacyVerifyMessage);
@@ -0,0 +1,67 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <test/util/setup_common.h>
+#include <txdb.h>
+#include <validation.h>
+
+#include <vector>
+
+static void LoadBlockIndex(benchmark::Bench& bench, int nThreads)
+{
+    TestingSetup test_setup{CBaseChainParams::REGTEST};
+    CBlockTreeDB db(64 << 20, true);
+
+    // a chain alternating between proof of work and proof of stake headers
+    const int nCount = 100000;
+    std::vector<CBlockIndex> vIndex(nCount);
+    std::vector<uint256> vHashes(nCount);
+    std::vector<const CBlockIndex*> vInfo;
+    for (int i = 0; i < nCount; i++) {
+        CBlockIndex& index = vIndex[i];
+        index.pprev = i ? &vIndex[i - 1] : nullptr;
+        index.nHeight = i;
+        index.nTime = 1600000000 + i;
+        index.nBits = 0x207fffff;
+        index.nNonce = i;
+        index.nStatus = BLOCK_VALID_TRANSACTIONS | BLOCK_HAVE_DATA;
+        index.nTx = 1;
+        index.fProofOfStake = i % 2;
+        if (index.fProofOfStake)
+            index.stakeSource = std::make_pair(vHashes[i - 1], 0U);
+        vHashes[i] = CDiskBlockIndex(&index).GetBlockHash();
+        index.phashBlock = &vHashes[i];
+        vInfo.push_back(&index);
+    }
+    assert(db.WriteBatchSync({}, 0, vInfo));
+
+    bench.batch(nCount).unit("entry").run([&] {
+        BlockMap mapBlockIndex;
+        auto insertBlockIndex = [&mapBlockIndex](const uint256& hash, bool fProofOfStake) {
+            auto it = mapBlockIndex.find(hash);
+            if (it != mapBlockIndex.end())
+                return it->second;
+            CBlockIndex* pindexNew = new CBlockIndex();
+            it = mapBlockIndex.emplace(hash, pindexNew).first;
+            pindexNew->phashBlock = &it->first;
+            pindexNew->fProofOfStake = fProofOfStake;
+            return pindexNew;
+        };
+        bool fLoaded = db.LoadBlockIndexGuts(Params().GetConsensus(), insertBlockIndex, nThreads);
+        assert(fLoaded);
+        assert(mapBlockIndex.size() == (size_t)nCount + 1);
+        for (const auto& entry : mapBlockIndex)
+            delete entry.second;
+    });
+    mapUsedStakePointers.clear();
+}
+
+static void LoadBlockIndexSingleThread(benchmark::Bench& bench) { LoadBlockIndex(bench, 1); }
+static void LoadBlockIndexParallel(benchmark::Bench& bench) { LoadBlockIndex(bench, MAX_BLOCK_INDEX_LOAD_THREADS); }
+
+BENCHMARK(LoadBlockIndexSingleThread);
+BENCHMARK(LoadBlockIndexParallel);
@@ -0,0 +1,216 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <flat-database.h>
+#include <key.h>
+#include <masternode/masternode-budget.h>
+#include <masternode/masternode-payments.h>
+#include <masternode/masternodeman.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <vector>
+
+// Fill the global masternode list with nCount enabled masternodes whose collateral is never looked up
+static std::vector<CMasternode> FillMasternodeList(size_t nCount)
+{
+    FastRandomContext rng(true);
+    std::vector<CMasternode> vMasternodes;
+    vMasternodes.reserve(nCount);
+
+    mnodeman.Clear();
+    LOCK(cs_main);
+    const int nHeight = ::ChainActive().Height();
+    for (size_t i = 0; i < nCount; i++) {
+        CKey key;
+        key.MakeNewKey(true);
+
+        CMasternode mn;
+        mn.vin = CTxIn(COutPoint(rng.rand256(), 0));
+        mn.pubkey = key.GetPubKey();
+        mn.pubkey2 = mn.pubkey;
+        mn.protocolVersion = PROTOCOL_VERSION;
+        mn.sigTime = GetAdjustedTime() - 30 * 24 * 60 * 60;
+        mn.lastPing = CMasternodePing(mn.vin);
+        mn.activeState = CMasternode::MASTERNODE_ENABLED;
+        mn.unitTest = true;
+        mn.cacheInputAge = 1000000;
+        mn.cacheInputAgeBlock = nHeight;
+        mnodeman.Add(mn);
+        vMasternodes.push_back(mn);
+    }
+    return vMasternodes;
+}
+
+// Give every block of the chain a winner with enough votes to count as paid
+static void FillMasternodeBlocks(const std::vector<CMasternode>& vMasternodes)
+{
+    LOCK2(cs_main, cs_mapMasternodeBlocks);
+    masternodePayments.mapMasternodeBlocks.clear();
+    for (int nHeight = 1; nHeight <= ::ChainActive().Height(); nHeight++) {
+        CMasternodeBlockPayees blockPayees(nHeight);
+        blockPayees.AddPayee(GetScriptForDestination(PKHash(vMasternodes[nHeight % vMasternodes.size()].pubkey)), 10);
+        masternodePayments.mapMasternodeBlocks[nHeight] = blockPayees;
+    }
+}
+
+static void MasternodeRanks(benchmark::Bench& bench, size_t nCount)
+{
+    TestChain100Setup test_setup;
+    FillMasternodeList(nCount);
+    const int nHeight = WITH_LOCK(cs_main, return ::ChainActive().Height());
+
+    bench.run([&] {
+        auto vRanks = mnodeman.GetMasternodeRanks(nHeight);
+        assert(vRanks.size() == nCount);
+    });
+    mnodeman.Clear();
+}
+
+static void MasternodeRank(benchmark::Bench& bench, size_t nCount)
+{
+    TestChain100Setup test_setup;
+    std::vector<CMasternode> vMasternodes = FillMasternodeList(nCount);
+    const int nHeight = WITH_LOCK(cs_main, return ::ChainActive().Height());
+
+    bench.run([&] {
+        int nRank = mnodeman.GetMasternodeRank(vMasternodes.back().vin, nHeight);
+        assert(nRank > 0);
+    });
+    mnodeman.Clear();
+}
+
+static void MasternodeNextInQueue(benchmark::Bench& bench, size_t nCount)
+{
+    TestChain100Setup test_setup;
+    FillMasternodeBlocks(FillMasternodeList(nCount));
+    const int nHeight = WITH_LOCK(cs_main, return ::ChainActive().Height());
+
+    bench.run([&] {
+        int nQueued = 0;
+        mnodeman.GetNextMasternodeInQueueForPayment(nHeight + 1, true, nQueued);
+    });
+    mnodeman.Clear();
+    WITH_LOCK(cs_mapMasternodeBlocks, masternodePayments.mapMasternodeBlocks.clear());
+}
+
+static void MasternodeLastPaid(benchmark::Bench& bench, size_t nCount)
+{
+    TestChain100Setup test_setup;
+    std::vector<CMasternode> vMasternodes = FillMasternodeList(nCount);
+    FillMasternodeBlocks(vMasternodes);
+
+    size_t i = 0;
+    bench.run([&] {
+        // most of them were not paid within the chain, so this walks the whole window
+        vMasternodes[i++ % vMasternodes.size()].GetLastPaid();
+    });
+    mnodeman.Clear();
+    WITH_LOCK(cs_mapMasternodeBlocks, masternodePayments.mapMasternodeBlocks.clear());
+}
+
+static void BudgetGetBudget(benchmark::Bench& bench, size_t nCount)
+{
+    TestChain100Setup test_setup;
+    std::vector<CMasternode> vMasternodes = FillMasternodeList(nCount);
+
+    // proposals can only enter through budget.dat without a collateral transaction
+    std::map<uint256, CBudgetProposal> mapProposals;
+    for (int n = 0; n < 20; n++) {
+        CBudgetProposal proposal("proposal" + std::to_string(n), "http://crownplatform.com", 0, 100000,
+            GetScriptForDestination(PKHash(vMasternodes[n].pubkey)), (n + 1) * COIN, uint256());
+        proposal.nTime = GetTime() - 24 * 60 * 60;
+        for (const CMasternode& mn : vMasternodes) {
+            CBudgetVote vote(mn.vin, proposal.GetHash(), n % 3 ? VOTE_YES : VOTE_NO);
+            vote.nTime = proposal.nTime;
+            proposal.mapVotes[vote.vin.prevout.GetHash()] = vote;
+        }
+        mapProposals.emplace(proposal.GetHash(), proposal);
+    }
+
+    CBudgetManager manager;
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    for (int n = 0; n < 6; n++)
+        ss << std::map<uint256, CBudgetVote>();
+    ss << mapProposals << std::map<uint256, BudgetDraft>();
+    ss >> manager;
+
+    bench.run([&] {
+        manager.GetBudget();
+    });
+    mnodeman.Clear();
+}
+
+static void MasternodeCacheDump(benchmark::Bench& bench, size_t nCount)
+{
+    TestChain100Setup test_setup;
+    FillMasternodeList(nCount);
+    CFlatDB<CMasternodeMan> flatdb("mncache.dat", "magicMasternodeCache");
+
+    bench.run([&] {
+        flatdb.Dump(mnodeman);
+    });
+    mnodeman.Clear();
+}
+
+static void MasternodeCacheLoad(benchmark::Bench& bench, size_t nCount)
+{
+    TestChain100Setup test_setup;
+    FillMasternodeList(nCount);
+    CFlatDB<CMasternodeMan> flatdb("mncache.dat", "magicMasternodeCache");
+    flatdb.Dump(mnodeman);
+
+    bench.run([&] {
+        CMasternodeMan cache;
+        flatdb.Load(cache);
+        assert(cache.size() == (int)nCount);
+    });
+    mnodeman.Clear();
+}
+
+static void MasternodeRanks1k(benchmark::Bench& bench) { MasternodeRanks(bench, 1000); }
+static void MasternodeRanks5k(benchmark::Bench& bench) { MasternodeRanks(bench, 5000); }
+static void MasternodeRanks20k(benchmark::Bench& bench) { MasternodeRanks(bench, 20000); }
+static void MasternodeRank1k(benchmark::Bench& bench) { MasternodeRank(bench, 1000); }
+static void MasternodeRank5k(benchmark::Bench& bench) { MasternodeRank(bench, 5000); }
+static void MasternodeRank20k(benchmark::Bench& bench) { MasternodeRank(bench, 20000); }
+static void MasternodeNextInQueue1k(benchmark::Bench& bench) { MasternodeNextInQueue(bench, 1000); }
+static void MasternodeNextInQueue5k(benchmark::Bench& bench) { MasternodeNextInQueue(bench, 5000); }
+static void MasternodeNextInQueue20k(benchmark::Bench& bench) { MasternodeNextInQueue(bench, 20000); }
+static void MasternodeLastPaid1k(benchmark::Bench& bench) { MasternodeLastPaid(bench, 1000); }
+static void MasternodeLastPaid5k(benchmark::Bench& bench) { MasternodeLastPaid(bench, 5000); }
+static void MasternodeLastPaid20k(benchmark::Bench& bench) { MasternodeLastPaid(bench, 20000); }
+static void BudgetGetBudget1k(benchmark::Bench& bench) { BudgetGetBudget(bench, 1000); }
+static void BudgetGetBudget5k(benchmark::Bench& bench) { BudgetGetBudget(bench, 5000); }
+static void BudgetGetBudget20k(benchmark::Bench& bench) { BudgetGetBudget(bench, 20000); }
+static void MasternodeCacheDump1k(benchmark::Bench& bench) { MasternodeCacheDump(bench, 1000); }
+static void MasternodeCacheDump5k(benchmark::Bench& bench) { MasternodeCacheDump(bench, 5000); }
+static void MasternodeCacheDump20k(benchmark::Bench& bench) { MasternodeCacheDump(bench, 20000); }
+static void MasternodeCacheLoad1k(benchmark::Bench& bench) { MasternodeCacheLoad(bench, 1000); }
+static void MasternodeCacheLoad5k(benchmark::Bench& bench) { MasternodeCacheLoad(bench, 5000); }
+static void MasternodeCacheLoad20k(benchmark::Bench& bench) { MasternodeCacheLoad(bench, 20000); }
+
+BENCHMARK(MasternodeRanks1k);
+BENCHMARK(MasternodeRanks5k);
+BENCHMARK(MasternodeRanks20k);
+BENCHMARK(MasternodeRank1k);
+BENCHMARK(MasternodeRank5k);
+BENCHMARK(MasternodeRank20k);
+BENCHMARK(MasternodeNextInQueue1k);
+BENCHMARK(MasternodeNextInQueue5k);
+BENCHMARK(MasternodeNextInQueue20k);
+BENCHMARK(MasternodeLastPaid1k);
+BENCHMARK(MasternodeLastPaid5k);
+BENCHMARK(MasternodeLastPaid20k);
+BENCHMARK(BudgetGetBudget1k);
+BENCHMARK(BudgetGetBudget5k);
+BENCHMARK(BudgetGetBudget20k);
+BENCHMARK(MasternodeCacheDump1k);
+BENCHMARK(MasternodeCacheDump5k);
+BENCHMARK(MasternodeCacheDump20k);
+BENCHMARK(MasternodeCacheLoad1k);
+BENCHMARK(MasternodeCacheLoad5k);
+BENCHMARK(MasternodeCacheLoad20k);
@@ -0,0 +1,30 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <masternode/masternodeman.h>
+#include <test/util/mnsim.h>
+#include <test/util/setup_common.h>
+#include <util/system.h>
+
+// Time for a node to take in a whole masternode list over the network
+static void MasternodeNetworkSyncList(benchmark::Bench& bench, size_t nCount)
+{
+    TestChain100Setup test_setup;
+    gArgs.ForceSetArg("-jumpstart", "1");
+    {
+        MasternodeNetworkSim sim(test_setup.m_node, nCount, 8);
+
+        bench.batch(nCount).unit("mnb").run([&] {
+            mnodeman.Clear();
+            sim.SyncList();
+            assert(mnodeman.CountEnabled() == (int)nCount);
+        });
+    }
+    gArgs.ForceSetArg("-jumpstart", "0");
+}
+
+static void MasternodeNetworkSyncList1k(benchmark::Bench& bench) { MasternodeNetworkSyncList(bench, 1000); }
+
+BENCHMARK(MasternodeNetworkSyncList1k);
@@ -0,0 +1,79 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chainparams.h>
+#include <net.h>
+#include <netmessagemaker.h>
+#include <random.h>
+#include <test/util/net.h>
+#include <test/util/setup_common.h>
+#include <util/system.h>
+
+#include <vector>
+
+#ifndef WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+
+// One round of the socket thread of a node with many connections, a few of
+// which have sent a message, as on a busy masternode or seed node.
+static void SocketHandlerPeers(benchmark::Bench& bench, int nPeers, int nActive)
+{
+    TestingSetup test_setup{CBaseChainParams::REGTEST};
+    RaiseFileDescriptorLimit(2 * nPeers + 100);
+
+    ConnmanTestMsg connman(0x1337, 0x1337);
+    CConnman::Options options;
+    options.nReceiveFloodSize = 1 << 30;
+    connman.Init(options);
+
+    std::vector<CNode*> vNodes;
+    std::vector<SOCKET> vRemote;
+    for (int i = 0; i < nPeers; i++) {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) break;
+        vNodes.push_back(new CNode(i, NODE_NETWORK, 0, fds[0], CAddress(CService(in_addr{0x0100007f}, 7777), NODE_NETWORK), 0, 0, CAddress(), std::string(), ConnectionType::INBOUND));
+        vNodes.back()->fSuccessfullyConnected = true;
+        connman.AddTestNode(*vNodes.back());
+        vRemote.push_back(fds[1]);
+    }
+    assert((int)vRemote.size() == nPeers);
+
+    CSerializedNetMsg msg = CNetMsgMaker(PROTOCOL_VERSION).Make(NetMsgType::PING, uint64_t{0});
+    std::vector<unsigned char> vBytes;
+    V1TransportSerializer().prepareForTransport(msg, vBytes);
+    vBytes.insert(vBytes.end(), msg.data.begin(), msg.data.end());
+
+    FastRandomContext rng(true);
+    std::vector<CNode*> vSent;
+    bench.run([&] {
+        for (CNode* pnode : vSent) {
+            LOCK(pnode->cs_vProcessMsg);
+            pnode->vProcessMsg.clear();
+            pnode->nProcessQueueSize = 0;
+        }
+        vSent.clear();
+        for (int i = 0; i < nActive; i++) {
+            const size_t n = rng.randrange(vRemote.size());
+            ssize_t nWritten = write(vRemote[n], vBytes.data(), vBytes.size());
+            assert(nWritten == (ssize_t)vBytes.size());
+            vSent.push_back(vNodes[n]);
+        }
+        connman.SocketHandlerOnce();
+    });
+
+    // Deletes the nodes, which closes our end of each socket pair, then
+    // close the remote ends.
+    connman.ClearTestNodes();
+    vNodes.clear();
+    for (SOCKET hSocket : vRemote) {
+        close(hSocket);
+    }
+}
+
+static void SocketHandler1000Peers(benchmark::Bench& bench) { SocketHandlerPeers(bench, 1000, 10); }
+
+BENCHMARK(SocketHandler1000Peers);
+#endif
@@ -0,0 +1,231 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockimport.h>
+
+#include <consensus/consensus.h>
+#include <consensus/validation.h>
+#include <crypto/common.h>
+#include <streams.h>
+#include <util/threadnames.h>
+#include <validation.h>
+#include <version.h>
+
+#include <string.h>
+
+CBlockImporter::CBlockImporter(FILE* fileIn, const CMessageHeader::MessageStartChars& message_start, const Consensus::Params& params, int nThreads)
+    : file(fileIn), m_params(params)
+{
+    memcpy(m_message_start, message_start, sizeof(m_message_start));
+
+    const long nStartPos = ftell(file);
+    StartReader(nStartPos > 0 ? nStartPos : 0);
+    for (int i = 0; i < std::max(nThreads, 1); i++)
+        m_workers.emplace_back(&CBlockImporter::ThreadDecode, this);
+}
+
+CBlockImporter::~CBlockImporter()
+{
+    StopReader();
+    {
+        LOCK(m_mutex);
+        m_stop_workers = true;
+    }
+    m_cv_decode.notify_all();
+    for (std::thread& worker : m_workers)
+        worker.join();
+    fclose(file);
+}
+
+void CBlockImporter::StartReader(uint64_t nPos)
+{
+    m_reader = std::thread(&CBlockImporter::ThreadRead, this, nPos);
+}
+
+void CBlockImporter::StopReader()
+{
+    {
+        LOCK(m_mutex);
+        m_stop_reader = true;
+    }
+    m_cv_space.notify_all();
+    if (m_reader.joinable())
+        m_reader.join();
+}
+
+void CBlockImporter::Restart(uint64_t nPos)
+{
+    StopReader();
+    {
+        LOCK(m_mutex);
+        // workers still decoding a dropped block only touch their own copy
+        m_ordered.clear();
+        m_undecoded.clear();
+        m_queued_bytes = 0;
+        m_read_done = false;
+        m_stop_reader = false;
+    }
+    if (fseek(file, nPos, SEEK_SET) != 0) {
+        LOCK(m_mutex);
+        m_read_error = "failed to seek in block file";
+        m_read_done = true;
+        return;
+    }
+    StartReader(nPos);
+}
+
+std::shared_ptr<ImportedBlock> CBlockImporter::Next()
+{
+    WAIT_LOCK(m_mutex, lock);
+    while (m_ordered.empty() ? !m_read_done : !m_ordered.front()->fDecoded)
+        m_cv_ready.wait(lock);
+
+    if (m_ordered.empty()) {
+        if (!m_read_error.empty())
+            throw std::runtime_error(m_read_error);
+        return nullptr;
+    }
+
+    std::shared_ptr<ImportedBlock> block = m_ordered.front();
+    m_ordered.pop_front();
+    m_queued_bytes -= block->vData.size();
+    block->vData.clear();
+    block->vData.shrink_to_fit();
+    m_cv_space.notify_one();
+    return block;
+}
+
+bool CBlockImporter::Queue(std::shared_ptr<ImportedBlock> block)
+{
+    {
+        WAIT_LOCK(m_mutex, lock);
+        while (!m_stop_reader && !m_ordered.empty() && m_queued_bytes + block->vData.size() > MAX_IMPORT_QUEUE_BYTES)
+            m_cv_space.wait(lock);
+        if (m_stop_reader)
+            return false;
+
+        m_queued_bytes += block->vData.size();
+        m_ordered.push_back(block);
+        m_undecoded.push_back(std::move(block));
+    }
+    m_cv_decode.notify_one();
+    return true;
+}
+
+void CBlockImporter::ThreadRead(uint64_t nPos)
+{
+    util::ThreadRename("loadblkread");
+
+    static const size_t HEADER_SIZE = CMessageHeader::MESSAGE_START_SIZE + sizeof(uint32_t);
+    // buffer holds the file from nBufferPos on, nothing before nScan is needed anymore
+    std::vector<unsigned char> buffer;
+    uint64_t nBufferPos = nPos;
+    size_t nScan = 0;
+    bool fEof = false;
+    std::string strError;
+
+    // make sure nNeeded bytes from nScan on are in the buffer, false at the end of the file
+    auto fill = [&](size_t nNeeded) {
+        while (buffer.size() - nScan < nNeeded && !fEof) {
+            buffer.erase(buffer.begin(), buffer.begin() + nScan);
+            nBufferPos += nScan;
+            nScan = 0;
+
+            const size_t nOld = buffer.size();
+            buffer.resize(nOld + std::max(IMPORT_READ_CHUNK_SIZE, nNeeded - nOld));
+            const size_t nRead = fread(buffer.data() + nOld, 1, buffer.size() - nOld, file);
+            buffer.resize(nOld + nRead);
+            if (nRead == 0) {
+                if (ferror(file))
+                    strError = "CBlockImporter: Read error";
+                fEof = true;
+            }
+        }
+        return buffer.size() - nScan >= nNeeded;
+    };
+
+    while (fill(HEADER_SIZE)) {
+        {
+            LOCK(m_mutex);
+            if (m_stop_reader)
+                return;
+        }
+
+        const unsigned char* pFound = (const unsigned char*)memchr(buffer.data() + nScan, m_message_start[0], buffer.size() - nScan);
+        if (!pFound) {
+            nScan = buffer.size();
+            continue;
+        }
+        nScan = pFound - buffer.data();
+        if (!fill(HEADER_SIZE))
+            break;
+        if (memcmp(buffer.data() + nScan, m_message_start, CMessageHeader::MESSAGE_START_SIZE)) {
+            nScan++;
+            continue;
+        }
+        const uint32_t nSize = ReadLE32(buffer.data() + nScan + CMessageHeader::MESSAGE_START_SIZE);
+        if (nSize < 80 || nSize > MAX_BLOCK_SERIALIZED_SIZE || !fill(HEADER_SIZE + nSize)) {
+            // not a block, or one cut off by the end of the file
+            nScan++;
+            continue;
+        }
+
+        auto block = std::make_shared<ImportedBlock>();
+        block->nPos = nBufferPos + nScan + HEADER_SIZE;
+        block->vData.assign(buffer.begin() + nScan + HEADER_SIZE, buffer.begin() + nScan + HEADER_SIZE + nSize);
+        nScan += HEADER_SIZE + nSize;
+        if (!Queue(std::move(block)))
+            return;
+    }
+
+    {
+        LOCK(m_mutex);
+        m_read_error = strError;
+        m_read_done = true;
+    }
+    m_cv_ready.notify_all();
+}
+
+void CBlockImporter::Decode(ImportedBlock& block) const
+{
+    try {
+        auto pblock = std::make_shared<CBlock>();
+        SpanReader reader(SER_DISK, CLIENT_VERSION, block.vData);
+        reader >> *pblock;
+        block.hash = pblock->GetHash();
+
+        // sets fChecked, a failure is reported again by AcceptBlock
+        BlockValidationState state;
+        CheckBlock(*pblock, state, m_params);
+        block.pblock = std::move(pblock);
+    } catch (const std::exception& e) {
+        block.strError = e.what();
+    }
+}
+
+void CBlockImporter::ThreadDecode()
+{
+    util::ThreadRename("loadblkdecode");
+
+    while (true) {
+        std::shared_ptr<ImportedBlock> block;
+        {
+            WAIT_LOCK(m_mutex, lock);
+            while (!m_stop_workers && m_undecoded.empty())
+                m_cv_decode.wait(lock);
+            if (m_stop_workers)
+                return;
+            block = m_undecoded.front();
+            m_undecoded.pop_front();
+        }
+
+        Decode(*block);
+
+        {
+            LOCK(m_mutex);
+            block->fDecoded = true;
+        }
+        m_cv_ready.notify_all();
+    }
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef CROWN_BLOCKIMPORT_H
+#define CROWN_BLOCKIMPORT_H
+
+#include <primitives/block.h>
+#include <protocol.h>
+#include <sync.h>
+#include <uint256.h>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Consensus {
+struct Params;
+}
+
+//! Upper bound on the threads decoding blocks during an import
+static const int MAX_IMPORT_DECODE_THREADS = 8;
+//! Bytes read from the file at once while scanning for blocks
+static const size_t IMPORT_READ_CHUNK_SIZE = 8 * 1024 * 1024;
+//! Serialized size of the blocks read ahead of the one being submitted
+static const size_t MAX_IMPORT_QUEUE_BYTES = 64 * 1024 * 1024;
+
+/** A block found in the file, decoded by one of the workers */
+struct ImportedBlock {
+    //! File position of the serialized block, past the message start and size
+    uint64_t nPos{0};
+    std::vector<unsigned char> vData;
+    //! nullptr if the block failed to deserialize
+    std::shared_ptr<CBlock> pblock;
+    uint256 hash;
+    std::string strError;
+    bool fDecoded{false};
+};
+
+/**
+ * Reads the blocks of a blk*.dat or bootstrap file for -reindex and -loadblock.
+ *
+ * A reader thread scans the file in large chunks for the message start and
+ * hands the serialized blocks to a few decode threads. These deserialize the
+ * block, which hashes its transactions, and run the context-free CheckBlock(),
+ * so validation skips the merkle root and transaction checks later. Next()
+ * returns the blocks in file order, the reader stays at most
+ * MAX_IMPORT_QUEUE_BYTES ahead of the caller.
+ *
+ * Takes over the file and closes it when destroyed.
+ */
+class CBlockImporter
+{
+public:
+    CBlockImporter(FILE* fileIn, const CMessageHeader::MessageStartChars& message_start, const Consensus::Params& params, int nThreads);
+    ~CBlockImporter();
+
+    CBlockImporter(const CBlockImporter&) = delete;
+    CBlockImporter& operator=(const CBlockImporter&) = delete;
+
+    /**
+     * The next block in the file, nullptr once the end is reached.
+     * Throws std::runtime_error if reading the file failed.
+     */
+    std::shared_ptr<ImportedBlock> Next();
+
+    //! Drop the blocks read ahead and scan again from nPos, used to resync after a corrupt block
+    void Restart(uint64_t nPos);
+
+private:
+    FILE* file;
+    CMessageHeader::MessageStartChars m_message_start;
+    const Consensus::Params& m_params;
+
+    Mutex m_mutex;
+    //! Wakes the workers when there is a block to decode
+    std::condition_variable m_cv_decode;
+    //! Wakes the caller of Next() when a block was decoded or the reader finished
+    std::condition_variable m_cv_ready;
+    //! Wakes the reader when the caller took a block
+    std::condition_variable m_cv_space;
+
+    //! In file order
+    std::deque<std::shared_ptr<ImportedBlock>> m_ordered GUARDED_BY(m_mutex);
+    std::deque<std::shared_ptr<ImportedBlock>> m_undecoded GUARDED_BY(m_mutex);
+    size_t m_queued_bytes GUARDED_BY(m_mutex){0};
+    bool m_read_done GUARDED_BY(m_mutex){false};
+    std::string m_read_error GUARDED_BY(m_mutex);
+    bool m_stop_reader GUARDED_BY(m_mutex){false};
+    bool m_stop_workers GUARDED_BY(m_mutex){false};
+
+    std::thread m_reader;
+    std::vector<std::thread> m_workers;
+
+    void StartReader(uint64_t nPos);
+    void StopReader();
+    void ThreadRead(uint64_t nPos);
+    void ThreadDecode();
+    bool Queue(std::shared_ptr<ImportedBlock> block);
+    void Decode(ImportedBlock& block) const;
+};
+
+#endif // CROWN_BLOCKIMPORT_H
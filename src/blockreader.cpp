@@ -0,0 +1,165 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockreader.h>
+
+#include <crypto/common.h>
+#include <fs.h>
+#include <serialize.h>
+#include <validation.h>
+
+#include <string.h>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+CBlockFileReader g_blockfile_reader;
+CBlockCache g_block_cache(BLOCK_CACHE_MAX_BYTES);
+
+CBlockFileMapping::~CBlockFileMapping()
+{
+#ifndef WIN32
+    munmap(const_cast<uint8_t*>(pData), nSize);
+#endif
+}
+
+bool CBlockFileReader::IsAvailable()
+{
+#ifndef WIN32
+    // a few dozen mapped block files don't fit in a 32 bit address space
+    return sizeof(void*) >= 8;
+#else
+    return false;
+#endif
+}
+
+std::shared_ptr<const CBlockFileMapping> CBlockFileReader::GetMapping(int nFile, size_t nMinSize)
+{
+    LOCK(cs);
+    for (auto it = m_mappings.begin(); it != m_mappings.end(); ++it) {
+        if (it->first != nFile)
+            continue;
+        if (it->second->nSize >= nMinSize) {
+            m_mappings.splice(m_mappings.begin(), m_mappings, it);
+            return it->second;
+        }
+        // the file grew since it was mapped
+        m_mappings.erase(it);
+        break;
+    }
+
+#ifndef WIN32
+    const fs::path path = GetBlockPosFilename(FlatFilePos(nFile, 0));
+    int fd = open(path.string().c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < nMinSize || st.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+    void* pData = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    // the mapping keeps the file referenced
+    close(fd);
+    if (pData == MAP_FAILED)
+        return nullptr;
+
+    auto mapping = std::make_shared<const CBlockFileMapping>((const uint8_t*)pData, (size_t)st.st_size);
+    m_mappings.emplace_front(nFile, mapping);
+    if (m_mappings.size() > MAX_MAPPED_BLOCK_FILES)
+        m_mappings.pop_back();
+    return mapping;
+#else
+    return nullptr;
+#endif
+}
+
+std::shared_ptr<const CBlockFileMapping> CBlockFileReader::MapBlock(const FlatFilePos& pos, const CMessageHeader::MessageStartChars& message_start, Span<const uint8_t>& block)
+{
+    // the message start and block size are written in front of the block
+    static const unsigned int HEADER_SIZE = CMessageHeader::MESSAGE_START_SIZE + sizeof(uint32_t);
+    if (!IsAvailable() || pos.IsNull() || pos.nPos < HEADER_SIZE)
+        return nullptr;
+
+    std::shared_ptr<const CBlockFileMapping> mapping = GetMapping(pos.nFile, pos.nPos);
+    if (!mapping)
+        return nullptr;
+
+    const uint8_t* pHeader = mapping->pData + pos.nPos - HEADER_SIZE;
+    if (memcmp(pHeader, message_start, CMessageHeader::MESSAGE_START_SIZE))
+        return nullptr;
+    const uint32_t nBlockSize = ReadLE32(pHeader + CMessageHeader::MESSAGE_START_SIZE);
+    if (nBlockSize > MAX_SIZE)
+        return nullptr;
+
+    if ((size_t)pos.nPos + nBlockSize > mapping->nSize) {
+        mapping = GetMapping(pos.nFile, (size_t)pos.nPos + nBlockSize);
+        if (!mapping)
+            return nullptr;
+    }
+
+    block = Span<const uint8_t>(mapping->pData + pos.nPos, nBlockSize);
+    return mapping;
+}
+
+void CBlockFileReader::CloseFiles(const std::set<int>& setFiles)
+{
+    LOCK(cs);
+    m_mappings.remove_if([&setFiles](const std::pair<int, std::shared_ptr<const CBlockFileMapping>>& entry) {
+        return setFiles.count(entry.first) > 0;
+    });
+}
+
+std::shared_ptr<const CBlock> CBlockCache::Get(const uint256& hash, const FlatFilePos& pos)
+{
+    LOCK(cs);
+    auto it = m_index.find(hash);
+    if (it == m_index.end() || it->second->pos != pos)
+        return nullptr;
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->block;
+}
+
+void CBlockCache::Add(const uint256& hash, const FlatFilePos& pos, const std::shared_ptr<const CBlock>& block, size_t nSize)
+{
+    if (nSize > nMaxBytes)
+        return;
+
+    LOCK(cs);
+    auto it = m_index.find(hash);
+    if (it != m_index.end()) {
+        nBytes -= it->second->nSize;
+        m_lru.erase(it->second);
+        m_index.erase(it);
+    }
+
+    m_lru.push_front(Entry{hash, pos, block, nSize});
+    m_index.emplace(hash, m_lru.begin());
+    nBytes += nSize;
+
+    while (nBytes > nMaxBytes) {
+        const Entry& oldest = m_lru.back();
+        nBytes -= oldest.nSize;
+        m_index.erase(oldest.hash);
+        m_lru.pop_back();
+    }
+}
+
+void CBlockCache::Clear()
+{
+    LOCK(cs);
+    m_lru.clear();
+    m_index.clear();
+    nBytes = 0;
+}
+
+size_t CBlockCache::size() const
+{
+    LOCK(cs);
+    return m_lru.size();
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef CROWN_BLOCKREADER_H
+#define CROWN_BLOCKREADER_H
+
+#include <flatfile.h>
+#include <primitives/block.h>
+#include <protocol.h>
+#include <span.h>
+#include <sync.h>
+#include <uint256.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+
+//! Number of block files kept mapped at once
+static const size_t MAX_MAPPED_BLOCK_FILES = 64;
+//! Serialized size of the decoded blocks kept in memory
+static const size_t BLOCK_CACHE_MAX_BYTES = 32 * 1024 * 1024;
+
+/** Read only mapping of a whole block file, unmapped when the last user drops it */
+class CBlockFileMapping
+{
+public:
+    const uint8_t* const pData;
+    const size_t nSize;
+
+    CBlockFileMapping(const uint8_t* pDataIn, size_t nSizeIn) : pData(pDataIn), nSize(nSizeIn) {}
+    ~CBlockFileMapping();
+
+    CBlockFileMapping(const CBlockFileMapping&) = delete;
+    CBlockFileMapping& operator=(const CBlockFileMapping&) = delete;
+};
+
+/**
+ * Memory mapped access to the blk*.dat files.
+ *
+ * Blocks are deserialized straight from the mapping instead of through
+ * stdio. The file that is still appended to is mapped again when a read goes
+ * past the mapped size. Only 64 bit POSIX systems map the files, elsewhere
+ * MapBlock() always fails and the callers read through a FILE as before.
+ */
+class CBlockFileReader
+{
+private:
+    Mutex cs;
+    // most recently used first
+    std::list<std::pair<int, std::shared_ptr<const CBlockFileMapping>>> m_mappings GUARDED_BY(cs);
+
+    std::shared_ptr<const CBlockFileMapping> GetMapping(int nFile, size_t nMinSize);
+
+public:
+    static bool IsAvailable();
+
+    /**
+     * Find the serialized block stored at pos, after checking the message
+     * start and size written in front of it. The span stays valid as long as
+     * the returned mapping is held, nullptr if the block can't be mapped.
+     */
+    std::shared_ptr<const CBlockFileMapping> MapBlock(const FlatFilePos& pos, const CMessageHeader::MessageStartChars& message_start, Span<const uint8_t>& block);
+
+    //! Drop the mappings of files that are about to be removed
+    void CloseFiles(const std::set<int>& setFiles);
+};
+
+/**
+ * Recently decoded blocks by hash, bounded by their serialized size.
+ *
+ * An entry only matches a lookup at the position it was read from, so a
+ * block that was stored again elsewhere is read again.
+ */
+class CBlockCache
+{
+private:
+    struct Entry {
+        uint256 hash;
+        FlatFilePos pos;
+        std::shared_ptr<const CBlock> block;
+        size_t nSize;
+    };
+
+    mutable Mutex cs;
+    const size_t nMaxBytes;
+    size_t nBytes GUARDED_BY(cs){0};
+    // most recently used first
+    std::list<Entry> m_lru GUARDED_BY(cs);
+    std::map<uint256, std::list<Entry>::iterator> m_index GUARDED_BY(cs);
+
+public:
+    explicit CBlockCache(size_t nMaxBytesIn) : nMaxBytes(nMaxBytesIn) {}
+
+    std::shared_ptr<const CBlock> Get(const uint256& hash, const FlatFilePos& pos);
+    void Add(const uint256& hash, const FlatFilePos& pos, const std::shared_ptr<const CBlock>& block, size_t nSize);
+    void Clear();
+    size_t size() const;
+};
+
+extern CBlockFileReader g_blockfile_reader;
+extern CBlockCache g_block_cache;
+
+#endif // CROWN_BLOCKREADER_H
@@ -6,6 +6,7 @@
 
 #include <primitives/transaction.h>
 #include <hash.h>
+#include <memusage.h>
 #include <script/script.h>
 #include <script/standard.h>
 #include <random.h>
@@ -274,3 +275,8 @@ void CRollingBloomFilter::reset()
     nGeneration = 1;
     std::fill(data.begin(), data.end(), 0);
 }
+
+size_t CRollingBloomFilter::DynamicMemoryUsage() const
+{
+    return memusage::DynamicUsage(data);
+}
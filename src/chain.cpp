@@ -10,16 +10,14 @@ CBlockHeader CBlockIndex::GetBlockHeader(const Consensus::Params& consensusParam
 {
     CBlockHeader block;
     block.nVersion       = nVersion;
-    if (nVersion.IsAuxpow()) {
-        ReadBlockHeaderFromDisk(block, this, consensusParams);
-        return block;
-    }
     if (pprev)
         block.hashPrevBlock = pprev->GetBlockHash();
     block.hashMerkleRoot = hashMerkleRoot;
     block.nTime          = nTime;
     block.nBits          = nBits;
     block.nNonce         = nNonce;
+    if (nVersion.IsAuxpow())
+        block.auxpow = ReadBlockAuxPow(this, consensusParams);
     return block;
 }
 
@@ -8,10 +8,13 @@
 #include <sync.h>
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <vector>
 
 #include <boost/thread/condition_variable.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 
 template <typename T>
 class CCheckQueueControl;
@@ -25,101 +28,197 @@ class CCheckQueueControl;
   * onto the queue, where they are processed by N-1 worker threads. When
   * the master is done adding work, it temporarily joins the worker pool
   * as an N'th worker, until all jobs are done.
+  *
+  * The master groups the verifications into chunks and deals them out
+  * round robin to queues of its own and of every worker. Each thread takes
+  * chunks from its own queue first and steals from the others when it runs
+  * out, so handing out work needs no lock. A mutex is only taken to put an
+  * idle thread to sleep and to wake it again.
   */
 template <typename T>
 class CCheckQueue
 {
 private:
-    //! Mutex to protect the inner state
+    //! Verifications handed out together
+    struct Chunk {
+        std::vector<T> checks;
+    };
+
+    //! Chunks a queue holds before the master runs further ones itself
+    static const uint64_t QUEUE_CAPACITY = 256;
+    //! Queues of their own for the first workers, later ones share them
+    static const size_t MAX_QUEUES = 65;
+    //! Rounds an idle thread polls the queues before it goes to sleep
+    static const int IDLE_SPINS = 64;
+
+    /**
+     * Ring of chunks that only the master pushes to, and that any thread
+     * pops from. Positions only grow, so a pop whose position was taken in
+     * the meantime fails its compare and swap.
+     */
+    struct WorkQueue {
+        std::atomic<uint64_t> head{0};
+        char padding[64];
+        std::atomic<uint64_t> tail{0};
+        std::unique_ptr<std::atomic<Chunk*>[]> slots{new std::atomic<Chunk*>[QUEUE_CAPACITY]};
+    };
+
+    //! Mutex idle threads sleep on
     boost::mutex mutex;
 
     //! Worker threads block on this when out of work
     boost::condition_variable condWorker;
 
-    //! Master thread blocks on this when out of work
+    //! Master thread blocks on this while the last chunks are verified
     boost::condition_variable condMaster;
 
-    //! The queue of elements to be processed.
-    //! As the order of booleans doesn't matter, it is used as a LIFO (stack)
-    std::vector<T> queue;
+    //! Queue 0 is the master's, the workers' follow
+    std::unique_ptr<WorkQueue[]> queues{new WorkQueue[MAX_QUEUES]};
+    std::atomic<size_t> nQueues{1};
+    std::atomic<size_t> nWorkers{0};
 
-    //! The number of workers (including the master) that are idle.
-    int nIdle;
-
-    //! The total number of workers (including the master).
-    int nTotal;
+    //! Chunks pushed and not taken yet
+    std::atomic<int64_t> nQueued{0};
+    //! Workers sleeping on condWorker
+    std::atomic<int> nSleeping{0};
 
     //! The temporary evaluation result.
-    bool fAllOk;
+    std::atomic<bool> fAllOk{true};
 
     /**
      * Number of verifications that haven't completed yet.
-     * This includes elements that are no longer queued, but still in the
-     * worker's own batches.
+     * This includes verifications that were taken, until they are destroyed.
      */
-    unsigned int nTodo;
+    std::atomic<uint64_t> nTodo{0};
 
     //! The maximum number of elements to be processed in one batch
     unsigned int nBatchSize;
 
-    /** Internal function that does bulk of the verification work. */
-    bool Loop(bool fMaster = false)
+    // Only used by the master, serialized by ControlMutex
+    //! Chunks are reused once all of them are verified
+    std::vector<std::unique_ptr<Chunk>> vChunks;
+    size_t nChunksUsed{0};
+    Chunk* pending{nullptr};
+    size_t nNextQueue{0};
+
+    //! Number of verifications in a chunk, small enough to share a block's work among the threads
+    size_t ChunkSize() const { return std::max(1U, nBatchSize / 8); }
+
+    Chunk* NewChunk()
     {
-        boost::condition_variable& cond = fMaster ? condMaster : condWorker;
-        std::vector<T> vChecks;
-        vChecks.reserve(nBatchSize);
-        unsigned int nNow = 0;
-        bool fOk = true;
-        do {
-            {
-                boost::unique_lock<boost::mutex> lock(mutex);
-                // first do the clean-up of the previous loop run (allowing us to do it in the same critsect)
-                if (nNow) {
-                    fAllOk &= fOk;
-                    nTodo -= nNow;
-                    if (nTodo == 0 && !fMaster)
-                        // We processed the last element; inform the master it can exit and return the result
-                        condMaster.notify_one();
-                } else {
-                    // first iteration
-                    nTotal++;
-                }
-                // logically, the do loop starts here
-                while (queue.empty()) {
-                    if (fMaster && nTodo == 0) {
-                        nTotal--;
-                        bool fRet = fAllOk;
-                        // reset the status for new work later
-                        fAllOk = true;
-                        // return the current status
-                        return fRet;
-                    }
-                    nIdle++;
-                    cond.wait(lock); // wait
-                    nIdle--;
-                }
-                // Decide how many work units to process now.
-                // * Do not try to do everything at once, but aim for increasingly smaller batches so
-                //   all workers finish approximately simultaneously.
-                // * Try to account for idle jobs which will instantly start helping.
-                // * Don't do batches smaller than 1 (duh), or larger than nBatchSize.
-                nNow = std::max(1U, std::min(nBatchSize, (unsigned int)queue.size() / (nTotal + nIdle + 1)));
-                vChecks.resize(nNow);
-                for (unsigned int i = 0; i < nNow; i++) {
-                    // We want the lock on the mutex to be as short as possible, so swap jobs from the global
-                    // queue to the local batch vector instead of copying.
-                    vChecks[i].swap(queue.back());
-                    queue.pop_back();
+        if (nChunksUsed == vChunks.size()) {
+            vChunks.emplace_back(new Chunk);
+            // never reallocate, checks are only swapped in and out
+            vChunks.back()->checks.reserve(ChunkSize());
+        }
+        return vChunks[nChunksUsed++].get();
+    }
+
+    static bool Push(WorkQueue& queue, Chunk* chunk)
+    {
+        const uint64_t tail = queue.tail.load(std::memory_order_relaxed);
+        if (tail - queue.head.load(std::memory_order_acquire) >= QUEUE_CAPACITY)
+            return false;
+        queue.slots[tail % QUEUE_CAPACITY].store(chunk, std::memory_order_relaxed);
+        queue.tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    static Chunk* Pop(WorkQueue& queue)
+    {
+        uint64_t head = queue.head.load(std::memory_order_acquire);
+        while (head < queue.tail.load(std::memory_order_acquire)) {
+            Chunk* chunk = queue.slots[head % QUEUE_CAPACITY].load(std::memory_order_relaxed);
+            if (queue.head.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+                return chunk;
+        }
+        return nullptr;
+    }
+
+    //! Take a chunk from queue nOwn, or steal one from the other queues
+    Chunk* Take(size_t nOwn)
+    {
+        const size_t n = nQueues.load(std::memory_order_acquire);
+        for (size_t i = 0; i < n; i++) {
+            if (Chunk* chunk = Pop(queues[(nOwn + i) % n])) {
+                nQueued--;
+                return chunk;
+            }
+        }
+        return nullptr;
+    }
+
+    void Run(Chunk& chunk)
+    {
+        const uint64_t nNow = chunk.checks.size();
+        // Check whether we need to do work at all
+        bool fOk = fAllOk.load(std::memory_order_relaxed);
+        for (T& check : chunk.checks)
+            if (fOk)
+                fOk = check();
+        if (!fOk)
+            fAllOk.store(false, std::memory_order_relaxed);
+        chunk.checks.clear();
+        if (nTodo.fetch_sub(nNow, std::memory_order_acq_rel) == nNow) {
+            // We processed the last element; inform the master it can exit and return the result
+            boost::lock_guard<boost::mutex> lock(mutex);
+            condMaster.notify_one();
+        }
+    }
+
+    //! Hand the pending chunk to a queue, or verify it here if all queues are full
+    void Publish()
+    {
+        Chunk* chunk = pending;
+        pending = nullptr;
+        nTodo.fetch_add(chunk->checks.size(), std::memory_order_relaxed);
+
+        // counted before it can be taken, so that nQueued doesn't drop below zero
+        nQueued++;
+        const size_t n = nQueues.load(std::memory_order_acquire);
+        for (size_t i = 0; i < n; i++) {
+            if (Push(queues[nNextQueue++ % n], chunk)) {
+                if (nSleeping > 0) {
+                    boost::lock_guard<boost::mutex> lock(mutex);
+                    condWorker.notify_one();
                 }
-                // Check whether we need to do work at all
-                fOk = fAllOk;
+                return;
             }
-            // execute work
-            for (T& check : vChecks)
-                if (fOk)
-                    fOk = check();
-            vChecks.clear();
-        } while (true);
+        }
+        nQueued--;
+        Run(*chunk);
+    }
+
+    /** Internal function that does bulk of the verification work. */
+    void Loop(size_t nOwn)
+    {
+        while (true) {
+            Chunk* chunk = nullptr;
+            for (int i = 0; i < IDLE_SPINS && !chunk; i++) {
+                chunk = Take(nOwn);
+                if (!chunk)
+                    boost::this_thread::yield();
+            }
+            if (chunk) {
+                Run(*chunk);
+                continue;
+            }
+
+            boost::unique_lock<boost::mutex> lock(mutex);
+            // nSleeping is raised before nQueued is read, and the master
+            // raises nQueued before it reads nSleeping, so a chunk pushed
+            // meanwhile is either seen here or followed by a notification
+            nSleeping++;
+            try {
+                while (nQueued == 0)
+                    condWorker.wait(lock);
+            } catch (...) {
+                // interrupted
+                nSleeping--;
+                throw;
+            }
+            nSleeping--;
+        }
     }
 
 public:
@@ -127,33 +226,53 @@ public:
     boost::mutex ControlMutex;
 
     //! Create a new check queue
-    explicit CCheckQueue(unsigned int nBatchSizeIn) : nIdle(0), nTotal(0), fAllOk(true), nTodo(0), nBatchSize(nBatchSizeIn) {}
+    explicit CCheckQueue(unsigned int nBatchSizeIn) : nBatchSize(nBatchSizeIn) {}
 
     //! Worker thread
     void Thread()
     {
-        Loop();
+        const size_t nOwn = 1 + nWorkers++ % (MAX_QUEUES - 1);
+        size_t n = nQueues.load();
+        while (n < nOwn + 1 && !nQueues.compare_exchange_weak(n, nOwn + 1)) {}
+        Loop(nOwn);
     }
 
     //! Wait until execution finishes, and return whether all evaluations were successful.
     bool Wait()
     {
-        return Loop(true);
+        if (pending)
+            Publish();
+        while (true) {
+            if (Chunk* chunk = Take(0)) {
+                Run(*chunk);
+                continue;
+            }
+            boost::unique_lock<boost::mutex> lock(mutex);
+            // only the master pushes, so nothing is left to take but the workers' chunks
+            while (nTodo.load(std::memory_order_acquire) != 0 && nQueued == 0)
+                condMaster.wait(lock);
+            if (nTodo.load(std::memory_order_acquire) == 0)
+                break;
+        }
+        nChunksUsed = 0;
+        bool fRet = fAllOk;
+        // reset the status for new work later
+        fAllOk = true;
+        // return the current status
+        return fRet;
     }
 
     //! Add a batch of checks to the queue
     void Add(std::vector<T>& vChecks)
     {
-        boost::unique_lock<boost::mutex> lock(mutex);
         for (T& check : vChecks) {
-            queue.push_back(T());
-            check.swap(queue.back());
+            if (!pending)
+                pending = NewChunk();
+            pending->checks.emplace_back();
+            check.swap(pending->checks.back());
+            if (pending->checks.size() >= ChunkSize())
+                Publish();
         }
-        nTodo += vChecks.size();
-        if (vChecks.size() == 1)
-            condWorker.notify_one();
-        else if (vChecks.size() > 1)
-            condWorker.notify_all();
     }
 
     ~CCheckQueue()
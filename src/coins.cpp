@@ -7,6 +7,7 @@
 #include <consensus/consensus.h>
 #include <logging.h>
 #include <random.h>
+#include <util/memory.h>
 #include <version.h>
 
 bool CCoinsView::GetCoin(const COutPoint &outpoint, Coin &coin) const { return false; }
@@ -221,6 +222,14 @@ bool CCoinsViewCache::Flush() {
     return fOk;
 }
 
+std::unique_ptr<CCoinsMap> CCoinsViewCache::ReleaseCoins() {
+    std::unique_ptr<CCoinsMap> mapCoins = MakeUnique<CCoinsMap>();
+    mapCoins->swap(cacheCoins);
+    cacheCoins.set_pool_budget(nCacheBudget);
+    cachedCoinsUsage = 0;
+    return mapCoins;
+}
+
 void CCoinsViewCache::Uncache(const COutPoint& hash)
 {
     CCoinsMap::iterator it = cacheCoins.find(hash);
@@ -230,6 +239,15 @@ void CCoinsViewCache::Uncache(const COutPoint& hash)
     }
 }
 
+void CCoinsViewCache::AddPrefetchedCoin(const COutPoint& outpoint, Coin&& coin)
+{
+    if (coin.IsSpent())
+        return;
+    auto ret = cacheCoins.emplace(std::piecewise_construct, std::forward_as_tuple(outpoint), std::forward_as_tuple(std::move(coin)));
+    if (ret.second)
+        cachedCoinsUsage += ret.first->second.coin.DynamicMemoryUsage();
+}
+
 unsigned int CCoinsViewCache::GetCacheSize() const {
     return cacheCoins.size();
 }
@@ -252,6 +270,13 @@ void CCoinsViewCache::ReallocateCache()
     assert(cacheCoins.size() == 0);
     cacheCoins.~CCoinsMap();
     ::new (&cacheCoins) CCoinsMap();
+    cacheCoins.set_pool_budget(nCacheBudget);
+}
+
+void CCoinsViewCache::SetCacheBudget(size_t nBytes)
+{
+    nCacheBudget = nBytes;
+    cacheCoins.set_pool_budget(nBytes);
 }
 
 static const size_t MIN_TRANSACTION_OUTPUT_WEIGHT = WITNESS_SCALE_FACTOR * ::GetSerializeSize(CTxOut(), PROTOCOL_VERSION);
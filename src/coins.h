@@ -10,6 +10,7 @@
 #include <core_memusage.h>
 #include <crypto/siphash.h>
 #include <memusage.h>
+#include <pooledhashmap.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
 #include <uint256.h>
@@ -169,7 +170,7 @@ struct CCoinsCacheEntry
     explicit CCoinsCacheEntry(Coin&& coin_) : coin(std::move(coin_)), flags(0) {}
 };
 
-typedef std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher> CCoinsMap;
+typedef PooledHashMap<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher> CCoinsMap;
 
 /** Cursor for iterating over CoinsView state */
 class CCoinsViewCursor
@@ -261,6 +262,9 @@ protected:
     /* Cached dynamic memory usage for the inner Coin objects. */
     mutable size_t cachedCoinsUsage;
 
+    /* Memory budget the cache is sized for, 0 if unknown. */
+    size_t nCacheBudget{0};
+
 public:
     CCoinsViewCache(CCoinsView *baseIn);
 
@@ -318,12 +322,25 @@ public:
      */
     bool Flush();
 
+    /**
+     * Hand the cached coins over to the caller, which is then responsible
+     * for writing the modified ones to the base, and continue empty as after
+     * Flush(). The best block is kept.
+     */
+    std::unique_ptr<CCoinsMap> ReleaseCoins();
+
     /**
      * Removes the UTXO with the given outpoint from the cache, if it is
      * not modified.
      */
     void Uncache(const COutPoint &outpoint);
 
+    /**
+     * Add a coin that was read from the backing view ahead of its use,
+     * unless the outpoint is cached already. Spent coins are not added.
+     */
+    void AddPrefetchedCoin(const COutPoint& outpoint, Coin&& coin);
+
     //! Calculate the size of the cache (in number of transaction outputs)
     unsigned int GetCacheSize() const;
 
@@ -334,12 +351,12 @@ public:
     bool HaveInputs(const CTransaction& tx) const;
 
     //! Force a reallocation of the cache map. This is required when downsizing
-    //! the cache because the map's allocator may be hanging onto a lot of
-    //! memory despite having called .clear().
-    //!
-    //! See: https://stackoverflow.com/questions/42114044/how-to-release-unordered-map-memory
+    //! the cache because the map keeps its table and entry pool after .clear().
     void ReallocateCache();
 
+    //! Size the entry pool of the cache for a memory budget of nBytes
+    void SetCacheBudget(size_t nBytes);
+
 private:
     /**
      * @note this is marked const, but may actually append to `cacheCoins`, increasing
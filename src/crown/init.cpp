@@ -4,6 +4,8 @@
 
 #include <crown/init.h>
 
+#include <key_io.h>
+
 void loadNodeConfiguration()
 {
     masternodeConfig.clear();
@@ -28,14 +30,49 @@ bool setupNodeConfiguration()
 {
     fMasterNode = gArgs.GetBoolArg("-masternode", false);
     fSystemNode = gArgs.GetBoolArg("-systemnode", false);
+    const bool fNodeHost = gArgs.GetBoolArg("-nodehost", false);
 
     if (fMasterNode && fSystemNode) {
         return InitError(strprintf(_("Masternode and Systemnode cannot run together")));
     }
 
+    if (fNodeHost && !fMasterNode && !fSystemNode) {
+        return InitError(_("-nodehost requires -masternode or -systemnode"));
+    }
+
     std::shared_ptr<CWallet> pwallet = GetMainWallet();
 
-    if (fMasterNode) {
+    if (fMasterNode && fNodeHost) {
+        LogPrintf("IS MASTERNODE HOST\n");
+        if (masternodeConfig.getCount() == 0) {
+            return InitError(_("-nodehost requires at least one entry in masternode.conf"));
+        }
+
+        // the first entry takes the place of -masternodeprivkey, so manual votes are signed with it
+        bool fFirst = true;
+        for (const CNodeEntry& mne : masternodeConfig.getEntries()) {
+            CActiveMasternode& active = fFirst ? activeMasternode : AddHostedMasternode();
+            if (!CService(LookupNumeric(mne.getIp().c_str())).IsValid()) {
+                return InitError(strprintf(_("Invalid address %s of masternode %s"), mne.getIp(), mne.getAlias()));
+            }
+            // operator keys are not kept in the wallet, so none is needed to host the nodes
+            active.keyMasternode = DecodeSecret(mne.getPrivKey());
+            if (!active.keyMasternode.IsValid()) {
+                return InitError(strprintf(_("Invalid private key of masternode %s"), mne.getAlias()));
+            }
+            active.pubKeyMasternode = active.keyMasternode.GetPubKey();
+            active.strAlias = mne.getAlias();
+            active.strAddr = mne.getIp();
+            active.strCollateralTxHash = mne.getTxHash();
+            active.strCollateralOutputIndex = mne.getOutputIndex();
+            LogPrintf(" %s addr %s\n", active.strAlias, active.strAddr);
+            if (fFirst) {
+                strMasterNodeAddr = mne.getIp();
+                strMasterNodePrivKey = mne.getPrivKey();
+                fFirst = false;
+            }
+        }
+    } else if (fMasterNode) {
         LogPrintf("IS MASTERNODE\n");
         strMasterNodeAddr = gArgs.GetArg("-masternodeaddr", "");
         LogPrintf(" addr %s\n", strMasterNodeAddr.c_str());
@@ -45,6 +82,7 @@ bool setupNodeConfiguration()
                 return InitError(strprintf(_("Invalid -masternodeaddr address")));
             }
         }
+        activeMasternode.strAddr = strMasterNodeAddr;
 
         strMasterNodePrivKey = gArgs.GetArg("-masternodeprivkey", "");
         if (!strMasterNodePrivKey.empty()) {
@@ -55,12 +93,43 @@ bool setupNodeConfiguration()
                 return InitError(strprintf(_("Invalid masternodeprivkey. Please see documentation.")));
             }
             activeMasternode.pubKeyMasternode = pubkey;
+            activeMasternode.keyMasternode = key;
         } else {
             return InitError(_("You must specify a masternodeprivkey in the configuration. Please see documentation for help."));
         }
     }
 
-    if (fSystemNode) {
+    if (fSystemNode && fNodeHost) {
+        LogPrintf("IS SYSTEMNODE HOST\n");
+        if (systemnodeConfig.getCount() == 0) {
+            return InitError(_("-nodehost requires at least one entry in systemnode.conf"));
+        }
+
+        // the first entry takes the place of -systemnodeprivkey
+        bool fFirst = true;
+        for (const CNodeEntry& sne : systemnodeConfig.getEntries()) {
+            CActiveSystemnode& active = fFirst ? activeSystemnode : AddHostedSystemnode();
+            if (!CService(LookupNumeric(sne.getIp().c_str())).IsValid()) {
+                return InitError(strprintf(_("Invalid address %s of systemnode %s"), sne.getIp(), sne.getAlias()));
+            }
+            // operator keys are not kept in the wallet, so none is needed to host the nodes
+            active.keySystemnode = DecodeSecret(sne.getPrivKey());
+            if (!active.keySystemnode.IsValid()) {
+                return InitError(strprintf(_("Invalid private key of systemnode %s"), sne.getAlias()));
+            }
+            active.pubKeySystemnode = active.keySystemnode.GetPubKey();
+            active.strAlias = sne.getAlias();
+            active.strAddr = sne.getIp();
+            active.strCollateralTxHash = sne.getTxHash();
+            active.strCollateralOutputIndex = sne.getOutputIndex();
+            LogPrintf(" %s addr %s\n", active.strAlias, active.strAddr);
+            if (fFirst) {
+                strSystemNodeAddr = sne.getIp();
+                strSystemNodePrivKey = sne.getPrivKey();
+                fFirst = false;
+            }
+        }
+    } else if (fSystemNode) {
         LogPrintf("IS SYSTEMNODE\n");
         strSystemNodeAddr = gArgs.GetArg("-systemnodeaddr", "");
         LogPrintf(" addr %s\n", strSystemNodeAddr.c_str());
@@ -70,6 +139,7 @@ bool setupNodeConfiguration()
                 return InitError(strprintf(_("Invalid -systemnodeaddr address")));
             }
         }
+        activeSystemnode.strAddr = strSystemNodeAddr;
 
         strSystemNodePrivKey = gArgs.GetArg("-systemnodeprivkey", "");
         if (!strSystemNodePrivKey.empty()) {
@@ -80,6 +150,7 @@ bool setupNodeConfiguration()
                 return InitError(strprintf(_("Invalid systemnodeprivkey. Please see documentation.")));
             }
             activeSystemnode.pubKeySystemnode = pubkey;
+            activeSystemnode.keySystemnode = key;
         } else {
             return InitError(_("You must specify a systemnodeprivkey in the configuration. Please see documentation for help."));
         }
@@ -4,6 +4,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <consensus/validation.h>
+#include <core_memusage.h>
 #include <crown/instantx.h>
 #include <mn_processing.h>
 #include <masternode/masternode-sync.h>
@@ -11,6 +12,7 @@
 #include <netmessagemaker.h>
 #include <node/context.h>
 #include <rpc/blockchain.h>
+#include <validationinterface.h>
 
 using namespace std;
 using namespace boost;
@@ -259,41 +261,44 @@ void CInstantSend::DoConsensusVote(const CMutableTransaction& tx, int64_t nBlock
     if (!fMasterNode)
         return;
 
-    int n = mnodeman.GetMasternodeRank(activeMasternode.vin, nBlockHeight, MIN_INSTANTX_PROTO_VERSION);
+    // every masternode we host in the top votes on its own
+    for (const CActiveMasternode* pactive : GetActiveMasternodes()) {
+        int n = mnodeman.GetMasternodeRank(pactive->vin, nBlockHeight, MIN_INSTANTX_PROTO_VERSION);
 
-    if (n == -1) {
-        LogPrintf("InstantX::DoConsensusVote - Unknown Masternode\n");
-        return;
-    }
+        if (n == -1) {
+            LogPrintf("InstantX::DoConsensusVote - Unknown Masternode %s\n", pactive->strAlias);
+            continue;
+        }
 
-    if (n > INSTANTX_SIGNATURES_TOTAL) {
-        LogPrintf("InstantX::DoConsensusVote - Masternode not in the top %d (%d)\n", INSTANTX_SIGNATURES_TOTAL, n);
-        return;
-    }
-    /*
-        nBlockHeight calculated from the transaction is the authoritive source
-    */
+        if (n > INSTANTX_SIGNATURES_TOTAL) {
+            LogPrintf("InstantX::DoConsensusVote - Masternode %s not in the top %d (%d)\n", pactive->strAlias, INSTANTX_SIGNATURES_TOTAL, n);
+            continue;
+        }
+        /*
+            nBlockHeight calculated from the transaction is the authoritive source
+        */
 
-    LogPrintf("InstantX::DoConsensusVote - In the top %d (%d)\n", INSTANTX_SIGNATURES_TOTAL, n);
+        LogPrintf("InstantX::DoConsensusVote - In the top %d (%d)\n", INSTANTX_SIGNATURES_TOTAL, n);
 
-    CConsensusVote ctx;
-    ctx.vinMasternode = activeMasternode.vin;
-    ctx.txHash = tx.GetHash();
-    ctx.nBlockHeight = nBlockHeight;
-    if (!ctx.Sign()) {
-        LogPrintf("InstantX::DoConsensusVote - Failed to sign consensus vote\n");
-        return;
-    }
-    if (!ctx.SignatureValid()) {
-        LogPrintf("InstantX::DoConsensusVote - Signature invalid\n");
-        return;
-    }
+        CConsensusVote ctx;
+        ctx.vinMasternode = pactive->vin;
+        ctx.txHash = tx.GetHash();
+        ctx.nBlockHeight = nBlockHeight;
+        if (!ctx.Sign(pactive->keyMasternode)) {
+            LogPrintf("InstantX::DoConsensusVote - Failed to sign consensus vote\n");
+            continue;
+        }
+        if (!ctx.SignatureValid()) {
+            LogPrintf("InstantX::DoConsensusVote - Signature invalid\n");
+            continue;
+        }
 
-    uint256 ctxHash = ctx.GetHash();
-    mapTxLockVote[ctxHash] = ctx;
+        uint256 ctxHash = ctx.GetHash();
+        mapTxLockVote[ctxHash] = ctx;
 
-    CInv inv(MSG_TXLOCK_VOTE, ctxHash);
-    connman.RelayInv(inv);
+        CInv inv(MSG_TXLOCK_VOTE, ctxHash);
+        connman.RelayInv(inv);
+    }
 }
 
 //received a consensus vote
@@ -347,6 +352,9 @@ bool CInstantSend::ProcessConsensusVote(CNode* pnode, const CConsensusVote& ctx,
 
         if ((*i).second.CountSignatures() >= INSTANTX_SIGNATURES_REQUIRED) {
             LogPrintf("InstantX::ProcessConsensusVote - Transaction Lock Is Complete \n");
+            // later votes keep the lock complete, only the one completing it is published
+            if ((*i).second.CountSignatures() == INSTANTX_SIGNATURES_REQUIRED)
+                GetMainSignals().InstantSendLockCompleted(ctx.txHash);
             LogPrintf("InstantX::ProcessConsensusVote - Transaction Lock Is Complete %s !\n", (*i).second.GetHash().ToString().c_str());
 
             CMutableTransaction& tx = mapTxLockReq[ctx.txHash];
@@ -501,6 +509,30 @@ std::string CInstantSend::ToString() const
     return info.str();
 }
 
+static size_t RecursiveDynamicUsage(const CConsensusVote& vote)
+{
+    return RecursiveDynamicUsage(vote.vinMasternode) + memusage::DynamicUsage(vote.vchMasterNodeSignature);
+}
+
+size_t CInstantSend::DynamicMemoryUsage() const
+{
+    LOCK(cs);
+    size_t nUsage = memusage::DynamicUsage(mapLockedInputs) + memusage::DynamicUsage(mapTxLocks) + memusage::DynamicUsage(mapUnknownVotes) +
+                    memusage::DynamicUsage(mapTxLockReqRejected) + memusage::DynamicUsage(mapTxLockVote) + memusage::DynamicUsage(mapTxLockReq);
+    for (const auto& lock : mapTxLocks) {
+        nUsage += memusage::DynamicUsage(lock.second.vecConsensusVotes);
+        for (const CConsensusVote& vote : lock.second.vecConsensusVotes)
+            nUsage += RecursiveDynamicUsage(vote);
+    }
+    for (const auto& tx : mapTxLockReqRejected)
+        nUsage += RecursiveDynamicUsage(tx.second);
+    for (const auto& vote : mapTxLockVote)
+        nUsage += RecursiveDynamicUsage(vote.second);
+    for (const auto& tx : mapTxLockReq)
+        nUsage += RecursiveDynamicUsage(tx.second);
+    return nUsage;
+}
+
 void CInstantSend::Clear()
 {
     LOCK(cs);
@@ -543,20 +575,13 @@ bool CConsensusVote::SignatureValid() const
     return true;
 }
 
-bool CConsensusVote::Sign()
+bool CConsensusVote::Sign(const CKey& key2)
 {
     std::string errorMessage;
 
-    CKey key2;
-    CPubKey pubkey2;
+    CPubKey pubkey2 = key2.GetPubKey();
     std::string strMessage = txHash.ToString().c_str() + boost::lexical_cast<std::string>(nBlockHeight);
     //LogPrintf("signing strMessage %s \n", strMessage.c_str());
-    //LogPrintf("signing privkey %s \n", strMasterNodePrivKey.c_str());
-
-    if (!legacySigner.SetKey(strMasterNodePrivKey, key2, pubkey2)) {
-        LogPrintf("CConsensusVote::Sign() - ERROR: Invalid masternodeprivkey: '%s'\n", errorMessage.c_str());
-        return false;
-    }
 
     if (!legacySigner.SignMessage(strMessage, vchMasterNodeSignature, key2)) {
         LogPrintf("CConsensusVote::Sign() - Sign message failed");
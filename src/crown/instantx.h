@@ -47,6 +47,7 @@ public:
     bool TxLockRequested(uint256 txHash) const;
     bool AlreadyHave(uint256 txHash) const;
     std::string ToString() const;
+    size_t DynamicMemoryUsage() const;
 
     SERIALIZE_METHODS(CInstantSend, obj)
     {
@@ -94,7 +95,7 @@ public:
     }
     uint256 GetHash() const;
     bool SignatureValid() const;
-    bool Sign();
+    bool Sign(const CKey& key2);
 
     SERIALIZE_METHODS(CConsensusVote, obj)
     {
@@ -12,6 +12,7 @@
 #include <node/context.h>
 #include <rpc/blockchain.h>
 #include <rpc/util.h>
+#include <scheduler.h>
 #include <script/sign.h>
 #include <shutdown.h>
 #include <systemnode/systemnodeman.h>
@@ -47,72 +48,61 @@ std::string currentSyncStatus()
     return lastStatusMessage;
 }
 
-void ThreadMasternodeSync(CConnman& connman)
+static bool CanProcessNodes(bool fBlockchainSynced)
 {
-    util::ThreadRename("crown-mnodesync");
-
     if (fReindex || fImporting)
-        return;
+        return false;
     if (::ChainstateActive().IsInitialBlockDownload())
-        return;
+        return false;
     if (ShutdownRequested())
-        return;
-    if (!masternodeSync.IsBlockchainSynced())
-        return;
-
-    static unsigned int c1 = 0;
-
-    masternodeSync.Process(connman);
-    {
-        c1++;
-
-        mnodeman.Check();
+        return false;
+    return fBlockchainSynced;
+}
 
-        // check if we should activate or ping every few minutes,
-        // start right after sync is considered to be done
-        if (c1 % MASTERNODE_PING_SECONDS == 15)
-            activeMasternode.ManageStatus(connman);
+static void ManageActiveNodes(CConnman& connman)
+{
+    if (CanProcessNodes(masternodeSync.IsBlockchainSynced()))
+        for (CActiveMasternode* pactive : GetActiveMasternodes())
+            pactive->ManageStatus(connman);
+    if (CanProcessNodes(systemnodeSync.IsBlockchainSynced()))
+        for (CActiveSystemnode* pactive : GetActiveSystemnodes())
+            pactive->ManageStatus(connman);
+}
 
-        if (c1 % 60 == 0) {
+void StartNodeSync(CScheduler& scheduler, CConnman& connman)
+{
+    // the sync state machines drive themselves from here on
+    masternodeSync.Start(scheduler, connman);
+    systemnodeSync.Start(scheduler, connman);
+
+    scheduler.scheduleEvery([] {
+        if (CanProcessNodes(masternodeSync.IsBlockchainSynced()))
+            mnodeman.Check();
+        if (CanProcessNodes(systemnodeSync.IsBlockchainSynced()))
+            snodeman.Check();
+    }, std::chrono::seconds{MASTERNODE_CHECK_SECONDS});
+
+    // check if we should activate or ping every few minutes, starting right away
+    scheduler.scheduleFromNow([&connman] { ManageActiveNodes(connman); }, std::chrono::milliseconds{0});
+    scheduler.scheduleEvery([&connman] { ManageActiveNodes(connman); }, std::chrono::seconds{MASTERNODE_PING_SECONDS});
+
+    scheduler.scheduleEvery([&connman] {
+        if (CanProcessNodes(masternodeSync.IsBlockchainSynced())) {
             mnodeman.CheckAndRemove();
             mnodeman.ProcessMasternodeConnections(connman);
             masternodePayments.CheckAndRemove();
             instantSend.CheckAndRemove();
         }
-    }
-}
-
-void ThreadSystemnodeSync(CConnman& connman)
-{
-    util::ThreadRename("crown-snodesync");
-
-    if (fReindex || fImporting)
-        return;
-    if (::ChainstateActive().IsInitialBlockDownload())
-        return;
-    if (ShutdownRequested())
-        return;
-    if (!systemnodeSync.IsBlockchainSynced())
-        return;
-
-    static unsigned int c2 = 0;
-
-    systemnodeSync.Process(connman);
-    {
-        c2++;
-
-        snodeman.Check();
-
-        // check if we should activate or ping every few minutes,
-        // start right after sync is considered to be done
-        if (c2 % SYSTEMNODE_PING_SECONDS == 15)
-            activeSystemnode.ManageStatus(connman);
-
-        if (c2 % 60 == 0) {
+        if (CanProcessNodes(systemnodeSync.IsBlockchainSynced())) {
             snodeman.CheckAndRemove();
             snodeman.ProcessSystemnodeConnections(connman);
             systemnodePayments.CheckAndRemove();
         }
-    }
+    }, std::chrono::seconds{60});
 }
 
+void StopNodeSync()
+{
+    masternodeSync.Stop();
+    systemnodeSync.Stop();
+}
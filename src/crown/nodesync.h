@@ -9,10 +9,13 @@
 #include <net.h>
 
 class CConnman;
+class CScheduler;
 
 std::string currentSyncStatus();
 
-void ThreadMasternodeSync(CConnman& connman);
-void ThreadSystemnodeSync(CConnman& connman);
+/** Start the masternode/systemnode sync state machines and schedule the periodic list maintenance */
+void StartNodeSync(CScheduler& scheduler, CConnman& connman);
+/** Detach the sync state machines from the scheduler and connection manager passed to StartNodeSync() */
+void StopNodeSync();
 
 #endif // CROWN_NODESYNC_H
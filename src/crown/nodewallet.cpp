@@ -103,20 +103,30 @@ bool CWallet::GetBudgetSystemCollateralTX(CTransactionRef& tx, uint256 hash)
     return CreateTransaction(vecSend, tx, nFeeRequired, nChangePosRet, error, coinControl, fee_calc_out);
 }
 
-bool CWallet::GetActiveMasternode(CMasternode*& activeStakingNode)
+bool CWallet::GetStakingMasternodes(std::vector<CMasternode*>& vStakingNodes)
 {
-    activeStakingNode = nullptr;
-    if (activeMasternode.status == ACTIVE_MASTERNODE_STARTED)
-        activeStakingNode = mnodeman.Find(activeMasternode.vin);
-    return activeStakingNode != nullptr;
+    vStakingNodes.clear();
+    for (const CActiveMasternode* pactive : GetActiveMasternodes()) {
+        if (pactive->status != ACTIVE_MASTERNODE_STARTED)
+            continue;
+        CMasternode* pmn = mnodeman.Find(pactive->vin);
+        if (pmn)
+            vStakingNodes.push_back(pmn);
+    }
+    return !vStakingNodes.empty();
 }
 
-bool CWallet::GetActiveSystemnode(CSystemnode*& activeStakingNode)
+bool CWallet::GetStakingSystemnodes(std::vector<CSystemnode*>& vStakingNodes)
 {
-    activeStakingNode = nullptr;
-    if (activeSystemnode.status == ACTIVE_SYSTEMNODE_STARTED)
-        activeStakingNode = snodeman.Find(activeSystemnode.vin);
-    return activeStakingNode != nullptr;
+    vStakingNodes.clear();
+    for (const CActiveSystemnode* pactive : GetActiveSystemnodes()) {
+        if (pactive->status != ACTIVE_SYSTEMNODE_STARTED)
+            continue;
+        CSystemnode* psn = snodeman.Find(pactive->vin);
+        if (psn)
+            vStakingNodes.push_back(psn);
+    }
+    return !vStakingNodes.empty();
 }
 
 uint256 CWallet::GenerateStakeModifier(const CBlockIndex* prewardBlockIndex) const
@@ -230,16 +240,15 @@ void NodeMinter(const CChainParams& chainparams, CConnman& connman)
 #define STAKE_SEARCH_INTERVAL 30
 bool CWallet::CreateCoinStake(const int nHeight, const uint32_t& nBits, const uint32_t& nTime, CMutableTransaction& txCoinStake, uint32_t& nTxNewTime, StakePointer& stakePointer)
 {
-    CTxIn* pvinActiveNode;
-    CPubKey* ppubkeyActiveNode;
-    int nActiveNodeInputHeight;
+    // collateral and its input height of every node we run, by the key their stake pointers pay to
+    std::map<CPubKey, std::pair<COutPoint, int>> mapStakingNodes;
     std::vector<StakePointer> vStakePointers;
     CAmount nAmountMN;
 
     //! Maybe have a polymorphic base class for masternode and systemnode?
     if (fMasterNode) {
-        CMasternode* activeStakingNode;
-        if (!GetActiveMasternode(activeStakingNode)) {
+        std::vector<CMasternode*> vStakingNodes;
+        if (!GetStakingMasternodes(vStakingNodes)) {
             LogPrintf("CreateCoinStake -- Couldn't find CMasternode object for active masternode\n");
             return false;
         }
@@ -247,14 +256,13 @@ bool CWallet::CreateCoinStake(const int nHeight, const uint32_t& nBits, const ui
             LogPrintf("CreateCoinStake -- Couldn't find recent payment blocks for MN\n");
             return false;
         }
-        pvinActiveNode = &activeStakingNode->vin;
-        ppubkeyActiveNode = &activeStakingNode->pubkey;
-        nActiveNodeInputHeight = ::ChainActive().Height() - activeStakingNode->GetMasternodeInputAge();
+        for (CMasternode* pmn : vStakingNodes)
+            mapStakingNodes.emplace(pmn->pubkey, std::make_pair(pmn->vin.prevout, ::ChainActive().Height() - pmn->GetMasternodeInputAge()));
         nAmountMN = static_cast<CAmount>(Params().GetConsensus().nMasternodeCollateral);
 
     } else if (fSystemNode) {
-        CSystemnode* activeStakingNode;
-        if (!GetActiveSystemnode(activeStakingNode)) {
+        std::vector<CSystemnode*> vStakingNodes;
+        if (!GetStakingSystemnodes(vStakingNodes)) {
             LogPrintf("CreateCoinStake -- Couldn't find CSystemnode object for active systemnode\n");
             return false;
         }
@@ -262,9 +270,8 @@ bool CWallet::CreateCoinStake(const int nHeight, const uint32_t& nBits, const ui
             LogPrintf("CreateCoinStake -- Couldn't find recent payment blocks for SN\n");
             return false;
         }
-        pvinActiveNode = &activeStakingNode->vin;
-        ppubkeyActiveNode = &activeStakingNode->pubkey;
-        nActiveNodeInputHeight = ::ChainActive().Height() - activeStakingNode->GetSystemnodeInputAge();
+        for (CSystemnode* psn : vStakingNodes)
+            mapStakingNodes.emplace(psn->pubkey, std::make_pair(psn->vin.prevout, ::ChainActive().Height() - psn->GetSystemnodeInputAge()));
         nAmountMN = static_cast<CAmount>(Params().GetConsensus().nSystemnodeCollateral);
 
     } else {
@@ -279,6 +286,12 @@ bool CWallet::CreateCoinStake(const int nHeight, const uint32_t& nBits, const ui
 
         CBlockIndex* pindex = g_chainman.BlockIndex().at(pointer.hashBlock);
 
+        auto itNode = mapStakingNodes.find(pointer.pubKeyProofOfStake);
+        if (itNode == mapStakingNodes.end())
+            continue;
+        const COutPoint& outpointActiveNode = itNode->second.first;
+        const int nActiveNodeInputHeight = itNode->second.second;
+
         // Make sure this pointer is not too deep
         if (nHeight - pindex->nHeight >= Params().GetConsensus().ValidStakePointerDuration() + 1)
             continue;
@@ -300,12 +313,12 @@ bool CWallet::CreateCoinStake(const int nHeight, const uint32_t& nBits, const ui
         if (!SearchTimeSpan(kernel, nTime, nTime + STAKE_SEARCH_INTERVAL, nTarget))
             continue;
 
-        LogPrintf("%s: Found valid kernel for mn/sn collateral %s\n", __func__, pvinActiveNode->prevout.ToString());
+        LogPrintf("%s: Found valid kernel for mn/sn collateral %s\n", __func__, outpointActiveNode.ToString());
         LogPrintf("%s: %s\n", __func__, kernel.ToString());
 
         //Add stake payment to coinstake tx
         CAmount nBlockReward = GetBlockValue(nHeight, 0, Params().GetConsensus()); //Do not add fees until after they are packaged into the block
-        CScript scriptBlockReward = GetScriptForDestination(PKHash(*ppubkeyActiveNode));
+        CScript scriptBlockReward = GetScriptForDestination(PKHash(pointer.pubKeyProofOfStake));
         CTxOut out(nBlockReward, scriptBlockReward);
         txCoinStake.vout.emplace_back(out);
         nTxNewTime = kernel.GetTime();
@@ -373,20 +386,25 @@ bool GetPointers(stakingnode* pstaker, std::vector<StakePointer>& vStakePointers
 
 bool CWallet::GetRecentStakePointers(std::vector<StakePointer>& vStakePointers)
 {
+    // the pointers of all the nodes we run, each one carries the key of its node
+    bool found = false;
     if (fMasterNode) {
-        // find pointer to active CMasternode object
-        CMasternode* pactiveMN;
-        if (!GetActiveMasternode(pactiveMN))
+        std::vector<CMasternode*> vStakingNodes;
+        if (!GetStakingMasternodes(vStakingNodes))
             return error("GetRecentStakePointer -- Couldn't find CMasternode object for active masternode\n");
 
-        return GetPointers(pactiveMN, vStakePointers, MN_PMT_SLOT);
+        for (CMasternode* pmn : vStakingNodes)
+            found |= GetPointers(pmn, vStakePointers, MN_PMT_SLOT);
+        return found;
     }
 
-    CSystemnode* pactiveSN;
-    if (!GetActiveSystemnode(pactiveSN))
+    std::vector<CSystemnode*> vStakingNodes;
+    if (!GetStakingSystemnodes(vStakingNodes))
         return error("GetRecentStakePointer -- Couldn't find CSystemnode object for active systemnode\n");
 
-    return GetPointers(pactiveSN, vStakePointers, SN_PMT_SLOT);
+    for (CSystemnode* psn : vStakingNodes)
+        found |= GetPointers(psn, vStakePointers, SN_PMT_SLOT);
+    return found;
 }
 
 
@@ -0,0 +1,155 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef CROWN_SEENCACHE_H
+#define CROWN_SEENCACHE_H
+
+#include <bloom.h>
+#include <memusage.h>
+#include <serialize.h>
+#include <uint256.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+/**
+ * Map of relayed messages by hash, bounded to a maximum number of entries.
+ *
+ * The full objects are kept for getdata and relay. Once more than nMaxSize
+ * are stored the oldest ones are dropped and only remembered in a rolling
+ * bloom filter, so IsSeen() still rejects them when they are announced again.
+ * The filter only covers the most recent nMaxSize / 2 to 3 * nMaxSize / 4
+ * evictions; older messages are rejected by their own expiry checks.
+ * Only the full objects are serialized, in the same format as a std::map.
+ */
+template <typename T>
+class CSeenCache
+{
+public:
+    typedef std::map<uint256, T> map_type;
+    typedef typename map_type::iterator iterator;
+    typedef typename map_type::const_iterator const_iterator;
+
+private:
+    size_t nMaxSize;
+    map_type mapObjects;
+    // insertion order, may still hold hashes that were erased meanwhile
+    std::vector<uint256> vOrder;
+    size_t nOrderBegin{0};
+    // number of entries of each erased hash still in vOrder, these always
+    // come before the entry of a reinserted object with the same hash
+    std::map<uint256, size_t> mapStale;
+    CRollingBloomFilter filterEvicted;
+
+    //! Whether the next entry of hash in vOrder was erased, and consume it if so
+    bool ConsumeStale(const uint256& hash)
+    {
+        auto it = mapStale.find(hash);
+        if (it == mapStale.end())
+            return false;
+        if (--it->second == 0)
+            mapStale.erase(it);
+        return true;
+    }
+
+    void Trim()
+    {
+        while (mapObjects.size() > nMaxSize && nOrderBegin < vOrder.size()) {
+            const uint256& hash = vOrder[nOrderBegin++];
+            if (!ConsumeStale(hash) && mapObjects.erase(hash))
+                filterEvicted.insert(hash);
+        }
+
+        // drop the consumed and stale part of the order once it dominates
+        if (vOrder.size() - nOrderBegin > 2 * mapObjects.size() + 64 || nOrderBegin > vOrder.size() / 2) {
+            std::vector<uint256> vNewOrder;
+            vNewOrder.reserve(mapObjects.size());
+            for (size_t i = nOrderBegin; i < vOrder.size(); i++) {
+                if (!ConsumeStale(vOrder[i]))
+                    vNewOrder.push_back(vOrder[i]);
+            }
+            vOrder.swap(vNewOrder);
+            nOrderBegin = 0;
+        }
+    }
+
+public:
+    explicit CSeenCache(size_t nMaxSizeIn) : nMaxSize(nMaxSizeIn), filterEvicted(nMaxSizeIn / 2 + 1, 0.001) {}
+
+    iterator begin() { return mapObjects.begin(); }
+    iterator end() { return mapObjects.end(); }
+    const_iterator begin() const { return mapObjects.begin(); }
+    const_iterator end() const { return mapObjects.end(); }
+    iterator find(const uint256& hash) { return mapObjects.find(hash); }
+    const_iterator find(const uint256& hash) const { return mapObjects.find(hash); }
+
+    size_t size() const { return mapObjects.size(); }
+    size_t max_size() const { return nMaxSize; }
+
+    //! Whether the full object is still available
+    size_t count(const uint256& hash) const { return mapObjects.count(hash); }
+
+    //! Whether the message was seen, even if its object was already dropped
+    bool IsSeen(const uint256& hash) const
+    {
+        return mapObjects.count(hash) || filterEvicted.contains(hash);
+    }
+
+    bool insert(const std::pair<uint256, T>& entry)
+    {
+        if (!mapObjects.insert(entry).second)
+            return false;
+        vOrder.push_back(entry.first);
+        Trim();
+        return true;
+    }
+
+    //! Forget a message, it is accepted again if it comes back
+    size_t erase(const uint256& hash)
+    {
+        if (!mapObjects.erase(hash))
+            return 0;
+        mapStale[hash]++;
+        return 1;
+    }
+    iterator erase(iterator it)
+    {
+        mapStale[it->first]++;
+        return mapObjects.erase(it);
+    }
+
+    void clear()
+    {
+        mapObjects.clear();
+        vOrder.clear();
+        nOrderBegin = 0;
+        mapStale.clear();
+        filterEvicted.reset();
+    }
+
+    size_t DynamicMemoryUsage() const
+    {
+        return memusage::DynamicUsage(mapObjects) + memusage::DynamicUsage(vOrder) + memusage::DynamicUsage(mapStale) + filterEvicted.DynamicMemoryUsage();
+    }
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << mapObjects;
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        clear();
+        s >> mapObjects;
+        vOrder.reserve(mapObjects.size());
+        for (const auto& entry : mapObjects)
+            vOrder.push_back(entry.first);
+        Trim();
+    }
+};
+
+#endif // CROWN_SEENCACHE_H
@@ -24,11 +24,21 @@ namespace sha256d64_sse41
 void Transform_4way(unsigned char* out, const unsigned char* in);
 }
 
+namespace sha256_sse41
+{
+void Transform_4way(uint32_t* s, const unsigned char* const* chunks);
+}
+
 namespace sha256d64_avx2
 {
 void Transform_8way(unsigned char* out, const unsigned char* in);
 }
 
+namespace sha256_avx2
+{
+void Transform_8way(uint32_t* s, const unsigned char* const* chunks);
+}
+
 namespace sha256d64_shani
 {
 void Transform_2way(unsigned char* out, const unsigned char* in);
@@ -37,6 +47,7 @@ void Transform_2way(unsigned char* out, const unsigned char* in);
 namespace sha256_shani
 {
 void Transform(uint32_t* s, const unsigned char* chunk, size_t blocks);
+void Transform_2way(uint32_t* s, const unsigned char* const* chunks);
 }
 
 // Internal implementation code.
@@ -416,6 +427,8 @@ void TransformD64(unsigned char* out, const unsigned char* in)
 
 typedef void (*TransformType)(uint32_t*, const unsigned char*, size_t);
 typedef void (*TransformD64Type)(unsigned char*, const unsigned char*);
+/** Process one 64-byte chunk for each of several independent states, stored 8 words apart. */
+typedef void (*TransformMultiType)(uint32_t*, const unsigned char* const*);
 
 template<TransformType tr>
 void TransformD64Wrapper(unsigned char* out, const unsigned char* in)
@@ -461,6 +474,8 @@ TransformD64Type TransformD64 = sha256::TransformD64;
 TransformD64Type TransformD64_2way = nullptr;
 TransformD64Type TransformD64_4way = nullptr;
 TransformD64Type TransformD64_8way = nullptr;
+TransformMultiType TransformMulti = nullptr;
+size_t TransformMultiLanes = 1;
 
 bool SelfTest() {
     // Input state (equal to the initial SHA256 state)
@@ -544,6 +559,20 @@ bool SelfTest() {
         if (!std::equal(out, out + 256, result_d64)) return false;
     }
 
+    // Test TransformMulti, if available, with every lane at a different position in the input.
+    if (TransformMulti) {
+        uint32_t states[8 * 8];
+        const unsigned char* chunks[8];
+        for (size_t lane = 0; lane < TransformMultiLanes; ++lane) {
+            std::copy(result[lane], result[lane] + 8, states + 8 * lane);
+            chunks[lane] = data + 1 + 64 * lane;
+        }
+        TransformMulti(states, chunks);
+        for (size_t lane = 0; lane < TransformMultiLanes; ++lane) {
+            if (!std::equal(states + 8 * lane, states + 8 * lane + 8, result[lane + 1])) return false;
+        }
+    }
+
     return true;
 }
 
@@ -597,6 +626,8 @@ std::string SHA256AutoDetect()
         Transform = sha256_shani::Transform;
         TransformD64 = TransformD64Wrapper<sha256_shani::Transform>;
         TransformD64_2way = sha256d64_shani::Transform_2way;
+        TransformMulti = sha256_shani::Transform_2way;
+        TransformMultiLanes = 2;
         ret = "shani(1way,2way)";
         have_sse4 = false; // Disable SSE4/AVX2;
         have_avx2 = false;
@@ -611,6 +642,8 @@ std::string SHA256AutoDetect()
 #endif
 #if defined(ENABLE_SSE41) && !defined(BUILD_BITCOIN_INTERNAL)
         TransformD64_4way = sha256d64_sse41::Transform_4way;
+        TransformMulti = sha256_sse41::Transform_4way;
+        TransformMultiLanes = 4;
         ret += ",sse41(4way)";
 #endif
     }
@@ -618,6 +651,8 @@ std::string SHA256AutoDetect()
 #if defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL)
     if (have_avx2 && have_avx && enabled_avx) {
         TransformD64_8way = sha256d64_avx2::Transform_8way;
+        TransformMulti = sha256_avx2::Transform_8way;
+        TransformMultiLanes = 8;
         ret += ",avx2(8way)";
     }
 #endif
@@ -717,3 +752,108 @@ void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
         --blocks;
     }
 }
+
+namespace {
+/** One message of a SHA256DMulti() call, as seen by the lane processing it. */
+struct MultiLane
+{
+    const unsigned char* in;
+    unsigned char* out; // nullptr while the lane is idle
+    size_t full_blocks; // 64-byte blocks taken directly from the input
+    size_t blocks;      // all blocks, including the padded tail and the second hash
+    size_t done;
+    unsigned char tail[128];
+    unsigned char second[64];
+
+    void Start(uint32_t* s, const unsigned char* input, size_t len, unsigned char* output)
+    {
+        in = input;
+        out = output;
+        full_blocks = len / 64;
+        const size_t rest = len % 64;
+        const size_t tail_blocks = rest + 9 > 64 ? 2 : 1;
+        blocks = full_blocks + tail_blocks + 1;
+        done = 0;
+        if (rest) memcpy(tail, input + 64 * full_blocks, rest);
+        tail[rest] = 0x80;
+        memset(tail + rest + 1, 0, 64 * tail_blocks - rest - 9);
+        WriteBE64(tail + 64 * tail_blocks - 8, (uint64_t)len << 3);
+        sha256::Initialize(s);
+    }
+
+    const unsigned char* Next() const
+    {
+        if (done < full_blocks) return in + 64 * done;
+        if (done + 1 < blocks) return tail + 64 * (done - full_blocks);
+        return second;
+    }
+
+    /** Account for a processed block, returns true when the message is finished. */
+    bool Advance(uint32_t* s)
+    {
+        if (++done + 1 == blocks) {
+            // the first hash is complete, it becomes the message of the second one
+            for (int i = 0; i < 8; ++i) WriteBE32(second + 4 * i, s[i]);
+            second[32] = 0x80;
+            memset(second + 33, 0, 23);
+            WriteBE64(second + 56, 256);
+            sha256::Initialize(s);
+        } else if (done == blocks) {
+            for (int i = 0; i < 8; ++i) WriteBE32(out + 4 * i, s[i]);
+            return true;
+        }
+        return false;
+    }
+};
+} // namespace
+
+size_t SHA256DMultiLanes()
+{
+    return TransformMulti ? TransformMultiLanes : 1;
+}
+
+void SHA256DMulti(unsigned char* output, const unsigned char* const* inputs, const size_t* lengths, size_t count)
+{
+    if (!TransformMulti || count < 2) {
+        unsigned char hash[CSHA256::OUTPUT_SIZE];
+        for (size_t i = 0; i < count; ++i) {
+            CSHA256().Write(inputs[i], lengths[i]).Finalize(hash);
+            CSHA256().Write(hash, sizeof(hash)).Finalize(output + 32 * i);
+        }
+        return;
+    }
+
+    static const unsigned char idle[64] = {0};
+    MultiLane lanes[8];
+    uint32_t states[8 * 8];
+    const unsigned char* chunks[8];
+    size_t next = 0;
+    size_t active = 0;
+    for (size_t lane = 0; lane < TransformMultiLanes; ++lane) {
+        if (next < count) {
+            lanes[lane].Start(states + 8 * lane, inputs[next], lengths[next], output + 32 * next);
+            ++next;
+            ++active;
+        } else {
+            lanes[lane].out = nullptr;
+        }
+    }
+    while (active) {
+        for (size_t lane = 0; lane < TransformMultiLanes; ++lane) {
+            chunks[lane] = lanes[lane].out ? lanes[lane].Next() : idle;
+        }
+        TransformMulti(states, chunks);
+        for (size_t lane = 0; lane < TransformMultiLanes; ++lane) {
+            MultiLane& job = lanes[lane];
+            if (!job.out || !job.Advance(states + 8 * lane)) continue;
+            // refill the lane as soon as its message is done, so the lanes stay busy
+            if (next < count) {
+                job.Start(states + 8 * lane, inputs[next], lengths[next], output + 32 * next);
+                ++next;
+            } else {
+                job.out = nullptr;
+                --active;
+            }
+        }
+    }
+}
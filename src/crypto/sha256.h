@@ -38,4 +38,16 @@ std::string SHA256AutoDetect();
  */
 void SHA256D64(unsigned char* output, const unsigned char* input, size_t blocks);
 
+/** Compute the double-SHA256's of several messages of arbitrary length at once,
+ *  using the multi-lane kernels of the detected implementation when available.
+ *  output:  pointer to a count*32 byte output buffer
+ *  inputs:  pointers to the messages
+ *  lengths: the sizes of the messages in bytes
+ *  count:   the number of hashes to compute.
+ */
+void SHA256DMulti(unsigned char* output, const unsigned char* const* inputs, const size_t* lengths, size_t count);
+
+/** The number of messages SHA256DMulti() hashes in parallel, 1 if it can't. */
+size_t SHA256DMultiLanes();
+
 #endif // BITCOIN_CRYPTO_SHA256_H
@@ -231,6 +231,7 @@ void Shutdown(NodeContext& node)
     if (g_load_block.joinable()) g_load_block.join();
     threadGroup.interrupt_all();
     threadGroup.join_all();
+    StopNodeSync();
 
     // After the threads that potentially access these pointers have been stopped,
     // destruct and reset all to nullptr.
@@ -405,6 +406,7 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-alertnotify=<cmd>", "Execute command when a relevant alert is received or we see a really long fork (%s in cmd is replaced by message)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 #endif
     argsman.AddArg("-assumevalid=<hex>", strprintf("If this block is in the chain assume that it and its ancestors are valid and potentially skip their script verification (0 to verify all, default: %s, testnet: %s, signet: %s)", defaultChainParams->GetConsensus().defaultAssumeValid.GetHex(), testnetChainParams->GetConsensus().defaultAssumeValid.GetHex(), signetChainParams->GetConsensus().defaultAssumeValid.GetHex()), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-backgroundflush", strprintf("Write the coins cache to disk on a background thread on periodic and cache size triggered flushes, while block validation continues. Up to twice -dbcache may be used by the coins while a write is pending (default: %u)", DEFAULT_BACKGROUND_FLUSH), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-blocksdir=<dir>", "Specify directory to hold blocks subdirectory for *.dat files (default: <datadir>)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 #if HAVE_SYSTEM
     argsman.AddArg("-blocknotify=<cmd>", "Execute command when the best block changes (%s in cmd is replaced by block hash)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
@@ -427,6 +429,7 @@ void SetupServerArgs(NodeContext& node)
         -GetNumCores(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-persistmempool", strprintf("Whether to save the mempool on shutdown and load on restart (default: %u)", DEFAULT_PERSIST_MEMPOOL), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-pid=<file>", strprintf("Specify pid file. Relative paths will be prefixed by a net-specific datadir location. (default: %s)", BITCOIN_PID_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-prefetchthreads=<n>", strprintf("Set the number of threads reading the coins spent by a block from disk before it is connected (0 to %d, 0 = off, default: %d)", MAX_SCRIPTCHECK_THREADS, DEFAULT_COINS_PREFETCH_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-prune=<n>", strprintf("Reduce storage requirements by enabling pruning (deleting) of old blocks. This allows the pruneblockchain RPC to be called to delete specific blocks, and enables automatic pruning of old blocks if a target size in MiB is provided. This mode is incompatible with -txindex and -rescan. "
             "Warning: Reverting this setting requires re-downloading the entire blockchain. "
             "(default: 0 = disable pruning blocks, 1 = allow manual pruning via RPC, >=%u = automatically prune block files to stay under the specified target size in MiB)", MIN_DISK_SPACE_FOR_BLOCK_FILES / 1024 / 1024), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
@@ -503,11 +506,23 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-zmqpubrawblock=<address>", "Enable publish raw block in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawtx=<address>", "Enable publish raw transaction in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubsequence=<address>", "Enable publish hash block and tx sequence in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubmasternode=<address>", "Enable publish masternode list changes in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubsystemnode=<address>", "Enable publish systemnode list changes in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubmnpayment=<address>", "Enable publish masternode payment winner votes in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubsnpayment=<address>", "Enable publish systemnode payment winner votes in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubbudget=<address>", "Enable publish budget proposals and votes in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubixlock=<address>", "Enable publish completed InstantSend locks in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubhashblockhwm=<n>", strprintf("Set publish hash block outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubhashtxhwm=<n>", strprintf("Set publish hash transaction outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawblockhwm=<n>", strprintf("Set publish raw block outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawtxhwm=<n>", strprintf("Set publish raw transaction outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubsequencehwm=<n>", strprintf("Set publish hash sequence message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubmasternodehwm=<n>", strprintf("Set publish masternode outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubsystemnodehwm=<n>", strprintf("Set publish systemnode outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubmnpaymenthwm=<n>", strprintf("Set publish masternode payment outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubsnpaymenthwm=<n>", strprintf("Set publish systemnode payment outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubbudgethwm=<n>", strprintf("Set publish budget outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubixlockhwm=<n>", strprintf("Set publish InstantSend lock outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
 #else
     hidden_args.emplace_back("-zmqpubhashblock=<address>");
     hidden_args.emplace_back("-zmqpubhashtx=<address>");
@@ -519,6 +534,18 @@ void SetupServerArgs(NodeContext& node)
     hidden_args.emplace_back("-zmqpubrawblockhwm=<n>");
     hidden_args.emplace_back("-zmqpubrawtxhwm=<n>");
     hidden_args.emplace_back("-zmqpubsequencehwm=<n>");
+    hidden_args.emplace_back("-zmqpubmasternode=<address>");
+    hidden_args.emplace_back("-zmqpubsystemnode=<address>");
+    hidden_args.emplace_back("-zmqpubmnpayment=<address>");
+    hidden_args.emplace_back("-zmqpubsnpayment=<address>");
+    hidden_args.emplace_back("-zmqpubbudget=<address>");
+    hidden_args.emplace_back("-zmqpubixlock=<address>");
+    hidden_args.emplace_back("-zmqpubmasternodehwm=<n>");
+    hidden_args.emplace_back("-zmqpubsystemnodehwm=<n>");
+    hidden_args.emplace_back("-zmqpubmnpaymenthwm=<n>");
+    hidden_args.emplace_back("-zmqpubsnpaymenthwm=<n>");
+    hidden_args.emplace_back("-zmqpubbudgethwm=<n>");
+    hidden_args.emplace_back("-zmqpubixlockhwm=<n>");
 #endif
 
     argsman.AddArg("-neckbeard", strprintf("Enable full PoW hash verification per blockheader (default: %u)", DEFAULT_CHECKBLOCKPOW), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
@@ -595,6 +622,7 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-systemnode", "Run as systemnode", false, OptionsCategory::RPC);
     argsman.AddArg("-systemnodeprivkey", "Systemnode private key", false, OptionsCategory::RPC);
     argsman.AddArg("-systemnodeaddr", strprintf(_("Set external address:port to get to this systemnode (example: %s)").translated, "1.2.3.4:12345"), false, OptionsCategory::RPC);
+    argsman.AddArg("-nodehost", "Run every masternode of masternode.conf (with -masternode) or systemnode of systemnode.conf (with -systemnode) in this daemon, each entry needs its own external address", false, OptionsCategory::RPC);
     argsman.AddArg("-jumpstart", "Allow network to be jumpstarted if no stake pointers exist.", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-diagnode", "Enable full masternode/systemnode diagnostic messaging.", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 
@@ -1094,6 +1122,7 @@ bool AppInitParameterInteraction(const ArgsManager& args)
 
     fCheckBlockIndex = args.GetBoolArg("-checkblockindex", chainparams.DefaultConsistencyChecks());
     fCheckpointsEnabled = args.GetBoolArg("-checkpoints", DEFAULT_CHECKPOINTS_ENABLED);
+    g_background_flush = args.GetBoolArg("-backgroundflush", DEFAULT_BACKGROUND_FLUSH);
 
     hashAssumeValid = uint256S(args.GetArg("-assumevalid", chainparams.GetConsensus().defaultAssumeValid.GetHex()));
     if (!hashAssumeValid.IsNull())
@@ -1349,11 +1378,28 @@ bool AppInitMain(const util::Ref& context, NodeContext& node, interfaces::BlockA
     // Number of script-checking threads <= MAX_SCRIPTCHECK_THREADS
     script_threads = std::min(script_threads, MAX_SCRIPTCHECK_THREADS);
 
+    // The header proof of work is only checked with -neckbeard
+    const bool header_checks = gArgs.GetBoolArg("-neckbeard", DEFAULT_CHECKBLOCKPOW);
+
     LogPrintf("Script verification uses %d additional threads\n", script_threads);
+    if (header_checks)
+        LogPrintf("Header verification uses %d additional threads\n", script_threads);
     if (script_threads >= 1) {
         g_parallel_script_checks = true;
         for (int i = 0; i < script_threads; ++i) {
             threadGroup.create_thread([i]() { return ThreadScriptCheck(i); });
+            if (header_checks)
+                threadGroup.create_thread([i]() { return ThreadHeaderCheck(i); });
+        }
+    }
+
+    // The prefetch threads mostly wait on disk reads, so they are not bound to the cores like -par
+    const int prefetch_threads = std::min(std::max<int>(args.GetArg("-prefetchthreads", DEFAULT_COINS_PREFETCH_THREADS), 0), MAX_SCRIPTCHECK_THREADS);
+    LogPrintf("Coins prefetch uses %d threads\n", prefetch_threads);
+    if (prefetch_threads >= 1) {
+        g_coins_prefetch = true;
+        for (int i = 0; i < prefetch_threads; ++i) {
+            threadGroup.create_thread([i]() { return ThreadCoinsPrefetch(i); });
         }
     }
 
@@ -2052,8 +2098,7 @@ bool AppInitMain(const util::Ref& context, NodeContext& node, interfaces::BlockA
         banman->DumpBanlist();
     }, DUMP_BANS_INTERVAL);
 
-    node.scheduler->scheduleEvery(std::bind(&ThreadMasternodeSync, std::ref(*node.connman)), std::chrono::milliseconds{1000});
-    node.scheduler->scheduleEvery(std::bind(&ThreadSystemnodeSync, std::ref(*node.connman)), std::chrono::milliseconds{1000});
+    StartNodeSync(*node.scheduler, *node.connman);
     node.scheduler->scheduleEvery(std::bind(&NodeMinter, std::ref(Params()), std::ref(*node.connman)), std::chrono::milliseconds{5000});
 
 #if HAVE_SYSTEM
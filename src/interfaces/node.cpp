@@ -275,6 +275,14 @@ public:
     {
         return MakeHandler(::uiInterface.BannedListChanged_connect(fn));
     }
+    std::unique_ptr<Handler> handleNotifyMasternodeChanged(NotifyMasternodeChangedFn fn) override
+    {
+        return MakeHandler(::uiInterface.NotifyMasternodeChanged_connect(fn));
+    }
+    std::unique_ptr<Handler> handleNotifySystemnodeChanged(NotifySystemnodeChangedFn fn) override
+    {
+        return MakeHandler(::uiInterface.NotifySystemnodeChanged_connect(fn));
+    }
     std::unique_ptr<Handler> handleNotifyBlockTip(NotifyBlockTipFn fn) override
     {
         return MakeHandler(::uiInterface.NotifyBlockTip_connect([fn](SynchronizationState sync_state, const CBlockIndex* block) {
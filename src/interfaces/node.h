@@ -11,6 +11,7 @@
 #include <netaddress.h> // For Network
 #include <support/allocators/secure.h> // For SecureString
 #include <util/translation.h>
+#include <util/ui_change_type.h>
 
 #include <functional>
 #include <memory>
@@ -24,6 +25,7 @@ class BanMan;
 class CCoinControl;
 class CFeeRate;
 class CNodeStats;
+class COutPoint;
 class Coin;
 class RPCTimerInterface;
 class UniValue;
@@ -215,6 +217,14 @@ public:
     using BannedListChangedFn = std::function<void()>;
     virtual std::unique_ptr<Handler> handleBannedListChanged(BannedListChangedFn fn) = 0;
 
+    //! Register handler for masternode list changes.
+    using NotifyMasternodeChangedFn = std::function<void(const COutPoint& outpoint, ChangeType status)>;
+    virtual std::unique_ptr<Handler> handleNotifyMasternodeChanged(NotifyMasternodeChangedFn fn) = 0;
+
+    //! Register handler for systemnode list changes.
+    using NotifySystemnodeChangedFn = std::function<void(const COutPoint& outpoint, ChangeType status)>;
+    virtual std::unique_ptr<Handler> handleNotifySystemnodeChanged(NotifySystemnodeChangedFn fn) = 0;
+
     //! Register handler for block tip messages.
     using NotifyBlockTipFn =
         std::function<void(SynchronizationState, interfaces::BlockTip tip, double verification_progress)>;
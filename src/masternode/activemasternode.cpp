@@ -10,6 +10,28 @@
 class CActiveMasternode;
 CActiveMasternode activeMasternode;
 
+// written during init only, so it is read without a lock afterwards
+static std::vector<std::unique_ptr<CActiveMasternode>> vHostedMasternodes;
+
+std::vector<CActiveMasternode*> GetActiveMasternodes()
+{
+    std::vector<CActiveMasternode*> vActive{&activeMasternode};
+    for (const auto& hosted : vHostedMasternodes)
+        vActive.push_back(hosted.get());
+    return vActive;
+}
+
+CActiveMasternode& AddHostedMasternode()
+{
+    vHostedMasternodes.emplace_back(new CActiveMasternode());
+    return *vHostedMasternodes.back();
+}
+
+void ClearHostedMasternodes()
+{
+    vHostedMasternodes.clear();
+}
+
 //
 // Bootup the Masternode, look for a 10000 CRW input and register on the network
 //
@@ -42,7 +64,7 @@ void CActiveMasternode::ManageStatus(CConnman& connman)
                 if (!pmn->vchSignover.empty()) {
                     if (pmn->pubkey.Verify(pubKeyMasternode.GetHash(), pmn->vchSignover)) {
                         LogPrintf("%s: Verified pubkey2 signover for staking\n", __func__);
-                        activeMasternode.vchSigSignover = pmn->vchSignover;
+                        vchSigSignover = pmn->vchSignover;
                     } else {
                         LogPrintf("%s: Failed to verify pubkey on signover!\n", __func__);
                     }
@@ -74,14 +96,14 @@ void CActiveMasternode::ManageStatus(CConnman& connman)
             return;
         }
 
-        if (strMasterNodeAddr.empty()) {
+        if (strAddr.empty()) {
             if (!GetLocal(service)) {
                 notCapableReason = "Can't detect external address. Please use the masternodeaddr configuration option.";
                 LogPrintf("CActiveMasternode::ManageStatus() - not capable: %s\n", notCapableReason);
                 return;
             }
         } else {
-            service = CService(strMasterNodeAddr);
+            service = CService(strAddr);
         }
 
         if (Params().NetworkIDString() == CBaseChainParams::MAIN) {
@@ -117,7 +139,7 @@ void CActiveMasternode::ManageStatus(CConnman& connman)
         CPubKey pubKeyCollateralAddress;
         CKey keyCollateralAddress;
 
-        if (GetMainWallet()->GetMasternodeVinAndKeys(vin, pubKeyCollateralAddress, keyCollateralAddress)) {
+        if (GetMainWallet()->GetMasternodeVinAndKeys(vin, pubKeyCollateralAddress, keyCollateralAddress, strCollateralTxHash, strCollateralOutputIndex)) {
             if (GetUTXOConfirmations(vin.prevout) < MASTERNODE_MIN_CONFIRMATIONS) {
                 status = ACTIVE_MASTERNODE_INPUT_TOO_NEW;
                 notCapableReason = strprintf("%s - %d confirmations", GetStatus(), GetUTXOConfirmations(vin.prevout));
@@ -129,15 +151,6 @@ void CActiveMasternode::ManageStatus(CConnman& connman)
             pwallet->LockCoin(vin.prevout);
 
             // send to all nodes
-            CPubKey pubKeyMasternode;
-            CKey keyMasternode;
-
-            if (!legacySigner.SetKey(strMasterNodePrivKey, keyMasternode, pubKeyMasternode)) {
-                notCapableReason = "Error upon calling SetKey: " + errorMessage;
-                LogPrintf("Register::ManageStatus() - %s\n", notCapableReason);
-                return;
-            }
-
             CMasternodeBroadcast mnb;
             bool fSignOver = true;
             if (!CMasternodeBroadcast::Create(vin, service, keyCollateralAddress, pubKeyCollateralAddress, keyMasternode, pubKeyMasternode, fSignOver, errorMessage, mnb)) {
@@ -196,14 +209,6 @@ bool CActiveMasternode::SendMasternodePing(std::string& errorMessage, CConnman&
         return false;
     }
 
-    CPubKey pubKeyMasternode;
-    CKey keyMasternode;
-
-    if (!legacySigner.SetKey(strMasterNodePrivKey, keyMasternode, pubKeyMasternode)) {
-        errorMessage = strprintf("Error upon calling SetKey: %s\n", errorMessage);
-        return false;
-    }
-
     LogPrintf("CActiveMasternode::SendMasternodePing() - Relay Masternode Ping vin = %s\n", vin.ToString());
 
     CMasternodePing mnp(vin);
@@ -221,13 +226,15 @@ bool CActiveMasternode::SendMasternodePing(std::string& errorMessage, CConnman&
         }
 
         pmn->lastPing = mnp;
+        mnodeman.NotifyListChanged(pmn->vin.prevout, NodeListChange::UPDATED);
         mnodeman.mapSeenMasternodePing.insert(make_pair(mnp.GetHash(), mnp));
 
         //mnodeman.mapSeenMasternodeBroadcast.lastPing is probably outdated, so we'll update it
         CMasternodeBroadcast mnb(*pmn);
         uint256 hash = mnb.GetHash();
-        if (mnodeman.mapSeenMasternodeBroadcast.count(hash))
-            mnodeman.mapSeenMasternodeBroadcast[hash].lastPing = mnp;
+        auto it = mnodeman.mapSeenMasternodeBroadcast.find(hash);
+        if (it != mnodeman.mapSeenMasternodeBroadcast.end())
+            it->second.lastPing = mnp;
 
         mnp.Relay(connman);
 
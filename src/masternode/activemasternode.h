@@ -21,6 +21,13 @@
 class CActiveMasternode;
 extern CActiveMasternode activeMasternode;
 
+/** All masternodes run by this daemon, activeMasternode first followed by the ones added with -nodehost */
+std::vector<CActiveMasternode*> GetActiveMasternodes();
+/** Host one more masternode, only to be called during init before the masternode threads start */
+CActiveMasternode& AddHostedMasternode();
+/** Stop hosting the masternodes added with AddHostedMasternode */
+void ClearHostedMasternodes();
+
 // Responsible for activating the Masternode and pinging the network
 class CActiveMasternode {
 private:
@@ -34,6 +41,15 @@ public:
     // Initialized by init.cpp
     // Keys for the main Masternode
     CPubKey pubKeyMasternode;
+    CKey keyMasternode;
+
+    // Name in masternode.conf, empty for the one configured by -masternodeprivkey
+    std::string strAlias;
+    // External address, detected when empty
+    std::string strAddr;
+    // Collateral, any suitable coin of the wallet when empty
+    std::string strCollateralTxHash;
+    std::string strCollateralOutputIndex;
 
     // Signature signing over staking priviledge
     std::vector<unsigned char> vchSigSignover;
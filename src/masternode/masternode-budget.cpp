@@ -5,6 +5,7 @@
 
 #include <boost/range/algorithm.hpp>
 #include <boost/range/algorithm_ext.hpp>
+#include <core_memusage.h>
 #include <crown/legacysigner.h>
 #include <crown/nodewallet.h>
 #include <index/txindex.h>
@@ -14,6 +15,7 @@
 #include <netmessagemaker.h>
 #include <node/context.h>
 #include <rpc/blockchain.h>
+#include <validationinterface.h>
 
 CBudgetManager budget;
 RecursiveMutex cs_budget;
@@ -220,7 +222,7 @@ void CBudgetManager::SubmitBudgetDraft(CConnman& connman)
     }
 
     BudgetDraftBroadcast tempBudget(blockStart, vecTxBudgetPayments, uint256());
-    if (mapSeenBudgetDrafts.count(tempBudget.GetHash())) {
+    if (mapSeenBudgetDrafts.IsSeen(tempBudget.GetHash())) {
         LogPrint(BCLog::MASTERNODE, "CBudgetManager::SubmitBudgetDraft - Budget already exists - %s\n", tempBudget.GetHash().ToString());
         nSubmittedHeight = nCurrentHeight;
         return; //already exists
@@ -322,6 +324,7 @@ bool CBudgetManager::AddProposal(const CBudgetProposal& budgetProposal)
 
     mapProposals.insert(make_pair(budgetProposal.GetHash(), budgetProposal));
     mapSeenMasternodeBudgetProposals.insert(make_pair(budgetProposal.GetHash(), budgetProposal));
+    GetMainSignals().BudgetProposalAdded(budgetProposal.GetHash());
     return true;
 }
 
@@ -525,6 +528,17 @@ std::vector<CBudgetProposal*> CBudgetManager::GetAllProposals()
     return vBudgetProposalRet;
 }
 
+std::vector<CBudgetProposal> CBudgetManager::GetProposalsSnapshot() const
+{
+    LOCK(cs);
+
+    std::vector<CBudgetProposal> vProposals;
+    vProposals.reserve(mapProposals.size());
+    for (const auto& entry : mapProposals)
+        vProposals.push_back(entry.second);
+    return vProposals;
+}
+
 //
 // Sort by votes, if there's a tie sort by their feeHash TX
 //
@@ -821,7 +835,7 @@ void CBudgetManager::ProcessMessage(CNode* pfrom, const std::string& strCommand,
 
         DebugLogBudget(budgetProposalBroadcast, pfrom->addr, "PR");
 
-        if (mapSeenMasternodeBudgetProposals.count(budgetProposalBroadcast.GetHash())) {
+        if (mapSeenMasternodeBudgetProposals.IsSeen(budgetProposalBroadcast.GetHash())) {
             masternodeSync.AddedBudgetItem(budgetProposalBroadcast.GetHash());
             return;
         }
@@ -863,7 +877,7 @@ void CBudgetManager::ProcessMessage(CNode* pfrom, const std::string& strCommand,
 
         DebugLogBudget(vote, pfrom->addr, "VR");
 
-        if (mapSeenMasternodeBudgetVotes.count(vote.GetHash())) {
+        if (mapSeenMasternodeBudgetVotes.IsSeen(vote.GetHash())) {
             masternodeSync.AddedBudgetItem(vote.GetHash());
             return;
         }
@@ -961,7 +975,7 @@ void CBudgetManager::ProcessMessage(CNode* pfrom, const std::string& strCommand,
         vRecv >> vote;
         vote.fValid = true;
 
-        if (mapSeenBudgetDraftVotes.count(vote.GetHash())) {
+        if (mapSeenBudgetDraftVotes.IsSeen(vote.GetHash())) {
             masternodeSync.AddedBudgetItem(vote.GetHash());
             return;
         }
@@ -1109,7 +1123,7 @@ void CBudgetManager::Sync(CNode* pfrom, uint256 nProp, CConnman& connman, bool f
     while (it3 != mapSeenBudgetDrafts.end()) {
         std::map<uint256, BudgetDraft>::const_iterator pbudgetDraft = mapBudgetDrafts.find((*it3).first);
         if (pbudgetDraft != mapBudgetDrafts.end() && (nProp.IsNull() || (*it3).first == nProp))
-            pbudgetDraft->second.Sync(pfrom, fPartial);
+            nInvCount += pbudgetDraft->second.Sync(pfrom, fPartial);
         ++it3;
     }
 
@@ -1181,6 +1195,7 @@ bool CBudgetManager::SubmitProposalVote(const CBudgetVote& vote, std::string& st
     DebugLogBudget(vote, CAddress(), "VA");
     if (proposal.AddOrUpdateVote(vote, strError)) {
         mapSeenMasternodeBudgetVotes.insert(make_pair(vote.GetHash(), vote));
+        GetMainSignals().BudgetProposalVote(vote.nProposalHash, vote.vin.prevout, vote.nVote);
         return true;
     }
     return false;
@@ -1222,7 +1237,11 @@ bool CBudgetManager::ReceiveProposalVote(const CBudgetVote& vote, CNode* pfrom,
         return false;
     }
 
-    return mapProposals[vote.nProposalHash].AddOrUpdateVote(vote, strError);
+    if (!mapProposals[vote.nProposalHash].AddOrUpdateVote(vote, strError))
+        return false;
+
+    GetMainSignals().BudgetProposalVote(vote.nProposalHash, vote.vin.prevout, vote.nVote);
+    return true;
 }
 
 bool CBudgetManager::UpdateBudgetDraft(BudgetDraftVote& vote, CNode* pfrom, CConnman& connman, std::string& strError)
@@ -1868,6 +1887,24 @@ bool BudgetDraft::ComparePayments(const CTxBudgetPayment& a, const CTxBudgetPaym
         return false;
 }
 
+template <typename Vote>
+static size_t RecursiveDynamicUsage(const std::map<uint256, Vote>& mapVotes)
+{
+    size_t nUsage = memusage::DynamicUsage(mapVotes);
+    for (const auto& vote : mapVotes)
+        nUsage += RecursiveDynamicUsage(vote.second.vin) + memusage::DynamicUsage(vote.second.vchSig);
+    return nUsage;
+}
+
+size_t BudgetDraft::DynamicMemoryUsage() const
+{
+    LOCK(cs);
+    size_t nUsage = memusage::DynamicUsage(m_payments) + memusage::DynamicUsage(m_signature) + RecursiveDynamicUsage(m_masternodeSubmittedId);
+    for (const CTxBudgetPayment& payment : m_payments)
+        nUsage += RecursiveDynamicUsage(payment.payee);
+    return nUsage + RecursiveDynamicUsage(m_votes) + RecursiveDynamicUsage(m_obsoleteVotes);
+}
+
 std::string BudgetDraft::GetStatus() const
 {
     std::vector<CTxBudgetPayment> payments = GetBudgetPayments();
@@ -2025,29 +2062,23 @@ const std::vector<CTxBudgetPayment>& BudgetDraft::GetBudgetPayments() const
 
 void BudgetDraft::SubmitVote(CConnman& connman)
 {
-    CPubKey pubKeyMasternode;
-    CKey keyMasternode;
-    std::string errorMessage;
-
-    if (!legacySigner.SetKey(strMasterNodePrivKey, keyMasternode, pubKeyMasternode)) {
-        LogPrint(BCLog::MASTERNODE, "BudgetDraft::SubmitVote - Error upon calling SetKey\n");
-        return;
-    }
-
-    BudgetDraftVote vote(activeMasternode.vin, GetHash());
-    if (!vote.Sign(keyMasternode, pubKeyMasternode)) {
-        LogPrint(BCLog::MASTERNODE, "BudgetDraft::SubmitVote - Failure to sign.");
-        return;
-    }
+    // each masternode we host votes for the finalized budget
+    for (CActiveMasternode* pactive : GetActiveMasternodes()) {
+        BudgetDraftVote vote(pactive->vin, GetHash());
+        if (!vote.Sign(pactive->keyMasternode, pactive->pubKeyMasternode)) {
+            LogPrint(BCLog::MASTERNODE, "BudgetDraft::SubmitVote - Failure to sign.");
+            continue;
+        }
 
-    std::string strError = "";
-    if (budget.UpdateBudgetDraft(vote, nullptr, connman, strError)) {
-        LogPrint(BCLog::MASTERNODE, "BudgetDraft::SubmitVote  - new finalized budget vote - %s\n", vote.GetHash().ToString());
+        std::string strError = "";
+        if (budget.UpdateBudgetDraft(vote, nullptr, connman, strError)) {
+            LogPrint(BCLog::MASTERNODE, "BudgetDraft::SubmitVote  - new finalized budget vote - %s\n", vote.GetHash().ToString());
 
-        vote.Relay(connman);
-        m_voteSubmittedTime = GetTime();
-    } else {
-        LogPrint(BCLog::MASTERNODE, "BudgetDraft::SubmitVote : Error submitting vote - %s\n", strError);
+            vote.Relay(connman);
+            m_voteSubmittedTime = GetTime();
+        } else {
+            LogPrint(BCLog::MASTERNODE, "BudgetDraft::SubmitVote : Error submitting vote - %s\n", strError);
+        }
     }
 }
 
@@ -2269,3 +2300,20 @@ std::string CBudgetManager::ToString() const
 
     return info.str();
 }
+
+size_t CBudgetManager::DynamicMemoryUsage() const
+{
+    LOCK(cs);
+    size_t nUsage = memusage::DynamicUsage(mapCollateralTxids) + memusage::DynamicUsage(mapProposals) + memusage::DynamicUsage(mapBudgetDrafts);
+    for (const auto& proposal : mapProposals)
+        nUsage += RecursiveDynamicUsage(proposal.second.address) + RecursiveDynamicUsage(proposal.second.mapVotes);
+    for (const auto& budgetDraft : mapBudgetDrafts)
+        nUsage += budgetDraft.second.DynamicMemoryUsage();
+    nUsage += mapSeenMasternodeBudgetProposals.DynamicMemoryUsage() + mapSeenBudgetDrafts.DynamicMemoryUsage();
+    nUsage += mapSeenMasternodeBudgetVotes.DynamicMemoryUsage() + mapSeenBudgetDraftVotes.DynamicMemoryUsage();
+    for (const auto& vote : mapSeenMasternodeBudgetVotes)
+        nUsage += RecursiveDynamicUsage(vote.second.vin) + memusage::DynamicUsage(vote.second.vchSig);
+    for (const auto& vote : mapSeenBudgetDraftVotes)
+        nUsage += RecursiveDynamicUsage(vote.second.vin) + memusage::DynamicUsage(vote.second.vchSig);
+    return nUsage + RecursiveDynamicUsage(mapOrphanMasternodeBudgetVotes) + RecursiveDynamicUsage(mapOrphanBudgetDraftVotes);
+}
@@ -7,6 +7,7 @@
 #define MASTERNODE_BUDGET_H
 
 #include <base58.h>
+#include <crown/seencache.h>
 #include <init.h>
 #include <key.h>
 #include <masternode/masternode.h>
@@ -36,6 +37,12 @@ static const int64_t BUDGET_FEE_CONFIRMATIONS = 6;
 static const int64_t BUDGET_VOTE_UPDATE_MIN = 60 * 60;
 static const int64_t FINAL_BUDGET_VOTE_UPDATE_MIN = 30 * 60;
 
+//! Number of budget messages kept for relay and sync, older ones are only remembered as seen
+static const size_t MAX_SEEN_BUDGET_PROPOSALS = 10000;
+static const size_t MAX_SEEN_BUDGET_VOTES = 100000;
+static const size_t MAX_SEEN_BUDGET_DRAFTS = 10000;
+static const size_t MAX_SEEN_BUDGET_DRAFT_VOTES = 100000;
+
 extern std::vector<CBudgetProposalBroadcast> vecImmatureBudgetProposals;
 extern std::vector<BudgetDraftBroadcast> vecImmatureBudgetDrafts;
 
@@ -118,11 +125,11 @@ private:
     map<uint256, CBudgetProposal> mapProposals;
     map<uint256, BudgetDraft> mapBudgetDrafts;
 
-    std::map<uint256, CBudgetProposalBroadcast> mapSeenMasternodeBudgetProposals;
-    std::map<uint256, CBudgetVote> mapSeenMasternodeBudgetVotes;
+    CSeenCache<CBudgetProposalBroadcast> mapSeenMasternodeBudgetProposals{MAX_SEEN_BUDGET_PROPOSALS};
+    CSeenCache<CBudgetVote> mapSeenMasternodeBudgetVotes{MAX_SEEN_BUDGET_VOTES};
     std::map<uint256, CBudgetVote> mapOrphanMasternodeBudgetVotes;
-    std::map<uint256, BudgetDraftBroadcast> mapSeenBudgetDrafts;
-    std::map<uint256, BudgetDraftVote> mapSeenBudgetDraftVotes;
+    CSeenCache<BudgetDraftBroadcast> mapSeenBudgetDrafts{MAX_SEEN_BUDGET_DRAFTS};
+    CSeenCache<BudgetDraftVote> mapSeenBudgetDraftVotes{MAX_SEEN_BUDGET_DRAFT_VOTES};
     std::map<uint256, BudgetDraftVote> mapOrphanBudgetDraftVotes;
 
 public:
@@ -157,6 +164,8 @@ public:
 
     std::vector<CBudgetProposal*> GetBudget();
     std::vector<CBudgetProposal*> GetAllProposals();
+    /// Copies of all proposals, for readers that must not hold cs while using them
+    std::vector<CBudgetProposal> GetProposalsSnapshot() const;
     std::vector<BudgetDraft*> GetBudgetDrafts();
 
     bool AddBudgetDraft(BudgetDraft& budgetDraft);
@@ -165,7 +174,7 @@ public:
 
     bool HasItem(uint256 hash) const
     {
-        return mapSeenMasternodeBudgetVotes.count(hash) || mapSeenBudgetDrafts.count(hash) || mapSeenBudgetDraftVotes.count(hash);
+        return mapSeenMasternodeBudgetVotes.IsSeen(hash) || mapSeenBudgetDrafts.IsSeen(hash) || mapSeenBudgetDraftVotes.IsSeen(hash);
     }
 
     const BudgetDraftBroadcast* GetSeenBudgetDraft(uint256 hash) const;
@@ -187,6 +196,7 @@ public:
 
     std::string GetRequiredPaymentsString(int nBlockHeight) const;
     std::string ToString() const;
+    size_t DynamicMemoryUsage() const;
 
     void CheckOrphanVotes(CConnman& connman);
     void CheckAndRemove();
@@ -353,6 +363,7 @@ public:
     std::string GetStatus() const;
 
     uint256 GetHash() const;
+    size_t DynamicMemoryUsage() const;
 
     SERIALIZE_METHODS(BudgetDraft, obj)
     {
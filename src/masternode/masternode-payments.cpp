@@ -3,6 +3,7 @@
 // Distributed under the MIT/X11 software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <core_memusage.h>
 #include <crown/spork.h>
 #include <masternode/masternode-budget.h>
 #include <mn_processing.h>
@@ -10,6 +11,7 @@
 #include <netfulfilledman.h>
 #include <netmessagemaker.h>
 #include <util/moneystr.h>
+#include <validationinterface.h>
 
 /** Object for who's going to get paid on which blocks */
 CMasternodePayments masternodePayments;
@@ -304,6 +306,15 @@ bool CMasternodePayments::GetBlockPayee(int nBlockHeight, CScript& payee)
     return false;
 }
 
+std::vector<CMasternodePayee> CMasternodePayments::GetBlockPayees(int nBlockHeight)
+{
+    LOCK(cs_mapMasternodeBlocks);
+    auto it = mapMasternodeBlocks.find(nBlockHeight);
+    if (it == mapMasternodeBlocks.end())
+        return std::vector<CMasternodePayee>();
+    return it->second.GetPayees();
+}
+
 // Is this masternode scheduled to get paid soon?
 // -- Only look ahead up to 8 blocks to allow for propagation of the latest 2 winners
 bool CMasternodePayments::IsScheduled(CMasternode& mn, int nNotBlockHeight)
@@ -362,7 +373,12 @@ bool CMasternodePayments::AddWinningMasternode(CMasternodePaymentWinner& winnerI
     int n = 1;
     if (IsReferenceNode(winnerIn.vinMasternode))
         n = 100;
-    mapMasternodeBlocks[winnerIn.nBlockHeight].AddPayee(winnerIn.payee, n);
+    CMasternodeBlockPayees& blockPayees = mapMasternodeBlocks[winnerIn.nBlockHeight];
+    // the payee is elected once it has enough votes to be enforced
+    const bool fElected = blockPayees.HasPayeeWithVotes(winnerIn.payee, MNPAYMENTS_SIGNATURES_REQUIRED);
+    blockPayees.AddPayee(winnerIn.payee, n);
+    if (!fElected && blockPayees.HasPayeeWithVotes(winnerIn.payee, MNPAYMENTS_SIGNATURES_REQUIRED))
+        GetMainSignals().MasternodePaymentWinner(winnerIn.nBlockHeight, winnerIn.payee);
 
     return true;
 }
@@ -537,31 +553,38 @@ bool CMasternodePayments::ProcessBlock(int nBlockHeight, CConnman& connman)
     if (!fMasterNode)
         return false;
 
+    if (nBlockHeight <= nCachedBlockHeight)
+        return false;
+
     //reference node - hybrid mode
 
-    if (!IsReferenceNode(activeMasternode.vin)) {
-        int n = mnodeman.GetMasternodeRank(activeMasternode.vin, nBlockHeight - 100, MIN_MNW_PEER_PROTO_VERSION);
+    std::vector<CActiveMasternode*> vVoters;
+    for (CActiveMasternode* pactive : GetActiveMasternodes()) {
+        if (!IsReferenceNode(pactive->vin)) {
+            int n = mnodeman.GetMasternodeRank(pactive->vin, nBlockHeight - 100, MIN_MNW_PEER_PROTO_VERSION);
 
-        if (n == -1) {
-            LogPrint(BCLog::MASTERNODE, "CMasternodePayments::ProcessBlock - Unknown Masternode\n");
-            return false;
-        }
+            if (n == -1) {
+                LogPrint(BCLog::MASTERNODE, "CMasternodePayments::ProcessBlock - Unknown Masternode %s\n", pactive->strAlias);
+                continue;
+            }
 
-        if (n > MNPAYMENTS_SIGNATURES_TOTAL) {
-            LogPrint(BCLog::MASTERNODE, "CMasternodePayments::ProcessBlock - Masternode not in the top %d (%d)\n", MNPAYMENTS_SIGNATURES_TOTAL, n);
-            return false;
+            if (n > MNPAYMENTS_SIGNATURES_TOTAL) {
+                LogPrint(BCLog::MASTERNODE, "CMasternodePayments::ProcessBlock - Masternode %s not in the top %d (%d)\n", pactive->strAlias, MNPAYMENTS_SIGNATURES_TOTAL, n);
+                continue;
+            }
         }
+        vVoters.push_back(pactive);
     }
 
-    if (nBlockHeight <= nCachedBlockHeight)
+    if (vVoters.empty())
         return false;
 
-    CMasternodePaymentWinner newWinner(activeMasternode.vin);
-
+    // the winner only depends on the height, so all our masternodes vote for the same payee
+    CScript payee;
     if (budget.IsBudgetPaymentBlock(nBlockHeight)) {
         //is budget payment block -- handled by the budgeting software
     } else {
-        LogPrint(BCLog::MASTERNODE, "CMasternodePayments::ProcessBlock() Start nHeight %d - vin %s. \n", nBlockHeight, activeMasternode.vin.ToString().c_str());
+        LogPrint(BCLog::MASTERNODE, "CMasternodePayments::ProcessBlock() Start nHeight %d - %d voters. \n", nBlockHeight, vVoters.size());
 
         // pay to the oldest MN that still had no payment but its input is old enough and it was active long enough
         int nCount = 0;
@@ -570,38 +593,37 @@ bool CMasternodePayments::ProcessBlock(int nBlockHeight, CConnman& connman)
         if (pmn) {
             LogPrint(BCLog::MASTERNODE, "CMasternodePayments::ProcessBlock() Found by FindOldestNotInVec \n");
 
-            newWinner.nBlockHeight = nBlockHeight;
-
-            CScript payee = GetScriptForDestination(PKHash(pmn->pubkey));
-            newWinner.AddPayee(payee);
+            payee = GetScriptForDestination(PKHash(pmn->pubkey));
 
-            LogPrint(BCLog::MASTERNODE, "CMasternodePayments::ProcessBlock() Winner payee %s nHeight %d. \n", payee.ToString(), newWinner.nBlockHeight);
+            LogPrint(BCLog::MASTERNODE, "CMasternodePayments::ProcessBlock() Winner payee %s nHeight %d. \n", payee.ToString(), nBlockHeight);
         } else {
             LogPrint(BCLog::MASTERNODE, "CMasternodePayments::ProcessBlock() Failed to find masternode to pay\n");
         }
     }
 
-    std::string errorMessage;
-    CPubKey pubKeyMasternode;
-    CKey keyMasternode;
-
-    if (!legacySigner.SetKey(strMasterNodePrivKey, keyMasternode, pubKeyMasternode)) {
-        LogPrint(BCLog::MASTERNODE, "CMasternodePayments::ProcessBlock() - Error upon calling SetKey: %s\n", errorMessage.c_str());
-        return false;
-    }
+    bool fVoted = false;
+    for (CActiveMasternode* pactive : vVoters) {
+        CMasternodePaymentWinner newWinner(pactive->vin);
+        if (!payee.empty()) {
+            newWinner.nBlockHeight = nBlockHeight;
+            newWinner.AddPayee(payee);
+        }
 
-    LogPrint(BCLog::MASTERNODE, "CMasternodePayments::ProcessBlock() - Signing Winner\n");
-    if (newWinner.Sign(keyMasternode, pubKeyMasternode)) {
-        LogPrint(BCLog::MASTERNODE, "CMasternodePayments::ProcessBlock() - AddWinningMasternode\n");
+        LogPrint(BCLog::MASTERNODE, "CMasternodePayments::ProcessBlock() - Signing Winner vin %s\n", pactive->vin.ToString());
+        if (newWinner.Sign(pactive->keyMasternode, pactive->pubKeyMasternode)) {
+            LogPrint(BCLog::MASTERNODE, "CMasternodePayments::ProcessBlock() - AddWinningMasternode\n");
 
-        if (AddWinningMasternode(newWinner)) {
-            newWinner.Relay(connman);
-            nCachedBlockHeight = nBlockHeight;
-            return true;
+            if (AddWinningMasternode(newWinner)) {
+                newWinner.Relay(connman);
+                fVoted = true;
+            }
         }
     }
 
-    return false;
+    if (fVoted)
+        nCachedBlockHeight = nBlockHeight;
+
+    return fVoted;
 }
 
 void CMasternodePaymentWinner::Relay(CConnman& connman)
@@ -668,3 +690,24 @@ std::string CMasternodePayments::ToString() const
 
     return info.str();
 }
+
+size_t CMasternodePayments::DynamicMemoryUsage() const
+{
+    size_t nUsage = 0;
+    {
+        LOCK(cs_mapMasternodePayeeVotes);
+        nUsage += memusage::DynamicUsage(mapMasternodePayeeVotes) + memusage::DynamicUsage(mapMasternodesLastVote);
+        for (const auto& vote : mapMasternodePayeeVotes)
+            nUsage += RecursiveDynamicUsage(vote.second.vinMasternode) + RecursiveDynamicUsage(vote.second.payee) + memusage::DynamicUsage(vote.second.vchSig);
+    }
+    {
+        LOCK2(cs_mapMasternodeBlocks, cs_vecPayments);
+        nUsage += memusage::DynamicUsage(mapMasternodeBlocks);
+        for (const auto& block : mapMasternodeBlocks) {
+            nUsage += memusage::DynamicUsage(block.second.vecPayments);
+            for (const CMasternodePayee& payee : block.second.vecPayments)
+                nUsage += RecursiveDynamicUsage(payee.scriptPubKey);
+        }
+    }
+    return nUsage;
+}
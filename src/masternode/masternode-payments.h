@@ -118,6 +118,12 @@ public:
         return false;
     }
 
+    std::vector<CMasternodePayee> GetPayees()
+    {
+        LOCK(cs_vecPayments);
+        return vecPayments;
+    }
+
     bool IsTransactionValid(const CTransaction& txNew, const CAmount& nValueCreated);
     std::string GetRequiredPaymentsString();
 
@@ -228,6 +234,8 @@ public:
     int LastPayment(CMasternode& mn);
 
     bool GetBlockPayee(int nBlockHeight, CScript& payee);
+    /// Copy of the payees voted for at a height, empty if no votes were seen
+    std::vector<CMasternodePayee> GetBlockPayees(int nBlockHeight);
     bool IsTransactionValid(const CAmount& nValueCreated, const CTransaction& txNew, int nBlockHeight);
     bool IsScheduled(CMasternode& mn, int nNotBlockHeight);
 
@@ -238,6 +246,7 @@ public:
     std::string GetRequiredPaymentsString(int nBlockHeight);
     void FillBlockPayee(CMutableTransaction& txNew, int64_t nFees);
     std::string ToString() const;
+    size_t DynamicMemoryUsage() const;
 
     SERIALIZE_METHODS(CMasternodePayments, obj)
     {
@@ -11,6 +11,8 @@
 #include <node/context.h>
 #include <node/ui_interface.h>
 #include <rpc/blockchain.h>
+#include <scheduler.h>
+#include <shutdown.h>
 
 class CMasternodeSync;
 CMasternodeSync masternodeSync;
@@ -82,14 +84,20 @@ void CMasternodeSync::Reset()
     countMasternodeWinner = 0;
     countBudgetItemProp = 0;
     countBudgetItemFin = 0;
+    nMaxCountMasternodeList = 0;
+    nMaxCountMasternodeWinner = 0;
+    nMaxCountBudgetItemProp = 0;
+    nMaxCountBudgetItemFin = 0;
     RequestedMasternodeAssets = MASTERNODE_SYNC_INITIAL;
     RequestedMasternodeAttempt = 0;
     nAssetSyncStarted = GetTime();
+
+    ScheduleStep();
 }
 
 void CMasternodeSync::AddedMasternodeList(uint256 hash)
 {
-    if (mnodeman.mapSeenMasternodeBroadcast.count(hash)) {
+    if (mnodeman.mapSeenMasternodeBroadcast.IsSeen(hash)) {
         if (mapSeenSyncMNB[hash] < MASTERNODE_SYNC_THRESHOLD) {
             lastMasternodeList = GetTime();
             mapSeenSyncMNB[hash]++;
@@ -97,6 +105,8 @@ void CMasternodeSync::AddedMasternodeList(uint256 hash)
     } else {
         lastMasternodeList = GetTime();
         mapSeenSyncMNB.insert(make_pair(hash, 1));
+        if (RequestedMasternodeAssets == MASTERNODE_SYNC_LIST && IsAssetComplete())
+            ScheduleStep();
     }
 }
 
@@ -110,6 +120,8 @@ void CMasternodeSync::AddedMasternodeWinner(uint256 hash)
     } else {
         lastMasternodeWinner = GetTime();
         mapSeenSyncMNW.insert(make_pair(hash, 1));
+        if (RequestedMasternodeAssets == MASTERNODE_SYNC_MNW && IsAssetComplete())
+            ScheduleStep();
     }
 }
 
@@ -123,6 +135,8 @@ void CMasternodeSync::AddedBudgetItem(uint256 hash)
     } else {
         lastBudgetItem = GetTime();
         mapSeenSyncBudget.insert(make_pair(hash, 1));
+        if (RequestedMasternodeAssets == MASTERNODE_SYNC_BUDGET && IsAssetComplete())
+            ScheduleStep();
     }
 }
 
@@ -202,28 +216,35 @@ void CMasternodeSync::ProcessMessage(CNode* pfrom, const std::string& strCommand
                 return;
             sumMasternodeList += nCount;
             countMasternodeList++;
+            nMaxCountMasternodeList = std::max(nMaxCountMasternodeList, nCount);
             break;
         case (MASTERNODE_SYNC_MNW):
             if (nItemID != RequestedMasternodeAssets)
                 return;
             sumMasternodeWinner += nCount;
             countMasternodeWinner++;
+            nMaxCountMasternodeWinner = std::max(nMaxCountMasternodeWinner, nCount);
             break;
         case (MASTERNODE_SYNC_BUDGET_PROP):
             if (RequestedMasternodeAssets != MASTERNODE_SYNC_BUDGET)
                 return;
             sumBudgetItemProp += nCount;
             countBudgetItemProp++;
+            nMaxCountBudgetItemProp = std::max(nMaxCountBudgetItemProp, nCount);
             break;
         case (MASTERNODE_SYNC_BUDGET_FIN):
             if (RequestedMasternodeAssets != MASTERNODE_SYNC_BUDGET)
                 return;
             sumBudgetItemFin += nCount;
             countBudgetItemFin++;
+            nMaxCountBudgetItemFin = std::max(nMaxCountBudgetItemFin, nCount);
             break;
         }
 
         LogPrintf("CMasternodeSync:ProcessMessage - ssc - got inventory count %d %d\n", nItemID, nCount);
+
+        if (IsAssetComplete())
+            ScheduleStep();
     }
 }
 
@@ -237,150 +258,196 @@ void CMasternodeSync::ClearFulfilledRequest(CConnman& connman)
     });
 }
 
-void CMasternodeSync::Process(CConnman& connman)
+bool CMasternodeSync::IsAssetComplete() const
 {
-    const CNetMsgMaker msgMaker(PROTOCOL_VERSION);
-    static int tick = 0;
+    // Every peer we asked (up to the threshold) has to report its count, and we need to have seen as many
+    // items as the best of them announced
+    const int nPeersNeeded = std::max(1, std::min(RequestedMasternodeAttempt, MASTERNODE_SYNC_THRESHOLD));
 
-    if (tick++ % MASTERNODE_SYNC_TIMEOUT != 0)
-        return;
+    switch (RequestedMasternodeAssets) {
+    case (MASTERNODE_SYNC_LIST):
+        return countMasternodeList >= nPeersNeeded && (int)mapSeenSyncMNB.size() >= nMaxCountMasternodeList;
+    case (MASTERNODE_SYNC_MNW):
+        return countMasternodeWinner >= nPeersNeeded && (int)mapSeenSyncMNW.size() >= nMaxCountMasternodeWinner;
+    case (MASTERNODE_SYNC_BUDGET):
+        return countBudgetItemProp >= nPeersNeeded && countBudgetItemFin >= nPeersNeeded &&
+               (int)mapSeenSyncBudget.size() >= nMaxCountBudgetItemProp + nMaxCountBudgetItemFin;
+    }
+    return false;
+}
+
+void CMasternodeSync::Start(CScheduler& scheduler, CConnman& connman)
+{
+    m_scheduler = &scheduler;
+    m_connman = &connman;
+    ScheduleStep();
+}
+
+void CMasternodeSync::Stop()
+{
+    LOCK(cs_step);
+    m_scheduler = nullptr;
+    m_connman = nullptr;
+    m_step_time = 0;
+}
 
-    if (IsSynced()) {
+void CMasternodeSync::ScheduleStep(std::chrono::milliseconds delta)
+{
+    if (!m_scheduler)
         return;
+
+    const int64_t nStepTime = GetTimeMillis() + delta.count();
+    {
+        LOCK(cs_step);
+        // an earlier step is already queued, it will re-arm the timer if needed
+        if (m_step_time != 0 && m_step_time <= nStepTime)
+            return;
+        m_step_time = nStepTime;
     }
 
-    //try syncing again
-    if (RequestedMasternodeAssets == MASTERNODE_SYNC_FAILED && lastFailure + (1 * 60) < GetTime()) {
-        Reset();
-    } else if (RequestedMasternodeAssets == MASTERNODE_SYNC_FAILED) {
-        return;
+    m_scheduler->scheduleFromNow([this, nStepTime] {
+        {
+            LOCK(cs_step);
+            if (m_step_time != nStepTime)
+                return;
+            m_step_time = 0;
+        }
+        Step();
+    }, delta);
+}
+
+void CMasternodeSync::Fail()
+{
+    if (IsSporkActive(SPORK_8_MASTERNODE_PAYMENT_ENFORCEMENT)) {
+        LogPrintf("CMasternodeSync::Step - ERROR - Sync has failed, will retry later\n");
+        RequestedMasternodeAssets = MASTERNODE_SYNC_FAILED;
+        RequestedMasternodeAttempt = 0;
+        lastFailure = GetTime();
+        nCountFailures++;
+    } else {
+        GetNextAsset();
     }
+}
 
-    // Calculate "progress" for LOG reporting / GUI notification
-    double nSyncProgress = double(RequestedMasternodeAttempt + (RequestedMasternodeAssets - 1) * 8) / (8 * 4);
-    uiInterface.NotifyAdditionalDataSyncProgressChanged(nSyncProgress);
-    LogPrintf("CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d nRequestedMasternodeAttempt %d nSyncProgress %f\n", tick, RequestedMasternodeAssets, RequestedMasternodeAttempt, nSyncProgress);
+void CMasternodeSync::Step()
+{
+    const std::chrono::milliseconds nTimeout{MASTERNODE_SYNC_TIMEOUT * 1000};
 
-    if (!IsBlockchainSynced() && RequestedMasternodeAssets > MASTERNODE_SYNC_SPORKS)
+    if (IsSynced() || ShutdownRequested())
         return;
 
-    if (RequestedMasternodeAssets == MASTERNODE_SYNC_INITIAL)
-        GetNextAsset();
+    // wait for the chain, there is no point in asking for assets before that
+    if (fReindex || fImporting || ::ChainstateActive().IsInitialBlockDownload() || !IsBlockchainSynced()) {
+        ScheduleStep(nTimeout);
+        return;
+    }
 
-    std::vector<CNode*> vNodesCopy = connman.CopyNodeVector();
-    for (auto& pnode : vNodesCopy) {
-        if (RequestedMasternodeAssets == MASTERNODE_SYNC_SPORKS) {
-            if (netfulfilledman.HasFulfilledRequest(pnode->addr, "getspork"))
-                continue;
-            netfulfilledman.AddFulfilledRequest(pnode->addr, "getspork");
-            connman.PushMessage(pnode, CNetMsgMaker(pnode->GetCommonVersion()).Make(NetMsgType::GETSPORKS));
-            if (RequestedMasternodeAttempt >= 2)
-                GetNextAsset();
-            RequestedMasternodeAttempt++;
+    //try syncing again
+    if (RequestedMasternodeAssets == MASTERNODE_SYNC_FAILED) {
+        if (lastFailure + (1 * 60) >= GetTime()) {
+            ScheduleStep(std::chrono::seconds{lastFailure + (1 * 60) + 1 - GetTime()});
             return;
         }
+        Reset();
+    }
 
-        if (pnode->nVersion >= masternodePayments.GetMinMasternodePaymentsProto()) {
-            if (RequestedMasternodeAssets == MASTERNODE_SYNC_LIST) {
-                LogPrintf("CMasternodeSync::Process() - lastMasternodeList %lld (GetTime() - MASTERNODE_SYNC_TIMEOUT) %lld\n", lastMasternodeList, GetTime() - MASTERNODE_SYNC_TIMEOUT);
-                if (lastMasternodeList > 0 && lastMasternodeList < GetTime() - MASTERNODE_SYNC_TIMEOUT * 2 && RequestedMasternodeAttempt >= MASTERNODE_SYNC_THRESHOLD) {
-                    GetNextAsset();
-                    return;
-                }
+    if (RequestedMasternodeAssets == MASTERNODE_SYNC_INITIAL)
+        GetNextAsset();
 
-                if (netfulfilledman.HasFulfilledRequest(pnode->addr, "mnsync"))
-                    continue;
-                netfulfilledman.AddFulfilledRequest(pnode->addr, "mnsync");
-
-                // timeout
-                if (lastMasternodeList == 0 && (RequestedMasternodeAttempt >= MASTERNODE_SYNC_THRESHOLD * 3 || GetTime() - nAssetSyncStarted > MASTERNODE_SYNC_TIMEOUT * 5)) {
-                    if (IsSporkActive(SPORK_8_MASTERNODE_PAYMENT_ENFORCEMENT)) {
-                        LogPrintf("CMasternodeSync::Process - ERROR - Sync has failed, will retry later\n");
-                        RequestedMasternodeAssets = MASTERNODE_SYNC_FAILED;
-                        RequestedMasternodeAttempt = 0;
-                        lastFailure = GetTime();
-                        nCountFailures++;
-                    } else {
-                        GetNextAsset();
-                    }
-                    return;
-                }
-
-                if (RequestedMasternodeAttempt >= MASTERNODE_SYNC_THRESHOLD * 3)
-                    return;
+    CConnman& connman = *m_connman;
+    std::vector<CNode*> vNodesCopy = connman.CopyNodeVector();
 
-                mnodeman.DsegUpdate(pnode, connman);
-                RequestedMasternodeAttempt++;
-                return;
-            }
+    // a stage that completes hands over to the next one straight away
+    int nPrevAsset = -1;
+    while (nPrevAsset != RequestedMasternodeAssets && !IsSynced() && RequestedMasternodeAssets != MASTERNODE_SYNC_FAILED) {
+        nPrevAsset = RequestedMasternodeAssets;
 
-            if (RequestedMasternodeAssets == MASTERNODE_SYNC_MNW) {
-                if (lastMasternodeWinner > 0 && lastMasternodeWinner < GetTime() - MASTERNODE_SYNC_TIMEOUT * 2 && RequestedMasternodeAttempt >= MASTERNODE_SYNC_THRESHOLD) { //hasn't received a new item in the last five seconds, so we'll move to the
-                    GetNextAsset();
-                    return;
-                }
+        // Calculate "progress" for LOG reporting / GUI notification
+        double nSyncProgress = double(RequestedMasternodeAttempt + (RequestedMasternodeAssets - 1) * 8) / (8 * 4);
+        uiInterface.NotifyAdditionalDataSyncProgressChanged(nSyncProgress);
+        LogPrintf("CMasternodeSync::Step -- nRequestedMasternodeAssets %d nRequestedMasternodeAttempt %d nSyncProgress %f\n", RequestedMasternodeAssets, RequestedMasternodeAttempt, nSyncProgress);
 
-                if (netfulfilledman.HasFulfilledRequest(pnode->addr, "mnwsync"))
+        if (RequestedMasternodeAssets == MASTERNODE_SYNC_SPORKS) {
+            for (auto& pnode : vNodesCopy) {
+                if (RequestedMasternodeAttempt > MASTERNODE_SYNC_THRESHOLD)
+                    break;
+                if (netfulfilledman.HasFulfilledRequest(pnode->addr, "getspork"))
                     continue;
-                netfulfilledman.AddFulfilledRequest(pnode->addr, "mnwsync");
-
-                // timeout
-                if (lastMasternodeWinner == 0 && (RequestedMasternodeAttempt >= MASTERNODE_SYNC_THRESHOLD * 3 || GetTime() - nAssetSyncStarted > MASTERNODE_SYNC_TIMEOUT * 5)) {
-                    if (IsSporkActive(SPORK_8_MASTERNODE_PAYMENT_ENFORCEMENT)) {
-                        LogPrintf("CMasternodeSync::Process - ERROR - Sync has failed, will retry later\n");
-                        RequestedMasternodeAssets = MASTERNODE_SYNC_FAILED;
-                        RequestedMasternodeAttempt = 0;
-                        lastFailure = GetTime();
-                        nCountFailures++;
-                    } else {
-                        GetNextAsset();
-                    }
-                    return;
-                }
-
-                if (RequestedMasternodeAttempt >= MASTERNODE_SYNC_THRESHOLD * 3)
-                    return;
-
-                int nMnCount = mnodeman.CountEnabled();
-                connman.PushMessage(pnode, msgMaker.Make(NetMsgType::GETMNWINNERS, nMnCount));
+                netfulfilledman.AddFulfilledRequest(pnode->addr, "getspork");
+                connman.PushMessage(pnode, CNetMsgMaker(pnode->GetCommonVersion()).Make(NetMsgType::GETSPORKS));
                 RequestedMasternodeAttempt++;
-
-                return;
             }
-        }
-
-        if (RequestedMasternodeAssets == MASTERNODE_SYNC_BUDGET) {
-            //we'll start rejecting votes if we accidentally get set as synced too soon
-            if (lastBudgetItem > 0 && lastBudgetItem < GetTime() - MASTERNODE_SYNC_TIMEOUT * 2 && RequestedMasternodeAttempt >= MASTERNODE_SYNC_THRESHOLD) { //hasn't received a new item in the last five seconds, so we'll move to the
-                // Hasn't received a new item in the last five seconds, so we'll move to the
+            if (RequestedMasternodeAttempt > MASTERNODE_SYNC_THRESHOLD)
                 GetNextAsset();
+            continue;
+        }
 
-                //try to activate our masternode if possible
-                activeMasternode.ManageStatus(connman);
+        int64_t lastItem = 0;
+        std::string strFulfilled;
+        if (RequestedMasternodeAssets == MASTERNODE_SYNC_LIST) {
+            lastItem = lastMasternodeList;
+            strFulfilled = "mnsync";
+        } else if (RequestedMasternodeAssets == MASTERNODE_SYNC_MNW) {
+            lastItem = lastMasternodeWinner;
+            strFulfilled = "mnwsync";
+        } else if (RequestedMasternodeAssets == MASTERNODE_SYNC_BUDGET) {
+            lastItem = lastBudgetItem;
+            strFulfilled = "busync";
+        }
 
-                return;
-            }
+        // everything announced has arrived, or we haven't received a new item in a while
+        if (IsAssetComplete() || (lastItem > 0 && lastItem < GetTime() - MASTERNODE_SYNC_TIMEOUT * 2 && RequestedMasternodeAttempt >= MASTERNODE_SYNC_THRESHOLD)) {
+            GetNextAsset();
+            //try to activate our masternode if possible
+            if (IsSynced())
+                for (CActiveMasternode* pactive : GetActiveMasternodes())
+                    pactive->ManageStatus(connman);
+            continue;
+        }
 
-            // timeout
-            if (lastBudgetItem == 0 && (RequestedMasternodeAttempt >= MASTERNODE_SYNC_THRESHOLD * 3 || GetTime() - nAssetSyncStarted > MASTERNODE_SYNC_TIMEOUT * 5)) {
+        // timeout
+        if (lastItem == 0 && (RequestedMasternodeAttempt >= MASTERNODE_SYNC_THRESHOLD * 3 || GetTime() - nAssetSyncStarted > MASTERNODE_SYNC_TIMEOUT * 5)) {
+            if (RequestedMasternodeAssets == MASTERNODE_SYNC_BUDGET) {
                 // maybe there is no budgets at all, so just finish syncing
                 GetNextAsset();
-                activeMasternode.ManageStatus(connman);
-                return;
+                for (CActiveMasternode* pactive : GetActiveMasternodes())
+                    pactive->ManageStatus(connman);
+            } else {
+                Fail();
             }
+            continue;
+        }
 
-            if (netfulfilledman.HasFulfilledRequest(pnode->addr, "busync"))
+        // ask a couple of peers at once when the stage starts, then one more on every timer
+        int nAsk = RequestedMasternodeAttempt == 0 ? MASTERNODE_SYNC_THRESHOLD : 1;
+        for (auto& pnode : vNodesCopy) {
+            if (nAsk == 0 || RequestedMasternodeAttempt >= MASTERNODE_SYNC_THRESHOLD * 3)
+                break;
+            if (RequestedMasternodeAssets != MASTERNODE_SYNC_BUDGET && pnode->nVersion < masternodePayments.GetMinMasternodePaymentsProto())
                 continue;
-            netfulfilledman.AddFulfilledRequest(pnode->addr, "busync");
-
-            if (RequestedMasternodeAttempt >= MASTERNODE_SYNC_THRESHOLD * 3)
-                return;
+            if (netfulfilledman.HasFulfilledRequest(pnode->addr, strFulfilled))
+                continue;
+            netfulfilledman.AddFulfilledRequest(pnode->addr, strFulfilled);
 
-            uint256 n = uint256();
-            connman.PushMessage(pnode, CNetMsgMaker(pnode->GetCommonVersion()).Make(NetMsgType::BUDGETVOTESYNC, n));
+            if (RequestedMasternodeAssets == MASTERNODE_SYNC_LIST) {
+                mnodeman.DsegUpdate(pnode, connman);
+            } else if (RequestedMasternodeAssets == MASTERNODE_SYNC_MNW) {
+                int nMnCount = mnodeman.CountEnabled();
+                connman.PushMessage(pnode, CNetMsgMaker(PROTOCOL_VERSION).Make(NetMsgType::GETMNWINNERS, nMnCount));
+            } else {
+                uint256 n = uint256();
+                connman.PushMessage(pnode, CNetMsgMaker(pnode->GetCommonVersion()).Make(NetMsgType::BUDGETVOTESYNC, n));
+            }
             RequestedMasternodeAttempt++;
-
-            return;
+            nAsk--;
         }
     }
+
+    connman.ReleaseNodeVector(vNodesCopy);
+
+    if (RequestedMasternodeAssets == MASTERNODE_SYNC_FAILED) {
+        ScheduleStep(std::chrono::seconds{1 * 60 + 1});
+    } else if (!IsSynced()) {
+        ScheduleStep(nTimeout);
+    }
 }
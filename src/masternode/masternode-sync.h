@@ -7,6 +7,9 @@
 #define MASTERNODE_SYNC_H
 
 #include <net.h>
+#include <sync.h>
+
+#include <chrono>
 
 #define MASTERNODE_SYNC_INITIAL 0
 #define MASTERNODE_SYNC_SPORKS 1
@@ -22,11 +25,17 @@
 #define MASTERNODE_SYNC_THRESHOLD 2
 
 class CMasternodeSync;
+class CScheduler;
 extern CMasternodeSync masternodeSync;
 
 //
 // CMasternodeSync : Sync masternode assets in stages
 //
+// The sync is a state machine driven by events rather than a polling thread. A stage advances as soon
+// as the peers we asked have reported their counts (ssc) and we have seen that many items, otherwise
+// an explicit timer re-evaluates the stage every MASTERNODE_SYNC_TIMEOUT seconds until it times out.
+// No timers are left running once the sync has finished.
+//
 
 class CMasternodeSync {
 public:
@@ -50,6 +59,11 @@ public:
     int countMasternodeWinner;
     int countBudgetItemProp;
     int countBudgetItemFin;
+    // largest count reported by a single peer
+    int nMaxCountMasternodeList;
+    int nMaxCountMasternodeWinner;
+    int nMaxCountBudgetItemProp;
+    int nMaxCountBudgetItemFin;
 
     // Count peers we've requested the list from
     int RequestedMasternodeAssets;
@@ -70,11 +84,26 @@ public:
     bool IsBudgetPropEmpty();
 
     void Reset();
-    void Process(CConnman& connman);
+    void Start(CScheduler& scheduler, CConnman& connman);
+    //! Forget the scheduler and connection manager, before they go away
+    void Stop();
+    void ScheduleStep(std::chrono::milliseconds delta = std::chrono::milliseconds{0});
+    void Step();
+    bool IsAssetComplete() const;
     bool IsSynced();
     bool IsBlockchainSynced();
     bool AreSporksSynced() const;
     void ClearFulfilledRequest(CConnman& connman);
+
+private:
+    CScheduler* m_scheduler{nullptr};
+    CConnman* m_connman{nullptr};
+
+    Mutex cs_step;
+    // time in ms of the pending step, 0 if none is queued
+    int64_t m_step_time GUARDED_BY(cs_step){0};
+
+    void Fail();
 };
 
 #endif
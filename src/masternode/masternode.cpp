@@ -202,27 +202,22 @@ void CMasternode::Check(bool forceCheck)
     if (activeState == MASTERNODE_VIN_SPENT)
         return;
 
+    const int nPrevState = activeState;
+
     if (!IsPingedWithin(MASTERNODE_REMOVAL_SECONDS)) {
         activeState = MASTERNODE_REMOVE;
-        return;
-    }
-
-    if (!IsPingedWithin(MASTERNODE_EXPIRATION_SECONDS)) {
+    } else if (!IsPingedWithin(MASTERNODE_EXPIRATION_SECONDS)) {
         activeState = MASTERNODE_EXPIRED;
-        return;
-    }
-
-    //test if the collateral is still good
-    if (!unitTest) {
-        CollateralStatus err = CheckCollateral(vin.prevout);
-        if (err == COLLATERAL_UTXO_NOT_FOUND) {
-            activeState = MASTERNODE_VIN_SPENT;
-            LogPrint(BCLog::MASTERNODE, "CMasternode::Check -- Failed to find Masternode UTXO, masternode=%s\n", vin.prevout.ToString());
-            return;
-        }
+    } else if (!unitTest && CheckCollateral(vin.prevout) == COLLATERAL_UTXO_NOT_FOUND) {
+        //test if the collateral is still good
+        activeState = MASTERNODE_VIN_SPENT;
+        LogPrint(BCLog::MASTERNODE, "CMasternode::Check -- Failed to find Masternode UTXO, masternode=%s\n", vin.prevout.ToString());
+    } else {
+        activeState = MASTERNODE_ENABLED; // OK
     }
 
-    activeState = MASTERNODE_ENABLED; // OK
+    if (activeState != nPrevState)
+        mnodeman.NotifyListChanged(vin.prevout, activeState == MASTERNODE_EXPIRED ? NodeListChange::EXPIRED : NodeListChange::UPDATED);
 }
 
 bool CMasternode::IsValidNetAddr() const
@@ -249,6 +244,17 @@ int64_t CMasternode::SecondsSincePayment() const
     return month + UintToArith256(hash).GetCompact(false);
 }
 
+int64_t CMasternode::GetLastPaidOffset() const
+{
+    CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
+    ss << vin;
+    ss << sigTime;
+    uint256 hash = ss.GetHash();
+
+    // use a deterministic offset to break a tie -- 2.5 minutes
+    return UintToArith256(hash).GetCompact(false) % 150;
+}
+
 int64_t CMasternode::GetLastPaid() const
 {
     CBlockIndex* pindexPrev = ::ChainActive().Tip();
@@ -258,13 +264,7 @@ int64_t CMasternode::GetLastPaid() const
     CScript mnpayee;
     mnpayee = GetScriptForDestination(PKHash(pubkey));
 
-    CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
-    ss << vin;
-    ss << sigTime;
-    uint256 hash = ss.GetHash();
-
-    // use a deterministic offset to break a tie -- 2.5 minutes
-    int64_t nOffset = UintToArith256(hash).GetCompact(false) % 150;
+    int64_t nOffset = GetLastPaidOffset();
 
     if (::ChainActive().Tip() == nullptr)
         return false;
@@ -581,6 +581,7 @@ bool CMasternodeBroadcast::CheckAndUpdate(int& nDos, CConnman& connman) const
         //take the newest entry
         LogPrint(BCLog::MASTERNODE, "mnb - Got updated entry for %s\n", addr.ToString());
         if (pmn->UpdateFromNewBroadcast((*this), connman)) {
+            mnodeman.NotifyListChanged(pmn->vin.prevout, NodeListChange::UPDATED);
             pmn->Check();
             if (pmn->IsEnabled())
                 Relay(connman);
@@ -595,8 +596,12 @@ bool CMasternodeBroadcast::CheckInputsAndAdd(int& nDoS, CConnman& connman) const
 {
     // we are a masternode with the same vin (i.e. already activated) and this mnb is ours (matches our Masternode privkey)
     // so nothing to do here for us
-    if (fMasterNode && vin.prevout == activeMasternode.vin.prevout && pubkey2 == activeMasternode.pubKeyMasternode)
-        return true;
+    if (fMasterNode) {
+        for (const CActiveMasternode* pactive : GetActiveMasternodes()) {
+            if (vin.prevout == pactive->vin.prevout && pubkey2 == pactive->pubKeyMasternode)
+                return true;
+        }
+    }
 
     // incorrect ping or its sigTime
     if (lastPing == CMasternodePing() || !lastPing.CheckAndUpdate(nDoS, connman, false, true))
@@ -644,17 +649,19 @@ bool CMasternodeBroadcast::CheckInputsAndAdd(int& nDoS, CConnman& connman) const
     mnodeman.Add(mn);
 
     // if it matches our Masternode privkey, then we've been remotely activated
-    if (pubkey2 == activeMasternode.pubKeyMasternode && protocolVersion == PROTOCOL_VERSION) {
-        activeMasternode.EnableHotColdMasterNode(vin, addr);
-        if (!vchSignover.empty()) {
-            if (pubkey.Verify(pubkey2.GetHash(), vchSignover)) {
-                LogPrint(BCLog::MASTERNODE, "%s: Verified pubkey2 signover for staking, added to activemasternode\n", __func__);
-                activeMasternode.vchSigSignover = vchSignover;
+    for (CActiveMasternode* pactive : GetActiveMasternodes()) {
+        if (pubkey2 == pactive->pubKeyMasternode && protocolVersion == PROTOCOL_VERSION) {
+            pactive->EnableHotColdMasterNode(vin, addr);
+            if (!vchSignover.empty()) {
+                if (pubkey.Verify(pubkey2.GetHash(), vchSignover)) {
+                    LogPrint(BCLog::MASTERNODE, "%s: Verified pubkey2 signover for staking, added to activemasternode\n", __func__);
+                    pactive->vchSigSignover = vchSignover;
+                } else {
+                    LogPrint(BCLog::MASTERNODE, "%s: Failed to verify pubkey on signover!\n", __func__);
+                }
             } else {
-                LogPrint(BCLog::MASTERNODE, "%s: Failed to verify pubkey on signover!\n", __func__);
+                LogPrint(BCLog::MASTERNODE, "%s: NOT SIGNOVER!\n", __func__);
             }
-        } else {
-            LogPrint(BCLog::MASTERNODE, "%s: NOT SIGNOVER!\n", __func__);
         }
     }
 
@@ -850,12 +857,14 @@ bool CMasternodePing::CheckAndUpdate(int& nDos, CConnman& connman, bool fRequire
             }
 
             pmn->lastPing = *this;
+            mnodeman.NotifyListChanged(pmn->vin.prevout, NodeListChange::UPDATED);
 
             //mnodeman.mapSeenMasternodeBroadcast.lastPing is probably outdated, so we'll update it
             CMasternodeBroadcast mnb(*pmn);
             uint256 hash = mnb.GetHash();
-            if (mnodeman.mapSeenMasternodeBroadcast.count(hash)) {
-                mnodeman.mapSeenMasternodeBroadcast[hash].lastPing = *this;
+            auto it = mnodeman.mapSeenMasternodeBroadcast.find(hash);
+            if (it != mnodeman.mapSeenMasternodeBroadcast.end()) {
+                it->second.lastPing = *this;
             }
 
             pmn->Check(true);
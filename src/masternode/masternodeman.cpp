@@ -3,10 +3,12 @@
 // Distributed under the MIT/X11 software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <core_memusage.h>
 #include <crown/legacysigner.h>
 #include <mn_processing.h>
 #include <net_processing.h>
 #include <netmessagemaker.h>
+#include <node/ui_interface.h>
 #include <nodediag.h>
 
 /** Masternode manager */
@@ -52,6 +54,7 @@ bool CMasternodeMan::Add(const CMasternode& mn)
     if (!pmn) {
         LogPrint(BCLog::MASTERNODE, "CMasternodeMan: Adding new Masternode %s - %i now\n", mn.addr.ToString(), size() + 1);
         vMasternodes.push_back(mn);
+        NotifyListChanged(mn.vin.prevout, NodeListChange::ADDED);
         return true;
     }
 
@@ -120,7 +123,9 @@ void CMasternodeMan::CheckAndRemove(bool forceExpiredRemoval)
                 }
             }
 
+            const COutPoint outpoint = (*it).vin.prevout;
             it = vMasternodes.erase(it);
+            NotifyListChanged(outpoint, NodeListChange::REMOVED);
         } else {
             ++it;
         }
@@ -179,10 +184,36 @@ void CMasternodeMan::CheckAndRemove(bool forceExpiredRemoval)
     }
 }
 
+void CMasternodeMan::NotifyListChanged(const COutPoint& outpoint, NodeListChange change)
+{
+    m_snapshot_stale = true;
+    uiInterface.NotifyMasternodeChanged(outpoint, change == NodeListChange::ADDED ? CT_NEW : change == NodeListChange::REMOVED ? CT_DELETED : CT_UPDATED);
+    GetMainSignals().MasternodeListChanged(outpoint, change);
+}
+
+MasternodeListSnapshot CMasternodeMan::GetMasternodeListSnapshot()
+{
+    LOCK(cs_snapshot);
+    if (m_snapshot && !m_snapshot_stale)
+        return m_snapshot;
+
+    LOCK(cs);
+    // clear the flag before copying, a change made after the copy marks the new snapshot stale again
+    m_snapshot_stale = false;
+    m_snapshot = std::make_shared<const std::vector<CMasternode>>(vMasternodes);
+    return m_snapshot;
+}
+
 void CMasternodeMan::Clear()
 {
     LOCK(cs);
+    std::vector<COutPoint> vRemoved;
+    vRemoved.reserve(vMasternodes.size());
+    for (const CMasternode& mn : vMasternodes)
+        vRemoved.push_back(mn.vin.prevout);
     vMasternodes.clear();
+    for (const COutPoint& outpoint : vRemoved)
+        NotifyListChanged(outpoint, NodeListChange::REMOVED);
     mAskedUsForMasternodeList.clear();
     mWeAskedForMasternodeList.clear();
     mWeAskedForMasternodeListEntry.clear();
@@ -272,6 +303,19 @@ CMasternode* CMasternodeMan::Find(const CService& addr)
     return nullptr;
 }
 
+bool CMasternodeMan::GetMasternode(const COutPoint& outpoint, CMasternode& mnRet)
+{
+    LOCK(cs);
+
+    for (const auto& mn : vMasternodes) {
+        if (mn.vin.prevout == outpoint) {
+            mnRet = mn;
+            return true;
+        }
+    }
+    return false;
+}
+
 //
 // Deterministically select the oldest/best masternode to pay on the network
 //
@@ -470,6 +514,69 @@ std::vector<pair<int, CMasternode>> CMasternodeMan::GetMasternodeRanks(int64_t n
     return vecMasternodeRanks;
 }
 
+MasternodeListInfoMap CMasternodeMan::GetMasternodeListInfo(int nBlockHeight)
+{
+    LOCK(cs_listinfo);
+
+    const CBlockIndex* pindex;
+    {
+        LOCK(cs_main);
+        pindex = ::ChainActive()[nBlockHeight];
+    }
+    if (!pindex)
+        return std::make_shared<const std::map<COutPoint, CMasternodeListInfo>>();
+    if (m_listinfo && m_listinfo_block == pindex->GetBlockHash())
+        return m_listinfo;
+
+    MasternodeListSnapshot snapshot = GetMasternodeListSnapshot();
+    auto info = std::make_shared<std::map<COutPoint, CMasternodeListInfo>>();
+
+    // rank the enabled entries the same way GetMasternodeRanks does
+    std::vector<pair<int64_t, CTxIn>> vecScores;
+    const int nMinPaymentsProto = masternodePayments.GetMinMasternodePaymentsProto();
+    int nEnabled = 0;
+    for (const auto& mn : *snapshot) {
+        if (!mn.IsEnabled())
+            continue;
+        if (mn.protocolVersion >= nMinPaymentsProto)
+            nEnabled++;
+        vecScores.push_back(make_pair(mn.CalculateScore(nBlockHeight).GetCompact(false), mn.vin));
+    }
+    sort(vecScores.rbegin(), vecScores.rend(), CompareScoreTxIn());
+
+    int rank = 0;
+    for (const auto& s : vecScores)
+        (*info)[s.second.prevout].nRank = ++rank;
+
+    // walk the payment window once for all entries instead of once per entry, see CMasternode::GetLastPaid
+    std::map<CScript, int64_t> mapLastPaid;
+    {
+        LOCK2(cs_main, cs_mapMasternodeBlocks);
+        LOCK(cs_vecPayments);
+        const int nCount = nEnabled * 1.25;
+        const CBlockIndex* BlockReading = pindex;
+        for (int n = 0; n < nCount && BlockReading && BlockReading->nHeight > 0; n++, BlockReading = BlockReading->pprev) {
+            auto it = masternodePayments.mapMasternodeBlocks.find(BlockReading->nHeight);
+            if (it == masternodePayments.mapMasternodeBlocks.end())
+                continue;
+            // the most recent block wins, same as searching each payee with at least 2 votes
+            for (const CMasternodePayee& payee : it->second.vecPayments) {
+                if (payee.nVotes >= 2)
+                    mapLastPaid.emplace(payee.scriptPubKey, BlockReading->nTime);
+            }
+        }
+    }
+    for (const auto& mn : *snapshot) {
+        auto it = mapLastPaid.find(GetScriptForDestination(PKHash(mn.pubkey)));
+        if (it != mapLastPaid.end())
+            (*info)[mn.vin.prevout].nLastPaid = it->second + mn.GetLastPaidOffset();
+    }
+
+    m_listinfo_block = pindex->GetBlockHash();
+    m_listinfo = info;
+    return m_listinfo;
+}
+
 CMasternode* CMasternodeMan::GetMasternodeByRank(int nRank, int64_t nBlockHeight, int minProtocol, bool fOnlyActive)
 {
     std::vector<pair<int64_t, CTxIn>> vecMasternodeScores;
@@ -559,7 +666,7 @@ void CMasternodeMan::ProcessMessage(CNode* pfrom, const std::string& strCommand,
 
         LogPrint(BCLog::MASTERNODE, "mnp - Masternode ping, vin: %s\n", mnp.vin.ToString());
 
-        if (mapSeenMasternodePing.count(mnp.GetHash())) return;
+        if (mapSeenMasternodePing.IsSeen(mnp.GetHash())) return;
         mapSeenMasternodePing.insert(make_pair(mnp.GetHash(), mnp));
 
         int nDoS = 0;
@@ -640,6 +747,7 @@ void CMasternodeMan::Remove(CTxIn vin)
         if ((*it).vin == vin) {
             LogPrint(BCLog::MASTERNODE, "CMasternodeMan: Removing Masternode %s - %i now\n", (*it).addr.ToString(), size() - 1);
             vMasternodes.erase(it);
+            NotifyListChanged(vin.prevout, NodeListChange::REMOVED);
             break;
         }
         ++it;
@@ -659,6 +767,48 @@ std::string CMasternodeMan::ToString() const
     return info.str();
 }
 
+static size_t RecursiveDynamicUsage(const CMasternodePing& mnp)
+{
+    return RecursiveDynamicUsage(mnp.vin) + memusage::DynamicUsage(mnp.vchSig) + memusage::DynamicUsage(mnp.vPrevBlockHash) + memusage::DynamicUsage(mnp.vchSigPrevBlocks);
+}
+
+static size_t RecursiveDynamicUsage(const CMasternode& mn)
+{
+    return RecursiveDynamicUsage(mn.vin) + memusage::DynamicUsage(mn.sig) + memusage::DynamicUsage(mn.vchSignover) + RecursiveDynamicUsage(mn.lastPing);
+}
+
+size_t CMasternodeMan::DynamicMemoryUsage() const
+{
+    size_t nUsage = 0;
+    {
+        LOCK(cs);
+        nUsage += memusage::DynamicUsage(vMasternodes);
+        for (const CMasternode& mn : vMasternodes)
+            nUsage += RecursiveDynamicUsage(mn);
+        nUsage += memusage::DynamicUsage(mAskedUsForMasternodeList) + memusage::DynamicUsage(mWeAskedForMasternodeList) + memusage::DynamicUsage(mWeAskedForMasternodeListEntry);
+        nUsage += mapSeenMasternodeBroadcast.DynamicMemoryUsage() + mapSeenMasternodePing.DynamicMemoryUsage();
+        for (const auto& entry : mapSeenMasternodeBroadcast)
+            nUsage += RecursiveDynamicUsage(entry.second);
+        for (const auto& entry : mapSeenMasternodePing)
+            nUsage += RecursiveDynamicUsage(entry.second);
+    }
+    {
+        // older snapshots still held by readers are not counted
+        LOCK(cs_snapshot);
+        if (m_snapshot) {
+            nUsage += memusage::DynamicUsage(m_snapshot) + memusage::DynamicUsage(*m_snapshot);
+            for (const CMasternode& mn : *m_snapshot)
+                nUsage += RecursiveDynamicUsage(mn);
+        }
+    }
+    {
+        LOCK(cs_listinfo);
+        if (m_listinfo)
+            nUsage += memusage::DynamicUsage(m_listinfo) + memusage::DynamicUsage(*m_listinfo);
+    }
+    return nUsage;
+}
+
 void CMasternodeMan::UpdateMasternodeList(CMasternodeBroadcast mnb, CConnman& connman)
 {
     mapSeenMasternodePing.insert(make_pair(mnb.lastPing.GetHash(), mnb.lastPing));
@@ -672,7 +822,8 @@ void CMasternodeMan::UpdateMasternodeList(CMasternodeBroadcast mnb, CConnman& co
         CMasternode mn(mnb);
         Add(mn);
     } else {
-        pmn->UpdateFromNewBroadcast(mnb, connman);
+        if (pmn->UpdateFromNewBroadcast(mnb, connman))
+            NotifyListChanged(pmn->vin.prevout, NodeListChange::UPDATED);
     }
 }
 
@@ -682,7 +833,7 @@ bool CMasternodeMan::CheckMnbAndUpdateMasternodeList(CMasternodeBroadcast mnb, i
     LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckMnbAndUpdateMasternodeList - Masternode broadcast, vin: %s\n", mnb.vin.ToString());
 
     uint256 mnbHash = mnb.GetHash();
-    if (mapSeenMasternodeBroadcast.count(mnbHash)) {
+    if (mapSeenMasternodeBroadcast.IsSeen(mnbHash)) {
         masternodeSync.AddedMasternodeList(mnbHash);
         return true;
     }
@@ -7,22 +7,41 @@
 #define MASTERNODEMAN_H
 
 #include <base58.h>
+#include <crown/seencache.h>
 #include <key.h>
 #include <masternode/masternode.h>
 #include <net.h>
 #include <sync.h>
 #include <util/system.h>
 #include <validation.h>
+#include <validationinterface.h>
+
+#include <atomic>
+#include <memory>
 
 #define MASTERNODES_DUMP_SECONDS (15 * 60)
 #define MASTERNODES_DSEG_SECONDS (3 * 60 * 60)
 
+//! Number of masternode broadcasts and pings kept for relay, older ones are only remembered as seen
+static const size_t MAX_SEEN_MASTERNODE_BROADCASTS = 10000;
+static const size_t MAX_SEEN_MASTERNODE_PINGS = 40000;
+
 using namespace std;
 
 class CMasternodeMan;
 
 extern CMasternodeMan mnodeman;
 
+/** Immutable, shared copy of the masternode list handed out to readers */
+typedef std::shared_ptr<const std::vector<CMasternode>> MasternodeListSnapshot;
+
+/** Values of a list entry that are expensive to derive, computed once per chain height */
+struct CMasternodeListInfo {
+    int nRank{0}; // position in the payment ranking, 0 if not enabled
+    int64_t nLastPaid{0};
+};
+typedef std::shared_ptr<const std::map<COutPoint, CMasternodeListInfo>> MasternodeListInfoMap;
+
 class CMasternodeMan {
 private:
     // critical section to protect the inner data structures
@@ -40,11 +59,21 @@ private:
     // which Masternodes we've asked for
     std::map<COutPoint, int64_t> mWeAskedForMasternodeListEntry;
 
+    // last snapshot handed out to readers, rebuilt lazily once the list changed
+    mutable Mutex cs_snapshot;
+    MasternodeListSnapshot m_snapshot GUARDED_BY(cs_snapshot);
+    std::atomic<bool> m_snapshot_stale{true};
+
+    // derived values of the entries, valid for the block they were computed at
+    mutable Mutex cs_listinfo;
+    uint256 m_listinfo_block GUARDED_BY(cs_listinfo);
+    MasternodeListInfoMap m_listinfo GUARDED_BY(cs_listinfo);
+
 public:
     // Keep track of all broadcasts I've seen
-    map<uint256, CMasternodeBroadcast> mapSeenMasternodeBroadcast;
+    CSeenCache<CMasternodeBroadcast> mapSeenMasternodeBroadcast{MAX_SEEN_MASTERNODE_BROADCASTS};
     // Keep track of all pings I've seen
-    map<uint256, CMasternodePing> mapSeenMasternodePing;
+    CSeenCache<CMasternodePing> mapSeenMasternodePing{MAX_SEEN_MASTERNODE_PINGS};
 
     // keep track of dsq count to prevent masternodes from gaming legacySigner queue
     int64_t nDsqCount;
@@ -95,6 +124,8 @@ public:
     CMasternode* Find(const CTxIn& vin);
     CMasternode* Find(const CPubKey& pubKeyMasternode);
     CMasternode* Find(const CService& addr);
+    /// Copy an entry out of the list, safe to hold on to without locking
+    bool GetMasternode(const COutPoint& outpoint, CMasternode& mnRet);
 
     /// Find an entry in the masternode list that is next to be paid
     CMasternode* GetNextMasternodeInQueueForPayment(int nBlockHeight, bool fFilterSigTime, int& nCount);
@@ -105,11 +136,13 @@ public:
     /// Get the current winner for this block
     CMasternode* GetCurrentMasterNode(int mod = 1, int64_t nBlockHeight = 0, int minProtocol = 0);
 
-    std::vector<CMasternode> GetFullMasternodeVector()
-    {
-        Check();
-        return vMasternodes;
-    }
+    /// Get a snapshot of the list, readers can hold on to it without locking or copying
+    MasternodeListSnapshot GetMasternodeListSnapshot();
+    /// Called whenever an entry of the list was added, changed or removed, a null outpoint means the whole list.
+    /// Forwarded to the GUI and, through the validation interface queue, to ZMQ and other clients
+    void NotifyListChanged(const COutPoint& outpoint, NodeListChange change);
+    /// Get the rank and last payment time of the entries at a height, computed once per block
+    MasternodeListInfoMap GetMasternodeListInfo(int nBlockHeight);
 
     std::vector<pair<int, CMasternode>> GetMasternodeRanks(int64_t nBlockHeight, int minProtocol = 0);
     int GetMasternodeRank(const CTxIn& vin, int64_t nBlockHeight, int minProtocol = 0, bool fOnlyActive = true);
@@ -123,6 +156,7 @@ public:
     int size() { return vMasternodes.size(); }
 
     std::string ToString() const;
+    size_t DynamicMemoryUsage() const;
 
     void Remove(CTxIn vin);
 
@@ -72,13 +72,13 @@ bool AlreadyHaveMasternodeTypes(const CInv& inv, const CTxMemPool& mempool)
             }
             return false;
         case MSG_MASTERNODE_ANNOUNCE:
-            if(mnodeman.mapSeenMasternodeBroadcast.count(inv.hash)) {
+            if(mnodeman.mapSeenMasternodeBroadcast.IsSeen(inv.hash)) {
                 masternodeSync.AddedMasternodeList(inv.hash);
                 return true;
             }
             return false;
         case MSG_MASTERNODE_PING:
-            return mnodeman.mapSeenMasternodePing.count(inv.hash);
+            return mnodeman.mapSeenMasternodePing.IsSeen(inv.hash);
         case MSG_SYSTEMNODE_WINNER:
             if(systemnodePayments.mapSystemnodePayeeVotes.count(inv.hash)) {
                 systemnodeSync.AddedSystemnodeWinner(inv.hash);
@@ -86,13 +86,13 @@ bool AlreadyHaveMasternodeTypes(const CInv& inv, const CTxMemPool& mempool)
             }
             return false;
         case MSG_SYSTEMNODE_ANNOUNCE:
-            if(snodeman.mapSeenSystemnodeBroadcast.count(inv.hash)) {
+            if(snodeman.mapSeenSystemnodeBroadcast.IsSeen(inv.hash)) {
                 systemnodeSync.AddedSystemnodeList(inv.hash);
                 return true;
             }
             return false;
         case MSG_SYSTEMNODE_PING:
-            return snodeman.mapSeenSystemnodePing.count(inv.hash);
+            return snodeman.mapSeenSystemnodePing.IsSeen(inv.hash);
     }
     // Don't know what it is, just say we already got one
     return true;
@@ -132,21 +132,23 @@ void ProcessGetDataMasternodeTypes(CNode* pfrom, const CChainParams& chainparams
             }
         }
         if (!pushed && inv.type == MSG_MASTERNODE_ANNOUNCE) {
-            if(mnodeman.mapSeenMasternodeBroadcast.count(inv.hash)) {
+            auto it = mnodeman.mapSeenMasternodeBroadcast.find(inv.hash);
+            if(it != mnodeman.mapSeenMasternodeBroadcast.end()) {
                 if (pfrom->nVersion < MIN_MNW_PING_VERSION) {
-                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MNBROADCAST, mnodeman.mapSeenMasternodeBroadcast[inv.hash]));
+                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MNBROADCAST, it->second));
                 } else {
-                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MNBROADCAST2, mnodeman.mapSeenMasternodeBroadcast[inv.hash]));
+                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MNBROADCAST2, it->second));
                 }
                 pushed = true;
             }
         }
         if (!pushed && inv.type == MSG_MASTERNODE_PING) {
-            if(mnodeman.mapSeenMasternodePing.count(inv.hash)){
+            auto it = mnodeman.mapSeenMasternodePing.find(inv.hash);
+            if(it != mnodeman.mapSeenMasternodePing.end()){
                 if (pfrom->nVersion < MIN_MNW_PING_VERSION) {
-                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MNPING, mnodeman.mapSeenMasternodePing[inv.hash]));
+                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MNPING, it->second));
                 } else {
-                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MNPING2, mnodeman.mapSeenMasternodePing[inv.hash]));
+                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MNPING2, it->second));
                 }
                 pushed = true;
             }
@@ -160,14 +162,16 @@ void ProcessGetDataMasternodeTypes(CNode* pfrom, const CChainParams& chainparams
             }
         }
         if (!pushed && inv.type == MSG_SYSTEMNODE_ANNOUNCE) {
-            if(snodeman.mapSeenSystemnodeBroadcast.count(inv.hash)){
-                connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::SNBROADCAST, mnodeman.mapSeenMasternodeBroadcast[inv.hash]));
+            auto it = snodeman.mapSeenSystemnodeBroadcast.find(inv.hash);
+            if(it != snodeman.mapSeenSystemnodeBroadcast.end()){
+                connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::SNBROADCAST, it->second));
                 pushed = true;
             }
         }
         if (!pushed && inv.type == MSG_SYSTEMNODE_PING) {
-            if(snodeman.mapSeenSystemnodePing.count(inv.hash)){
-                connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::SNPING, mnodeman.mapSeenMasternodePing[inv.hash]));
+            auto it = snodeman.mapSeenSystemnodePing.find(inv.hash);
+            if(it != snodeman.mapSeenSystemnodePing.end()){
+                connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::SNPING, it->second));
                 pushed = true;
             }
         }
@@ -0,0 +1,66 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <msgstats.h>
+
+#include <net.h>
+#include <protocol.h>
+
+#include <algorithm>
+
+CMessageStats::TypeCounters::TypeCounters()
+{
+    for (auto& bucket : vHistogram)
+        bucket = 0;
+}
+
+CMessageStats::CMessageStats()
+{
+    for (const std::string& msg_type : getAllNetMessageTypes())
+        m_counters.emplace(std::piecewise_construct, std::forward_as_tuple(msg_type), std::forward_as_tuple());
+    m_counters.emplace(std::piecewise_construct, std::forward_as_tuple(NET_MESSAGE_COMMAND_OTHER), std::forward_as_tuple());
+}
+
+void CMessageStats::Record(const std::string& msg_type, uint64_t nBytes, std::chrono::microseconds duration)
+{
+    auto it = m_counters.find(msg_type);
+    if (it == m_counters.end())
+        it = m_counters.find(NET_MESSAGE_COMMAND_OTHER);
+    TypeCounters& counters = it->second;
+
+    const int64_t nMicros = std::max<int64_t>(duration.count(), 0);
+    counters.nCount.fetch_add(1, std::memory_order_relaxed);
+    counters.nBytes.fetch_add(nBytes, std::memory_order_relaxed);
+    counters.nTimeMicros.fetch_add(nMicros, std::memory_order_relaxed);
+    // single writer, no need for a compare and swap
+    if ((uint64_t)nMicros > counters.nMaxTimeMicros.load(std::memory_order_relaxed))
+        counters.nMaxTimeMicros.store(nMicros, std::memory_order_relaxed);
+
+    size_t nBucket = std::upper_bound(MSGSTATS_HISTOGRAM_BOUNDS.begin(), MSGSTATS_HISTOGRAM_BOUNDS.end(), nMicros) - MSGSTATS_HISTOGRAM_BOUNDS.begin();
+    counters.vHistogram[nBucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+CMessageStats& MessageStats()
+{
+    static CMessageStats stats;
+    return stats;
+}
+
+std::vector<CMessageTypeStats> CMessageStats::GetStats() const
+{
+    std::vector<CMessageTypeStats> vStats;
+    for (const auto& entry : m_counters) {
+        const TypeCounters& counters = entry.second;
+        CMessageTypeStats stats;
+        stats.strType = entry.first;
+        stats.nCount = counters.nCount.load(std::memory_order_relaxed);
+        stats.nBytes = counters.nBytes.load(std::memory_order_relaxed);
+        stats.nTimeMicros = counters.nTimeMicros.load(std::memory_order_relaxed);
+        stats.nMaxTimeMicros = counters.nMaxTimeMicros.load(std::memory_order_relaxed);
+        for (const auto& bucket : counters.vHistogram)
+            stats.vHistogram.push_back(bucket.load(std::memory_order_relaxed));
+        vStats.push_back(std::move(stats));
+    }
+    return vStats;
+}
@@ -0,0 +1,61 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef CROWN_MSGSTATS_H
+#define CROWN_MSGSTATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+//! Upper bounds of the handling time histogram buckets in microseconds, the last bucket is open
+static const std::array<int64_t, 6> MSGSTATS_HISTOGRAM_BOUNDS{{10, 100, 1000, 10000, 100000, 1000000}};
+static const size_t MSGSTATS_HISTOGRAM_BUCKETS = MSGSTATS_HISTOGRAM_BOUNDS.size() + 1;
+
+/** Copy of the statistics of one message type */
+struct CMessageTypeStats {
+    std::string strType;
+    uint64_t nCount;
+    uint64_t nBytes;
+    uint64_t nTimeMicros;
+    uint64_t nMaxTimeMicros;
+    std::vector<uint64_t> vHistogram;
+};
+
+/**
+ * Count, volume and handling time of received messages per message type.
+ *
+ * The set of types is fixed at construction, unknown types are counted as
+ * NET_MESSAGE_COMMAND_OTHER. Only the message handler thread records, so the
+ * counters are plain relaxed atomics and recording never takes a lock.
+ */
+class CMessageStats
+{
+private:
+    struct TypeCounters {
+        std::atomic<uint64_t> nCount{0};
+        std::atomic<uint64_t> nBytes{0};
+        std::atomic<uint64_t> nTimeMicros{0};
+        std::atomic<uint64_t> nMaxTimeMicros{0};
+        std::array<std::atomic<uint64_t>, MSGSTATS_HISTOGRAM_BUCKETS> vHistogram;
+
+        TypeCounters();
+    };
+
+    std::map<std::string, TypeCounters> m_counters;
+
+public:
+    CMessageStats();
+
+    void Record(const std::string& msg_type, uint64_t nBytes, std::chrono::microseconds duration);
+    std::vector<CMessageTypeStats> GetStats() const;
+};
+
+/** The statistics of this node, created on first use since the message types are static data of other units */
+CMessageStats& MessageStats();
+
+#endif // CROWN_MSGSTATS_H
@@ -36,6 +36,10 @@
 #include <poll.h>
 #endif
 
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
 #ifdef USE_UPNP
 #include <miniupnpc/miniupnpc.h>
 #include <miniupnpc/upnpcommands.h>
@@ -498,10 +502,21 @@ void CNode::CloseSocketDisconnect()
     if (hSocket != INVALID_SOCKET)
     {
         LogPrint(BCLog::NET, "disconnecting peer=%d\n", id);
+        UnregisterSocket();
         CloseSocket(hSocket);
     }
 }
 
+void CNode::UnregisterSocket()
+{
+#ifdef USE_EPOLL
+    if (m_epoll_fd != -1) {
+        epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, hSocket, nullptr);
+        m_epoll_fd = -1;
+    }
+#endif
+}
+
 void CConnman::AddWhitelistPermissionFlags(NetPermissionFlags& flags, const CNetAddr &addr) const {
     for (const auto& subnet : vWhitelistedRange) {
         if (subnet.m_subnet.Match(addr)) NetPermissions::AddFlag(flags, subnet.m_flags);
@@ -1313,7 +1328,70 @@ bool CConnman::GenerateSelectSet(std::set<SOCKET> &recv_set, std::set<SOCKET> &s
     return !recv_set.empty() || !send_set.empty() || !error_set.empty();
 }
 
-#ifdef USE_POLL
+#ifdef USE_EPOLL
+void CConnman::SocketEvents(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set)
+{
+    // Unlike with poll() and select(), the sockets stay registered with the
+    // kernel: only a change of the events waited for, which follow the logic
+    // of GenerateSelectSet(), is passed on. A socket is unregistered right
+    // before it is closed.
+    size_t nSockets = vhListenSocket.size();
+    {
+        LOCK(cs_vNodes);
+        for (CNode* pnode : vNodes)
+        {
+            bool select_recv = !pnode->fPauseRecv;
+            bool select_send;
+            {
+                LOCK(pnode->cs_vSend);
+                select_send = !pnode->vSendMsg.empty();
+            }
+
+            LOCK(pnode->cs_hSocket);
+            if (pnode->hSocket == INVALID_SOCKET)
+                continue;
+            nSockets++;
+
+            uint32_t events = 0;
+            if (select_send) {
+                events = EPOLLOUT;
+            } else if (select_recv) {
+                events = EPOLLIN;
+            }
+            if (pnode->m_epoll_fd == m_epoll_fd && pnode->m_epoll_events == events)
+                continue;
+            struct epoll_event event;
+            event.events = events;
+            event.data.fd = pnode->hSocket;
+            if (epoll_ctl(m_epoll_fd, pnode->m_epoll_fd == m_epoll_fd ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, pnode->hSocket, &event) != 0) {
+                LogPrintf("socket epoll_ctl error for peer=%d: %s\n", pnode->GetId(), NetworkErrorString(WSAGetLastError()));
+                pnode->fDisconnect = true;
+                continue;
+            }
+            pnode->m_epoll_fd = m_epoll_fd;
+            pnode->m_epoll_events = events;
+        }
+    }
+
+    if (nSockets == 0) {
+        interruptNet.sleep_for(std::chrono::milliseconds(SELECT_TIMEOUT_MILLISECONDS));
+        return;
+    }
+
+    std::vector<struct epoll_event> vevents(nSockets);
+    int nEvents = epoll_wait(m_epoll_fd, vevents.data(), vevents.size(), SELECT_TIMEOUT_MILLISECONDS);
+    if (nEvents < 0) return;
+
+    if (interruptNet) return;
+
+    for (int i = 0; i < nEvents; i++) {
+        const SOCKET hSocket = vevents[i].data.fd;
+        if (vevents[i].events & EPOLLIN)              recv_set.insert(hSocket);
+        if (vevents[i].events & EPOLLOUT)             send_set.insert(hSocket);
+        if (vevents[i].events & (EPOLLERR|EPOLLHUP))  error_set.insert(hSocket);
+    }
+}
+#elif defined(USE_POLL)
 void CConnman::SocketEvents(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set)
 {
     std::set<SOCKET> recv_select_set, send_select_set, error_select_set;
@@ -2367,6 +2445,19 @@ bool CConnman::BindListenPort(const CService& addrBind, bilingual_str& strError,
         return false;
     }
 
+#ifdef USE_EPOLL
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = hListenSocket;
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, hListenSocket, &event) != 0)
+    {
+        strError = strprintf(_("Error: Listening for incoming connections failed (epoll_ctl returned error %s)"), NetworkErrorString(WSAGetLastError()));
+        LogPrintf("%s\n", strError.original);
+        CloseSocket(hListenSocket);
+        return false;
+    }
+#endif
+
     vhListenSocket.push_back(ListenSocket(hListenSocket, permissions));
     return true;
 }
@@ -2440,6 +2531,13 @@ CConnman::CConnman(uint64_t nSeed0In, uint64_t nSeed1In, bool network_active)
 {
     SetTryNewOutboundPeer(false);
 
+#ifdef USE_EPOLL
+    m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll_fd == -1) {
+        LogPrintf("epoll_create1 failed: %s\n", NetworkErrorString(WSAGetLastError()));
+    }
+#endif
+
     Options connOptions;
     Init(connOptions);
     SetNetworkActive(network_active);
@@ -2501,6 +2599,17 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
 {
     Init(connOptions);
 
+#ifdef USE_EPOLL
+    if (m_epoll_fd == -1) {
+        if (clientInterface) {
+            clientInterface->ThreadSafeMessageBox(
+                _("Failed to create the socket event queue."),
+                "", CClientUIInterface::MSG_ERROR);
+        }
+        return false;
+    }
+#endif
+
     {
         LOCK(cs_totalBytesRecv);
         nTotalBytesRecv = 0;
@@ -2696,9 +2805,14 @@ void CConnman::StopNodes()
     for (CNode* pnode : vNodes)
         pnode->CloseSocketDisconnect();
     for (ListenSocket& hListenSocket : vhListenSocket)
-        if (hListenSocket.socket != INVALID_SOCKET)
+        if (hListenSocket.socket != INVALID_SOCKET) {
+#ifdef USE_EPOLL
+            if (m_epoll_fd != -1)
+                epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, hListenSocket.socket, nullptr);
+#endif
             if (!CloseSocket(hListenSocket.socket))
                 LogPrintf("CloseSocket(hListenSocket) failed with error %s\n", NetworkErrorString(WSAGetLastError()));
+        }
 
     // clean up some globals (to help leak detection)
     for (CNode* pnode : vNodes) {
@@ -2730,6 +2844,11 @@ CConnman::~CConnman()
 {
     Interrupt();
     Stop();
+#ifdef USE_EPOLL
+    if (m_epoll_fd != -1) {
+        close(m_epoll_fd);
+    }
+#endif
 }
 
 void CConnman::SetServices(const CService &addr, ServiceFlags nServices)
@@ -3067,6 +3186,10 @@ CNode::CNode(NodeId idIn, ServiceFlags nLocalServicesIn, int nMyStartingHeightIn
 
 CNode::~CNode()
 {
+    if (hSocket != INVALID_SOCKET) {
+        LOCK(cs_hSocket);
+        UnregisterSocket();
+    }
     CloseSocket(hSocket);
 }
 
@@ -3191,7 +3314,7 @@ std::vector<CNode*> CConnman::CopyNodeVector()
 void CConnman::ReleaseNodeVector(const std::vector<CNode*>& vecNodes)
 {
     LOCK(cs_vNodes);
-    for (auto&& pnode : vNodes) {
+    for (auto&& pnode : vecNodes) {
         LogPrint(BCLog::NET, "CConnman::ReleaseNodeVector -- releasing node: peer=%d addr=%s nRefCount=%d fNetworkNode=%d fInbound=%d fMasternode=%d\n",
                   pnode->id, pnode->addr.ToString(), pnode->GetRefCount(), pnode->fNetworkNode, pnode->fInbound, pnode->fMasternode);
         pnode->Release();
@@ -516,6 +516,10 @@ private:
     unsigned int nReceiveFloodSize{0};
 
     std::vector<ListenSocket> vhListenSocket;
+#ifdef USE_EPOLL
+    //! epoll instance the listening and peer sockets stay registered with
+    int m_epoll_fd{-1};
+#endif
     std::atomic<bool> fNetworkActive{true};
     bool fAddressesInitialized{false};
     std::deque<std::string> m_addr_fetches GUARDED_BY(m_addr_fetches_mutex);
@@ -873,6 +877,11 @@ public:
     // socket
     std::atomic<ServiceFlags> nServices{NODE_NONE};
     SOCKET hSocket GUARDED_BY(cs_hSocket);
+#ifdef USE_EPOLL
+    //! epoll instance hSocket is registered with, -1 if none
+    int m_epoll_fd GUARDED_BY(cs_hSocket){-1};
+    uint32_t m_epoll_events GUARDED_BY(cs_hSocket){0};
+#endif
     size_t nSendSize{0}; // total size of all vSendMsg entries
     size_t nSendOffset{0}; // offset inside the first vSendMsg already sent
     uint64_t nSendBytes GUARDED_BY(cs_vSend){0};
@@ -1252,6 +1261,8 @@ public:
     void AskForBlock(const CInv& inv);
 
     void CloseSocketDisconnect();
+    //! Remove hSocket from the epoll instance of the socket thread, if any
+    void UnregisterSocket() EXCLUSIVE_LOCKS_REQUIRED(cs_hSocket);
 
     void copyStats(CNodeStats &stats, const std::vector<bool> &m_asmap);
 
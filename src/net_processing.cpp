@@ -15,6 +15,7 @@
 #include <index/blockfilterindex.h>
 #include <merkleblock.h>
 #include <mn_processing.h>
+#include <msgstats.h>
 #include <netbase.h>
 #include <netmessagemaker.h>
 #include <policy/fees.h>
@@ -1678,10 +1679,9 @@ void static ProcessGetBlockData(CNode& pfrom, const CChainParams& chainparams, c
             // Don't set pblock as we've sent the block
         } else {
             // Send block from disk
-            std::shared_ptr<CBlock> pblockRead = std::make_shared<CBlock>();
-            if (!ReadBlockFromDisk(*pblockRead, pindex, consensusParams))
+            pblock = ReadBlockFromDisk(pindex, consensusParams);
+            if (!pblock)
                 assert(!"cannot load block from disk");
-            pblock = pblockRead;
         }
         if (pblock) {
             if (inv.IsMsgBlk()) {
@@ -3993,6 +3993,7 @@ bool PeerManager::ProcessMessages(CNode* pfrom, std::atomic<bool>& interruptMsgP
     // Message size
     unsigned int nMessageSize = msg.m_message_size;
 
+    const auto time_start = std::chrono::steady_clock::now();
     try {
         ProcessMessage(*pfrom, msg_type, msg.m_recv, msg.m_time, interruptMsgProc);
         if (interruptMsgProc) return false;
@@ -4005,6 +4006,7 @@ bool PeerManager::ProcessMessages(CNode* pfrom, std::atomic<bool>& interruptMsgP
     } catch (...) {
         LogPrint(BCLog::NET, "%s(%s, %u bytes): Unknown exception caught\n", __func__, SanitizeString(msg_type), nMessageSize);
     }
+    MessageStats().Record(msg_type, nMessageSize, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - time_start));
 
     return fMoreWork;
 }
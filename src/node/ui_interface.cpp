@@ -4,6 +4,7 @@
 
 #include <node/ui_interface.h>
 
+#include <primitives/transaction.h>
 #include <util/translation.h>
 
 #include <boost/signals2/optional_last_value.hpp>
@@ -23,6 +24,8 @@ struct UISignals {
     boost::signals2::signal<CClientUIInterface::NotifyHeaderTipSig> NotifyHeaderTip;
     boost::signals2::signal<CClientUIInterface::BannedListChangedSig> BannedListChanged;
     boost::signals2::signal<CClientUIInterface::NotifyAdditionalDataSyncProgressChangedSig> NotifyAdditionalDataSyncProgressChanged;
+    boost::signals2::signal<CClientUIInterface::NotifyMasternodeChangedSig> NotifyMasternodeChanged;
+    boost::signals2::signal<CClientUIInterface::NotifySystemnodeChangedSig> NotifySystemnodeChanged;
 };
 static UISignals g_ui_signals;
 
@@ -43,6 +46,8 @@ ADD_SIGNALS_IMPL_WRAPPER(NotifyBlockTip);
 ADD_SIGNALS_IMPL_WRAPPER(NotifyHeaderTip);
 ADD_SIGNALS_IMPL_WRAPPER(BannedListChanged);
 ADD_SIGNALS_IMPL_WRAPPER(NotifyAdditionalDataSyncProgressChanged);
+ADD_SIGNALS_IMPL_WRAPPER(NotifyMasternodeChanged);
+ADD_SIGNALS_IMPL_WRAPPER(NotifySystemnodeChanged);
 
 bool CClientUIInterface::ThreadSafeMessageBox(const bilingual_str& message, const std::string& caption, unsigned int style) { return g_ui_signals.ThreadSafeMessageBox(message, caption, style).value_or(false);}
 bool CClientUIInterface::ThreadSafeQuestion(const bilingual_str& message, const std::string& non_interactive_message, const std::string& caption, unsigned int style) { return g_ui_signals.ThreadSafeQuestion(message, non_interactive_message, caption, style).value_or(false);}
@@ -55,6 +60,8 @@ void CClientUIInterface::NotifyBlockTip(SynchronizationState s, const CBlockInde
 void CClientUIInterface::NotifyHeaderTip(SynchronizationState s, const CBlockIndex* i) { return g_ui_signals.NotifyHeaderTip(s, i); }
 void CClientUIInterface::BannedListChanged() { return g_ui_signals.BannedListChanged(); }
 void CClientUIInterface::NotifyAdditionalDataSyncProgressChanged(double nSyncProgress) { return g_ui_signals.NotifyAdditionalDataSyncProgressChanged(nSyncProgress); }
+void CClientUIInterface::NotifyMasternodeChanged(const COutPoint& outpoint, ChangeType status) { return g_ui_signals.NotifyMasternodeChanged(outpoint, status); }
+void CClientUIInterface::NotifySystemnodeChanged(const COutPoint& outpoint, ChangeType status) { return g_ui_signals.NotifySystemnodeChanged(outpoint, status); }
 
 bool InitError(const bilingual_str& str)
 {
@@ -6,11 +6,14 @@
 #ifndef BITCOIN_NODE_UI_INTERFACE_H
 #define BITCOIN_NODE_UI_INTERFACE_H
 
+#include <util/ui_change_type.h>
+
 #include <functional>
 #include <memory>
 #include <string>
 
 class CBlockIndex;
+class COutPoint;
 enum class SynchronizationState;
 struct bilingual_str;
 
@@ -110,6 +113,12 @@ public:
 
     /** Banlist did change. */
     ADD_SIGNALS_DECL_WRAPPER(BannedListChanged, void, void);
+
+    /** Masternode list entry added, updated or removed, a null outpoint means the whole list changed. */
+    ADD_SIGNALS_DECL_WRAPPER(NotifyMasternodeChanged, void, const COutPoint& outpoint, ChangeType status);
+
+    /** Systemnode list entry added, updated or removed, a null outpoint means the whole list changed. */
+    ADD_SIGNALS_DECL_WRAPPER(NotifySystemnodeChanged, void, const COutPoint& outpoint, ChangeType status);
 };
 
 /** Show warning message **/
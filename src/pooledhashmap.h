@@ -0,0 +1,420 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef CROWN_POOLEDHASHMAP_H
+#define CROWN_POOLEDHASHMAP_H
+
+#include <memusage.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Hash map with open addressing, whose entries are allocated from a pool.
+ *
+ * The table is a flat array of 8 byte slots, holding a tag from the hash and
+ * the index of the entry in the pool, probed linearly. A lookup reads a few
+ * adjacent slots and only the entries whose tag matches, instead of walking
+ * the heap allocated nodes of a bucket. The pool hands out entries from
+ * chunks of equal size, set with set_pool_budget(), and recycles erased ones
+ * through a free list. clear() keeps the table and the chunks for the next
+ * fill.
+ *
+ * Entries never move: references to them stay valid until they are erased,
+ * as with std::unordered_map. Erasing leaves the other slots in place, so a
+ * map can be erased from while it is iterated. Inserting invalidates the
+ * iterators.
+ */
+template <typename K, typename V, typename Hash>
+class PooledHashMap
+{
+public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<const K, V> value_type;
+    typedef size_t size_type;
+
+private:
+    struct Slot {
+        uint32_t tag{0};
+        //! REF_EMPTY, REF_ERASED or the pool index of the entry plus REF_FIRST
+        uint32_t ref{0};
+    };
+    static const uint32_t REF_EMPTY = 0;
+    static const uint32_t REF_ERASED = 1;
+    static const uint32_t REF_FIRST = 2;
+    static const uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+
+    typedef typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type Node;
+    static_assert(sizeof(Node) >= sizeof(uint32_t), "erased nodes link to the next free one");
+
+    static const size_t MIN_CAPACITY = 8;
+    //! log2 of the nodes in a chunk of the pool
+    static const int DEFAULT_CHUNK_SHIFT = 5;
+    static const int MAX_CHUNK_SHIFT = 16;
+
+    Hash m_hasher;
+    std::vector<Slot> m_slots;
+    size_t m_size{0};
+    size_t m_erased{0};
+
+    std::vector<std::unique_ptr<Node[]>> m_chunks;
+    int m_chunk_shift{DEFAULT_CHUNK_SHIFT};
+    //! Chunk size taken when the pool is empty the next time
+    int m_budget_chunk_shift{DEFAULT_CHUNK_SHIFT};
+    //! Nodes below this index were handed out before
+    uint32_t m_next_node{0};
+    uint32_t m_free_node{NO_NODE};
+
+    static uint32_t Tag(size_t hash) { return (uint32_t)((uint64_t)hash >> 32); }
+    static bool IsUsed(const Slot& slot) { return slot.ref >= REF_FIRST; }
+
+    value_type* Entry(const Slot& slot) const
+    {
+        const uint32_t node = slot.ref - REF_FIRST;
+        return reinterpret_cast<value_type*>(&m_chunks[node >> m_chunk_shift][node & ((1U << m_chunk_shift) - 1)]);
+    }
+
+    template <bool Const>
+    class Iterator
+    {
+    private:
+        typedef typename std::conditional<Const, const Slot*, Slot*>::type SlotPtr;
+        const PooledHashMap* map;
+        SlotPtr p;
+        SlotPtr end;
+
+        void Skip()
+        {
+            while (p != end && !IsUsed(*p))
+                ++p;
+        }
+
+        friend class PooledHashMap;
+        friend class Iterator<true>;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename std::conditional<Const, const typename PooledHashMap::value_type, typename PooledHashMap::value_type>::type value_type;
+        typedef ptrdiff_t difference_type;
+        typedef value_type* pointer;
+        typedef value_type& reference;
+
+        Iterator() : map(nullptr), p(nullptr), end(nullptr) {}
+        Iterator(const PooledHashMap* mapIn, SlotPtr pIn, SlotPtr endIn) : map(mapIn), p(pIn), end(endIn) { Skip(); }
+        template <bool C = Const, typename = typename std::enable_if<C>::type>
+        Iterator(const Iterator<false>& it) : map(it.map), p(it.p), end(it.end) {}
+
+        reference operator*() const { return *map->Entry(*p); }
+        pointer operator->() const { return map->Entry(*p); }
+        Iterator& operator++()
+        {
+            ++p;
+            Skip();
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator copy(*this);
+            ++(*this);
+            return copy;
+        }
+        bool operator==(const Iterator& it) const { return p == it.p; }
+        bool operator!=(const Iterator& it) const { return p != it.p; }
+    };
+
+public:
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    PooledHashMap() {}
+    ~PooledHashMap() { DestroyEntries(); }
+
+    PooledHashMap(const PooledHashMap&) = delete;
+    PooledHashMap& operator=(const PooledHashMap&) = delete;
+
+    iterator begin() { return MakeIterator(m_slots.data()); }
+    iterator end() { return MakeIterator(m_slots.data() + m_slots.size()); }
+    const_iterator begin() const { return const_iterator(this, m_slots.data(), m_slots.data() + m_slots.size()); }
+    const_iterator end() const { return const_iterator(this, m_slots.data() + m_slots.size(), m_slots.data() + m_slots.size()); }
+
+    size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    size_type bucket_count() const { return m_slots.size(); }
+
+    iterator find(const K& key)
+    {
+        Slot* slot = FindSlot(key, m_hasher(key));
+        return slot ? MakeIterator(slot) : end();
+    }
+
+    const_iterator find(const K& key) const
+    {
+        const Slot* slot = const_cast<PooledHashMap*>(this)->FindSlot(key, m_hasher(key));
+        return slot ? const_iterator(this, slot, m_slots.data() + m_slots.size()) : end();
+    }
+
+    size_type count(const K& key) const { return find(key) != end() ? 1 : 0; }
+
+    V& at(const K& key)
+    {
+        iterator it = find(key);
+        if (it == end())
+            throw std::out_of_range("PooledHashMap::at");
+        return it->second;
+    }
+
+    const V& at(const K& key) const
+    {
+        const_iterator it = find(key);
+        if (it == end())
+            throw std::out_of_range("PooledHashMap::at");
+        return it->second;
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        const uint32_t node = Allocate();
+        value_type* entry = reinterpret_cast<value_type*>(&NodeAt(node));
+        try {
+            ::new (entry) value_type(std::forward<Args>(args)...);
+        } catch (...) {
+            Release(node);
+            throw;
+        }
+
+        const size_t hash = m_hasher(entry->first);
+        if (Slot* slot = FindSlot(entry->first, hash)) {
+            entry->~value_type();
+            Release(node);
+            return std::make_pair(MakeIterator(slot), false);
+        }
+        return std::make_pair(Insert(hash, node), true);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) { return emplace(value); }
+
+    V& operator[](const K& key)
+    {
+        iterator it = find(key);
+        if (it != end())
+            return it->second;
+        return emplace(std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>()).first->second;
+    }
+
+    //! Returns the iterator following the erased entry
+    iterator erase(const_iterator pos)
+    {
+        Slot* slot = const_cast<Slot*>(pos.p);
+        Entry(*slot)->~value_type();
+        Release(slot->ref - REF_FIRST);
+        m_size--;
+
+        // an erased slot followed by an empty one ends no probe sequence, it can be emptied
+        Slot* const pBegin = m_slots.data();
+        Slot* const pEnd = pBegin + m_slots.size();
+        const Slot* pNext = slot + 1 == pEnd ? pBegin : slot + 1;
+        if (pNext->ref == REF_EMPTY) {
+            slot->ref = REF_EMPTY;
+            // and so can the erased slots before it
+            Slot* pPrev = slot == pBegin ? pEnd - 1 : slot - 1;
+            while (pPrev->ref == REF_ERASED) {
+                pPrev->ref = REF_EMPTY;
+                m_erased--;
+                pPrev = pPrev == pBegin ? pEnd - 1 : pPrev - 1;
+            }
+        } else {
+            slot->ref = REF_ERASED;
+            m_erased++;
+        }
+        return MakeIterator(slot + 1);
+    }
+
+    size_type erase(const K& key)
+    {
+        const_iterator it = find(key);
+        if (it == end())
+            return 0;
+        erase(it);
+        return 1;
+    }
+
+    //! Exchange the contents with other. References to entries stay valid, iterators don't
+    void swap(PooledHashMap& other)
+    {
+        // salted hashers aren't assignable, the slots depend on the salt
+        Hash hasher(m_hasher);
+        m_hasher.~Hash();
+        ::new (&m_hasher) Hash(other.m_hasher);
+        other.m_hasher.~Hash();
+        ::new (&other.m_hasher) Hash(hasher);
+        m_slots.swap(other.m_slots);
+        std::swap(m_size, other.m_size);
+        std::swap(m_erased, other.m_erased);
+        m_chunks.swap(other.m_chunks);
+        std::swap(m_chunk_shift, other.m_chunk_shift);
+        std::swap(m_budget_chunk_shift, other.m_budget_chunk_shift);
+        std::swap(m_next_node, other.m_next_node);
+        std::swap(m_free_node, other.m_free_node);
+    }
+
+    //! Erase every entry, the table and the pool are kept for the next fill
+    void clear()
+    {
+        DestroyEntries();
+        std::fill(m_slots.begin(), m_slots.end(), Slot());
+        m_size = 0;
+        m_erased = 0;
+        m_next_node = 0;
+        m_free_node = NO_NODE;
+        if (m_chunk_shift != m_budget_chunk_shift) {
+            m_chunks.clear();
+            m_chunk_shift = m_budget_chunk_shift;
+        }
+    }
+
+    void reserve(size_type n)
+    {
+        if (n * 4 > m_slots.size() * 3)
+            Rehash(CapacityFor(n));
+    }
+
+    /**
+     * Size the chunks of the pool to a 64th of nBytes, so that a map filling
+     * a memory budget of nBytes needs few allocations and leaves little of
+     * the last chunk unused. Takes effect once the map is empty.
+     */
+    void set_pool_budget(size_t nBytes)
+    {
+        int nShift = 0;
+        while (nShift < MAX_CHUNK_SHIFT && (sizeof(Node) << (nShift + 1)) <= nBytes / 64)
+            nShift++;
+        m_budget_chunk_shift = nShift;
+        if (m_next_node == 0) {
+            m_chunks.clear();
+            m_chunk_shift = nShift;
+        }
+    }
+
+    size_t DynamicMemoryUsage() const
+    {
+        return memusage::MallocUsage(m_slots.capacity() * sizeof(Slot)) +
+               memusage::MallocUsage(m_chunks.capacity() * sizeof(std::unique_ptr<Node[]>)) +
+               m_chunks.size() * memusage::MallocUsage(sizeof(Node) << m_chunk_shift);
+    }
+
+private:
+    static size_t CapacityFor(size_t n)
+    {
+        size_t nCapacity = MIN_CAPACITY;
+        while (n * 2 > nCapacity)
+            nCapacity *= 2;
+        return nCapacity;
+    }
+
+    iterator MakeIterator(Slot* slot) { return iterator(this, slot, m_slots.data() + m_slots.size()); }
+
+    Node& NodeAt(uint32_t node) { return m_chunks[node >> m_chunk_shift][node & ((1U << m_chunk_shift) - 1)]; }
+
+    Slot* FindSlot(const K& key, size_t hash)
+    {
+        if (m_slots.empty())
+            return nullptr;
+        const uint32_t tag = Tag(hash);
+        const size_t mask = m_slots.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            Slot& slot = m_slots[i];
+            if (slot.ref == REF_EMPTY)
+                return nullptr;
+            if (slot.tag == tag && IsUsed(slot) && Entry(slot)->first == key)
+                return &slot;
+        }
+    }
+
+    iterator Insert(size_t hash, uint32_t node)
+    {
+        // keep a quarter of the slots empty, erased ones count as used
+        if ((m_size + m_erased + 1) * 4 > m_slots.size() * 3)
+            Rehash(CapacityFor(m_size + 1));
+
+        const size_t mask = m_slots.size() - 1;
+        size_t i = hash & mask;
+        while (IsUsed(m_slots[i]))
+            i = (i + 1) & mask;
+        if (m_slots[i].ref == REF_ERASED)
+            m_erased--;
+        m_slots[i].tag = Tag(hash);
+        m_slots[i].ref = node + REF_FIRST;
+        m_size++;
+        return MakeIterator(&m_slots[i]);
+    }
+
+    void Rehash(size_t nCapacity)
+    {
+        // the slots keep no full hash, so the keys are hashed again
+        std::vector<Slot> slots(std::max(nCapacity, m_slots.size()));
+        const size_t mask = slots.size() - 1;
+        for (const Slot& slot : m_slots) {
+            if (!IsUsed(slot))
+                continue;
+            size_t i = m_hasher(Entry(slot)->first) & mask;
+            while (IsUsed(slots[i]))
+                i = (i + 1) & mask;
+            slots[i] = slot;
+        }
+        m_slots.swap(slots);
+        m_erased = 0;
+    }
+
+    uint32_t Allocate()
+    {
+        if (m_free_node != NO_NODE) {
+            const uint32_t node = m_free_node;
+            memcpy(&m_free_node, &NodeAt(node), sizeof(m_free_node));
+            return node;
+        }
+        if (m_next_node >= NO_NODE - REF_FIRST)
+            throw std::length_error("PooledHashMap: too many entries");
+        if ((m_next_node >> m_chunk_shift) == m_chunks.size())
+            m_chunks.emplace_back(new Node[(size_t)1 << m_chunk_shift]);
+        return m_next_node++;
+    }
+
+    void Release(uint32_t node)
+    {
+        memcpy(&NodeAt(node), &m_free_node, sizeof(m_free_node));
+        m_free_node = node;
+    }
+
+    void DestroyEntries()
+    {
+        if (std::is_trivially_destructible<value_type>::value)
+            return;
+        for (const Slot& slot : m_slots) {
+            if (IsUsed(slot))
+                Entry(slot)->~value_type();
+        }
+    }
+};
+
+namespace memusage {
+template <typename K, typename V, typename Hash>
+static inline size_t DynamicUsage(const PooledHashMap<K, V, Hash>& m)
+{
+    return m.DynamicMemoryUsage();
+}
+} // namespace memusage
+
+#endif // CROWN_POOLEDHASHMAP_H
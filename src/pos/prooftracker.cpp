@@ -1,59 +1,105 @@
 #include <pos/blockwitness.h>
 #include <pos/prooftracker.h>
 
+#include <crypto/siphash.h>
+#include <memusage.h>
+#include <random.h>
+
+#include <algorithm>
+#include <limits>
+
 #define REQUIRED_WITNESS_SIGS 6
 #define STAKE_REPACKAGE_THRESHOLD 3
 
+SaltedProofHasher::SaltedProofHasher() : k0(GetRand(std::numeric_limits<uint64_t>::max())), k1(GetRand(std::numeric_limits<uint64_t>::max())) {}
+
+size_t SaltedProofHasher::operator()(const uint256& hash) const
+{
+    return SipHashUint256(k0, k1, hash);
+}
+
 void ProofTracker::AddNewStake(const STAKEHASH& hashStake, const BLOCKHASH& hashBlock, int nHeight)
 {
-    if (!m_mapStakes.count(hashStake))
-        m_mapStakes.emplace(std::make_pair(hashStake, std::make_pair(nHeight, std::set<BLOCKHASH>())));
-    m_mapStakes.at(hashStake).second.emplace(hashBlock);
+    auto it = m_mapStakes.find(hashStake);
+    if (it == m_mapStakes.end()) {
+        it = m_mapStakes.emplace(hashStake, std::vector<BLOCKHASH>()).first;
+        m_mapBuckets[nHeight].vStakes.emplace_back(hashStake);
+    }
+
+    // Only the count up to the threshold matters, so a ground stake can never grow this past a few entries
+    std::vector<BLOCKHASH>& vBlocks = it->second;
+    if (vBlocks.size() >= STAKE_REPACKAGE_THRESHOLD)
+        return;
+    if (std::find(vBlocks.begin(), vBlocks.end(), hashBlock) == vBlocks.end())
+        vBlocks.emplace_back(hashBlock);
 }
 
 void ProofTracker::AddWitness(const BlockWitness& witness)
 {
-    if (!m_mapBlockWitness.count(witness.m_hashBlock))
-        m_mapBlockWitness.emplace(std::make_pair(witness.m_hashBlock, std::set<BlockWitness>()));
-    m_mapBlockWitness.at(witness.m_hashBlock).emplace(witness);
+    auto it = m_mapBlockWitness.find(witness.m_hashBlock);
+    if (it == m_mapBlockWitness.end()) {
+        // Pings reference recent blocks, so file the witnesses under the best height we have seen
+        it = m_mapBlockWitness.emplace(witness.m_hashBlock, std::vector<COutPoint>()).first;
+        m_mapBuckets[m_nBestHeight].vBlocks.emplace_back(witness.m_hashBlock);
+    }
+
+    std::vector<COutPoint>& vWitness = it->second;
+    const COutPoint& outpoint = witness.m_vin.prevout;
+    auto pos = std::lower_bound(vWitness.begin(), vWitness.end(), outpoint);
+    if (pos == vWitness.end() || *pos != outpoint)
+        vWitness.insert(pos, outpoint);
 }
 
-std::set<BlockWitness> ProofTracker::GetWitnesses(const uint256& hashBlock) const
+std::vector<BlockWitness> ProofTracker::GetWitnesses(const uint256& hashBlock) const
 {
-    if (m_mapBlockWitness.count(hashBlock))
-        return m_mapBlockWitness.at(hashBlock);
-    return std::set<BlockWitness>();
+    std::vector<BlockWitness> vWitness;
+    auto it = m_mapBlockWitness.find(hashBlock);
+    if (it == m_mapBlockWitness.end())
+        return vWitness;
+
+    vWitness.reserve(it->second.size());
+    for (const COutPoint& outpoint : it->second)
+        vWitness.emplace_back(CTxIn(outpoint), hashBlock);
+    return vWitness;
 }
 
 int ProofTracker::GetWitnessCount(const BLOCKHASH& hashBlock) const
 {
-    if (!m_mapBlockWitness.count(hashBlock))
+    auto it = m_mapBlockWitness.find(hashBlock);
+    if (it == m_mapBlockWitness.end())
         return 0;
-    return m_mapBlockWitness.at(hashBlock).size();
+    return it->second.size();
 }
 
 bool ProofTracker::HasSufficientProof(const BLOCKHASH& hashBlock) const
 {
-    return m_mapBlockWitness.count(hashBlock) && m_mapBlockWitness.at(hashBlock).size() >= REQUIRED_WITNESS_SIGS;
+    return GetWitnessCount(hashBlock) >= REQUIRED_WITNESS_SIGS;
 }
 
 bool ProofTracker::IsSuspicious(const STAKEHASH& hashStake, const BLOCKHASH& hashBlock, int nHeight)
 {
-    if (!m_mapStakes.count(hashStake)) {
+    if (nHeight > m_nBestHeight) {
+        // Witnesses received before the first block was checked have no height yet, move them up
+        // so the first prune does not drop them
+        if (m_nBestHeight == 0 && m_mapBuckets.count(0)) {
+            std::vector<BLOCKHASH>& vBlocks = m_mapBuckets[nHeight].vBlocks;
+            const std::vector<BLOCKHASH>& vUnknown = m_mapBuckets.at(0).vBlocks;
+            vBlocks.insert(vBlocks.end(), vUnknown.begin(), vUnknown.end());
+            m_mapBuckets.erase(0);
+        }
+        m_nBestHeight = nHeight;
+    }
+
+    auto it = m_mapStakes.find(hashStake);
+    if (it == m_mapStakes.end()) {
         AddNewStake(hashStake, hashBlock, nHeight);
         return false;
     }
 
-    if (m_mapStakes.at(hashStake).second.size() >= STAKE_REPACKAGE_THRESHOLD) {
+    if (it->second.size() >= STAKE_REPACKAGE_THRESHOLD) {
         //If there are enough masternode that has signed off on this hash then it is not suspicious
-        if (!m_mapBlockWitness.count(hashBlock))
-            return true; //suspicious because no records of mn signing this block
-
-        // Factored out for legibility...
-        const auto& vWitness = m_mapBlockWitness.at(hashBlock);
-        bool isSuspicious = vWitness.size() < REQUIRED_WITNESS_SIGS;
-        if (isSuspicious)
-            return isSuspicious;
+        if (!HasSufficientProof(hashBlock))
+            return true; //suspicious because not enough records of mn signing this block
     }
 
     //Not suspicious, but still record knowledge of this stake so potential suspicious repackaging of this stake
@@ -64,20 +110,24 @@ bool ProofTracker::IsSuspicious(const STAKEHASH& hashStake, const BLOCKHASH& has
 
 void ProofTracker::EraseBeforeHeight(int nHeight)
 {
-    std::set<uint256> setErase;
-    for (const auto& p : m_mapStakes) {
-        int nBlockHeight = p.second.first;
-        if (nBlockHeight < nHeight) {
-            setErase.emplace(p.first);
-            //Erase all witnesses associated with this stake hash
-            const std::set<BLOCKHASH>& setWitness = p.second.second;
-            for (const uint256& hashBlock : setWitness) {
-                m_mapBlockWitness.erase(hashBlock);
-            }
-        }
+    auto itEnd = m_mapBuckets.lower_bound(nHeight);
+    for (auto it = m_mapBuckets.begin(); it != itEnd; ++it) {
+        for (const STAKEHASH& hashStake : it->second.vStakes)
+            m_mapStakes.erase(hashStake);
+        for (const BLOCKHASH& hashBlock : it->second.vBlocks)
+            m_mapBlockWitness.erase(hashBlock);
     }
+    m_mapBuckets.erase(m_mapBuckets.begin(), itEnd);
+}
 
-    for (const uint256& hashStake : setErase) {
-        m_mapStakes.erase(hashStake);
-    }
+size_t ProofTracker::DynamicMemoryUsage() const
+{
+    size_t nUsage = memusage::DynamicUsage(m_mapBuckets) + memusage::DynamicUsage(m_mapStakes) + memusage::DynamicUsage(m_mapBlockWitness);
+    for (const auto& bucket : m_mapBuckets)
+        nUsage += memusage::DynamicUsage(bucket.second.vStakes) + memusage::DynamicUsage(bucket.second.vBlocks);
+    for (const auto& stake : m_mapStakes)
+        nUsage += memusage::DynamicUsage(stake.second);
+    for (const auto& witness : m_mapBlockWitness)
+        nUsage += memusage::DynamicUsage(witness.second);
+    return nUsage;
 }
@@ -1,28 +1,57 @@
 #ifndef PROOFTRACKER_H
 #define PROOFTRACKER_H
 
+#include <primitives/transaction.h>
+#include <uint256.h>
+
 #include <map>
-#include <set>
+#include <unordered_map>
+#include <vector>
 
 class BlockWitness;
-class uint256;
 
 typedef uint256 BLOCKHASH;
 typedef uint256 STAKEHASH;
 
+/** Salted hasher for the stake/block indexes, stake hashes can be ground by an attacker */
+class SaltedProofHasher
+{
+private:
+    const uint64_t k0, k1;
+
+public:
+    SaltedProofHasher();
+    size_t operator()(const uint256& hash) const;
+};
+
+/**
+ * Tracks which blocks a stake has been packaged into, and which masternodes have witnessed a block.
+ *
+ * Records are grouped into height buckets. The stake and block indexes only point into the buckets,
+ * so pruning drops whole buckets and costs O(expired) rather than a walk over everything tracked.
+ */
 class ProofTracker {
 private:
-    std::map<STAKEHASH, std::pair<int, std::set<BLOCKHASH>>> m_mapStakes; // {stakehash => [height, blockhash]}
-    std::map<BLOCKHASH, std::set<BlockWitness>> m_mapBlockWitness;
+    struct HeightBucket {
+        std::vector<STAKEHASH> vStakes;
+        std::vector<BLOCKHASH> vBlocks;
+    };
+
+    std::map<int, HeightBucket> m_mapBuckets;
+    std::unordered_map<STAKEHASH, std::vector<BLOCKHASH>, SaltedProofHasher> m_mapStakes; // {stakehash => distinct blockhashes, capped}
+    std::unordered_map<BLOCKHASH, std::vector<COutPoint>, SaltedProofHasher> m_mapBlockWitness; // {blockhash => sorted mn outpoints}
+    int m_nBestHeight{0};
+
     void AddNewStake(const STAKEHASH& hashStake, const BLOCKHASH& hashBlock, int nHeight);
 
 public:
-    std::set<BlockWitness> GetWitnesses(const uint256& hashBlock) const;
+    std::vector<BlockWitness> GetWitnesses(const uint256& hashBlock) const;
     bool HasSufficientProof(const BLOCKHASH& hashBlock) const;
     bool IsSuspicious(const STAKEHASH& hash, const BLOCKHASH& hashBlock, int nHeight);
     void AddWitness(const BlockWitness& witness);
     int GetWitnessCount(const BLOCKHASH& hashBlock) const;
     void EraseBeforeHeight(int nHeight);
+    size_t DynamicMemoryUsage() const;
 };
 
 #endif // PROOFTRACKER_H
@@ -1,8 +1,12 @@
 #include <crown/legacysigner.h>
 #include <key.h>
+#include <masternode/activemasternode.h>
+#include <masternode/masternodeman.h>
 #include <pos/kernel.h>
 #include <pos/stakeminer.h>
 #include <pos/stakevalidation.h>
+#include <systemnode/activesystemnode.h>
+#include <systemnode/systemnodeman.h>
 #include <util/system.h>
 
 //! Search a specific period of timestamps to see if a valid proof hash is created
@@ -23,26 +27,37 @@ bool SearchTimeSpan(Kernel& kernel, uint32_t nTimeStart, uint32_t nTimeEnd, cons
     return kernel.IsValidProof(nTarget);
 }
 
-bool SignBlock(CBlock* pblock)
+bool FindStakingKey(const CPubKey& pubKeyStake, CKey& keyNode, std::vector<unsigned char>& vchSigSignover)
 {
-    CPubKey pubKeyNode;
-    CKey keyNode;
-
-    std::string strPrivKey;
-    std::vector<unsigned char> vchSigSignover;
     if (fMasterNode) {
-        strPrivKey = strMasterNodePrivKey;
-        vchSigSignover = activeMasternode.vchSigSignover;
+        for (const CActiveMasternode* pactive : GetActiveMasternodes()) {
+            CMasternode mn;
+            if (pactive->pubKeyMasternode == pubKeyStake || (mnodeman.GetMasternode(pactive->vin.prevout, mn) && mn.pubkey == pubKeyStake)) {
+                keyNode = pactive->keyMasternode;
+                vchSigSignover = pactive->vchSigSignover;
+                return true;
+            }
+        }
     } else {
-        strPrivKey = strSystemNodePrivKey;
-        vchSigSignover = activeSystemnode.vchSigSignover;
+        for (const CActiveSystemnode* pactive : GetActiveSystemnodes()) {
+            CSystemnode sn;
+            if (pactive->pubKeySystemnode == pubKeyStake || (snodeman.GetSystemnode(pactive->vin.prevout, sn) && sn.pubkey == pubKeyStake)) {
+                keyNode = pactive->keySystemnode;
+                vchSigSignover = pactive->vchSigSignover;
+                return true;
+            }
+        }
     }
+    return false;
+}
 
-    std::string strErrorMessage;
-    if (!legacySigner.SetKey(strPrivKey, keyNode, pubKeyNode)) {
-        strErrorMessage = strprintf("Can't find keys for masternode - %s", strErrorMessage);
-        return error("%s: Failed to setkey %s\n", __func__, strErrorMessage);
-    }
+bool SignBlock(CBlock* pblock)
+{
+    CKey keyNode;
+    std::vector<unsigned char> vchSigSignover;
+    if (!FindStakingKey(pblock->stakePointer.pubKeyProofOfStake, keyNode, vchSigSignover))
+        return error("%s: Can't find keys for the node of stake pointer %s\n", __func__, pblock->stakePointer.pubKeyProofOfStake.GetHash().GetHex());
+    CPubKey pubKeyNode = keyNode.GetPubKey();
 
     // Switch keys if using signed over staking key
     if (!vchSigSignover.empty()) {
@@ -2,11 +2,16 @@
 #define CROWN_CORE_STAKEMINER_H
 
 #include <cstdint>
+#include <vector>
 
 class CBlock;
+class CKey;
+class CPubKey;
 class Kernel;
 class uint256;
 
 bool SearchTimeSpan(Kernel& kernel, uint32_t nTimeStart, uint32_t nTimeEnd, const uint256& nTarget);
+//! Operator key and signover of the node we run that owns the stake pointer paying to pubKeyStake
+bool FindStakingKey(const CPubKey& pubKeyStake, CKey& keyNode, std::vector<unsigned char>& vchSigSignover);
 bool SignBlock(CBlock* pblock);
 #endif //CROWN_CORE_STAKEMINER_H
@@ -261,7 +261,7 @@ unsigned int GetNextWorkRequired(const CBlockIndex* pindexLast, const CBlockHead
     return DarkGravityWave(pindexLast, params);
 }
 
-bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params& params)
+bool CheckProofOfWorkTarget(const uint256& hash, unsigned int nBits)
 {
     bool fNegative;
     bool fOverflow;
@@ -269,10 +269,6 @@ bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params&
 
     bnTarget.SetCompact(nBits, &fNegative, &fOverflow);
 
-    if (Params().NetworkIDString() == CBaseChainParams::MAIN && ::ChainActive().Height() >= params.PoSStartHeight() - 1) {
-        SetProofOfWorkLimit(uint256S("000003ffff000000000000000000000000000000000000000000000000000000"));
-    }
-
     // Check range
     if (fNegative || bnTarget == 0 || fOverflow)
         return false;
@@ -284,6 +280,20 @@ bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params&
     return true;
 }
 
+void UpdateProofOfWorkLimit(const Consensus::Params& params)
+{
+    if (Params().NetworkIDString() == CBaseChainParams::MAIN && ::ChainActive().Height() >= params.PoSStartHeight() - 1) {
+        SetProofOfWorkLimit(uint256S("000003ffff000000000000000000000000000000000000000000000000000000"));
+    }
+}
+
+bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params& params)
+{
+    UpdateProofOfWorkLimit(params);
+
+    return CheckProofOfWorkTarget(hash, nBits);
+}
+
 bool CheckProofOfWork(const CBlockHeader& block, const Consensus::Params& params)
 {
     if (!block.nVersion.IsLegacy() && params.fStrictChainId && block.nVersion.GetChainId() != params.AuxpowChainId()) {
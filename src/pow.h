@@ -27,5 +27,9 @@ unsigned int CalculateNextWorkRequired(const CBlockIndex* pindexLast, int64_t nF
 /** Check whether a block hash satisfies the proof-of-work requirement specified by nBits */
 bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params&);
 bool CheckProofOfWork(const CBlockHeader& block, const Consensus::Params& params);
+/** The target part of CheckProofOfWork, only looks at its arguments so it can run without cs_main */
+bool CheckProofOfWorkTarget(const uint256& hash, unsigned int nBits);
+/** The chain dependent part of CheckProofOfWork, lowers the mainnet limit once proof of stake starts */
+void UpdateProofOfWorkLimit(const Consensus::Params& params);
 
 #endif // BITCOIN_POW_H
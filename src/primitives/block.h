@@ -114,7 +114,7 @@ public:
     SERIALIZE_METHODS(CBlock, obj)
     {
         READWRITEAS(CBlockHeader, obj);
-        READWRITE(obj.vtx);
+        READWRITE(Using<TransactionBatchFormatter>(obj.vtx));
         if (obj.IsProofOfStake()) {
             READWRITE(obj.vchBlockSig);
             READWRITE(obj.stakePointer);
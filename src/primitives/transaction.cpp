@@ -6,11 +6,14 @@
 #include <primitives/transaction.h>
 
 #include <arith_uint256.h>
+#include <crypto/sha256.h>
 #include <hash.h>
+#include <streams.h>
 #include <tinyformat.h>
 #include <util/strencodings.h>
 
 #include <assert.h>
+#include <string.h>
 
 std::string COutPoint::ToString() const
 {
@@ -96,8 +99,51 @@ uint256 CTransaction::ComputeWitnessHash() const
 
 /* For backward compatibility, the hash is initialized to 0. TODO: remove the need for this default constructor entirely. */
 CTransaction::CTransaction() : vin(), vout(), nVersion(CTransaction::CURRENT_VERSION), nType(TRANSACTION_NORMAL), nLockTime(0), hash{}, m_witness_hash{} {}
-CTransaction::CTransaction(const CMutableTransaction& tx) : vin(tx.vin), vout(tx.vout), nVersion(tx.nVersion), nType(tx.nType), nLockTime(tx.nLockTime), extraPayload(tx.extraPayload), hash{ComputeHash()}, m_witness_hash{ComputeWitnessHash()} {ComputeHash();}
-CTransaction::CTransaction(CMutableTransaction&& tx) : vin(std::move(tx.vin)), vout(std::move(tx.vout)), nVersion(tx.nVersion), nType(tx.nType), nLockTime(tx.nLockTime), extraPayload(tx.extraPayload), hash{ComputeHash()}, m_witness_hash{ComputeWitnessHash()} {ComputeHash();}
+CTransaction::CTransaction(const CMutableTransaction& tx) : vin(tx.vin), vout(tx.vout), nVersion(tx.nVersion), nType(tx.nType), nLockTime(tx.nLockTime), extraPayload(tx.extraPayload), hash{ComputeHash()}, m_witness_hash{ComputeWitnessHash()} {}
+CTransaction::CTransaction(CMutableTransaction&& tx) : vin(std::move(tx.vin)), vout(std::move(tx.vout)), nVersion(tx.nVersion), nType(tx.nType), nLockTime(tx.nLockTime), extraPayload(tx.extraPayload), hash{ComputeHash()}, m_witness_hash{ComputeWitnessHash()} {}
+CTransaction::CTransaction(CMutableTransaction&& tx, const uint256& hashIn, const uint256& witness_hashIn) : vin(std::move(tx.vin)), vout(std::move(tx.vout)), nVersion(tx.nVersion), nType(tx.nType), nLockTime(tx.nLockTime), extraPayload(std::move(tx.extraPayload)), hash{hashIn}, m_witness_hash{witness_hashIn} {}
+
+void MakeTransactionRefs(std::vector<CMutableTransaction>&& vtxIn, std::vector<CTransactionRef>& vtxOut)
+{
+    // Serialize everything to hash into one buffer: the transaction without
+    // witness for the txid, and with it for the wtxid when it has one.
+    std::vector<unsigned char> vData;
+    std::vector<size_t> vEnd;
+    for (const CMutableTransaction& tx : vtxIn) {
+        CVectorWriter(SER_GETHASH, SERIALIZE_TRANSACTION_NO_WITNESS, vData, vData.size(), tx);
+        vEnd.push_back(vData.size());
+        if (tx.HasWitness()) {
+            CVectorWriter(SER_GETHASH, 0, vData, vData.size(), tx);
+            vEnd.push_back(vData.size());
+        }
+    }
+
+    std::vector<const unsigned char*> vInputs(vEnd.size());
+    std::vector<size_t> vLengths(vEnd.size());
+    for (size_t i = 0; i < vEnd.size(); i++) {
+        const size_t nBegin = i ? vEnd[i - 1] : 0;
+        vInputs[i] = vData.data() + nBegin;
+        vLengths[i] = vEnd[i] - nBegin;
+    }
+    std::vector<unsigned char> vHashes(vEnd.size() * CSHA256::OUTPUT_SIZE);
+    SHA256DMulti(vHashes.data(), vInputs.data(), vLengths.data(), vEnd.size());
+
+    vtxOut.clear();
+    vtxOut.reserve(vtxIn.size());
+    const unsigned char* pHash = vHashes.data();
+    for (CMutableTransaction& tx : vtxIn) {
+        uint256 hash, witness_hash;
+        memcpy(hash.begin(), pHash, CSHA256::OUTPUT_SIZE);
+        pHash += CSHA256::OUTPUT_SIZE;
+        if (tx.HasWitness()) {
+            memcpy(witness_hash.begin(), pHash, CSHA256::OUTPUT_SIZE);
+            pHash += CSHA256::OUTPUT_SIZE;
+        } else {
+            witness_hash = hash;
+        }
+        vtxOut.push_back(std::make_shared<const CTransaction>(std::move(tx), hash, witness_hash));
+    }
+}
 
 CAmount CTransaction::GetValueOut() const
 {
@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 #include <amount.h>
+#include <crypto/sha256.h>
 #include <script/script.h>
 #include <serialize.h>
 #include <uint256.h>
@@ -320,6 +321,8 @@ public:
     /** Convert a CMutableTransaction into a CTransaction. */
     explicit CTransaction(const CMutableTransaction &tx);
     CTransaction(CMutableTransaction &&tx);
+    /** Convert a CMutableTransaction whose hashes are already known, see MakeTransactionRefs(). */
+    CTransaction(CMutableTransaction &&tx, const uint256& hashIn, const uint256& witness_hashIn);
     CTransaction& operator=(const CTransaction& tx);
 
     template <typename Stream>
@@ -424,6 +427,32 @@ typedef std::shared_ptr<const CTransaction> CTransactionRef;
 static inline CTransactionRef MakeTransactionRef() { return std::make_shared<const CTransaction>(); }
 template <typename Tx> static inline CTransactionRef MakeTransactionRef(Tx&& txIn) { return std::make_shared<const CTransaction>(std::forward<Tx>(txIn)); }
 
+/** Convert many transactions at once, computing their txids and wtxids
+ *  together with SHA256DMulti() rather than one at a time. */
+void MakeTransactionRefs(std::vector<CMutableTransaction>&& vtxIn, std::vector<CTransactionRef>& vtxOut);
+
+/** Formatter for the transactions of a block or a blocktxn message, which are
+ *  hashed in a batch when deserialized. */
+struct TransactionBatchFormatter
+{
+    template<typename Stream>
+    void Ser(Stream& s, const std::vector<CTransactionRef>& vtx) { s << vtx; }
+
+    template<typename Stream>
+    void Unser(Stream& s, std::vector<CTransactionRef>& vtx)
+    {
+        if (SHA256DMultiLanes() < 4) {
+            // With SHA-NI a lone transaction hashes about as fast as a batch,
+            // which then doesn't make up for serializing them all again.
+            s >> vtx;
+            return;
+        }
+        std::vector<CMutableTransaction> vtxMutable;
+        s >> vtxMutable;
+        MakeTransactionRefs(std::move(vtxMutable), vtx);
+    }
+};
+
 /** A generic txid reference (txid or wtxid). */
 class GenTxid
 {
@@ -19,6 +19,7 @@
 #include <qt/datetablewidgetitem.h>
 #include <qt/privatekeywidget.h>
 #include <qt/guiutil.h>
+#include <qt/nodetablemodel.h>
 #include <qt/optionsmodel.h>
 #include <qt/startmissingdialog.h>
 #include <qt/walletmodel.h>
@@ -27,7 +28,7 @@
 #include <wallet/wallet.h>
 
 #include <QMessageBox>
-#include <QTimer>
+#include <QSortFilterProxyModel>
 
 int GetOffsetFromUtc()
 {
@@ -46,7 +47,9 @@ MasternodeList::MasternodeList(const PlatformStyle *platformStyle, QWidget *pare
     QWidget(parent),
     ui(new Ui::MasternodeList),
     clientModel(0),
-    walletModel(0)
+    walletModel(0),
+    nodeModel(0),
+    proxyModel(0)
 {
     ui->setupUi(this);
 
@@ -68,12 +71,6 @@ MasternodeList::MasternodeList(const PlatformStyle *platformStyle, QWidget *pare
     ui->tableWidgetMyMasternodes->setColumnWidth(4, columnActiveWidth);
     ui->tableWidgetMyMasternodes->setColumnWidth(5, columnLastSeenWidth);
 
-    ui->tableWidgetMasternodes->setColumnWidth(0, columnAddressWidth);
-    ui->tableWidgetMasternodes->setColumnWidth(1, columnProtocolWidth);
-    ui->tableWidgetMasternodes->setColumnWidth(2, columnStatusWidth);
-    ui->tableWidgetMasternodes->setColumnWidth(3, columnActiveWidth);
-    ui->tableWidgetMasternodes->setColumnWidth(4, columnLastSeenWidth);
-
     ui->tableWidgetMyMasternodes->setContextMenuPolicy(Qt::CustomContextMenu);
 
     QAction *startAliasAction = new QAction(tr("Start alias"), this);
@@ -86,21 +83,9 @@ MasternodeList::MasternodeList(const PlatformStyle *platformStyle, QWidget *pare
     connect(editAction, SIGNAL(triggered()), this, SLOT(on_editButton_clicked()));
     connect(ui->reloadButton, SIGNAL(triggered()), this, SLOT(on_reloadButton_clicked()));
 
-    timer = new QTimer(this);
-    connect(timer, SIGNAL(timeout()), this, SLOT(updateNodeList()));
-    connect(timer, SIGNAL(timeout()), this, SLOT(updateVoteList()));
-    connect(timer, SIGNAL(timeout()), this, SLOT(updateMyNodeList()));
-    connect(timer, SIGNAL(timeout()), this, SLOT(updateNextSuperblock()));
-    timer->start(1000);
-
-    updateNodeList();
+    updateMyNodeList();
     updateVoteList();
     updateNextSuperblock();
-
-    // Fill MN list
-    fFilterUpdated = false;
-    nTimeFilterUpdated = GetTime();
-    updateNodeList();
 }
 
 MasternodeList::~MasternodeList()
@@ -122,8 +107,33 @@ void MasternodeList::setClientModel(ClientModel *model)
         this->clientModel = model;
         if(model)
         {
-            // try to update list when masternode count changes
-            connect(clientModel, SIGNAL(strMasternodesChanged(QString)), this, SLOT(updateNodeList()));
+            // the list model follows the masternode manager's change notifications
+            nodeModel = new NodeTableModel(model->node(), NodeTableModel::Masternode, this);
+            proxyModel = new QSortFilterProxyModel(this);
+            proxyModel->setSourceModel(nodeModel);
+            proxyModel->setSortRole(NodeTableModel::SortRole);
+            proxyModel->setFilterKeyColumn(-1);
+            ui->tableViewMasternodes->setModel(proxyModel);
+
+            ui->tableViewMasternodes->setColumnWidth(NodeTableModel::Address, 200);
+            ui->tableViewMasternodes->setColumnWidth(NodeTableModel::Protocol, 60);
+            ui->tableViewMasternodes->setColumnWidth(NodeTableModel::Status, 80);
+            ui->tableViewMasternodes->setColumnWidth(NodeTableModel::Active, 130);
+            ui->tableViewMasternodes->setColumnWidth(NodeTableModel::LastSeen, 130);
+
+            connect(nodeModel, SIGNAL(entryChanged(QString,int)), this, SLOT(updateMyNode(QString,int)));
+            connect(proxyModel, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(updateCountLabel()));
+            connect(proxyModel, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(updateCountLabel()));
+            connect(proxyModel, SIGNAL(modelReset()), this, SLOT(updateCountLabel()));
+            connect(proxyModel, SIGNAL(layoutChanged()), this, SLOT(updateCountLabel()));
+            updateCountLabel();
+
+            // proposals and the next superblock only change with the chain
+            connect(model, &ClientModel::numBlocksChanged, this, [this](int, const QDateTime&, const QString&, double, bool header, SynchronizationState) {
+                if (header) return;
+                updateVoteList();
+                updateNextSuperblock();
+            });
         }
     }
 }
@@ -211,7 +221,7 @@ void MasternodeList::StartAll(std::string strCommand)
     msg.setText(QString::fromStdString(returnObj));
     msg.exec();
 
-    updateMyNodeList(true);
+    updateMyNodeList();
 }
 
 void MasternodeList::updateMyMasternodeInfo(QString strAlias, QString strAddr, QString privkey, QString txHash, QString txIndex, CMasternode *pmn)
@@ -253,92 +263,49 @@ void MasternodeList::updateMyMasternodeInfo(QString strAlias, QString strAddr, Q
     ui->tableWidgetMyMasternodes->setItem(nNewRow, 7, pubkeyItem);
 }
 
-void MasternodeList::updateMyNodeList(bool fForce)
+void MasternodeList::updateMyNodeList()
 {
-    static int64_t nTimeMyListUpdated = 0;
-
-    // automatically update my masternode list only once in MY_MASTERNODELIST_UPDATE_SECONDS seconds,
-    // this update still can be triggered manually at any time via button click
-    int64_t nSecondsTillUpdate = nTimeMyListUpdated + MY_MASTERNODELIST_UPDATE_SECONDS - GetTime();
-    ui->secondsLabel->setText(QString::number(nSecondsTillUpdate));
-
-    if (nSecondsTillUpdate > 0 && !fForce) return;
-    nTimeMyListUpdated = GetTime();
-
     ui->tableWidgetMyMasternodes->setSortingEnabled(false);
     for (CNodeEntry mne : masternodeConfig.getEntries()) {
-        CTxIn txin = CTxIn(uint256S(mne.getTxHash()), uint32_t(atoi(mne.getOutputIndex().c_str())));
-        CMasternode* pmn = mnodeman.Find(txin);
+        CMasternode mn;
+        bool fFound = mnodeman.GetMasternode(COutPoint(uint256S(mne.getTxHash()), uint32_t(atoi(mne.getOutputIndex().c_str()))), mn);
         updateMyMasternodeInfo(QString::fromStdString(mne.getAlias()), QString::fromStdString(mne.getIp()), QString::fromStdString(mne.getPrivKey()), QString::fromStdString(mne.getTxHash()),
-            QString::fromStdString(mne.getOutputIndex()), pmn);
+            QString::fromStdString(mne.getOutputIndex()), fFound ? &mn : nullptr);
     }
     ui->tableWidgetMyMasternodes->setSortingEnabled(true);
-
-    // reset "timer"
-    ui->secondsLabel->setText("0");
 }
 
-void MasternodeList::updateNodeList()
+void MasternodeList::updateMyNode(const QString& txHash, int outputIndex)
 {
-    TRY_LOCK(cs_mnlistupdate, fLockAcquired);
-    if(!fLockAcquired) {
+    // the whole list was reloaded, any of our entries may have changed
+    if (txHash.isEmpty()) {
+        updateMyNodeList();
         return;
     }
 
-    static int64_t nTimeListUpdated = GetTime();
-
-    // to prevent high cpu usage update only once in MASTERNODELIST_UPDATE_SECONDS seconds
-    // or MASTERNODELIST_FILTER_COOLDOWN_SECONDS seconds after filter was last changed
-    int64_t nSecondsToWait = fFilterUpdated
-                             ? nTimeFilterUpdated - GetTime() + MASTERNODELIST_FILTER_COOLDOWN_SECONDS
-                             : nTimeListUpdated - GetTime() + MASTERNODELIST_UPDATE_SECONDS;
-
-    if(fFilterUpdated) ui->countLabel->setText(QString::fromStdString(strprintf("Please wait... %d", nSecondsToWait)));
-    if(nSecondsToWait > 0) return;
-
-    nTimeListUpdated = GetTime();
-    fFilterUpdated = false;
-
-    QString strToFilter;
-    ui->countLabel->setText("Updating...");
-    ui->tableWidgetMasternodes->setSortingEnabled(false);
-    ui->tableWidgetMasternodes->clearContents();
-    ui->tableWidgetMasternodes->setRowCount(0);
-    std::vector<CMasternode> vMasternodes = mnodeman.GetFullMasternodeVector();
-
-    for (CMasternode& mn : vMasternodes)
-    {
-        // populate list
-        // Address, Protocol, Status, Active Seconds, Last Seen, Pub Key
-        QTableWidgetItem *addressItem = new QTableWidgetItem(QString::fromStdString(mn.addr.ToString()));
-        QTableWidgetItem *protocolItem = new QTableWidgetItem(QString::number(mn.protocolVersion));
-        QTableWidgetItem *statusItem = new QTableWidgetItem(QString::fromStdString(mn.Status()));
-        QTableWidgetItem *activeSecondsItem = new QTableWidgetItem(QString::fromStdString(DurationToDHMS(mn.lastPing.sigTime - mn.sigTime)));
-        QTableWidgetItem *lastSeenItem = new QTableWidgetItem(QString::fromStdString(DateTimeStrFormat("%Y-%m-%d %H:%M", mn.lastPing.sigTime + QDateTime::currentDateTime().offsetFromUtc())));
-        QTableWidgetItem *pubkeyItem = new QTableWidgetItem(QString::fromStdString(EncodeDestination(PKHash(mn.pubkey))));
-
-        if (strCurrentFilter != "")
-        {
-            strToFilter =   addressItem->text() + " " +
-                            protocolItem->text() + " " +
-                            statusItem->text() + " " +
-                            activeSecondsItem->text() + " " +
-                            lastSeenItem->text() + " " +
-                            pubkeyItem->text();
-            if (!strToFilter.contains(strCurrentFilter)) continue;
-        }
+    for (CNodeEntry mne : masternodeConfig.getEntries()) {
+        if (mne.getTxHash() != txHash.toStdString() || atoi(mne.getOutputIndex().c_str()) != outputIndex)
+            continue;
 
-        ui->tableWidgetMasternodes->insertRow(0);
-        ui->tableWidgetMasternodes->setItem(0, 0, addressItem);
-        ui->tableWidgetMasternodes->setItem(0, 1, protocolItem);
-        ui->tableWidgetMasternodes->setItem(0, 2, statusItem);
-        ui->tableWidgetMasternodes->setItem(0, 3, activeSecondsItem);
-        ui->tableWidgetMasternodes->setItem(0, 4, lastSeenItem);
-        ui->tableWidgetMasternodes->setItem(0, 5, pubkeyItem);
+        CMasternode mn;
+        bool fFound = mnodeman.GetMasternode(COutPoint(uint256S(mne.getTxHash()), uint32_t(outputIndex)), mn);
+        ui->tableWidgetMyMasternodes->setSortingEnabled(false);
+        updateMyMasternodeInfo(QString::fromStdString(mne.getAlias()), QString::fromStdString(mne.getIp()), QString::fromStdString(mne.getPrivKey()), QString::fromStdString(mne.getTxHash()),
+            QString::fromStdString(mne.getOutputIndex()), fFound ? &mn : nullptr);
+        ui->tableWidgetMyMasternodes->setSortingEnabled(true);
     }
+}
 
-    ui->countLabel->setText(QString::number(ui->tableWidgetMasternodes->rowCount()));
-    ui->tableWidgetMasternodes->setSortingEnabled(true);
+void MasternodeList::updateNodeList()
+{
+    if (nodeModel)
+        nodeModel->refresh();
+}
+
+void MasternodeList::updateCountLabel()
+{
+    if (proxyModel)
+        ui->countLabel->setText(QString::number(proxyModel->rowCount()));
 }
 
 void MasternodeList::on_reloadButton_clicked()
@@ -353,7 +320,7 @@ void MasternodeList::on_reloadButton_clicked()
     ui->tableWidgetMyMasternodes->setRowCount(0);
 
     loadNodeConfiguration();
-    updateMyNodeList(true);
+    updateMyNodeList();
 }
 
 void MasternodeList::updateNextSuperblock()
@@ -370,10 +337,8 @@ void MasternodeList::updateNextSuperblock()
 
 void MasternodeList::on_filterLineEdit_textChanged(const QString &strFilterIn)
 {
-    strCurrentFilter = strFilterIn;
-    nTimeFilterUpdated = GetTime();
-    fFilterUpdated = true;
-    ui->countLabel->setText(QString::fromStdString(strprintf("Please wait... %d", MASTERNODELIST_FILTER_COOLDOWN_SECONDS)));
+    if (proxyModel)
+        proxyModel->setFilterFixedString(strFilterIn);
 }
 
 void MasternodeList::on_startButton_clicked()
@@ -456,29 +421,19 @@ void MasternodeList::on_tableWidgetMyMasternodes_itemSelectionChanged()
 
 void MasternodeList::on_UpdateButton_clicked()
 {
-    updateMyNodeList(true);
+    updateNodeList();
+    updateMyNodeList();
 }
 
 void MasternodeList::on_UpdateVotesButton_clicked()
 {
-    updateVoteList(true);
+    updateVoteList();
 }
 
-void MasternodeList::updateVoteList(bool reset)
+void MasternodeList::updateVoteList()
 {
     Q_ASSERT(::ChainActive().Tip() != NULL);
 
-    static int64_t lastVoteListUpdate = 0;
-
-    // automatically update my masternode list only once in MY_MASTERNODELIST_UPDATE_SECONDS seconds,
-    // this update still can be triggered manually at any time via button click
-    int64_t timeTillUpdate = lastVoteListUpdate + MY_MASTERNODELIST_UPDATE_SECONDS - GetTime();
-    ui->voteSecondsLabel->setText(QString::number(timeTillUpdate));
-
-    if(timeTillUpdate > 0 && !reset) return;
-    lastVoteListUpdate = GetTime();
-
-    QString strToFilter;
     ui->tableWidgetVoting->setSortingEnabled(false);
     ui->tableWidgetVoting->clearContents();
     ui->tableWidgetVoting->setRowCount(0);
@@ -490,6 +445,7 @@ void MasternodeList::updateVoteList(bool reset)
 
     int blockStart = GetNextSuperblock(pindexPrev->nHeight);
     int blockEnd = blockStart + GetBudgetPaymentCycleBlocks() - 1;
+    const int nMasternodes = nodeModel ? nodeModel->rowCount(QModelIndex()) : 0;
 
     std::vector<CBudgetProposal*> winningProps = budget.GetAllProposals();
     for (CBudgetProposal* pbudgetProposal : winningProps)
@@ -538,7 +494,7 @@ void MasternodeList::updateVoteList(bool reset)
             ui->tableWidgetVoting->setItem(0, 12, monthlyPaymentItem);
 
             std::string projected;
-            if ((int64_t)pbudgetProposal->GetYeas() - (int64_t)pbudgetProposal->GetNays() > (ui->tableWidgetMasternodes->rowCount()/10)){
+            if ((int64_t)pbudgetProposal->GetYeas() - (int64_t)pbudgetProposal->GetNays() > (nMasternodes/10)){
                 nTotalAllotted += pbudgetProposal->GetAmount()/100000000;
                 projected = "Yes";
             } else {
@@ -551,9 +507,6 @@ void MasternodeList::updateVoteList(bool reset)
 
     ui->totalAllottedLabel->setText(QString::number(nTotalAllotted));
     ui->tableWidgetVoting->setSortingEnabled(true);
-
-    // reset "timer"
-    ui->voteSecondsLabel->setText("0");
 }
 
 void MasternodeList::VoteMany(std::string strCommand)
@@ -645,7 +598,7 @@ void MasternodeList::VoteMany(std::string strCommand)
     msg.setText(QString::fromStdString(returnObj));
     msg.setWindowTitle(tr("Voting Details"));
     msg.exec();
-    updateVoteList(true);
+    updateVoteList();
 }
 
 void MasternodeList::on_voteManyYesButton_clicked()
@@ -8,24 +8,21 @@
 #include <util/system.h>
 
 #include <QMenu>
-#include <QTimer>
 #include <QWidget>
 
-#define MY_MASTERNODELIST_UPDATE_SECONDS                 60
-#define MASTERNODELIST_UPDATE_SECONDS                    15
-#define MASTERNODELIST_FILTER_COOLDOWN_SECONDS            3
-
 namespace Ui
 {
 class MasternodeList;
 }
 
 class ClientModel;
+class NodeTableModel;
 class WalletModel;
 class SendCollateralDialog;
 
 QT_BEGIN_NAMESPACE
 class QModelIndex;
+class QSortFilterProxyModel;
 QT_END_NAMESPACE
 
 /** Masternode Manager page widget */
@@ -42,19 +39,19 @@ public:
     void StartAlias(std::string strAlias);
     void StartAll(std::string strCommand = "start-all");
     void VoteMany(std::string strCommand);
-    void on_filterLineEdit_textChanged(const QString &strFilterIn);
 
 private:
     QMenu* contextMenu;
-    int64_t nTimeFilterUpdated{0};
-    bool fFilterUpdated{false};
 
 public Q_SLOTS:
     void updateMyMasternodeInfo(QString strAlias, QString strAddr, QString privkey, QString txHash, QString txIndex, CMasternode *pmn);
-    void updateMyNodeList(bool fForce = false);
+    void updateMyNodeList();
+    void updateMyNode(const QString& txHash, int outputIndex);
     void updateNodeList();
-    void updateVoteList(bool reset = false);
+    void updateCountLabel();
+    void updateVoteList();
     void updateNextSuperblock();
+    void on_filterLineEdit_textChanged(const QString &strFilterIn);
 
     SendCollateralDialog* getSendCollateralDialog()
     {
@@ -64,13 +61,13 @@ public Q_SLOTS:
 Q_SIGNALS:
 
 private:
-    QTimer* timer;
     Ui::MasternodeList* ui;
     ClientModel* clientModel;
     WalletModel* walletModel;
+    NodeTableModel* nodeModel;
+    QSortFilterProxyModel* proxyModel;
     SendCollateralDialog *sendDialog;
     RecursiveMutex cs_mnlistupdate;
-    QString strCurrentFilter;
 
 private Q_SLOTS:
     void notReady();
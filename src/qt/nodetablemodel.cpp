@@ -0,0 +1,225 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <qt/nodetablemodel.h>
+
+#include <interfaces/handler.h>
+#include <interfaces/node.h>
+#include <key_io.h>
+#include <masternode/masternodeman.h>
+#include <qt/guiconstants.h>
+#include <systemnode/systemnodeman.h>
+#include <util/time.h>
+
+#include <QDateTime>
+#include <QTimer>
+
+template <typename T>
+static NodeTableEntry MakeEntry(const T& node)
+{
+    NodeTableEntry entry;
+    entry.outpoint = node.vin.prevout;
+    entry.address = QString::fromStdString(node.addr.ToString());
+    entry.protocol = node.protocolVersion;
+    entry.status = QString::fromStdString(node.Status());
+    entry.activeSeconds = node.lastPing.sigTime - node.sigTime;
+    entry.lastSeen = node.lastPing.sigTime;
+    entry.pubkey = QString::fromStdString(EncodeDestination(PKHash(node.pubkey)));
+    return entry;
+}
+
+NodeTableModel::NodeTableModel(interfaces::Node& node, NodeType type, QObject* parent) :
+    QAbstractTableModel(parent),
+    m_type(type)
+{
+    columns << tr("Address") << tr("Protocol") << tr("Status") << tr("Active") << tr("Last Seen (UTC)") << tr("Pubkey");
+
+    auto fn = [this](const COutPoint& outpoint, ChangeType status) { notifyChanged(outpoint, status); };
+    if (m_type == Masternode)
+        m_handler_changed = node.handleNotifyMasternodeChanged(fn);
+    else
+        m_handler_changed = node.handleNotifySystemnodeChanged(fn);
+
+    // load initial data
+    refresh();
+}
+
+NodeTableModel::~NodeTableModel()
+{
+    m_handler_changed->disconnect();
+}
+
+int NodeTableModel::rowCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+    return m_rows.size();
+}
+
+int NodeTableModel::columnCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+    return columns.length();
+}
+
+QVariant NodeTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= (int)m_rows.size())
+        return QVariant();
+
+    const NodeTableEntry& rec = m_rows[index.row()];
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case Address:
+            return rec.address;
+        case Protocol:
+            return rec.protocol;
+        case Status:
+            return rec.status;
+        case Active:
+            return QString::fromStdString(DurationToDHMS(rec.activeSeconds));
+        case LastSeen:
+            return QString::fromStdString(DateTimeStrFormat("%Y-%m-%d %H:%M", rec.lastSeen + QDateTime::currentDateTime().offsetFromUtc()));
+        case Pubkey:
+            return rec.pubkey;
+        }
+    } else if (role == SortRole) {
+        switch (index.column()) {
+        case Active:
+            return (qint64)rec.activeSeconds;
+        case LastSeen:
+            return (qint64)rec.lastSeen;
+        default:
+            return data(index, Qt::DisplayRole);
+        }
+    }
+
+    return QVariant();
+}
+
+QVariant NodeTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section < columns.size())
+        return columns[section];
+    return QVariant();
+}
+
+void NodeTableModel::notifyChanged(const COutPoint& outpoint, ChangeType status)
+{
+    Q_UNUSED(status);
+
+    bool fSchedule;
+    {
+        LOCK(cs_pending);
+        fSchedule = m_pending.empty() && !m_pending_reload;
+        if (outpoint.IsNull())
+            m_pending_reload = true;
+        else
+            m_pending.insert(outpoint);
+    }
+
+    // only the first change of a burst needs to wake up the GUI thread
+    if (fSchedule) {
+        bool invoked = QMetaObject::invokeMethod(this, "schedulePending", Qt::QueuedConnection);
+        assert(invoked);
+    }
+}
+
+void NodeTableModel::schedulePending()
+{
+    QTimer::singleShot(MODEL_UPDATE_DELAY, this, SLOT(processPending()));
+}
+
+void NodeTableModel::processPending()
+{
+    std::set<COutPoint> pending;
+    bool fReload;
+    {
+        LOCK(cs_pending);
+        pending.swap(m_pending);
+        fReload = m_pending_reload;
+        m_pending_reload = false;
+    }
+
+    if (fReload) {
+        refresh();
+        return;
+    }
+
+    for (const COutPoint& outpoint : pending)
+        updateEntry(outpoint);
+}
+
+void NodeTableModel::refresh()
+{
+    beginResetModel();
+    m_rows.clear();
+    m_row_index.clear();
+    if (m_type == Masternode) {
+        MasternodeListSnapshot snapshot = mnodeman.GetMasternodeListSnapshot();
+        for (const CMasternode& mn : *snapshot)
+            m_rows.push_back(MakeEntry(mn));
+    } else {
+        SystemnodeListSnapshot snapshot = snodeman.GetSystemnodeListSnapshot();
+        for (const CSystemnode& sn : *snapshot)
+            m_rows.push_back(MakeEntry(sn));
+    }
+    for (size_t i = 0; i < m_rows.size(); i++)
+        m_row_index[m_rows[i].outpoint] = i;
+    endResetModel();
+
+    Q_EMIT entryChanged(QString(), 0);
+}
+
+bool NodeTableModel::fetchEntry(const COutPoint& outpoint, NodeTableEntry& entry) const
+{
+    if (m_type == Masternode) {
+        CMasternode mn;
+        if (!mnodeman.GetMasternode(outpoint, mn))
+            return false;
+        entry = MakeEntry(mn);
+    } else {
+        CSystemnode sn;
+        if (!snodeman.GetSystemnode(outpoint, sn))
+            return false;
+        entry = MakeEntry(sn);
+    }
+    return true;
+}
+
+void NodeTableModel::updateEntry(const COutPoint& outpoint)
+{
+    NodeTableEntry entry;
+    bool fFound = fetchEntry(outpoint, entry);
+    auto it = m_row_index.find(outpoint);
+
+    if (fFound && it != m_row_index.end()) {
+        int row = it->second;
+        m_rows[row] = entry;
+        Q_EMIT dataChanged(index(row, 0), index(row, columns.size() - 1));
+    } else if (fFound) {
+        int row = m_rows.size();
+        beginInsertRows(QModelIndex(), row, row);
+        m_rows.push_back(entry);
+        m_row_index[outpoint] = row;
+        endInsertRows();
+    } else if (it != m_row_index.end()) {
+        // move the last row into the gap so no other row has to shift, views sort through a proxy anyway
+        int row = it->second;
+        int last = m_rows.size() - 1;
+        m_row_index.erase(it);
+        if (row != last) {
+            m_rows[row] = m_rows[last];
+            m_row_index[m_rows[row].outpoint] = row;
+            Q_EMIT dataChanged(index(row, 0), index(row, columns.size() - 1));
+        }
+        beginRemoveRows(QModelIndex(), last, last);
+        m_rows.pop_back();
+        endRemoveRows();
+    } else {
+        return;
+    }
+
+    Q_EMIT entryChanged(QString::fromStdString(outpoint.hash.ToString()), outpoint.n);
+}
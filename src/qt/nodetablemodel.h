@@ -0,0 +1,103 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef CROWN_QT_NODETABLEMODEL_H
+#define CROWN_QT_NODETABLEMODEL_H
+
+#include <primitives/transaction.h>
+#include <sync.h>
+#include <util/ui_change_type.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include <QAbstractTableModel>
+#include <QStringList>
+
+namespace interfaces {
+class Handler;
+class Node;
+}
+
+/** Row of the masternode/systemnode table, copied out of the manager's list */
+struct NodeTableEntry {
+    COutPoint outpoint;
+    QString address;
+    int protocol;
+    QString status;
+    int64_t activeSeconds;
+    int64_t lastSeen;
+    QString pubkey;
+};
+
+/**
+   Qt model of the masternode or systemnode list. Rows are added, updated and removed
+   one outpoint at a time from the managers' change notifications, the whole list is
+   only reloaded when refresh() is called.
+ */
+class NodeTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum NodeType {
+        Masternode,
+        Systemnode
+    };
+
+    enum ColumnIndex {
+        Address = 0,
+        Protocol = 1,
+        Status = 2,
+        Active = 3,
+        LastSeen = 4,
+        Pubkey = 5
+    };
+
+    /** Role returning the raw value of a cell, for sorting */
+    static const int SortRole = Qt::UserRole;
+
+    explicit NodeTableModel(interfaces::Node& node, NodeType type, QObject* parent);
+    ~NodeTableModel();
+
+    /** @name Methods overridden from QAbstractTableModel
+        @{*/
+    int rowCount(const QModelIndex& parent) const override;
+    int columnCount(const QModelIndex& parent) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+    /*@}*/
+
+    /** Called from the core thread, queues the outpoint for the next update */
+    void notifyChanged(const COutPoint& outpoint, ChangeType status);
+
+public Q_SLOTS:
+    void refresh();
+
+Q_SIGNALS:
+    /** An entry was added, updated or removed, a null hash means the whole list was reloaded */
+    void entryChanged(const QString& txHash, int outputIndex);
+
+private Q_SLOTS:
+    void schedulePending();
+    void processPending();
+
+private:
+    NodeType m_type;
+    QStringList columns;
+    std::vector<NodeTableEntry> m_rows;
+    std::map<COutPoint, int> m_row_index;
+    std::unique_ptr<interfaces::Handler> m_handler_changed;
+
+    Mutex cs_pending;
+    std::set<COutPoint> m_pending GUARDED_BY(cs_pending);
+    bool m_pending_reload GUARDED_BY(cs_pending){false};
+
+    bool fetchEntry(const COutPoint& outpoint, NodeTableEntry& entry) const;
+    void updateEntry(const COutPoint& outpoint);
+};
+
+#endif // CROWN_QT_NODETABLEMODEL_H
@@ -17,6 +17,7 @@
 #include <qt/createsystemnodedialog.h>
 #include <qt/datetablewidgetitem.h>
 #include <qt/guiutil.h>
+#include <qt/nodetablemodel.h>
 #include <qt/privatekeywidget.h>
 #include <qt/optionsmodel.h>
 #include <qt/startmissingdialog.h>
@@ -26,7 +27,7 @@
 #include <wallet/wallet.h>
 
 #include <QMessageBox>
-#include <QTimer>
+#include <QSortFilterProxyModel>
 
 RecursiveMutex cs_systemnodes;
 
@@ -34,7 +35,9 @@ SystemnodeList::SystemnodeList(const PlatformStyle *platformStyle, QWidget *pare
     QWidget(parent),
     ui(new Ui::SystemnodeList),
     clientModel(0),
-    walletModel(0)
+    walletModel(0),
+    nodeModel(0),
+    proxyModel(0)
 {
     ui->setupUi(this);
 
@@ -54,12 +57,6 @@ SystemnodeList::SystemnodeList(const PlatformStyle *platformStyle, QWidget *pare
     ui->tableWidgetMySystemnodes->setColumnWidth(4, columnActiveWidth);
     ui->tableWidgetMySystemnodes->setColumnWidth(5, columnLastSeenWidth);
 
-    ui->tableWidgetSystemnodes->setColumnWidth(0, columnAddressWidth);
-    ui->tableWidgetSystemnodes->setColumnWidth(1, columnProtocolWidth);
-    ui->tableWidgetSystemnodes->setColumnWidth(2, columnStatusWidth);
-    ui->tableWidgetSystemnodes->setColumnWidth(3, columnActiveWidth);
-    ui->tableWidgetSystemnodes->setColumnWidth(4, columnLastSeenWidth);
-
     ui->tableWidgetMySystemnodes->setContextMenuPolicy(Qt::CustomContextMenu);
 
     QAction* startAliasAction = new QAction(tr("Start alias"), this);
@@ -69,17 +66,7 @@ SystemnodeList::SystemnodeList(const PlatformStyle *platformStyle, QWidget *pare
     connect(startAliasAction, SIGNAL(triggered()), this, SLOT(on_startButton_clicked()));
     connect(ui->reloadButton, SIGNAL(triggered()), this, SLOT(on_reloadButton_clicked()));
 
-    timer = new QTimer(this);
-    connect(timer, SIGNAL(timeout()), this, SLOT(updateNodeList()));
-    connect(timer, SIGNAL(timeout()), this, SLOT(updateMyNodeList()));
-    timer->start(1000);
-
-    updateNodeList();
-
-    // Fill MN list
-    fFilterUpdated = false;
-    nTimeFilterUpdated = GetTime();
-    updateNodeList();
+    updateMyNodeList();
 }
 
 SystemnodeList::~SystemnodeList()
@@ -101,8 +88,26 @@ void SystemnodeList::setClientModel(ClientModel *model)
         this->clientModel = model;
         if(model)
         {
-            // try to update list when systemnode count changes
-            connect(clientModel, SIGNAL(strSystemnodesChanged(QString)), this, SLOT(updateNodeList()));
+            // the list model follows the systemnode manager's change notifications
+            nodeModel = new NodeTableModel(model->node(), NodeTableModel::Systemnode, this);
+            proxyModel = new QSortFilterProxyModel(this);
+            proxyModel->setSourceModel(nodeModel);
+            proxyModel->setSortRole(NodeTableModel::SortRole);
+            proxyModel->setFilterKeyColumn(-1);
+            ui->tableViewSystemnodes->setModel(proxyModel);
+
+            ui->tableViewSystemnodes->setColumnWidth(NodeTableModel::Address, 200);
+            ui->tableViewSystemnodes->setColumnWidth(NodeTableModel::Protocol, 60);
+            ui->tableViewSystemnodes->setColumnWidth(NodeTableModel::Status, 80);
+            ui->tableViewSystemnodes->setColumnWidth(NodeTableModel::Active, 130);
+            ui->tableViewSystemnodes->setColumnWidth(NodeTableModel::LastSeen, 130);
+
+            connect(nodeModel, SIGNAL(entryChanged(QString,int)), this, SLOT(updateMyNode(QString,int)));
+            connect(proxyModel, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(updateCountLabel()));
+            connect(proxyModel, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(updateCountLabel()));
+            connect(proxyModel, SIGNAL(modelReset()), this, SLOT(updateCountLabel()));
+            connect(proxyModel, SIGNAL(layoutChanged()), this, SLOT(updateCountLabel()));
+            updateCountLabel();
         }
     }
 }
@@ -149,7 +154,7 @@ void SystemnodeList::StartAlias(std::string strAlias)
     msg.setText(QString::fromStdString(strStatusHtml));
     msg.exec();
 
-    updateMyNodeList(true);
+    updateMyNodeList();
 }
 
 void SystemnodeList::StartAll(std::string strCommand)
@@ -192,7 +197,7 @@ void SystemnodeList::StartAll(std::string strCommand)
     msg.setText(QString::fromStdString(returnObj));
     msg.exec();
 
-    updateMyNodeList(true);
+    updateMyNodeList();
 }
 
 void SystemnodeList::updateMySystemnodeInfo(QString strAlias, QString strAddr, QString privkey, QString txHash, QString txIndex, CSystemnode *pmn)
@@ -234,29 +239,37 @@ void SystemnodeList::updateMySystemnodeInfo(QString strAlias, QString strAddr, Q
     ui->tableWidgetMySystemnodes->setItem(nNewRow, 7, pubkeyItem);
 }
 
-void SystemnodeList::updateMyNodeList(bool fForce)
+void SystemnodeList::updateMyNodeList()
 {
-    static int64_t nTimeMyListUpdated = 0;
-
-    // automatically update my systemnode list only once in MY_SYSTEMNODELIST_UPDATE_SECONDS seconds,
-    // this update still can be triggered manually at any time via button click
-    int64_t nSecondsTillUpdate = nTimeMyListUpdated + MY_SYSTEMNODELIST_UPDATE_SECONDS - GetTime();
-    ui->secondsLabel->setText(QString::number(nSecondsTillUpdate));
-
-    if (nSecondsTillUpdate > 0 && !fForce) return;
-    nTimeMyListUpdated = GetTime();
-
     ui->tableWidgetMySystemnodes->setSortingEnabled(false);
     for (CNodeEntry sne : systemnodeConfig.getEntries()) {
-        CTxIn txin = CTxIn(uint256S(sne.getTxHash()), uint32_t(atoi(sne.getOutputIndex().c_str())));
-        CSystemnode* pmn = snodeman.Find(txin);
+        CSystemnode sn;
+        bool fFound = snodeman.GetSystemnode(COutPoint(uint256S(sne.getTxHash()), uint32_t(atoi(sne.getOutputIndex().c_str()))), sn);
         updateMySystemnodeInfo(QString::fromStdString(sne.getAlias()), QString::fromStdString(sne.getIp()), QString::fromStdString(sne.getPrivKey()), QString::fromStdString(sne.getTxHash()),
-            QString::fromStdString(sne.getOutputIndex()), pmn);
+            QString::fromStdString(sne.getOutputIndex()), fFound ? &sn : nullptr);
     }
     ui->tableWidgetMySystemnodes->setSortingEnabled(true);
+}
+
+void SystemnodeList::updateMyNode(const QString& txHash, int outputIndex)
+{
+    // the whole list was reloaded, any of our entries may have changed
+    if (txHash.isEmpty()) {
+        updateMyNodeList();
+        return;
+    }
 
-    // reset "timer"
-    ui->secondsLabel->setText("0");
+    for (CNodeEntry sne : systemnodeConfig.getEntries()) {
+        if (sne.getTxHash() != txHash.toStdString() || atoi(sne.getOutputIndex().c_str()) != outputIndex)
+            continue;
+
+        CSystemnode sn;
+        bool fFound = snodeman.GetSystemnode(COutPoint(uint256S(sne.getTxHash()), uint32_t(outputIndex)), sn);
+        ui->tableWidgetMySystemnodes->setSortingEnabled(false);
+        updateMySystemnodeInfo(QString::fromStdString(sne.getAlias()), QString::fromStdString(sne.getIp()), QString::fromStdString(sne.getPrivKey()), QString::fromStdString(sne.getTxHash()),
+            QString::fromStdString(sne.getOutputIndex()), fFound ? &sn : nullptr);
+        ui->tableWidgetMySystemnodes->setSortingEnabled(true);
+    }
 }
 
 void SystemnodeList::on_reloadButton_clicked()
@@ -271,78 +284,25 @@ void SystemnodeList::on_reloadButton_clicked()
     ui->tableWidgetMySystemnodes->setRowCount(0);
 
     loadNodeConfiguration();
-    updateMyNodeList(true);
+    updateMyNodeList();
 }
 
 void SystemnodeList::updateNodeList()
 {
-    TRY_LOCK(cs_snlistupdate, fLockAcquired);
-    if(!fLockAcquired) {
-        return;
-    }
-
-    static int64_t nTimeListUpdated = GetTime();
-
-    // to prevent high cpu usage update only once in SYSTEMNODELIST_UPDATE_SECONDS seconds
-    // or SYSTEMNODELIST_FILTER_COOLDOWN_SECONDS seconds after filter was last changed
-    int64_t nSecondsToWait = fFilterUpdated
-                             ? nTimeFilterUpdated - GetTime() + SYSTEMNODELIST_FILTER_COOLDOWN_SECONDS
-                             : nTimeListUpdated - GetTime() + SYSTEMNODELIST_UPDATE_SECONDS;
-
-    if(fFilterUpdated) ui->countLabel->setText(QString::fromStdString(strprintf("Please wait... %d", nSecondsToWait)));
-    if(nSecondsToWait > 0) return;
-
-    nTimeListUpdated = GetTime();
-    fFilterUpdated = false;
-
-    QString strToFilter;
-    ui->countLabel->setText("Updating...");
-    ui->tableWidgetSystemnodes->setSortingEnabled(false);
-    ui->tableWidgetSystemnodes->clearContents();
-    ui->tableWidgetSystemnodes->setRowCount(0);
-    std::vector<CSystemnode> vSystemnodes = snodeman.GetFullSystemnodeVector();
-
-    for (CSystemnode& sn : vSystemnodes)
-    {
-        // populate list
-        // Address, Protocol, Status, Active Seconds, Last Seen, Pub Key
-        QTableWidgetItem *addressItem = new QTableWidgetItem(QString::fromStdString(sn.addr.ToString()));
-        QTableWidgetItem *protocolItem = new QTableWidgetItem(QString::number(sn.protocolVersion));
-        QTableWidgetItem *statusItem = new QTableWidgetItem(QString::fromStdString(sn.Status()));
-        QTableWidgetItem *activeSecondsItem = new QTableWidgetItem(QString::fromStdString(DurationToDHMS(sn.lastPing.sigTime - sn.sigTime)));
-        QTableWidgetItem *lastSeenItem = new QTableWidgetItem(QString::fromStdString(DateTimeStrFormat("%Y-%m-%d %H:%M", sn.lastPing.sigTime + QDateTime::currentDateTime().offsetFromUtc())));
-        QTableWidgetItem *pubkeyItem = new QTableWidgetItem(QString::fromStdString(EncodeDestination(PKHash(sn.pubkey))));
-
-        if (strCurrentFilter != "")
-        {
-            strToFilter =   addressItem->text() + " " +
-                            protocolItem->text() + " " +
-                            statusItem->text() + " " +
-                            activeSecondsItem->text() + " " +
-                            lastSeenItem->text() + " " +
-                            pubkeyItem->text();
-            if (!strToFilter.contains(strCurrentFilter)) continue;
-        }
-
-        ui->tableWidgetSystemnodes->insertRow(0);
-        ui->tableWidgetSystemnodes->setItem(0, 0, addressItem);
-        ui->tableWidgetSystemnodes->setItem(0, 1, protocolItem);
-        ui->tableWidgetSystemnodes->setItem(0, 2, statusItem);
-        ui->tableWidgetSystemnodes->setItem(0, 3, activeSecondsItem);
-        ui->tableWidgetSystemnodes->setItem(0, 4, lastSeenItem);
-        ui->tableWidgetSystemnodes->setItem(0, 5, pubkeyItem);
-    }
+    if (nodeModel)
+        nodeModel->refresh();
+}
 
-    ui->countLabel->setText(QString::number(ui->tableWidgetSystemnodes->rowCount()));
-    ui->tableWidgetSystemnodes->setSortingEnabled(true);
+void SystemnodeList::updateCountLabel()
+{
+    if (proxyModel)
+        ui->countLabel->setText(QString::number(proxyModel->rowCount()));
 }
 
 void SystemnodeList::on_filterLineEdit_textChanged(const QString &strFilterIn)
 {
-    strCurrentFilter = strFilterIn;
-    nTimeFilterUpdated = GetTime();
-    fFilterUpdated = true;
-    ui->countLabel->setText(QString::fromStdString(strprintf("Please wait... %d", SYSTEMNODELIST_FILTER_COOLDOWN_SECONDS)));
+    if (proxyModel)
+        proxyModel->setFilterFixedString(strFilterIn);
 }
 
 void SystemnodeList::on_startButton_clicked()
@@ -419,5 +379,6 @@ void SystemnodeList::on_UpdateButton_clicked()
         return;
     }
 
-    updateMyNodeList(true);
+    updateNodeList();
+    updateMyNodeList();
 }
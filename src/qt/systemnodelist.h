@@ -7,23 +7,20 @@
 #include <util/system.h>
 
 #include <QMenu>
-#include <QTimer>
 #include <QWidget>
 
-#define MY_SYSTEMNODELIST_UPDATE_SECONDS                 60
-#define SYSTEMNODELIST_UPDATE_SECONDS                    15
-#define SYSTEMNODELIST_FILTER_COOLDOWN_SECONDS            3
-
 namespace Ui
 {
 class SystemnodeList;
 }
 
 class ClientModel;
+class NodeTableModel;
 class WalletModel;
 
 QT_BEGIN_NAMESPACE
 class QModelIndex;
+class QSortFilterProxyModel;
 QT_END_NAMESPACE
 
 /** Systemnode Manager page widget */
@@ -39,27 +36,27 @@ public:
     void setWalletModel(WalletModel* walletModel);
     void StartAlias(std::string strAlias);
     void StartAll(std::string strCommand = "start-all");
-    void on_filterLineEdit_textChanged(const QString &strFilterIn);
 
 private:
     QMenu* contextMenu;
-    int64_t nTimeFilterUpdated{0};
-    bool fFilterUpdated{false};
 
 public Q_SLOTS:
     void updateMySystemnodeInfo(QString strAlias, QString strAddr, QString privkey, QString txHash, QString txIndex, CSystemnode *pmn);
-    void updateMyNodeList(bool fForce = false);
+    void updateMyNodeList();
+    void updateMyNode(const QString& txHash, int outputIndex);
     void updateNodeList();
+    void updateCountLabel();
+    void on_filterLineEdit_textChanged(const QString &strFilterIn);
 
 Q_SIGNALS:
 
 private:
-    QTimer* timer;
     Ui::SystemnodeList* ui;
     ClientModel* clientModel;
     WalletModel* walletModel;
+    NodeTableModel* nodeModel;
+    QSortFilterProxyModel* proxyModel;
     RecursiveMutex cs_snlistupdate;
-    QString strCurrentFilter;
 
 private Q_SLOTS:
     void notReady();
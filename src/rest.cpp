@@ -8,6 +8,11 @@
 #include <core_io.h>
 #include <httpserver.h>
 #include <index/txindex.h>
+#include <key_io.h>
+#include <masternode/masternode-budget.h>
+#include <masternode/masternode-payments.h>
+#include <masternode/masternode-sync.h>
+#include <masternode/masternodeman.h>
 #include <node/context.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
@@ -16,6 +21,9 @@
 #include <rpc/server.h>
 #include <streams.h>
 #include <sync.h>
+#include <systemnode/systemnode-payments.h>
+#include <systemnode/systemnode-sync.h>
+#include <systemnode/systemnodeman.h>
 #include <txmempool.h>
 #include <util/check.h>
 #include <util/ref.h>
@@ -667,6 +675,191 @@ static bool rest_blockhash_by_height(const util::Ref& context, HTTPRequest* req,
     }
 }
 
+/**
+ * Reply with a Crown object in the requested format. The handlers below
+ * copy the manager state first, so nothing is locked while this runs.
+ */
+template <typename Serialize, typename ToJSON>
+static bool CrownReply(HTTPRequest* req, RetFormat rf, Serialize serialize, ToJSON to_json)
+{
+    switch (rf) {
+    case RetFormat::BINARY: {
+        CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+        serialize(ss);
+        req->WriteHeader("Content-Type", "application/octet-stream");
+        req->WriteReply(HTTP_OK, ss.str());
+        return true;
+    }
+    case RetFormat::HEX: {
+        CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+        serialize(ss);
+        req->WriteHeader("Content-Type", "text/plain");
+        req->WriteReply(HTTP_OK, HexStr(ss) + "\n");
+        return true;
+    }
+    case RetFormat::JSON: {
+        UniValue result = to_json();
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, result.write() + "\n");
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+    }
+    }
+}
+
+/**
+ * The lists and the budget are only served once they are synced, but a
+ * request for an unknown format is rejected first.
+ */
+static bool CheckNodeSync(HTTPRequest* req, RetFormat rf, bool fSynced, const std::string& strType)
+{
+    if (rf == RetFormat::UNDEF)
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+    if (!fSynced)
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, strType + " sync has not yet completed");
+    return true;
+}
+
+static int RESTChainHeight()
+{
+    LOCK(cs_main);
+    return ::ChainActive().Height();
+}
+
+template <typename Node, typename InfoMap>
+static UniValue NodeListToJSON(const std::vector<Node>& vNodes, const InfoMap& info)
+{
+    UniValue result(UniValue::VARR);
+    for (const Node& node : vNodes) {
+        const std::string strStatus = node.Status();
+        auto it = info->find(node.vin.prevout);
+
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("rank", it != info->end() && strStatus == "ENABLED" ? it->second.nRank : 0);
+        obj.pushKV("txhash", node.vin.prevout.hash.ToString());
+        obj.pushKV("outidx", (uint64_t)node.vin.prevout.n);
+        obj.pushKV("pubkey", HexStr(node.pubkey2));
+        obj.pushKV("status", strStatus);
+        obj.pushKV("addr", EncodeDestination(PKHash(node.pubkey)));
+        obj.pushKV("version", node.protocolVersion);
+        obj.pushKV("ipaddr", node.addr.ToString());
+        obj.pushKV("lastseen", (int64_t)node.lastPing.sigTime);
+        obj.pushKV("activetime", (int64_t)(node.lastPing.sigTime - node.sigTime));
+        obj.pushKV("lastpaid", it != info->end() ? it->second.nLastPaid : (int64_t)0);
+        result.push_back(obj);
+    }
+    return result;
+}
+
+static bool rest_masternodes(const util::Ref& context, HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    if (!CheckNodeSync(req, rf, masternodeSync.IsSynced(), "Masternode"))
+        return false;
+
+    MasternodeListSnapshot snapshot = mnodeman.GetMasternodeListSnapshot();
+    return CrownReply(req, rf,
+        [&](CDataStream& ss) { ss << *snapshot; },
+        [&] { return NodeListToJSON(*snapshot, mnodeman.GetMasternodeListInfo(RESTChainHeight())); });
+}
+
+static bool rest_systemnodes(const util::Ref& context, HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    if (!CheckNodeSync(req, rf, systemnodeSync.IsSynced(), "Systemnode"))
+        return false;
+
+    SystemnodeListSnapshot snapshot = snodeman.GetSystemnodeListSnapshot();
+    return CrownReply(req, rf,
+        [&](CDataStream& ss) { ss << *snapshot; },
+        [&] { return NodeListToJSON(*snapshot, snodeman.GetSystemnodeListInfo(RESTChainHeight())); });
+}
+
+template <typename Payee>
+static UniValue PayeesToJSON(const std::vector<Payee>& vPayees)
+{
+    UniValue result(UniValue::VARR);
+    for (const Payee& payee : vPayees) {
+        CTxDestination dest;
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("payee", ExtractDestination(payee.scriptPubKey, dest) ? EncodeDestination(dest) : HexStr(payee.scriptPubKey));
+        obj.pushKV("votes", payee.nVotes);
+        result.push_back(obj);
+    }
+    return result;
+}
+
+static bool rest_mnpayments(const util::Ref& context, HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string height_str;
+    const RetFormat rf = ParseDataFormat(height_str, strURIPart);
+
+    int32_t nHeight = -1;
+    if (!ParseInt32(height_str, &nHeight) || nHeight < 0)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid height: " + SanitizeString(height_str));
+
+    const std::vector<CMasternodePayee> vMasternodePayees = masternodePayments.GetBlockPayees(nHeight);
+    const std::vector<CSystemnodePayee> vSystemnodePayees = systemnodePayments.GetBlockPayees(nHeight);
+    return CrownReply(req, rf,
+        [&](CDataStream& ss) { ss << nHeight << vMasternodePayees << vSystemnodePayees; },
+        [&] {
+            UniValue result(UniValue::VOBJ);
+            result.pushKV("height", nHeight);
+            result.pushKV("masternodes", PayeesToJSON(vMasternodePayees));
+            result.pushKV("systemnodes", PayeesToJSON(vSystemnodePayees));
+            return result;
+        });
+}
+
+static bool rest_budget(const util::Ref& context, HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    if (!CheckNodeSync(req, rf, masternodeSync.IsSynced(), "Masternode"))
+        return false;
+
+    const std::vector<CBudgetProposal> vProposals = budget.GetProposalsSnapshot();
+    return CrownReply(req, rf,
+        [&](CDataStream& ss) { ss << vProposals; },
+        [&] {
+            UniValue result(UniValue::VARR);
+            for (const CBudgetProposal& proposal : vProposals) {
+                CTxDestination dest;
+                ExtractDestination(proposal.GetPayee(), dest);
+
+                UniValue obj(UniValue::VOBJ);
+                obj.pushKV("Name", proposal.GetName());
+                obj.pushKV("URL", proposal.GetURL());
+                obj.pushKV("Hash", proposal.GetHash().ToString());
+                obj.pushKV("FeeHash", proposal.nFeeTXHash.ToString());
+                obj.pushKV("BlockStart", (int64_t)proposal.GetBlockStart());
+                obj.pushKV("BlockEnd", (int64_t)proposal.GetBlockEnd());
+                obj.pushKV("TotalPaymentCount", (int64_t)proposal.GetTotalPaymentCount());
+                obj.pushKV("PaymentAddress", EncodeDestination(dest));
+                obj.pushKV("Ratio", proposal.GetRatio());
+                obj.pushKV("Yeas", (int64_t)proposal.GetYeas());
+                obj.pushKV("Nays", (int64_t)proposal.GetNays());
+                obj.pushKV("Abstains", (int64_t)proposal.GetAbstains());
+                obj.pushKV("TotalPayment", ValueFromAmount(proposal.GetAmount() * proposal.GetTotalPaymentCount()));
+                obj.pushKV("MonthlyPayment", ValueFromAmount(proposal.GetAmount()));
+                result.push_back(obj);
+            }
+            return result;
+        });
+}
+
 static const struct {
     const char* prefix;
     bool (*handler)(const util::Ref& context, HTTPRequest* req, const std::string& strReq);
@@ -680,6 +873,10 @@ static const struct {
       {"/rest/headers/", rest_headers},
       {"/rest/getutxos", rest_getutxos},
       {"/rest/blockhashbyheight/", rest_blockhash_by_height},
+      {"/rest/masternodes", rest_masternodes},
+      {"/rest/systemnodes", rest_systemnodes},
+      {"/rest/mnpayments/", rest_mnpayments},
+      {"/rest/budget", rest_budget},
 };
 
 void StartREST(const util::Ref& context)
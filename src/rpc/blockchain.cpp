@@ -1277,6 +1277,11 @@ RPCHelpMan getblockchaininfo()
                         {RPCResult::Type::BOOL, "initialblockdownload", "(debug information) estimate of whether this node is in Initial Block Download mode"},
                         {RPCResult::Type::STR_HEX, "chainwork", "total amount of work in active chain, in hexadecimal"},
                         {RPCResult::Type::NUM, "size_on_disk", "the estimated size of the block and undo files on disk"},
+                        {RPCResult::Type::OBJ, "coinsprefetch", "inputs of the blocks connected since startup",
+                        {
+                            {RPCResult::Type::NUM, "hits", "inputs that were in the coins cache already"},
+                            {RPCResult::Type::NUM, "misses", "inputs that were read from the database ahead of connecting the block"},
+                        }},
                         {RPCResult::Type::BOOL, "pruned", "if the blocks are subject to pruning"},
                         {RPCResult::Type::NUM, "pruneheight", "lowest-height complete block stored (only present if pruning is enabled)"},
                         {RPCResult::Type::BOOL, "automatic_pruning", "whether automatic pruning is enabled (only present if pruning is enabled)"},
@@ -1328,6 +1333,10 @@ RPCHelpMan getblockchaininfo()
     obj.pushKV("initialblockdownload",  ::ChainstateActive().IsInitialBlockDownload());
     obj.pushKV("chainwork",             tip->nChainWork.GetHex());
     obj.pushKV("size_on_disk",          CalculateCurrentUsage());
+    UniValue prefetch(UniValue::VOBJ);
+    prefetch.pushKV("hits",             g_coins_prefetch_stats.nHits);
+    prefetch.pushKV("misses",           g_coins_prefetch_stats.nMisses);
+    obj.pushKV("coinsprefetch",         prefetch);
     obj.pushKV("pruned",                fPruneMode);
     if (fPruneMode) {
         const CBlockIndex* block = tip;
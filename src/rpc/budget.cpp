@@ -30,6 +30,49 @@
 
 #include <fstream>
 
+/**
+ * Vote with every masternode run by this node (see -nodehost). vote returns
+ * whether it succeeded and sets its result message. A single masternode
+ * answers with that message, several with the overall and per alias results
+ * of vote-many.
+ */
+template <typename F>
+static UniValue VoteWithActiveMasternodes(F vote)
+{
+    const std::vector<CActiveMasternode*> vActive = GetActiveMasternodes();
+
+    int success = 0;
+    int failed = 0;
+    std::string strResult;
+    UniValue resultsObj(UniValue::VOBJ);
+    for (CActiveMasternode* pactive : vActive) {
+        UniValue statusObj(UniValue::VOBJ);
+        if (!pactive->keyMasternode.IsValid()) {
+            strResult = "Error upon calling SetKey";
+        } else if (!mnodeman.Find(pactive->vin)) {
+            strResult = "Failure to find masternode in list : " + pactive->vin.ToString();
+        } else if (vote(*pactive, strResult)) {
+            success++;
+            statusObj.pushKV("result", "success");
+            resultsObj.pushKV(pactive->strAlias, statusObj);
+            continue;
+        }
+        failed++;
+        statusObj.pushKV("result", "failed");
+        statusObj.pushKV("errorMessage", strResult);
+        resultsObj.pushKV(pactive->strAlias, statusObj);
+    }
+
+    if (vActive.size() == 1)
+        return strResult;
+
+    UniValue returnObj(UniValue::VOBJ);
+    returnObj.pushKV("overall", strprintf("Voted successfully %d time(s) and failed %d time(s).", success, failed));
+    returnObj.pushKV("detail", resultsObj);
+
+    return returnObj;
+}
+
 UniValue mnbudget(const JSONRPCRequest& request)
 {
     std::string strCommand;
@@ -299,30 +342,23 @@ UniValue mnbudget(const JSONRPCRequest& request)
         if (strVote == "no")
             nVote = VOTE_NO;
 
-        CPubKey pubKeyMasternode;
-        CKey keyMasternode;
-        std::string errorMessage;
-
-        if (!legacySigner.SetKey(strMasterNodePrivKey, keyMasternode, pubKeyMasternode))
-            return "Error upon calling SetKey";
-
-        CMasternode* pmn = mnodeman.Find(activeMasternode.vin);
-        if (!pmn) {
-            return "Failure to find masternode in list : " + activeMasternode.vin.ToString();
-        }
-
-        CBudgetVote vote(activeMasternode.vin, hash, nVote);
-        if (!vote.Sign(keyMasternode, pubKeyMasternode)) {
-            return "Failure to sign.";
-        }
+        return VoteWithActiveMasternodes([&](CActiveMasternode& active, std::string& strResult) {
+            CBudgetVote vote(active.vin, hash, nVote);
+            if (!vote.Sign(active.keyMasternode, active.pubKeyMasternode)) {
+                strResult = "Failure to sign.";
+                return false;
+            }
 
-        std::string strError = "";
-        if (budget.SubmitProposalVote(vote, strError)) {
-            vote.Relay(*g_rpc_node->connman);
-            return "Voted successfully";
-        } else {
-            return "Error voting : " + strError;
-        }
+            std::string strError = "";
+            if (budget.SubmitProposalVote(vote, strError)) {
+                vote.Relay(*g_rpc_node->connman);
+                strResult = "Voted successfully";
+                return true;
+            } else {
+                strResult = "Error voting : " + strError;
+                return false;
+            }
+        });
     }
 
     if (strCommand == "projection") {
@@ -640,30 +676,23 @@ UniValue mnfinalbudget(const JSONRPCRequest& request)
         std::string strHash = request.params[1].get_str();
         uint256 hash(uint256S(strHash));
 
-        CPubKey pubKeyMasternode;
-        CKey keyMasternode;
-        std::string errorMessage;
-
-        if (!legacySigner.SetKey(strMasterNodePrivKey, keyMasternode, pubKeyMasternode))
-            return "Error upon calling SetKey";
-
-        CMasternode* pmn = mnodeman.Find(activeMasternode.vin);
-        if (!pmn) {
-            return "Failure to find masternode in list : " + activeMasternode.vin.ToString();
-        }
-
-        BudgetDraftVote vote(activeMasternode.vin, hash);
-        if (!vote.Sign(keyMasternode, pubKeyMasternode)) {
-            return "Failure to sign.";
-        }
+        return VoteWithActiveMasternodes([&](CActiveMasternode& active, std::string& strResult) {
+            BudgetDraftVote vote(active.vin, hash);
+            if (!vote.Sign(active.keyMasternode, active.pubKeyMasternode)) {
+                strResult = "Failure to sign.";
+                return false;
+            }
 
-        std::string strError = "";
-        if (budget.UpdateBudgetDraft(vote, nullptr, *g_rpc_node->connman, strError)) {
-            vote.Relay(*g_rpc_node->connman);
-            return "success";
-        } else {
-            return "Error voting : " + strError;
-        }
+            std::string strError = "";
+            if (budget.UpdateBudgetDraft(vote, nullptr, *g_rpc_node->connman, strError)) {
+                vote.Relay(*g_rpc_node->connman);
+                strResult = "success";
+                return true;
+            } else {
+                strResult = "Error voting : " + strError;
+                return false;
+            }
+        });
     }
 
     if (strCommand == "show") {
@@ -188,6 +188,12 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "getnodeaddresses", 0, "count"},
     { "addpeeraddress", 1, "port"},
     { "stop", 0, "wait" },
+    { "listmasternodes", 1, "offset" },
+    { "listmasternodes", 2, "limit" },
+    { "listmasternodes", 4, "minprotocol" },
+    { "listsystemnodes", 1, "offset" },
+    { "listsystemnodes", 2, "limit" },
+    { "listsystemnodes", 4, "minprotocol" },
 };
 // clang-format on
 
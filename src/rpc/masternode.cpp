@@ -25,18 +25,18 @@
 
 UniValue listmasternodes(const JSONRPCRequest& request)
 {
-    std::string strFilter = "";
-
-    if (request.params.size() == 1)
-        strFilter = request.params[0].get_str();
-
-    if (request.fHelp || (request.params.size() > 1))
+    if (request.fHelp || (request.params.size() > 6))
         throw std::runtime_error(
-            "listmasternodes ( \"filter\" )\n"
+            "listmasternodes ( \"filter\" offset limit \"status\" minprotocol \"fields\" )\n"
             "\nGet a ranked list of masternodes\n"
 
             "\nArguments:\n"
             "1. \"filter\"    (string, optional) Filter search text. Partial match by txhash, status, or addr.\n"
+            "2. offset      (numeric, optional, default=0) Number of matching entries to skip\n"
+            "3. limit       (numeric, optional, default=0) Maximum number of entries to return, 0 for no limit\n"
+            "4. \"status\"    (string, optional, default=\"ENABLED\") Only list entries with this status, \"ALL\" for any status\n"
+            "5. minprotocol (numeric, optional, default=0) Only list entries with at least this protocol version\n"
+            "6. \"fields\"    (string, optional) Comma separated list of the fields to return, all fields if empty\n"
 
             "\nResult:\n"
             "[\n"
@@ -55,9 +55,34 @@ UniValue listmasternodes(const JSONRPCRequest& request)
             "  }\n"
             "  ,...\n"
             "]\n"
+            "\nRank and lastpaid are computed once per block.\n"
 
             "\nExamples:\n"
-            + HelpExampleCli("listmasternodes", "") + HelpExampleRpc("listmasternodes", ""));
+            + HelpExampleCli("listmasternodes", "") + HelpExampleCli("listmasternodes", "\"\" 0 10 \"ALL\" 0 \"txhash,outidx,status\"")
+            + HelpExampleRpc("listmasternodes", ""));
+
+    std::string strFilter = request.params.size() > 0 ? request.params[0].get_str() : "";
+    int nOffset = request.params.size() > 1 ? request.params[1].get_int() : 0;
+    int nLimit = request.params.size() > 2 ? request.params[2].get_int() : 0;
+    std::string strStatus = request.params.size() > 3 ? request.params[3].get_str() : "ENABLED";
+    int nMinProtocol = request.params.size() > 4 ? request.params[4].get_int() : 0;
+    if (nOffset < 0 || nLimit < 0)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative offset or limit");
+
+    static const std::set<std::string> setAllFields = {"rank", "txhash", "outidx", "pubkey", "status", "addr", "version", "ipaddr", "lastseen", "activetime", "lastpaid"};
+    std::set<std::string> setFields;
+    if (request.params.size() > 5) {
+        std::string strFields = request.params[5].get_str();
+        boost::char_separator<char> sep(", ");
+        boost::tokenizer<boost::char_separator<char>> tokens(strFields, sep);
+        for (const std::string& t : tokens) {
+            if (!setAllFields.count(t))
+                throw JSONRPCError(RPC_INVALID_PARAMETER, "Unknown field: " + t);
+            setFields.insert(t);
+        }
+    }
+    if (setFields.empty())
+        setFields = setAllFields;
 
     if (!masternodeSync.IsSynced()) {
         throw std::runtime_error("Masternode sync has not yet completed.\n");
@@ -73,37 +98,62 @@ UniValue listmasternodes(const JSONRPCRequest& request)
         nHeight = pindex->nHeight;
     }
 
-    std::vector<std::pair<int, CMasternode>> vMasternodeRanks = mnodeman.GetMasternodeRanks(nHeight);
-    for (const auto& s : vMasternodeRanks) {
-        UniValue obj(UniValue::VOBJ);
-        std::string strVin = s.second.vin.prevout.ToStringShort();
-        std::string strTxHash = s.second.vin.prevout.hash.ToString();
-        uint32_t oIdx = s.second.vin.prevout.n;
-        CMasternode* mn = mnodeman.Find(s.second.vin);
+    MasternodeListSnapshot snapshot = mnodeman.GetMasternodeListSnapshot();
+    MasternodeListInfoMap info = mnodeman.GetMasternodeListInfo(nHeight);
 
-        if (mn) {
-            if (strFilter != "" && strTxHash.find(strFilter) == std::string::npos && mn->Status().find(strFilter) == std::string::npos && EncodeDestination(PKHash(mn->pubkey)).find(strFilter) == std::string::npos)
-                continue;
+    // ranked entries first, in order of rank, then everything else in list order
+    std::vector<std::pair<int, const CMasternode*>> vEntries;
+    for (const CMasternode& mn : *snapshot) {
+        std::string strMasternodeStatus = mn.Status();
+        if (strStatus != "ALL" && strMasternodeStatus != strStatus)
+            continue;
+        if (mn.protocolVersion < nMinProtocol)
+            continue;
+        if (strFilter != "" && mn.vin.prevout.hash.ToString().find(strFilter) == std::string::npos && strMasternodeStatus.find(strFilter) == std::string::npos && EncodeDestination(PKHash(mn.pubkey)).find(strFilter) == std::string::npos)
+            continue;
 
-            std::string strStatus = mn->Status();
-            std::string strHost;
-            int port;
-            SplitHostPort(mn->addr.ToString(), port, strHost);
+        auto it = info->find(mn.vin.prevout);
+        int nRank = (it != info->end() && strMasternodeStatus == "ENABLED") ? it->second.nRank : 0;
+        vEntries.emplace_back(nRank, &mn);
+    }
+    std::stable_sort(vEntries.begin(), vEntries.end(), [](const std::pair<int, const CMasternode*>& a, const std::pair<int, const CMasternode*>& b) {
+        if (a.first == 0 || b.first == 0)
+            return a.first != 0 && b.first == 0;
+        return a.first < b.first;
+    });
+
+    size_t nEnd = vEntries.size();
+    if (nLimit > 0)
+        nEnd = std::min(nEnd, (size_t)nOffset + nLimit);
+    for (size_t i = nOffset; i < nEnd; i++) {
+        const CMasternode* mn = vEntries[i].second;
+        auto it = info->find(mn->vin.prevout);
 
-            obj.pushKV("rank", (strStatus == "ENABLED" ? s.first : 0));
-            obj.pushKV("txhash", strTxHash);
-            obj.pushKV("outidx", (uint64_t)oIdx);
+        UniValue obj(UniValue::VOBJ);
+        if (setFields.count("rank"))
+            obj.pushKV("rank", vEntries[i].first);
+        if (setFields.count("txhash"))
+            obj.pushKV("txhash", mn->vin.prevout.hash.ToString());
+        if (setFields.count("outidx"))
+            obj.pushKV("outidx", (uint64_t)mn->vin.prevout.n);
+        if (setFields.count("pubkey"))
             obj.pushKV("pubkey", HexStr(mn->pubkey2));
-            obj.pushKV("status", strStatus);
+        if (setFields.count("status"))
+            obj.pushKV("status", mn->Status());
+        if (setFields.count("addr"))
             obj.pushKV("addr", EncodeDestination(PKHash(mn->pubkey)));
+        if (setFields.count("version"))
             obj.pushKV("version", mn->protocolVersion);
+        if (setFields.count("ipaddr"))
             obj.pushKV("ipaddr", mn->addr.ToString());
+        if (setFields.count("lastseen"))
             obj.pushKV("lastseen", (int64_t)mn->lastPing.sigTime);
+        if (setFields.count("activetime"))
             obj.pushKV("activetime", (int64_t)(mn->lastPing.sigTime - mn->sigTime));
-            obj.pushKV("lastpaid", (int64_t)mn->GetLastPaid());
+        if (setFields.count("lastpaid"))
+            obj.pushKV("lastpaid", it != info->end() ? it->second.nLastPaid : (int64_t)0);
 
-            ret.push_back(obj);
-        }
+        ret.push_back(obj);
     }
 
     return ret;
@@ -276,6 +326,15 @@ UniValue startmasternode(const JSONRPCRequest& request)
             "\nResult: (for 'local' set):\n"
             "\"status\"     (string) Masternode status message\n"
 
+            "\nResult: (for 'local' set with -nodehost):\n"
+            "[\n"
+            "  {\n"
+            "    \"alias\": \"xxxx\",   (string) Masternode alias in masternode.conf\n"
+            "    \"status\": \"xxxx\"   (string) Masternode status message\n"
+            "  }\n"
+            "  ,...\n"
+            "]\n"
+
             "\nResult: (for other sets):\n"
             "{\n"
             "  \"overall\": \"xxxx\",     (string) Overall status message\n"
@@ -298,13 +357,27 @@ UniValue startmasternode(const JSONRPCRequest& request)
         if (!fMasterNode)
             throw std::runtime_error("you must set masternode=1 in the configuration\n");
 
-        if (activeMasternode.status != ACTIVE_MASTERNODE_STARTED) {
-            activeMasternode.status = ACTIVE_MASTERNODE_INITIAL;
-            activeMasternode.ManageStatus(*g_rpc_node->connman);
-            if (fLock)
-                GetMainWallet()->Lock();
+        bool fStarting = false;
+        for (CActiveMasternode* pactive : GetActiveMasternodes()) {
+            if (pactive->status != ACTIVE_MASTERNODE_STARTED) {
+                pactive->status = ACTIVE_MASTERNODE_INITIAL;
+                pactive->ManageStatus(*g_rpc_node->connman);
+                fStarting = true;
+            }
         }
+        if (fStarting && fLock)
+            GetMainWallet()->Lock();
 
+        if (gArgs.GetBoolArg("-nodehost", false)) {
+            UniValue ret(UniValue::VARR);
+            for (const CActiveMasternode* pactive : GetActiveMasternodes()) {
+                UniValue mnObj(UniValue::VOBJ);
+                mnObj.pushKV("alias", pactive->strAlias);
+                mnObj.pushKV("status", pactive->GetStatus());
+                ret.push_back(mnObj);
+            }
+            return ret;
+        }
         return activeMasternode.GetStatus();
     }
 
@@ -501,6 +574,8 @@ UniValue getmasternodestatus(const JSONRPCRequest& request)
             "  \"status\": \"xxxx\",      (string) Masternode status\n"
             "  \"message\": \"xxxx\"      (string) Masternode status message\n"
             "}\n"
+            "\nResult (with -nodehost): an array of the above, one for every masternode run by this node,\n"
+            "with the \"alias\" of the masternode in masternode.conf\n"
 
             "\nExamples:\n"
             + HelpExampleCli("getmasternodestatus", "") + HelpExampleRpc("getmasternodestatus", ""));
@@ -508,6 +583,25 @@ UniValue getmasternodestatus(const JSONRPCRequest& request)
     if (!fMasterNode)
         throw JSONRPCError(RPC_MISC_ERROR, ("This is not a masternode."));
 
+    if (gArgs.GetBoolArg("-nodehost", false)) {
+        UniValue ret(UniValue::VARR);
+        for (const CActiveMasternode* pactive : GetActiveMasternodes()) {
+            UniValue mnObj(UniValue::VOBJ);
+            mnObj.pushKV("alias", pactive->strAlias);
+            mnObj.pushKV("txid", pactive->vin.prevout.hash.ToString());
+            mnObj.pushKV("outputidx", (uint64_t)pactive->vin.prevout.n);
+            mnObj.pushKV("netaddr", pactive->service.ToString());
+            CMasternode* pmn = pactive->vin == CTxIn() ? nullptr : mnodeman.Find(pactive->vin);
+            if (pmn)
+                mnObj.pushKV("addr", EncodeDestination(PKHash(pmn->pubkey)));
+            mnObj.pushKV("status", pactive->GetStatus());
+            if (!pmn)
+                mnObj.pushKV("message", "Masternode not found in the list of available masternodes");
+            ret.push_back(mnObj);
+        }
+        return ret;
+    }
+
     if (activeMasternode.vin == CTxIn())
         throw JSONRPCError(RPC_MISC_ERROR, ("Active Masternode not initialized."));
 
@@ -526,6 +620,46 @@ UniValue getmasternodestatus(const JSONRPCRequest& request)
         + activeMasternode.GetStatus());
 }
 
+UniValue listhostedmasternodes(const JSONRPCRequest& request)
+{
+    if (request.fHelp || (request.params.size() != 0))
+        throw std::runtime_error(
+            "listhostedmasternodes\n"
+            "\nPrint the status of every masternode run by this node (see -nodehost)\n"
+
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"alias\": \"xxxx\",      (string) Masternode alias in masternode.conf\n"
+            "    \"txhash\": \"xxxx\",     (string) Collateral transaction hash\n"
+            "    \"outputidx\": n,         (numeric) Collateral transaction output index number\n"
+            "    \"netaddr\": \"xxxx\",    (string) Masternode network address\n"
+            "    \"pubkey\": \"xxxx\",     (string) Masternode operator public key\n"
+            "    \"status\": \"xxxx\"      (string) Masternode status message\n"
+            "  }\n"
+            "  ,...\n"
+            "]\n"
+
+            "\nExamples:\n"
+            + HelpExampleCli("listhostedmasternodes", "") + HelpExampleRpc("listhostedmasternodes", ""));
+
+    if (!fMasterNode)
+        throw JSONRPCError(RPC_MISC_ERROR, ("This is not a masternode."));
+
+    UniValue ret(UniValue::VARR);
+    for (const CActiveMasternode* pactive : GetActiveMasternodes()) {
+        UniValue mnObj(UniValue::VOBJ);
+        mnObj.pushKV("alias", pactive->strAlias);
+        mnObj.pushKV("txhash", pactive->vin.prevout.hash.ToString());
+        mnObj.pushKV("outputidx", (uint64_t)pactive->vin.prevout.n);
+        mnObj.pushKV("netaddr", pactive->service.ToString());
+        mnObj.pushKV("pubkey", HexStr(pactive->pubKeyMasternode));
+        mnObj.pushKV("status", pactive->GetStatus());
+        ret.push_back(mnObj);
+    }
+    return ret;
+}
+
 UniValue getmasternodewinners(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 3)
@@ -668,11 +802,11 @@ UniValue getmasternodescores(const JSONRPCRequest& request)
     }
     UniValue obj(UniValue::VOBJ);
 
-    std::vector<CMasternode> vMasternodes = mnodeman.GetFullMasternodeVector();
+    MasternodeListSnapshot vMasternodes = mnodeman.GetMasternodeListSnapshot();
     for (int nHeight = ::ChainActive().Tip()->nHeight - nLast; nHeight < ::ChainActive().Tip()->nHeight + 20; nHeight++) {
         uint256 nHigh;
-        CMasternode* pBestMasternode = NULL;
-        for (CMasternode& mn : vMasternodes) {
+        const CMasternode* pBestMasternode = NULL;
+        for (const CMasternode& mn : *vMasternodes) {
             uint256 n = ArithToUint256(mn.CalculateScore(nHeight));
             if (UintToArith256(n) > UintToArith256(nHigh)) {
                 nHigh = n;
@@ -876,7 +1010,7 @@ void RegisterMasternodeCommands(CRPCTable& t)
     static const CRPCCommand commands[] = {
         //  category              name                         actor (function)            arguments
         //  --------------------- ------------------------     ------------------          ---------
-        { "masternode", "listmasternodes", &listmasternodes, {} },
+        { "masternode", "listmasternodes", &listmasternodes, {"filter", "offset", "limit", "status", "minprotocol", "fields"} },
         { "masternode", "getmasternodecount", &getmasternodecount, {} },
         { "masternode", "createmasternodebroadcast", &createmasternodebroadcast, {} },
         { "masternode", "decodemasternodebroadcast", &decodemasternodebroadcast, {} },
@@ -886,6 +1020,7 @@ void RegisterMasternodeCommands(CRPCTable& t)
         { "masternode", "getmasternodeoutputs", &getmasternodeoutputs, {} },
         { "masternode", "listmasternodeconf", &listmasternodeconf, {} },
         { "masternode", "getmasternodestatus", &getmasternodestatus, {} },
+        { "masternode", "listhostedmasternodes", &listhostedmasternodes, {} },
         { "masternode", "getmasternodewinners", &getmasternodewinners, {} },
         { "masternode", "getmasternodescores", &getmasternodescores, {} },
     };
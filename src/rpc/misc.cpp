@@ -3,14 +3,22 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <crown/instantx.h>
 #include <crown/nodewallet.h>
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <key_io.h>
+#include <masternode/masternode-budget.h>
+#include <masternode/masternode-payments.h>
 #include <masternode/masternode-sync.h>
+#include <masternode/masternodeman.h>
+#include <memusage.h>
+#include <pos/prooftracker.h>
+#include <systemnode/systemnode-payments.h>
 #include <systemnode/systemnode-sync.h>
+#include <systemnode/systemnodeman.h>
 #include <node/context.h>
 #include <outputtype.h>
 #include <rpc/blockchain.h>
@@ -444,6 +452,32 @@ static UniValue RPCLockedMemoryInfo()
     return obj;
 }
 
+static UniValue RPCCrownMemoryInfo()
+{
+    std::vector<std::pair<std::string, size_t>> vUsage;
+    vUsage.emplace_back("mnodeman", mnodeman.DynamicMemoryUsage());
+    vUsage.emplace_back("snodeman", snodeman.DynamicMemoryUsage());
+    vUsage.emplace_back("masternodepayments", masternodePayments.DynamicMemoryUsage());
+    vUsage.emplace_back("systemnodepayments", systemnodePayments.DynamicMemoryUsage());
+    vUsage.emplace_back("budget", budget.DynamicMemoryUsage());
+    vUsage.emplace_back("instantsend", instantSend.DynamicMemoryUsage());
+    {
+        LOCK(cs_main);
+        vUsage.emplace_back("usedstakepointers", memusage::DynamicUsage(mapUsedStakePointers));
+        vUsage.emplace_back("blockhashcache", memusage::DynamicUsage(mapCacheBlockHashes));
+        vUsage.emplace_back("prooftracker", g_proofTracker->DynamicMemoryUsage());
+    }
+
+    UniValue obj(UniValue::VOBJ);
+    size_t nTotal = 0;
+    for (const auto& usage : vUsage) {
+        obj.pushKV(usage.first, uint64_t(usage.second));
+        nTotal += usage.second;
+    }
+    obj.pushKV("total", uint64_t(nTotal));
+    return obj;
+}
+
 #ifdef HAVE_MALLOC_INFO
 static std::string RPCMallocInfo()
 {
@@ -473,6 +507,7 @@ static RPCHelpMan getmemoryinfo()
                 {
                     {"mode", RPCArg::Type::STR, /* default */ "\"stats\"", "determines what kind of information is returned.\n"
             "  - \"stats\" returns general statistics about memory usage in the daemon.\n"
+            "  - \"crown\" returns the estimated heap usage of the masternode, systemnode, budget and staking data in bytes.\n"
             "  - \"mallocinfo\" returns an XML string describing low-level heap state (only available if compiled with glibc 2.10+)."},
                 },
                 {
@@ -490,6 +525,21 @@ static RPCHelpMan getmemoryinfo()
                             }},
                         }
                     },
+                    RPCResult{"mode \"crown\"",
+                        RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::NUM, "mnodeman", "Masternode list and seen broadcasts and pings"},
+                            {RPCResult::Type::NUM, "snodeman", "Systemnode list and seen broadcasts and pings"},
+                            {RPCResult::Type::NUM, "masternodepayments", "Masternode payment votes and block payees"},
+                            {RPCResult::Type::NUM, "systemnodepayments", "Systemnode payment votes and block payees"},
+                            {RPCResult::Type::NUM, "budget", "Budget proposals, drafts and votes"},
+                            {RPCResult::Type::NUM, "instantsend", "InstantSend lock requests, locks and votes"},
+                            {RPCResult::Type::NUM, "usedstakepointers", "Stake pointers used by blocks"},
+                            {RPCResult::Type::NUM, "blockhashcache", "Cached block hashes used for node scoring"},
+                            {RPCResult::Type::NUM, "prooftracker", "Stake and block witness tracking"},
+                            {RPCResult::Type::NUM, "total", "Sum of the above"},
+                        }
+                    },
                     RPCResult{"mode \"mallocinfo\"",
                         RPCResult::Type::STR, "", "\"<malloc version=\"1\">...\""
                     },
@@ -505,6 +555,8 @@ static RPCHelpMan getmemoryinfo()
         UniValue obj(UniValue::VOBJ);
         obj.pushKV("locked", RPCLockedMemoryInfo());
         return obj;
+    } else if (mode == "crown") {
+        return RPCCrownMemoryInfo();
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
         return RPCMallocInfo();
@@ -756,6 +808,8 @@ static RPCHelpMan mnsync()
     {
         ++masternodeSync.RequestedMasternodeAssets;
         ++systemnodeSync.RequestedSystemnodeAssets;
+        masternodeSync.ScheduleStep();
+        systemnodeSync.ScheduleStep();
         return "success";
     }
 
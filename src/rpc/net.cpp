@@ -7,6 +7,7 @@
 #include <banman.h>
 #include <clientversion.h>
 #include <core_io.h>
+#include <msgstats.h>
 #include <net.h>
 #include <net_permissions.h>
 #include <net_processing.h>
@@ -498,6 +499,77 @@ static RPCHelpMan getnettotals()
     };
 }
 
+static std::string HistogramBucketName(size_t nBucket)
+{
+    auto FormatMicros = [](int64_t nMicros) {
+        if (nMicros >= 1000000) return strprintf("%ds", nMicros / 1000000);
+        if (nMicros >= 1000) return strprintf("%dms", nMicros / 1000);
+        return strprintf("%dus", nMicros);
+    };
+    if (nBucket < MSGSTATS_HISTOGRAM_BOUNDS.size())
+        return "<" + FormatMicros(MSGSTATS_HISTOGRAM_BOUNDS[nBucket]);
+    return ">=" + FormatMicros(MSGSTATS_HISTOGRAM_BOUNDS.back());
+}
+
+static RPCHelpMan getmsgstats()
+{
+    return RPCHelpMan{"getmsgstats",
+                "\nReturns how many messages of each type were received and how long the message handler spent on them.\n"
+                "Types that were never received are left out unless asked for.\n",
+                {
+                    {"type", RPCArg::Type::STR, /* default */ "all types", "Only return the statistics of this message type"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ_DYN, "", "",
+                    {
+                        {RPCResult::Type::OBJ, "type", "The message type",
+                        {
+                            {RPCResult::Type::NUM, "count", "Number of messages handled"},
+                            {RPCResult::Type::NUM, "bytes", "Total payload size"},
+                            {RPCResult::Type::NUM, "time_us", "Total handling time in microseconds"},
+                            {RPCResult::Type::NUM, "avg_time_us", "Average handling time in microseconds"},
+                            {RPCResult::Type::NUM, "max_time_us", "Longest handling time in microseconds"},
+                            {RPCResult::Type::OBJ_DYN, "histogram", "Number of messages per handling time bucket",
+                            {
+                                {RPCResult::Type::NUM, "bucket", "Messages handled in less than the given time"},
+                            }},
+                        }},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getmsgstats", "")
+            + HelpExampleCli("getmsgstats", "\"mnb\"")
+            + HelpExampleRpc("getmsgstats", "\"mnb\"")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const std::string strType = request.params[0].isNull() ? "" : request.params[0].get_str();
+
+    UniValue ret(UniValue::VOBJ);
+    for (const CMessageTypeStats& stats : MessageStats().GetStats()) {
+        if (strType.empty() ? stats.nCount == 0 : stats.strType != strType)
+            continue;
+
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("count", stats.nCount);
+        obj.pushKV("bytes", stats.nBytes);
+        obj.pushKV("time_us", stats.nTimeMicros);
+        obj.pushKV("avg_time_us", stats.nCount ? stats.nTimeMicros / stats.nCount : 0);
+        obj.pushKV("max_time_us", stats.nMaxTimeMicros);
+        UniValue histogram(UniValue::VOBJ);
+        for (size_t i = 0; i < stats.vHistogram.size(); i++)
+            histogram.pushKV(HistogramBucketName(i), stats.vHistogram[i]);
+        obj.pushKV("histogram", histogram);
+        ret.pushKV(stats.strType, obj);
+    }
+    if (!strType.empty() && ret.empty())
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Unknown message type " + strType);
+
+    return ret;
+},
+    };
+}
+
 static UniValue GetNetworksInfo()
 {
     UniValue networks(UniValue::VARR);
@@ -904,6 +976,7 @@ static const CRPCCommand commands[] =
     { "network",            "disconnectnode",         &disconnectnode,         {"address", "nodeid"} },
     { "network",            "getaddednodeinfo",       &getaddednodeinfo,       {"node"} },
     { "network",            "getnettotals",           &getnettotals,           {} },
+    { "network",            "getmsgstats",            &getmsgstats,            {"type"} },
     { "network",            "getnetworkinfo",         &getnetworkinfo,         {} },
     { "network",            "setban",                 &setban,                 {"subnet", "command", "bantime", "absolute"} },
     { "network",            "listbanned",             &listbanned,             {} },
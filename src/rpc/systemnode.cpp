@@ -24,18 +24,18 @@
 
 UniValue listsystemnodes(const JSONRPCRequest& request)
 {
-    std::string strFilter = "";
-
-    if (request.params.size() == 1)
-        strFilter = request.params[0].get_str();
-
-    if (request.fHelp || (request.params.size() > 1))
+    if (request.fHelp || (request.params.size() > 6))
         throw std::runtime_error(
-            "listsystemnodes ( \"filter\" )\n"
+            "listsystemnodes ( \"filter\" offset limit \"status\" minprotocol \"fields\" )\n"
             "\nGet a ranked list of systemnodes\n"
 
             "\nArguments:\n"
             "1. \"filter\"    (string, optional) Filter search text. Partial match by txhash, status, or addr.\n"
+            "2. offset      (numeric, optional, default=0) Number of matching entries to skip\n"
+            "3. limit       (numeric, optional, default=0) Maximum number of entries to return, 0 for no limit\n"
+            "4. \"status\"    (string, optional, default=\"ENABLED\") Only list entries with this status, \"ALL\" for any status\n"
+            "5. minprotocol (numeric, optional, default=0) Only list entries with at least this protocol version\n"
+            "6. \"fields\"    (string, optional) Comma separated list of the fields to return, all fields if empty\n"
 
             "\nResult:\n"
             "[\n"
@@ -54,9 +54,34 @@ UniValue listsystemnodes(const JSONRPCRequest& request)
             "  }\n"
             "  ,...\n"
             "]\n"
+            "\nRank and lastpaid are computed once per block.\n"
 
             "\nExamples:\n"
-            + HelpExampleCli("listsystemnodes", "") + HelpExampleRpc("listsystemnodes", ""));
+            + HelpExampleCli("listsystemnodes", "") + HelpExampleCli("listsystemnodes", "\"\" 0 10 \"ALL\" 0 \"txhash,outidx,status\"")
+            + HelpExampleRpc("listsystemnodes", ""));
+
+    std::string strFilter = request.params.size() > 0 ? request.params[0].get_str() : "";
+    int nOffset = request.params.size() > 1 ? request.params[1].get_int() : 0;
+    int nLimit = request.params.size() > 2 ? request.params[2].get_int() : 0;
+    std::string strStatus = request.params.size() > 3 ? request.params[3].get_str() : "ENABLED";
+    int nMinProtocol = request.params.size() > 4 ? request.params[4].get_int() : 0;
+    if (nOffset < 0 || nLimit < 0)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative offset or limit");
+
+    static const std::set<std::string> setAllFields = {"rank", "txhash", "outidx", "pubkey", "status", "addr", "version", "ipaddr", "lastseen", "activetime", "lastpaid"};
+    std::set<std::string> setFields;
+    if (request.params.size() > 5) {
+        std::string strFields = request.params[5].get_str();
+        boost::char_separator<char> sep(", ");
+        boost::tokenizer<boost::char_separator<char>> tokens(strFields, sep);
+        for (const std::string& t : tokens) {
+            if (!setAllFields.count(t))
+                throw JSONRPCError(RPC_INVALID_PARAMETER, "Unknown field: " + t);
+            setFields.insert(t);
+        }
+    }
+    if (setFields.empty())
+        setFields = setAllFields;
 
     if (!systemnodeSync.IsSynced()) {
         throw std::runtime_error("Systemnode sync has not yet completed.\n");
@@ -72,37 +97,62 @@ UniValue listsystemnodes(const JSONRPCRequest& request)
         nHeight = pindex->nHeight;
     }
 
-    std::vector<std::pair<int, CSystemnode>> vSystemnodeRanks = snodeman.GetSystemnodeRanks(nHeight);
-    for (const auto& s : vSystemnodeRanks) {
-        UniValue obj(UniValue::VOBJ);
-        std::string strVin = s.second.vin.prevout.ToStringShort();
-        std::string strTxHash = s.second.vin.prevout.hash.ToString();
-        uint32_t oIdx = s.second.vin.prevout.n;
-        CSystemnode* sn = snodeman.Find(s.second.vin);
+    SystemnodeListSnapshot snapshot = snodeman.GetSystemnodeListSnapshot();
+    SystemnodeListInfoMap info = snodeman.GetSystemnodeListInfo(nHeight);
 
-        if (sn) {
-            if (strFilter != "" && strTxHash.find(strFilter) == std::string::npos && sn->Status().find(strFilter) == std::string::npos && EncodeDestination(PKHash(sn->pubkey)).find(strFilter) == std::string::npos)
-                continue;
+    // ranked entries first, in order of rank, then everything else in list order
+    std::vector<std::pair<int, const CSystemnode*>> vEntries;
+    for (const CSystemnode& sn : *snapshot) {
+        std::string strSystemnodeStatus = sn.Status();
+        if (strStatus != "ALL" && strSystemnodeStatus != strStatus)
+            continue;
+        if (sn.protocolVersion < nMinProtocol)
+            continue;
+        if (strFilter != "" && sn.vin.prevout.hash.ToString().find(strFilter) == std::string::npos && strSystemnodeStatus.find(strFilter) == std::string::npos && EncodeDestination(PKHash(sn.pubkey)).find(strFilter) == std::string::npos)
+            continue;
 
-            std::string strStatus = sn->Status();
-            std::string strHost;
-            int port;
-            SplitHostPort(sn->addr.ToString(), port, strHost);
+        auto it = info->find(sn.vin.prevout);
+        int nRank = (it != info->end() && strSystemnodeStatus == "ENABLED") ? it->second.nRank : 0;
+        vEntries.emplace_back(nRank, &sn);
+    }
+    std::stable_sort(vEntries.begin(), vEntries.end(), [](const std::pair<int, const CSystemnode*>& a, const std::pair<int, const CSystemnode*>& b) {
+        if (a.first == 0 || b.first == 0)
+            return a.first != 0 && b.first == 0;
+        return a.first < b.first;
+    });
+
+    size_t nEnd = vEntries.size();
+    if (nLimit > 0)
+        nEnd = std::min(nEnd, (size_t)nOffset + nLimit);
+    for (size_t i = nOffset; i < nEnd; i++) {
+        const CSystemnode* sn = vEntries[i].second;
+        auto it = info->find(sn->vin.prevout);
 
-            obj.pushKV("rank", (strStatus == "ENABLED" ? s.first : 0));
-            obj.pushKV("txhash", strTxHash);
-            obj.pushKV("outidx", (uint64_t)oIdx);
+        UniValue obj(UniValue::VOBJ);
+        if (setFields.count("rank"))
+            obj.pushKV("rank", vEntries[i].first);
+        if (setFields.count("txhash"))
+            obj.pushKV("txhash", sn->vin.prevout.hash.ToString());
+        if (setFields.count("outidx"))
+            obj.pushKV("outidx", (uint64_t)sn->vin.prevout.n);
+        if (setFields.count("pubkey"))
             obj.pushKV("pubkey", HexStr(sn->pubkey2));
-            obj.pushKV("status", strStatus);
+        if (setFields.count("status"))
+            obj.pushKV("status", sn->Status());
+        if (setFields.count("addr"))
             obj.pushKV("addr", EncodeDestination(PKHash(sn->pubkey)));
+        if (setFields.count("version"))
             obj.pushKV("version", sn->protocolVersion);
+        if (setFields.count("ipaddr"))
             obj.pushKV("ipaddr", sn->addr.ToString());
+        if (setFields.count("lastseen"))
             obj.pushKV("lastseen", (int64_t)sn->lastPing.sigTime);
+        if (setFields.count("activetime"))
             obj.pushKV("activetime", (int64_t)(sn->lastPing.sigTime - sn->sigTime));
-            obj.pushKV("lastpaid", (int64_t)sn->GetLastPaid());
+        if (setFields.count("lastpaid"))
+            obj.pushKV("lastpaid", it != info->end() ? it->second.nLastPaid : (int64_t)0);
 
-            ret.push_back(obj);
-        }
+        ret.push_back(obj);
     }
 
     return ret;
@@ -275,6 +325,15 @@ UniValue startsystemnode(const JSONRPCRequest& request)
             "\nResult: (for 'local' set):\n"
             "\"status\"     (string) Systemnode status message\n"
 
+            "\nResult: (for 'local' set with -nodehost):\n"
+            "[\n"
+            "  {\n"
+            "    \"alias\": \"xxxx\",   (string) Systemnode alias in systemnode.conf\n"
+            "    \"status\": \"xxxx\"   (string) Systemnode status message\n"
+            "  }\n"
+            "  ,...\n"
+            "]\n"
+
             "\nResult: (for other sets):\n"
             "{\n"
             "  \"overall\": \"xxxx\",     (string) Overall status message\n"
@@ -297,13 +356,27 @@ UniValue startsystemnode(const JSONRPCRequest& request)
         if (!fSystemNode)
             throw std::runtime_error("you must set systemnode=1 in the configuration\n");
 
-        if (activeSystemnode.status != ACTIVE_SYSTEMNODE_STARTED) {
-            activeSystemnode.status = ACTIVE_SYSTEMNODE_INITIAL;
-            activeSystemnode.ManageStatus(*g_rpc_node->connman);
-            if (fLock)
-                GetMainWallet()->Lock();
+        bool fStarting = false;
+        for (CActiveSystemnode* pactive : GetActiveSystemnodes()) {
+            if (pactive->status != ACTIVE_SYSTEMNODE_STARTED) {
+                pactive->status = ACTIVE_SYSTEMNODE_INITIAL;
+                pactive->ManageStatus(*g_rpc_node->connman);
+                fStarting = true;
+            }
         }
+        if (fStarting && fLock)
+            GetMainWallet()->Lock();
 
+        if (gArgs.GetBoolArg("-nodehost", false)) {
+            UniValue ret(UniValue::VARR);
+            for (const CActiveSystemnode* pactive : GetActiveSystemnodes()) {
+                UniValue snObj(UniValue::VOBJ);
+                snObj.pushKV("alias", pactive->strAlias);
+                snObj.pushKV("status", pactive->GetStatus());
+                ret.push_back(snObj);
+            }
+            return ret;
+        }
         return activeSystemnode.GetStatus();
     }
 
@@ -500,6 +573,8 @@ UniValue getsystemnodestatus(const JSONRPCRequest& request)
             "  \"status\": \"xxxx\",      (string) Systemnode status\n"
             "  \"message\": \"xxxx\"      (string) Systemnode status message\n"
             "}\n"
+            "\nResult (with -nodehost): an array of the above, one for every systemnode run by this node,\n"
+            "with the \"alias\" of the systemnode in systemnode.conf\n"
 
             "\nExamples:\n"
             + HelpExampleCli("getsystemnodestatus", "") + HelpExampleRpc("getsystemnodestatus", ""));
@@ -507,6 +582,25 @@ UniValue getsystemnodestatus(const JSONRPCRequest& request)
     if (!fSystemNode)
         throw JSONRPCError(RPC_MISC_ERROR, ("This is not a systemnode."));
 
+    if (gArgs.GetBoolArg("-nodehost", false)) {
+        UniValue ret(UniValue::VARR);
+        for (const CActiveSystemnode* pactive : GetActiveSystemnodes()) {
+            UniValue snObj(UniValue::VOBJ);
+            snObj.pushKV("alias", pactive->strAlias);
+            snObj.pushKV("txid", pactive->vin.prevout.hash.ToString());
+            snObj.pushKV("outputidx", (uint64_t)pactive->vin.prevout.n);
+            snObj.pushKV("netaddr", pactive->service.ToString());
+            CSystemnode* psn = pactive->vin == CTxIn() ? nullptr : snodeman.Find(pactive->vin);
+            if (psn)
+                snObj.pushKV("addr", EncodeDestination(PKHash(psn->pubkey)));
+            snObj.pushKV("status", pactive->GetStatus());
+            if (!psn)
+                snObj.pushKV("message", "Systemnode not found in the list of available systemnodes");
+            ret.push_back(snObj);
+        }
+        return ret;
+    }
+
     if (activeSystemnode.vin == CTxIn())
         throw JSONRPCError(RPC_MISC_ERROR, ("Active Systemnode not initialized."));
 
@@ -525,6 +619,46 @@ UniValue getsystemnodestatus(const JSONRPCRequest& request)
         + activeSystemnode.GetStatus());
 }
 
+UniValue listhostedsystemnodes(const JSONRPCRequest& request)
+{
+    if (request.fHelp || (request.params.size() != 0))
+        throw std::runtime_error(
+            "listhostedsystemnodes\n"
+            "\nPrint the status of every systemnode run by this node (see -nodehost)\n"
+
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"alias\": \"xxxx\",      (string) Systemnode alias in systemnode.conf\n"
+            "    \"txhash\": \"xxxx\",     (string) Collateral transaction hash\n"
+            "    \"outputidx\": n,         (numeric) Collateral transaction output index number\n"
+            "    \"netaddr\": \"xxxx\",    (string) Systemnode network address\n"
+            "    \"pubkey\": \"xxxx\",     (string) Systemnode operator public key\n"
+            "    \"status\": \"xxxx\"      (string) Systemnode status message\n"
+            "  }\n"
+            "  ,...\n"
+            "]\n"
+
+            "\nExamples:\n"
+            + HelpExampleCli("listhostedsystemnodes", "") + HelpExampleRpc("listhostedsystemnodes", ""));
+
+    if (!fSystemNode)
+        throw JSONRPCError(RPC_MISC_ERROR, ("This is not a systemnode."));
+
+    UniValue ret(UniValue::VARR);
+    for (const CActiveSystemnode* pactive : GetActiveSystemnodes()) {
+        UniValue snObj(UniValue::VOBJ);
+        snObj.pushKV("alias", pactive->strAlias);
+        snObj.pushKV("txhash", pactive->vin.prevout.hash.ToString());
+        snObj.pushKV("outputidx", (uint64_t)pactive->vin.prevout.n);
+        snObj.pushKV("netaddr", pactive->service.ToString());
+        snObj.pushKV("pubkey", HexStr(pactive->pubKeySystemnode));
+        snObj.pushKV("status", pactive->GetStatus());
+        ret.push_back(snObj);
+    }
+    return ret;
+}
+
 UniValue getsystemnodewinners(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 3)
@@ -667,11 +801,11 @@ UniValue getsystemnodescores(const JSONRPCRequest& request)
     }
     UniValue obj(UniValue::VOBJ);
 
-    std::vector<CSystemnode> vSystemnodes = snodeman.GetFullSystemnodeVector();
+    SystemnodeListSnapshot vSystemnodes = snodeman.GetSystemnodeListSnapshot();
     for (int nHeight = ::ChainActive().Tip()->nHeight - nLast; nHeight < ::ChainActive().Tip()->nHeight + 20; nHeight++) {
         uint256 nHigh;
-        CSystemnode* pBestSystemnode = NULL;
-        for (CSystemnode& sn : vSystemnodes) {
+        const CSystemnode* pBestSystemnode = NULL;
+        for (const CSystemnode& sn : *vSystemnodes) {
             uint256 n = ArithToUint256(sn.CalculateScore(nHeight));
             if (UintToArith256(n) > UintToArith256(nHigh)) {
                 nHigh = n;
@@ -874,7 +1008,7 @@ void RegisterSystemnodeCommands(CRPCTable& t)
     static const CRPCCommand commands[] = {
         //  category              name                         actor (function)            arguments
         //  --------------------- ------------------------     ------------------          ---------
-        { "systemnode", "listsystemnodes", &listsystemnodes, {} },
+        { "systemnode", "listsystemnodes", &listsystemnodes, {"filter", "offset", "limit", "status", "minprotocol", "fields"} },
         { "systemnode", "getsystemnodecount", &getsystemnodecount, {} },
         { "systemnode", "createsystemnodebroadcast", &createsystemnodebroadcast, {} },
         { "systemnode", "decodesystemnodebroadcast", &decodesystemnodebroadcast, {} },
@@ -884,6 +1018,7 @@ void RegisterSystemnodeCommands(CRPCTable& t)
         { "systemnode", "getsystemnodeoutputs", &getsystemnodeoutputs, {} },
         { "systemnode", "listsystemnodeconf", &listsystemnodeconf, {} },
         { "systemnode", "getsystemnodestatus", &getsystemnodestatus, {} },
+        { "systemnode", "listhostedsystemnodes", &listhostedsystemnodes, {} },
         { "systemnode", "getsystemnodewinners", &getsystemnodewinners, {} },
         { "systemnode", "getsystemnodescores", &getsystemnodescores, {} },
     };
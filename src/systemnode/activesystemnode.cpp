@@ -10,6 +10,28 @@
 class CActiveSystemnode;
 CActiveSystemnode activeSystemnode;
 
+// written during init only, so it is read without a lock afterwards
+static std::vector<std::unique_ptr<CActiveSystemnode>> vHostedSystemnodes;
+
+std::vector<CActiveSystemnode*> GetActiveSystemnodes()
+{
+    std::vector<CActiveSystemnode*> vActive{&activeSystemnode};
+    for (const auto& hosted : vHostedSystemnodes)
+        vActive.push_back(hosted.get());
+    return vActive;
+}
+
+CActiveSystemnode& AddHostedSystemnode()
+{
+    vHostedSystemnodes.emplace_back(new CActiveSystemnode());
+    return *vHostedSystemnodes.back();
+}
+
+void ClearHostedSystemnodes()
+{
+    vHostedSystemnodes.clear();
+}
+
 //
 // Bootup the Systemnode, look for a 500 CRW input and register on the network
 //
@@ -42,7 +64,7 @@ void CActiveSystemnode::ManageStatus(CConnman& connman)
                 if (!psn->vchSignover.empty()) {
                     if (psn->pubkey.Verify(pubKeySystemnode.GetHash(), psn->vchSignover)) {
                         LogPrintf("%s: Verified pubkey2 signover for staking\n", __func__);
-                        activeSystemnode.vchSigSignover = psn->vchSignover;
+                        vchSigSignover = psn->vchSignover;
                     } else {
                         LogPrintf("%s: Failed to verify pubkey on signover!\n", __func__);
                     }
@@ -74,14 +96,14 @@ void CActiveSystemnode::ManageStatus(CConnman& connman)
             return;
         }
 
-        if (strSystemNodeAddr.empty()) {
+        if (strAddr.empty()) {
             if (!GetLocal(service)) {
                 notCapableReason = "Can't detect external address. Please use the systemnodeaddr configuration option.";
                 LogPrintf("CActiveSystemnode::ManageStatus() - not capable: %s\n", notCapableReason);
                 return;
             }
         } else {
-            service = CService(strSystemNodeAddr);
+            service = CService(strAddr);
         }
 
         if (Params().NetworkIDString() == CBaseChainParams::MAIN) {
@@ -117,7 +139,7 @@ void CActiveSystemnode::ManageStatus(CConnman& connman)
         CPubKey pubKeyCollateralAddress;
         CKey keyCollateralAddress;
 
-        if (pwallet->GetSystemnodeVinAndKeys(vin, pubKeyCollateralAddress, keyCollateralAddress)) {
+        if (pwallet->GetSystemnodeVinAndKeys(vin, pubKeyCollateralAddress, keyCollateralAddress, strCollateralTxHash, strCollateralOutputIndex)) {
             if (GetUTXOConfirmations(vin.prevout) < SYSTEMNODE_MIN_CONFIRMATIONS) {
                 status = ACTIVE_SYSTEMNODE_INPUT_TOO_NEW;
                 notCapableReason = strprintf("%s - %d confirmations", GetStatus(), GetUTXOConfirmations(vin.prevout));
@@ -129,15 +151,6 @@ void CActiveSystemnode::ManageStatus(CConnman& connman)
             pwallet->LockCoin(vin.prevout);
 
             // send to all nodes
-            CPubKey pubKeySystemnode;
-            CKey keySystemnode;
-
-            if (!legacySigner.SetKey(strSystemNodePrivKey, keySystemnode, pubKeySystemnode)) {
-                notCapableReason = "Error upon calling SetKey: " + errorMessage;
-                LogPrintf("Register::ManageStatus() - %s\n", notCapableReason);
-                return;
-            }
-
             CSystemnodeBroadcast snb;
             bool fSignOver = true;
             if (!CSystemnodeBroadcast::Create(vin, service, keyCollateralAddress, pubKeyCollateralAddress, keySystemnode, pubKeySystemnode, fSignOver, errorMessage, snb)) {
@@ -196,14 +209,6 @@ bool CActiveSystemnode::SendSystemnodePing(std::string& errorMessage, CConnman&
         return false;
     }
 
-    CPubKey pubKeySystemnode;
-    CKey keySystemnode;
-
-    if (!legacySigner.SetKey(strSystemNodePrivKey, keySystemnode, pubKeySystemnode)) {
-        errorMessage = strprintf("Error upon calling SetKey: %s\n", errorMessage);
-        return false;
-    }
-
     LogPrintf("CActiveSystemnode::SendSystemnodePing() - Relay Systemnode Ping vin = %s\n", vin.ToString());
 
     CSystemnodePing snp(vin);
@@ -221,13 +226,15 @@ bool CActiveSystemnode::SendSystemnodePing(std::string& errorMessage, CConnman&
         }
 
         psn->lastPing = snp;
+        snodeman.NotifyListChanged(psn->vin.prevout, NodeListChange::UPDATED);
         snodeman.mapSeenSystemnodePing.insert(make_pair(snp.GetHash(), snp));
 
         //snodeman.mapSeenSystemnodeBroadcast.lastPing is probably outdated, so we'll update it
         CSystemnodeBroadcast snb(*psn);
         uint256 hash = snb.GetHash();
-        if (snodeman.mapSeenSystemnodeBroadcast.count(hash))
-            snodeman.mapSeenSystemnodeBroadcast[hash].lastPing = snp;
+        auto it = snodeman.mapSeenSystemnodeBroadcast.find(hash);
+        if (it != snodeman.mapSeenSystemnodeBroadcast.end())
+            it->second.lastPing = snp;
 
         snp.Relay(connman);
 
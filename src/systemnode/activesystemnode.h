@@ -21,6 +21,13 @@
 class CActiveSystemnode;
 extern CActiveSystemnode activeSystemnode;
 
+/** All systemnodes run by this daemon, activeSystemnode first followed by the ones added with -nodehost */
+std::vector<CActiveSystemnode*> GetActiveSystemnodes();
+/** Host one more systemnode, only to be called during init before the systemnode threads start */
+CActiveSystemnode& AddHostedSystemnode();
+/** Stop hosting the systemnodes added with AddHostedSystemnode */
+void ClearHostedSystemnodes();
+
 // Responsible for activating the Systemnode and pinging the network
 class CActiveSystemnode {
 private:
@@ -34,6 +41,15 @@ public:
     // Initialized by init.cpp
     // Keys for the main Systemnode
     CPubKey pubKeySystemnode;
+    CKey keySystemnode;
+
+    // Name in systemnode.conf, empty for the one configured by -systemnodeprivkey
+    std::string strAlias;
+    // External address, detected when empty
+    std::string strAddr;
+    // Collateral, any suitable coin of the wallet when empty
+    std::string strCollateralTxHash;
+    std::string strCollateralOutputIndex;
 
     // Signature signing over staking priviledge
     std::vector<unsigned char> vchSigSignover;
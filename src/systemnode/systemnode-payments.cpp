@@ -2,12 +2,14 @@
 // Distributed under the MIT/X11 software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <core_memusage.h>
 #include <crown/spork.h>
 #include <masternode/masternode-budget.h>
 #include <mn_processing.h>
 #include <net_processing.h>
 #include <netfulfilledman.h>
 #include <netmessagemaker.h>
+#include <validationinterface.h>
 
 /** Object for who's going to get paid on which blocks */
 CSystemnodePayments systemnodePayments;
@@ -323,6 +325,15 @@ bool CSystemnodePayments::GetBlockPayee(int nBlockHeight, CScript& payee)
     return false;
 }
 
+std::vector<CSystemnodePayee> CSystemnodePayments::GetBlockPayees(int nBlockHeight)
+{
+    LOCK(cs_mapSystemnodeBlocks);
+    auto it = mapSystemnodeBlocks.find(nBlockHeight);
+    if (it == mapSystemnodeBlocks.end())
+        return std::vector<CSystemnodePayee>();
+    return it->second.GetPayees();
+}
+
 void CSystemnodePayments::CheckAndRemove()
 {
     if (!systemnodeSync.IsBlockchainSynced())
@@ -389,66 +400,72 @@ bool CSystemnodePayments::ProcessBlock(int nBlockHeight, CConnman& connman)
     if (!fSystemNode)
         return false;
 
+    if (nBlockHeight <= nCachedBlockHeight)
+        return false;
+
     //reference node - hybrid mode
 
-    if (!IsReferenceNode(activeSystemnode.vin)) {
-        int n = snodeman.GetSystemnodeRank(activeSystemnode.vin, nBlockHeight - 100, MIN_MNW_PEER_PROTO_VERSION);
+    std::vector<CActiveSystemnode*> vVoters;
+    for (CActiveSystemnode* pactive : GetActiveSystemnodes()) {
+        if (!IsReferenceNode(pactive->vin)) {
+            int n = snodeman.GetSystemnodeRank(pactive->vin, nBlockHeight - 100, MIN_MNW_PEER_PROTO_VERSION);
 
-        if (n == -1) {
-            LogPrint(BCLog::SYSTEMNODE, "CSystemnodePayments::ProcessBlock - Unknown Systemnode\n");
-            return false;
-        }
+            if (n == -1) {
+                LogPrint(BCLog::SYSTEMNODE, "CSystemnodePayments::ProcessBlock - Unknown Systemnode %s\n", pactive->strAlias);
+                continue;
+            }
 
-        if (n > SNPAYMENTS_SIGNATURES_TOTAL) {
-            LogPrint(BCLog::SYSTEMNODE, "CSystemnodePayments::ProcessBlock - Systemnode not in the top %d (%d)\n", MNPAYMENTS_SIGNATURES_TOTAL, n);
-            return false;
+            if (n > SNPAYMENTS_SIGNATURES_TOTAL) {
+                LogPrint(BCLog::SYSTEMNODE, "CSystemnodePayments::ProcessBlock - Systemnode %s not in the top %d (%d)\n", pactive->strAlias, SNPAYMENTS_SIGNATURES_TOTAL, n);
+                continue;
+            }
         }
+        vVoters.push_back(pactive);
     }
 
-    if (nBlockHeight <= nCachedBlockHeight)
+    if (vVoters.empty())
         return false;
 
-    CSystemnodePaymentWinner newWinner(activeSystemnode.vin);
-
-    LogPrint(BCLog::SYSTEMNODE, "CSystemnodePayments::ProcessBlock() Start nHeight %d - vin %s. \n", nBlockHeight, activeSystemnode.vin.ToString().c_str());
+    LogPrint(BCLog::SYSTEMNODE, "CSystemnodePayments::ProcessBlock() Start nHeight %d - %d voters. \n", nBlockHeight, vVoters.size());
     // pay to the oldest MN that still had no payment but its input is old enough and it was active long enough
     int nCount = 0;
     CSystemnode* psn = snodeman.GetNextSystemnodeInQueueForPayment(nBlockHeight, true, nCount);
 
+    // the winner only depends on the height, so all our systemnodes vote for the same payee
+    CScript payee;
     if (psn) {
         LogPrint(BCLog::SYSTEMNODE, "CSystemnodePayments::ProcessBlock() Found by FindOldestNotInVec \n");
 
-        newWinner.nBlockHeight = nBlockHeight;
+        payee = GetScriptForDestination(PKHash(psn->pubkey));
 
-        CScript payee = GetScriptForDestination(PKHash(psn->pubkey));
-        newWinner.AddPayee(payee);
-
-        LogPrint(BCLog::SYSTEMNODE, "CSystemnodePayments::ProcessBlock() Winner payee %s nHeight %d. \n", payee.ToString(), newWinner.nBlockHeight);
+        LogPrint(BCLog::SYSTEMNODE, "CSystemnodePayments::ProcessBlock() Winner payee %s nHeight %d. \n", payee.ToString(), nBlockHeight);
     } else {
         LogPrint(BCLog::SYSTEMNODE, "CSystemnodePayments::ProcessBlock() Failed to find systemnode to pay\n");
     }
 
-    std::string errorMessage;
-    CPubKey pubKeySystemnode;
-    CKey keySystemnode;
-
-    if (!legacySigner.SetKey(strSystemNodePrivKey, keySystemnode, pubKeySystemnode)) {
-        LogPrint(BCLog::SYSTEMNODE, "CSystemnodePayments::ProcessBlock() - Error upon calling SetKey: %s\n", errorMessage.c_str());
-        return false;
-    }
+    bool fVoted = false;
+    for (CActiveSystemnode* pactive : vVoters) {
+        CSystemnodePaymentWinner newWinner(pactive->vin);
+        if (psn) {
+            newWinner.nBlockHeight = nBlockHeight;
+            newWinner.AddPayee(payee);
+        }
 
-    LogPrint(BCLog::SYSTEMNODE, "CSystemnodePayments::ProcessBlock() - Signing Winner\n");
-    if (newWinner.Sign(keySystemnode, pubKeySystemnode)) {
-        LogPrint(BCLog::SYSTEMNODE, "CSystemnodePayments::ProcessBlock() - AddWinningSystemnode\n");
+        LogPrint(BCLog::SYSTEMNODE, "CSystemnodePayments::ProcessBlock() - Signing Winner vin %s\n", pactive->vin.ToString());
+        if (newWinner.Sign(pactive->keySystemnode, pactive->pubKeySystemnode)) {
+            LogPrint(BCLog::SYSTEMNODE, "CSystemnodePayments::ProcessBlock() - AddWinningSystemnode\n");
 
-        if (AddWinningSystemnode(newWinner)) {
-            newWinner.Relay(connman);
-            nCachedBlockHeight = nBlockHeight;
-            return true;
+            if (AddWinningSystemnode(newWinner)) {
+                newWinner.Relay(connman);
+                fVoted = true;
+            }
         }
     }
 
-    return false;
+    if (fVoted)
+        nCachedBlockHeight = nBlockHeight;
+
+    return fVoted;
 }
 
 bool CSystemnodePayments::AddWinningSystemnode(CSystemnodePaymentWinner& winnerIn)
@@ -476,7 +493,12 @@ bool CSystemnodePayments::AddWinningSystemnode(CSystemnodePaymentWinner& winnerI
     int n = 1;
     if (IsReferenceNode(winnerIn.vinSystemnode))
         n = 100;
-    mapSystemnodeBlocks[winnerIn.nBlockHeight].AddPayee(winnerIn.payee, n);
+    CSystemnodeBlockPayees& blockPayees = mapSystemnodeBlocks[winnerIn.nBlockHeight];
+    // the payee is elected once it has enough votes to be enforced
+    const bool fElected = blockPayees.HasPayeeWithVotes(winnerIn.payee, SNPAYMENTS_SIGNATURES_REQUIRED);
+    blockPayees.AddPayee(winnerIn.payee, n);
+    if (!fElected && blockPayees.HasPayeeWithVotes(winnerIn.payee, SNPAYMENTS_SIGNATURES_REQUIRED))
+        GetMainSignals().SystemnodePaymentWinner(winnerIn.nBlockHeight, winnerIn.payee);
 
     return true;
 }
@@ -581,6 +603,27 @@ std::string CSystemnodePayments::ToString() const
     return info.str();
 }
 
+size_t CSystemnodePayments::DynamicMemoryUsage() const
+{
+    size_t nUsage = 0;
+    {
+        LOCK(cs_mapSystemnodePayeeVotes);
+        nUsage += memusage::DynamicUsage(mapSystemnodePayeeVotes) + memusage::DynamicUsage(mapSystemnodesLastVote);
+        for (const auto& vote : mapSystemnodePayeeVotes)
+            nUsage += RecursiveDynamicUsage(vote.second.vinSystemnode) + RecursiveDynamicUsage(vote.second.payee) + memusage::DynamicUsage(vote.second.vchSig);
+    }
+    {
+        LOCK2(cs_mapSystemnodeBlocks, cs_vecSNPayments);
+        nUsage += memusage::DynamicUsage(mapSystemnodeBlocks);
+        for (const auto& block : mapSystemnodeBlocks) {
+            nUsage += memusage::DynamicUsage(block.second.vecPayments);
+            for (const CSystemnodePayee& payee : block.second.vecPayments)
+                nUsage += RecursiveDynamicUsage(payee.scriptPubKey);
+        }
+    }
+    return nUsage;
+}
+
 bool CSystemnodePaymentWinner::Sign(CKey& keySystemnode, CPubKey& pubKeySystemnode)
 {
     std::string errorMessage;
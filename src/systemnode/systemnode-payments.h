@@ -114,6 +114,12 @@ public:
         return false;
     }
 
+    std::vector<CSystemnodePayee> GetPayees()
+    {
+        LOCK(cs_vecSNPayments);
+        return vecPayments;
+    }
+
     bool IsTransactionValid(const CTransaction& txNew, const CAmount& nValueCreated);
     std::string GetRequiredPaymentsString();
 
@@ -222,11 +228,14 @@ public:
     void CheckAndRemove();
     bool IsTransactionValid(const CAmount& nValueCreated, const CTransaction& txNew, int nBlockHeight);
     bool GetBlockPayee(int nBlockHeight, CScript& payee);
+    /// Copy of the payees voted for at a height, empty if no votes were seen
+    std::vector<CSystemnodePayee> GetBlockPayees(int nBlockHeight);
     bool IsScheduled(CSystemnode& sn, int nNotBlockHeight);
     bool CanVote(COutPoint outSystemnode, int nBlockHeight);
     std::string GetRequiredPaymentsString(int nBlockHeight);
     void FillBlockPayee(CMutableTransaction& txNew, int64_t nFees);
     std::string ToString() const;
+    size_t DynamicMemoryUsage() const;
 
     SERIALIZE_METHODS(CSystemnodePayments, obj)
     {
@@ -9,6 +9,8 @@
 #include <node/context.h>
 #include <node/ui_interface.h>
 #include <rpc/blockchain.h>
+#include <scheduler.h>
+#include <shutdown.h>
 
 class CSystemnodeSync;
 CSystemnodeSync systemnodeSync;
@@ -74,14 +76,18 @@ void CSystemnodeSync::Reset()
     countSystemnodeWinner = 0;
     countBudgetItemProp = 0;
     countBudgetItemFin = 0;
+    nMaxCountSystemnodeList = 0;
+    nMaxCountSystemnodeWinner = 0;
     RequestedSystemnodeAssets = SYSTEMNODE_SYNC_INITIAL;
     RequestedSystemnodeAttempt = 0;
     nAssetSyncStarted = GetTime();
+
+    ScheduleStep();
 }
 
 void CSystemnodeSync::AddedSystemnodeList(uint256 hash)
 {
-    if (snodeman.mapSeenSystemnodeBroadcast.count(hash)) {
+    if (snodeman.mapSeenSystemnodeBroadcast.IsSeen(hash)) {
         if (mapSeenSyncSNB[hash] < SYSTEMNODE_SYNC_THRESHOLD) {
             lastSystemnodeList = GetTime();
             mapSeenSyncSNB[hash]++;
@@ -89,6 +95,8 @@ void CSystemnodeSync::AddedSystemnodeList(uint256 hash)
     } else {
         lastSystemnodeList = GetTime();
         mapSeenSyncSNB.insert(make_pair(hash, 1));
+        if (RequestedSystemnodeAssets == SYSTEMNODE_SYNC_LIST && IsAssetComplete())
+            ScheduleStep();
     }
 }
 
@@ -102,6 +110,8 @@ void CSystemnodeSync::AddedSystemnodeWinner(uint256 hash)
     } else {
         lastSystemnodeWinner = GetTime();
         mapSeenSyncSNW.insert(make_pair(hash, 1));
+        if (RequestedSystemnodeAssets == SYSTEMNODE_SYNC_SNW && IsAssetComplete())
+            ScheduleStep();
     }
 }
 
@@ -163,16 +173,21 @@ void CSystemnodeSync::ProcessMessage(CNode* pfrom, const std::string& strCommand
                 return;
             sumSystemnodeList += nCount;
             countSystemnodeList++;
+            nMaxCountSystemnodeList = std::max(nMaxCountSystemnodeList, nCount);
             break;
         case (SYSTEMNODE_SYNC_SNW):
             if (nItemID != RequestedSystemnodeAssets)
                 return;
             sumSystemnodeWinner += nCount;
             countSystemnodeWinner++;
+            nMaxCountSystemnodeWinner = std::max(nMaxCountSystemnodeWinner, nCount);
             break;
         }
 
         LogPrintf("CSystemnodeSync:ProcessMessage - snssc - got inventory count %d %d\n", nItemID, nCount);
+
+        if (IsAssetComplete())
+            ScheduleStep();
     }
 }
 
@@ -185,120 +200,171 @@ void CSystemnodeSync::ClearFulfilledRequest(CConnman& connman)
     });
 }
 
-void CSystemnodeSync::Process(CConnman& connman)
+bool CSystemnodeSync::IsAssetComplete() const
 {
-    const CNetMsgMaker msgMaker(PROTOCOL_VERSION);
-    static int tick = 0;
+    // Every peer we asked (up to the threshold) has to report its count, and we need to have seen as many
+    // items as the best of them announced
+    const int nPeersNeeded = std::max(1, std::min(RequestedSystemnodeAttempt, SYSTEMNODE_SYNC_THRESHOLD));
+
+    switch (RequestedSystemnodeAssets) {
+    case (SYSTEMNODE_SYNC_LIST):
+        return countSystemnodeList >= nPeersNeeded && (int)mapSeenSyncSNB.size() >= nMaxCountSystemnodeList;
+    case (SYSTEMNODE_SYNC_SNW):
+        return countSystemnodeWinner >= nPeersNeeded && (int)mapSeenSyncSNW.size() >= nMaxCountSystemnodeWinner;
+    }
+    return false;
+}
+
+void CSystemnodeSync::Start(CScheduler& scheduler, CConnman& connman)
+{
+    m_scheduler = &scheduler;
+    m_connman = &connman;
+    ScheduleStep();
+}
+
+void CSystemnodeSync::Stop()
+{
+    LOCK(cs_step);
+    m_scheduler = nullptr;
+    m_connman = nullptr;
+    m_step_time = 0;
+}
+
+void CSystemnodeSync::ScheduleStep(std::chrono::milliseconds delta)
+{
+    if (!m_scheduler)
+        return;
+
+    const int64_t nStepTime = GetTimeMillis() + delta.count();
+    {
+        LOCK(cs_step);
+        // an earlier step is already queued, it will re-arm the timer if needed
+        if (m_step_time != 0 && m_step_time <= nStepTime)
+            return;
+        m_step_time = nStepTime;
+    }
+
+    m_scheduler->scheduleFromNow([this, nStepTime] {
+        {
+            LOCK(cs_step);
+            if (m_step_time != nStepTime)
+                return;
+            m_step_time = 0;
+        }
+        Step();
+    }, delta);
+}
+
+void CSystemnodeSync::Fail()
+{
+    if (IsSporkActive(SPORK_14_SYSTEMNODE_PAYMENT_ENFORCEMENT)) {
+        LogPrintf("CSystemnodeSync::Step - ERROR - Sync has failed, will retry later\n");
+        RequestedSystemnodeAssets = SYSTEMNODE_SYNC_FAILED;
+        RequestedSystemnodeAttempt = 0;
+        lastFailure = GetTime();
+        nCountFailures++;
+    } else {
+        GetNextAsset();
+    }
+}
+
+void CSystemnodeSync::Step()
+{
+    const std::chrono::milliseconds nTimeout{SYSTEMNODE_SYNC_TIMEOUT * 1000};
 
-    if (tick++ % SYSTEMNODE_SYNC_TIMEOUT != 0)
+    if (IsSynced() || ShutdownRequested())
         return;
 
-    if (IsSynced()) {
+    if (fReindex || fImporting || ::ChainstateActive().IsInitialBlockDownload() || !IsBlockchainSynced()) {
+        ScheduleStep(nTimeout);
         return;
     }
 
     //try syncing again
-    if (RequestedSystemnodeAssets == SYSTEMNODE_SYNC_FAILED && lastFailure + (1 * 60) < GetTime()) {
+    if (RequestedSystemnodeAssets == SYSTEMNODE_SYNC_FAILED) {
+        if (lastFailure + (1 * 60) >= GetTime()) {
+            ScheduleStep(std::chrono::seconds{lastFailure + (1 * 60) + 1 - GetTime()});
+            return;
+        }
         Reset();
-    } else if (RequestedSystemnodeAssets == SYSTEMNODE_SYNC_FAILED) {
-        return;
     }
 
-    // Calculate "progress" for LOG reporting / GUI notification
-    double nSyncProgress = double(RequestedSystemnodeAttempt + (RequestedSystemnodeAssets - 1) * 8) / (8 * 4);
-    uiInterface.NotifyAdditionalDataSyncProgressChanged(nSyncProgress);
-    LogPrintf("CSystemnodeSync::ProcessTick -- nTick %d nRequestedSystemnodeAssets %d nRequestedSystemnodeAttempt %d nSyncProgress %f\n", tick, RequestedSystemnodeAssets, RequestedSystemnodeAttempt, nSyncProgress);
-
     if (RequestedSystemnodeAssets == SYSTEMNODE_SYNC_INITIAL)
         GetNextAsset();
-    if (!IsBlockchainSynced() && RequestedSystemnodeAssets > SYSTEMNODE_SYNC_SPORKS)
-        return;
 
+    CConnman& connman = *m_connman;
+    const CNetMsgMaker msgMaker(PROTOCOL_VERSION);
     std::vector<CNode*> vNodesCopy = connman.CopyNodeVector();
-    for (auto& pnode : vNodesCopy) {
-        //set to synced
-        if (RequestedSystemnodeAssets == SYSTEMNODE_SYNC_SPORKS) {
-            if (netfulfilledman.HasFulfilledRequest(pnode->addr, "sngetspork"))
-                continue;
-            netfulfilledman.AddFulfilledRequest(pnode->addr, "sngetspork");
-            connman.PushMessage(pnode, msgMaker.Make(NetMsgType::GETSPORKS));
-            if (RequestedSystemnodeAttempt >= 2)
-                GetNextAsset();
-            RequestedSystemnodeAttempt++;
-            return;
-        }
 
-        {
-            if (RequestedSystemnodeAssets == SYSTEMNODE_SYNC_LIST) {
-                LogPrintf("CSystemnodeSync::Process() - lastSystemnodeList %lld (GetTime() - SYSTEMNODE_SYNC_TIMEOUT) %lld\n", lastSystemnodeList, GetTime() - SYSTEMNODE_SYNC_TIMEOUT);
-                if (lastSystemnodeList > 0 && lastSystemnodeList < GetTime() - SYSTEMNODE_SYNC_TIMEOUT * 2 && RequestedSystemnodeAttempt >= SYSTEMNODE_SYNC_THRESHOLD) { //hasn't received a new item in the last five seconds, so we'll move to the
-                    GetNextAsset();
-                    return;
-                }
-
-                if (netfulfilledman.HasFulfilledRequest(pnode->addr, "snsync"))
-                    continue;
-                netfulfilledman.AddFulfilledRequest(pnode->addr, "snsync");
-
-                // timeout
-                if (lastSystemnodeList == 0 && (RequestedSystemnodeAttempt >= SYSTEMNODE_SYNC_THRESHOLD * 3 || GetTime() - nAssetSyncStarted > SYSTEMNODE_SYNC_TIMEOUT * 5)) {
-                    if (IsSporkActive(SPORK_14_SYSTEMNODE_PAYMENT_ENFORCEMENT)) {
-                        LogPrintf("CSystemnodeSync::Process - ERROR - Sync has failed, will retry later\n");
-                        RequestedSystemnodeAssets = SYSTEMNODE_SYNC_FAILED;
-                        RequestedSystemnodeAttempt = 0;
-                        lastFailure = GetTime();
-                        nCountFailures++;
-                    } else {
-                        GetNextAsset();
-                    }
-                    return;
-                }
-
-                if (RequestedSystemnodeAttempt >= SYSTEMNODE_SYNC_THRESHOLD * 3)
-                    return;
+    int nPrevAsset = -1;
+    while (nPrevAsset != RequestedSystemnodeAssets && !IsSynced() && RequestedSystemnodeAssets != SYSTEMNODE_SYNC_FAILED) {
+        nPrevAsset = RequestedSystemnodeAssets;
 
-                snodeman.DsegUpdate(pnode, connman);
+        // Calculate "progress" for LOG reporting / GUI notification
+        double nSyncProgress = double(RequestedSystemnodeAttempt + (RequestedSystemnodeAssets - 1) * 8) / (8 * 4);
+        uiInterface.NotifyAdditionalDataSyncProgressChanged(nSyncProgress);
+        LogPrintf("CSystemnodeSync::Step -- nRequestedSystemnodeAssets %d nRequestedSystemnodeAttempt %d nSyncProgress %f\n", RequestedSystemnodeAssets, RequestedSystemnodeAttempt, nSyncProgress);
+
+        if (RequestedSystemnodeAssets == SYSTEMNODE_SYNC_SPORKS) {
+            for (auto& pnode : vNodesCopy) {
+                if (RequestedSystemnodeAttempt > SYSTEMNODE_SYNC_THRESHOLD)
+                    break;
+                if (netfulfilledman.HasFulfilledRequest(pnode->addr, "sngetspork"))
+                    continue;
+                netfulfilledman.AddFulfilledRequest(pnode->addr, "sngetspork");
+                connman.PushMessage(pnode, msgMaker.Make(NetMsgType::GETSPORKS));
                 RequestedSystemnodeAttempt++;
-                return;
             }
+            if (RequestedSystemnodeAttempt > SYSTEMNODE_SYNC_THRESHOLD)
+                GetNextAsset();
+            continue;
+        }
 
-            if (RequestedSystemnodeAssets == SYSTEMNODE_SYNC_SNW) {
-                if (lastSystemnodeWinner > 0 && lastSystemnodeWinner < GetTime() - SYSTEMNODE_SYNC_TIMEOUT * 2 && RequestedSystemnodeAttempt >= SYSTEMNODE_SYNC_THRESHOLD) {
-                    GetNextAsset();
-                    return;
-                }
+        const bool fList = RequestedSystemnodeAssets == SYSTEMNODE_SYNC_LIST;
+        const int64_t lastItem = fList ? lastSystemnodeList : lastSystemnodeWinner;
+        const std::string strFulfilled = fList ? "snsync" : "snwsync";
+
+        // everything announced has arrived, or we haven't received a new item in a while
+        if (IsAssetComplete() || (lastItem > 0 && lastItem < GetTime() - SYSTEMNODE_SYNC_TIMEOUT * 2 && RequestedSystemnodeAttempt >= SYSTEMNODE_SYNC_THRESHOLD)) {
+            GetNextAsset();
+            //try to activate our systemnode if possible
+            if (IsSynced())
+                for (CActiveSystemnode* pactive : GetActiveSystemnodes())
+                    pactive->ManageStatus(connman);
+            continue;
+        }
 
-                if (netfulfilledman.HasFulfilledRequest(pnode->addr, "snwsync"))
-                    continue;
-                netfulfilledman.AddFulfilledRequest(pnode->addr, "snwsync");
-
-                // timeout
-                if (lastSystemnodeWinner == 0 && (RequestedSystemnodeAttempt >= SYSTEMNODE_SYNC_THRESHOLD * 3 || GetTime() - nAssetSyncStarted > SYSTEMNODE_SYNC_TIMEOUT * 5)) {
-                    if (IsSporkActive(SPORK_14_SYSTEMNODE_PAYMENT_ENFORCEMENT)) {
-                        LogPrintf("CSystemnodeSync::Process - ERROR - Sync has failed, will retry later\n");
-                        RequestedSystemnodeAssets = SYSTEMNODE_SYNC_FAILED;
-                        RequestedSystemnodeAttempt = 0;
-                        lastFailure = GetTime();
-                        nCountFailures++;
-                    } else {
-                        GetNextAsset();
-                    }
-                    return;
-                }
-
-                if (RequestedSystemnodeAttempt >= SYSTEMNODE_SYNC_THRESHOLD * 3)
-                    return;
-
-                CBlockIndex* pindexPrev = ::ChainActive().Tip();
-                if (pindexPrev == nullptr)
-                    return;
+        // timeout
+        if (lastItem == 0 && (RequestedSystemnodeAttempt >= SYSTEMNODE_SYNC_THRESHOLD * 3 || GetTime() - nAssetSyncStarted > SYSTEMNODE_SYNC_TIMEOUT * 5)) {
+            Fail();
+            continue;
+        }
+
+        // ask a couple of peers at once when the stage starts, then one more on every timer
+        int nAsk = RequestedSystemnodeAttempt == 0 ? SYSTEMNODE_SYNC_THRESHOLD : 1;
+        for (auto& pnode : vNodesCopy) {
+            if (nAsk == 0 || RequestedSystemnodeAttempt >= SYSTEMNODE_SYNC_THRESHOLD * 3)
+                break;
+            if (netfulfilledman.HasFulfilledRequest(pnode->addr, strFulfilled))
+                continue;
+            netfulfilledman.AddFulfilledRequest(pnode->addr, strFulfilled);
 
+            if (fList) {
+                snodeman.DsegUpdate(pnode, connman);
+            } else {
                 int nSnCount = snodeman.CountEnabled();
                 connman.PushMessage(pnode, msgMaker.Make(NetMsgType::GETSNWINNERS, nSnCount));
-                RequestedSystemnodeAttempt++;
-
-                return;
             }
+            RequestedSystemnodeAttempt++;
+            nAsk--;
         }
     }
+
+    connman.ReleaseNodeVector(vNodesCopy);
+
+    if (RequestedSystemnodeAssets == SYSTEMNODE_SYNC_FAILED) {
+        ScheduleStep(std::chrono::seconds{1 * 60 + 1});
+    } else if (!IsSynced()) {
+        ScheduleStep(nTimeout);
+    }
 }
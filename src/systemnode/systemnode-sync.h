@@ -5,6 +5,11 @@
 #ifndef SYSTEMNODE_SYNC_H
 #define SYSTEMNODE_SYNC_H
 
+#include <net.h>
+#include <sync.h>
+
+#include <chrono>
+
 #define SYSTEMNODE_SYNC_INITIAL 0
 #define SYSTEMNODE_SYNC_SPORKS 1
 #define SYSTEMNODE_SYNC_LIST 2
@@ -16,11 +21,15 @@
 #define SYSTEMNODE_SYNC_THRESHOLD 2
 
 class CSystemnodeSync;
+class CScheduler;
 extern CSystemnodeSync systemnodeSync;
 
 //
 // CSystemnodeSync : Sync systemnode assets in stages
 //
+// Event driven like CMasternodeSync, a stage advances once the announced items have all arrived and
+// is otherwise re-evaluated on a SYSTEMNODE_SYNC_TIMEOUT timer.
+//
 
 class CSystemnodeSync {
 public:
@@ -43,6 +52,9 @@ public:
     int countSystemnodeWinner;
     int countBudgetItemProp;
     int countBudgetItemFin;
+    // largest count reported by a single peer
+    int nMaxCountSystemnodeList;
+    int nMaxCountSystemnodeWinner;
 
     // Count peers we've requested the list from
     int RequestedSystemnodeAssets;
@@ -60,10 +72,25 @@ public:
     void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman* connman, bool& target);
 
     void Reset();
-    void Process(CConnman& connman);
+    void Start(CScheduler& scheduler, CConnman& connman);
+    //! Forget the scheduler and connection manager, before they go away
+    void Stop();
+    void ScheduleStep(std::chrono::milliseconds delta = std::chrono::milliseconds{0});
+    void Step();
+    bool IsAssetComplete() const;
     bool IsSynced();
     bool IsBlockchainSynced();
     void ClearFulfilledRequest(CConnman& connman);
+
+private:
+    CScheduler* m_scheduler{nullptr};
+    CConnman* m_connman{nullptr};
+
+    Mutex cs_step;
+    // time in ms of the pending step, 0 if none is queued
+    int64_t m_step_time GUARDED_BY(cs_step){0};
+
+    void Fail();
 };
 
 #endif
@@ -108,12 +108,14 @@ bool CSystemnodePing::CheckAndUpdate(int& nDos, CConnman& connman, bool fRequire
             }
 
             psn->lastPing = *this;
+            snodeman.NotifyListChanged(psn->vin.prevout, NodeListChange::UPDATED);
 
             //snodeman.mapSeenSystemnodeBroadcast.lastPing is probably outdated, so we'll update it
             CSystemnodeBroadcast snb(*psn);
             uint256 hash = snb.GetHash();
-            if (snodeman.mapSeenSystemnodeBroadcast.count(hash)) {
-                snodeman.mapSeenSystemnodeBroadcast[hash].lastPing = *this;
+            auto it = snodeman.mapSeenSystemnodeBroadcast.find(hash);
+            if (it != snodeman.mapSeenSystemnodeBroadcast.end()) {
+                it->second.lastPing = *this;
             }
 
             psn->Check(true);
@@ -271,27 +273,22 @@ void CSystemnode::Check(bool forceCheck)
     if (activeState == SYSTEMNODE_VIN_SPENT)
         return;
 
+    const int nPrevState = activeState;
+
     if (!IsPingedWithin(SYSTEMNODE_REMOVAL_SECONDS)) {
         activeState = SYSTEMNODE_REMOVE;
-        return;
-    }
-
-    if (!IsPingedWithin(SYSTEMNODE_EXPIRATION_SECONDS)) {
+    } else if (!IsPingedWithin(SYSTEMNODE_EXPIRATION_SECONDS)) {
         activeState = SYSTEMNODE_EXPIRED;
-        return;
-    }
-
-    //test if the collateral is still good
-    if (!unitTest) {
-        CollateralStatus err = CheckCollateral(vin.prevout);
-        if (err == COLLATERAL_UTXO_NOT_FOUND) {
-            activeState = SYSTEMNODE_VIN_SPENT;
-            LogPrint(BCLog::SYSTEMNODE, "CSystemnode::Check -- Failed to find Systemnode UTXO, systemnode=%s\n", vin.prevout.ToString());
-            return;
-        }
+    } else if (!unitTest && CheckCollateral(vin.prevout) == COLLATERAL_UTXO_NOT_FOUND) {
+        //test if the collateral is still good
+        activeState = SYSTEMNODE_VIN_SPENT;
+        LogPrint(BCLog::SYSTEMNODE, "CSystemnode::Check -- Failed to find Systemnode UTXO, systemnode=%s\n", vin.prevout.ToString());
+    } else {
+        activeState = SYSTEMNODE_ENABLED; // OK
     }
 
-    activeState = SYSTEMNODE_ENABLED; // OK
+    if (activeState != nPrevState)
+        snodeman.NotifyListChanged(vin.prevout, activeState == SYSTEMNODE_EXPIRED ? NodeListChange::EXPIRED : NodeListChange::UPDATED);
 }
 
 int64_t CSystemnode::SecondsSincePayment() const
@@ -313,6 +310,17 @@ int64_t CSystemnode::SecondsSincePayment() const
     return month + UintToArith256(hash).GetCompact(false);
 }
 
+int64_t CSystemnode::GetLastPaidOffset() const
+{
+    CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
+    ss << vin;
+    ss << sigTime;
+    uint256 hash = ss.GetHash();
+
+    // use a deterministic offset to break a tie -- 2.5 minutes
+    return UintToArith256(hash).GetCompact(false) % 150;
+}
+
 int64_t CSystemnode::GetLastPaid() const
 {
     CBlockIndex* pindexPrev = ::ChainActive().Tip();
@@ -322,13 +330,7 @@ int64_t CSystemnode::GetLastPaid() const
     CScript snpayee;
     snpayee = GetScriptForDestination(PKHash(pubkey));
 
-    CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
-    ss << vin;
-    ss << sigTime;
-    uint256 hash = ss.GetHash();
-
-    // use a deterministic offset to break a tie -- 2.5 minutes
-    int64_t nOffset = UintToArith256(hash).GetCompact(false) % 150;
+    int64_t nOffset = GetLastPaidOffset();
 
     if (::ChainActive().Tip() == nullptr)
         return false;
@@ -492,6 +494,7 @@ bool CSystemnodeBroadcast::CheckAndUpdate(int& nDos, CConnman& connman) const
         //take the newest entry
         LogPrint(BCLog::SYSTEMNODE, "snb - Got updated entry for %s\n", addr.ToString());
         if (psn->UpdateFromNewBroadcast((*this), connman)) {
+            snodeman.NotifyListChanged(psn->vin.prevout, NodeListChange::UPDATED);
             psn->Check();
             if (psn->IsEnabled())
                 Relay(connman);
@@ -506,8 +509,12 @@ bool CSystemnodeBroadcast::CheckInputsAndAdd(int& nDoS, CConnman& connman) const
 {
     // we are a systemnode with the same vin (i.e. already activated) and this snb is ours (matches our systemnode privkey)
     // so nothing to do here for us
-    if (fSystemNode && vin.prevout == activeSystemnode.vin.prevout && pubkey2 == activeSystemnode.pubKeySystemnode)
-        return true;
+    if (fSystemNode) {
+        for (const CActiveSystemnode* pactive : GetActiveSystemnodes()) {
+            if (vin.prevout == pactive->vin.prevout && pubkey2 == pactive->pubKeySystemnode)
+                return true;
+        }
+    }
 
     // incorrect ping or its sigTime
     if (lastPing == CSystemnodePing() || !lastPing.CheckAndUpdate(nDoS, connman, false, true))
@@ -555,17 +562,19 @@ bool CSystemnodeBroadcast::CheckInputsAndAdd(int& nDoS, CConnman& connman) const
     snodeman.Add(sn);
 
     // if it matches our systemnode privkey, then we've been remotely activated
-    if (pubkey2 == activeSystemnode.pubKeySystemnode && protocolVersion == PROTOCOL_VERSION) {
-        activeSystemnode.EnableHotColdSystemNode(vin, addr);
-        if (!vchSignover.empty()) {
-            if (pubkey.Verify(pubkey2.GetHash(), vchSignover)) {
-                LogPrint(BCLog::SYSTEMNODE, "%s: Verified pubkey2 signover for staking, added to activesystemnode\n", __func__);
-                activeSystemnode.vchSigSignover = vchSignover;
+    for (CActiveSystemnode* pactive : GetActiveSystemnodes()) {
+        if (pubkey2 == pactive->pubKeySystemnode && protocolVersion == PROTOCOL_VERSION) {
+            pactive->EnableHotColdSystemNode(vin, addr);
+            if (!vchSignover.empty()) {
+                if (pubkey.Verify(pubkey2.GetHash(), vchSignover)) {
+                    LogPrint(BCLog::SYSTEMNODE, "%s: Verified pubkey2 signover for staking, added to activesystemnode\n", __func__);
+                    pactive->vchSigSignover = vchSignover;
+                } else {
+                    LogPrint(BCLog::SYSTEMNODE, "%s: Failed to verify pubkey on signover!\n", __func__);
+                }
             } else {
-                LogPrint(BCLog::SYSTEMNODE, "%s: Failed to verify pubkey on signover!\n", __func__);
+                LogPrint(BCLog::SYSTEMNODE, "%s: NOT SIGNOVER!\n", __func__);
             }
-        } else {
-            LogPrint(BCLog::SYSTEMNODE, "%s: NOT SIGNOVER!\n", __func__);
         }
     }
 
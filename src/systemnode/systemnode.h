@@ -248,6 +248,8 @@ public:
     }
 
     int64_t GetLastPaid() const;
+    /// Deterministic offset added to the time of the last payment to break a tie
+    int64_t GetLastPaidOffset() const;
 
     bool GetRecentPaymentBlocks(std::vector<const CBlockIndex*>& vPaymentBlocks, bool limitMostRecent = false) const;
 };
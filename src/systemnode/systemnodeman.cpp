@@ -2,10 +2,12 @@
 // Distributed under the MIT/X11 software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <core_memusage.h>
 #include <crown/legacysigner.h>
 #include <mn_processing.h>
 #include <net_processing.h>
 #include <netmessagemaker.h>
+#include <node/ui_interface.h>
 #include <nodediag.h>
 
 /** Systemnode manager */
@@ -66,6 +68,69 @@ std::vector<pair<int, CSystemnode>> CSystemnodeMan::GetSystemnodeRanks(int64_t n
     return vecSystemnodeRanks;
 }
 
+SystemnodeListInfoMap CSystemnodeMan::GetSystemnodeListInfo(int nBlockHeight)
+{
+    LOCK(cs_listinfo);
+
+    const CBlockIndex* pindex;
+    {
+        LOCK(cs_main);
+        pindex = ::ChainActive()[nBlockHeight];
+    }
+    if (!pindex)
+        return std::make_shared<const std::map<COutPoint, CSystemnodeListInfo>>();
+    if (m_listinfo && m_listinfo_block == pindex->GetBlockHash())
+        return m_listinfo;
+
+    SystemnodeListSnapshot snapshot = GetSystemnodeListSnapshot();
+    auto info = std::make_shared<std::map<COutPoint, CSystemnodeListInfo>>();
+
+    // rank the enabled entries the same way GetSystemnodeRanks does
+    std::vector<pair<int64_t, CTxIn>> vecScores;
+    const int nMinPaymentsProto = systemnodePayments.GetMinSystemnodePaymentsProto();
+    int nEnabled = 0;
+    for (const auto& sn : *snapshot) {
+        if (!sn.IsEnabled())
+            continue;
+        if (sn.protocolVersion >= nMinPaymentsProto)
+            nEnabled++;
+        vecScores.push_back(make_pair(sn.CalculateScore(nBlockHeight).GetCompact(false), sn.vin));
+    }
+    sort(vecScores.rbegin(), vecScores.rend(), CompareScoreTxIn());
+
+    int rank = 0;
+    for (const auto& s : vecScores)
+        (*info)[s.second.prevout].nRank = ++rank;
+
+    // walk the payment window once for all entries instead of once per entry, see CSystemnode::GetLastPaid
+    std::map<CScript, int64_t> mapLastPaid;
+    {
+        LOCK2(cs_main, cs_mapSystemnodeBlocks);
+        LOCK(cs_vecSNPayments);
+        const int nCount = nEnabled * 1.25;
+        const CBlockIndex* BlockReading = pindex;
+        for (int n = 0; n < nCount && BlockReading && BlockReading->nHeight > 0; n++, BlockReading = BlockReading->pprev) {
+            auto it = systemnodePayments.mapSystemnodeBlocks.find(BlockReading->nHeight);
+            if (it == systemnodePayments.mapSystemnodeBlocks.end())
+                continue;
+            // the most recent block wins, same as searching each payee with at least 2 votes
+            for (const CSystemnodePayee& payee : it->second.vecPayments) {
+                if (payee.nVotes >= 2)
+                    mapLastPaid.emplace(payee.scriptPubKey, BlockReading->nTime);
+            }
+        }
+    }
+    for (const auto& sn : *snapshot) {
+        auto it = mapLastPaid.find(GetScriptForDestination(PKHash(sn.pubkey)));
+        if (it != mapLastPaid.end())
+            (*info)[sn.vin.prevout].nLastPaid = it->second + sn.GetLastPaidOffset();
+    }
+
+    m_listinfo_block = pindex->GetBlockHash();
+    m_listinfo = info;
+    return m_listinfo;
+}
+
 void CSystemnodeMan::ProcessSystemnodeConnections(CConnman& connman)
 {
     for (const auto& pnode : connman.CopyNodeVector()) {
@@ -114,7 +179,7 @@ void CSystemnodeMan::ProcessMessage(CNode* pfrom, const std::string& strCommand,
 
         LogPrint(BCLog::SYSTEMNODE, "snp - Systemnode ping, vin: %s\n", snp.vin.ToString());
 
-        if (mapSeenSystemnodePing.count(snp.GetHash()))
+        if (mapSeenSystemnodePing.IsSeen(snp.GetHash()))
             return; //seen
         mapSeenSystemnodePing.insert(make_pair(snp.GetHash(), snp));
 
@@ -212,7 +277,7 @@ bool CSystemnodeMan::CheckSnbAndUpdateSystemnodeList(CSystemnodeBroadcast snb, i
     LogPrint(BCLog::SYSTEMNODE, "CSystemnodeMan::CheckSnbAndUpdateSystemnodeList - Systemnode broadcast, vin: %s\n", snb.vin.ToString());
 
     uint256 snbHash = snb.GetHash();
-    if (mapSeenSystemnodeBroadcast.count(snbHash)) {
+    if (mapSeenSystemnodeBroadcast.IsSeen(snbHash)) {
         systemnodeSync.AddedSystemnodeList(snbHash);
         return true;
     }
@@ -288,6 +353,19 @@ CSystemnode* CSystemnodeMan::Find(const CService& addr)
     return nullptr;
 }
 
+bool CSystemnodeMan::GetSystemnode(const COutPoint& outpoint, CSystemnode& snRet)
+{
+    LOCK(cs);
+
+    for (const auto& sn : vSystemnodes) {
+        if (sn.vin.prevout == outpoint) {
+            snRet = sn;
+            return true;
+        }
+    }
+    return false;
+}
+
 //
 // Deterministically select the oldest/best systemnode to pay on the network
 //
@@ -368,6 +446,7 @@ bool CSystemnodeMan::Add(CSystemnode& sn)
     if (!psn) {
         LogPrint(BCLog::SYSTEMNODE, "CSystemnodeMan: Adding new Systemnode %s - %i now\n", sn.addr.ToString(), size() + 1);
         vSystemnodes.push_back(sn);
+        NotifyListChanged(sn.vin.prevout, NodeListChange::ADDED);
         return true;
     }
 
@@ -388,7 +467,8 @@ void CSystemnodeMan::UpdateSystemnodeList(CSystemnodeBroadcast snb, CConnman& co
         CSystemnode sn(snb);
         Add(sn);
     } else {
-        psn->UpdateFromNewBroadcast(snb, connman);
+        if (psn->UpdateFromNewBroadcast(snb, connman))
+            NotifyListChanged(psn->vin.prevout, NodeListChange::UPDATED);
     }
 }
 
@@ -401,6 +481,7 @@ void CSystemnodeMan::Remove(CTxIn vin)
         if ((*it).vin == vin) {
             LogPrint(BCLog::SYSTEMNODE, "CSystemnodeMan: Removing Systemnode %s - %i now\n", (*it).addr.ToString(), size() - 1);
             vSystemnodes.erase(it);
+            NotifyListChanged(vin.prevout, NodeListChange::REMOVED);
             break;
         }
         ++it;
@@ -451,10 +532,78 @@ std::string CSystemnodeMan::ToString() const
     return info.str();
 }
 
+static size_t RecursiveDynamicUsage(const CSystemnodePing& snp)
+{
+    return RecursiveDynamicUsage(snp.vin) + memusage::DynamicUsage(snp.vchSig);
+}
+
+static size_t RecursiveDynamicUsage(const CSystemnode& sn)
+{
+    return RecursiveDynamicUsage(sn.vin) + memusage::DynamicUsage(sn.sig) + memusage::DynamicUsage(sn.vchSignover) + RecursiveDynamicUsage(sn.lastPing);
+}
+
+size_t CSystemnodeMan::DynamicMemoryUsage() const
+{
+    size_t nUsage = 0;
+    {
+        LOCK(cs);
+        nUsage += memusage::DynamicUsage(vSystemnodes);
+        for (const CSystemnode& sn : vSystemnodes)
+            nUsage += RecursiveDynamicUsage(sn);
+        nUsage += memusage::DynamicUsage(mAskedUsForSystemnodeList) + memusage::DynamicUsage(mWeAskedForSystemnodeList) + memusage::DynamicUsage(mWeAskedForSystemnodeListEntry);
+        nUsage += mapSeenSystemnodeBroadcast.DynamicMemoryUsage() + mapSeenSystemnodePing.DynamicMemoryUsage();
+        for (const auto& entry : mapSeenSystemnodeBroadcast)
+            nUsage += RecursiveDynamicUsage(entry.second);
+        for (const auto& entry : mapSeenSystemnodePing)
+            nUsage += RecursiveDynamicUsage(entry.second);
+    }
+    {
+        // older snapshots still held by readers are not counted
+        LOCK(cs_snapshot);
+        if (m_snapshot) {
+            nUsage += memusage::DynamicUsage(m_snapshot) + memusage::DynamicUsage(*m_snapshot);
+            for (const CSystemnode& sn : *m_snapshot)
+                nUsage += RecursiveDynamicUsage(sn);
+        }
+    }
+    {
+        LOCK(cs_listinfo);
+        if (m_listinfo)
+            nUsage += memusage::DynamicUsage(m_listinfo) + memusage::DynamicUsage(*m_listinfo);
+    }
+    return nUsage;
+}
+
+void CSystemnodeMan::NotifyListChanged(const COutPoint& outpoint, NodeListChange change)
+{
+    m_snapshot_stale = true;
+    uiInterface.NotifySystemnodeChanged(outpoint, change == NodeListChange::ADDED ? CT_NEW : change == NodeListChange::REMOVED ? CT_DELETED : CT_UPDATED);
+    GetMainSignals().SystemnodeListChanged(outpoint, change);
+}
+
+SystemnodeListSnapshot CSystemnodeMan::GetSystemnodeListSnapshot()
+{
+    LOCK(cs_snapshot);
+    if (m_snapshot && !m_snapshot_stale)
+        return m_snapshot;
+
+    LOCK(cs);
+    // clear the flag before copying, a change made after the copy marks the new snapshot stale again
+    m_snapshot_stale = false;
+    m_snapshot = std::make_shared<const std::vector<CSystemnode>>(vSystemnodes);
+    return m_snapshot;
+}
+
 void CSystemnodeMan::Clear()
 {
     LOCK(cs);
+    std::vector<COutPoint> vRemoved;
+    vRemoved.reserve(vSystemnodes.size());
+    for (const CSystemnode& sn : vSystemnodes)
+        vRemoved.push_back(sn.vin.prevout);
     vSystemnodes.clear();
+    for (const COutPoint& outpoint : vRemoved)
+        NotifyListChanged(outpoint, NodeListChange::REMOVED);
     mAskedUsForSystemnodeList.clear();
     mWeAskedForSystemnodeList.clear();
     mWeAskedForSystemnodeListEntry.clear();
@@ -569,7 +718,9 @@ void CSystemnodeMan::CheckAndRemove(bool forceExpiredRemoval)
                 }
             }
 
+            const COutPoint outpoint = (*it).vin.prevout;
             it = vSystemnodes.erase(it);
+            NotifyListChanged(outpoint, NodeListChange::REMOVED);
         } else {
             ++it;
         }
@@ -6,22 +6,41 @@
 #define SYSTEMNODEMAN_H
 
 #include <base58.h>
+#include <crown/seencache.h>
 #include <key.h>
 #include <net.h>
 #include <sync.h>
 #include <systemnode/systemnode.h>
 #include <util/system.h>
 #include <validation.h>
+#include <validationinterface.h>
+
+#include <atomic>
+#include <memory>
 
 #define SYSTEMNODES_DUMP_SECONDS (15 * 60)
 #define SYSTEMNODES_DSEG_SECONDS (3 * 60 * 60)
 
+//! Number of systemnode broadcasts and pings kept for relay, older ones are only remembered as seen
+static const size_t MAX_SEEN_SYSTEMNODE_BROADCASTS = 10000;
+static const size_t MAX_SEEN_SYSTEMNODE_PINGS = 40000;
+
 using namespace std;
 
 class CSystemnodeMan;
 
 extern CSystemnodeMan snodeman;
 
+/** Immutable, shared copy of the systemnode list handed out to readers */
+typedef std::shared_ptr<const std::vector<CSystemnode>> SystemnodeListSnapshot;
+
+/** Values of a list entry that are expensive to derive, computed once per chain height */
+struct CSystemnodeListInfo {
+    int nRank{0}; // position in the payment ranking, 0 if not enabled
+    int64_t nLastPaid{0};
+};
+typedef std::shared_ptr<const std::map<COutPoint, CSystemnodeListInfo>> SystemnodeListInfoMap;
+
 class CSystemnodeMan {
 private:
     // critical section to protect the inner data structures
@@ -39,12 +58,22 @@ private:
     // which Systemnodes we've asked for
     std::map<COutPoint, int64_t> mWeAskedForSystemnodeListEntry;
 
+    // last snapshot handed out to readers, rebuilt lazily once the list changed
+    mutable Mutex cs_snapshot;
+    SystemnodeListSnapshot m_snapshot GUARDED_BY(cs_snapshot);
+    std::atomic<bool> m_snapshot_stale{true};
+
+    // derived values of the entries, valid for the block they were computed at
+    mutable Mutex cs_listinfo;
+    uint256 m_listinfo_block GUARDED_BY(cs_listinfo);
+    SystemnodeListInfoMap m_listinfo GUARDED_BY(cs_listinfo);
+
 public:
     // Keep track of all broadcasts I've seen
-    map<uint256, CSystemnodeBroadcast> mapSeenSystemnodeBroadcast;
+    CSeenCache<CSystemnodeBroadcast> mapSeenSystemnodeBroadcast{MAX_SEEN_SYSTEMNODE_BROADCASTS};
 
     // Keep track of all pings I've seen
-    map<uint256, CSystemnodePing> mapSeenSystemnodePing;
+    CSeenCache<CSystemnodePing> mapSeenSystemnodePing{MAX_SEEN_SYSTEMNODE_PINGS};
 
     // Set when low-level node diagnostics are requested
     bool nodeDiag;
@@ -90,6 +119,8 @@ public:
     CSystemnode* Find(const CTxIn& vin);
     CSystemnode* Find(const CPubKey& pubKeySystemnode);
     CSystemnode* Find(const CService& addr);
+    /// Copy an entry out of the list, safe to hold on to without locking
+    bool GetSystemnode(const COutPoint& outpoint, CSystemnode& snRet);
 
     /// Find an entry in the systemnode list that is next to be paid
     CSystemnode* GetNextSystemnodeInQueueForPayment(int nBlockHeight, bool fFilterSigTime, int& nCount);
@@ -97,11 +128,13 @@ public:
     /// Get the current winner for this block
     CSystemnode* GetCurrentSystemNode(int mod = 1, int64_t nBlockHeight = 0, int minProtocol = 0);
 
-    std::vector<CSystemnode> GetFullSystemnodeVector()
-    {
-        Check();
-        return vSystemnodes;
-    }
+    /// Get a snapshot of the list, readers can hold on to it without locking or copying
+    SystemnodeListSnapshot GetSystemnodeListSnapshot();
+    /// Called whenever an entry of the list was added, changed or removed, a null outpoint means the whole list.
+    /// Forwarded to the GUI and, through the validation interface queue, to ZMQ and other clients
+    void NotifyListChanged(const COutPoint& outpoint, NodeListChange change);
+    /// Get the rank and last payment time of the entries at a height, computed once per block
+    SystemnodeListInfoMap GetSystemnodeListInfo(int nBlockHeight);
 
     std::vector<pair<int, CSystemnode>> GetSystemnodeRanks(int64_t nBlockHeight, int minProtocol = 0);
     int GetSystemnodeRank(const CTxIn& vin, int64_t nBlockHeight, int minProtocol = 0, bool fOnlyActive = true);
@@ -114,6 +147,7 @@ public:
     int size() { return vSystemnodes.size(); }
 
     std::string ToString() const;
+    size_t DynamicMemoryUsage() const;
 
     void Remove(CTxIn vin);
 
@@ -0,0 +1,76 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockimport.h>
+#include <chainparams.h>
+#include <streams.h>
+#include <validation.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockimport_tests, TestChain100Setup)
+
+static void WriteRecord(CAutoFile& file, const CBlock& block)
+{
+    file << Params().MessageStart() << (uint32_t)GetSerializeSize(block, CLIENT_VERSION) << block;
+}
+
+BOOST_AUTO_TEST_CASE(blockimport_file_order)
+{
+    std::vector<CBlock> vBlocks;
+    {
+        LOCK(cs_main);
+        for (const CBlockIndex* pindex = ::ChainActive().Genesis(); pindex; pindex = ::ChainActive().Next(pindex)) {
+            vBlocks.emplace_back();
+            BOOST_REQUIRE(ReadBlockFromDisk(vBlocks.back(), pindex, Params().GetConsensus()));
+        }
+    }
+
+    FILE* tmp = tmpfile();
+    BOOST_REQUIRE(tmp);
+    CAutoFile file(tmp, SER_DISK, CLIENT_VERSION);
+    std::vector<uint64_t> vPositions;
+    // fails to deserialize when taken for the start of a block
+    const std::vector<unsigned char> vGarbage(128, 0xff);
+    for (size_t i = 0; i < vBlocks.size(); i++) {
+        if (i == 50) {
+            // a record claiming to be larger than it is, which hides the next block
+            const size_t nHidden = CMessageHeader::MESSAGE_START_SIZE + sizeof(uint32_t) + GetSerializeSize(vBlocks[i], CLIENT_VERSION);
+            file << Params().MessageStart() << (uint32_t)(vGarbage.size() + nHidden + 80);
+            file.write((const char*)vGarbage.data(), vGarbage.size());
+        } else if (i % 10 == 0) {
+            file.write((const char*)vGarbage.data(), vGarbage.size());
+        }
+        vPositions.push_back(ftell(file.Get()) + CMessageHeader::MESSAGE_START_SIZE + sizeof(uint32_t));
+        WriteRecord(file, vBlocks[i]);
+    }
+    file.write((const char*)vGarbage.data(), vGarbage.size());
+    rewind(file.Get());
+
+    std::vector<std::shared_ptr<ImportedBlock>> vImported;
+    int nRestarts = 0;
+    {
+        CBlockImporter importer(file.release(), Params().MessageStart(), Params().GetConsensus(), 3);
+        while (std::shared_ptr<ImportedBlock> imported = importer.Next()) {
+            if (!imported->pblock) {
+                importer.Restart(imported->nPos - CMessageHeader::MESSAGE_START_SIZE - sizeof(uint32_t) + 1);
+                nRestarts++;
+                continue;
+            }
+            vImported.push_back(imported);
+        }
+    }
+
+    BOOST_CHECK_EQUAL(nRestarts, 1);
+    BOOST_REQUIRE_EQUAL(vImported.size(), vBlocks.size());
+    for (size_t i = 0; i < vBlocks.size(); i++) {
+        BOOST_CHECK(vImported[i]->hash == vBlocks[i].GetHash());
+        BOOST_CHECK_EQUAL(vImported[i]->nPos, vPositions[i]);
+        BOOST_CHECK(vImported[i]->pblock->fChecked);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,83 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockreader.h>
+#include <chainparams.h>
+#include <streams.h>
+#include <validation.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockreader_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(blockreader_mapped_read)
+{
+    const CBlockIndex* pindex = WITH_LOCK(cs_main, return ::ChainActive().Tip());
+    const FlatFilePos pos = WITH_LOCK(cs_main, return pindex->GetBlockPos());
+
+    // the mapped bytes are the serialized block
+    std::vector<uint8_t> vRaw;
+    BOOST_REQUIRE(ReadRawBlockFromDisk(vRaw, pindex, Params().MessageStart()));
+    CBlock block;
+    CDataStream(vRaw, SER_DISK, CLIENT_VERSION) >> block;
+    BOOST_CHECK(block.GetHash() == pindex->GetBlockHash());
+
+    Span<const uint8_t> data;
+    if (CBlockFileReader::IsAvailable()) {
+        BOOST_REQUIRE(g_blockfile_reader.MapBlock(pos, Params().MessageStart(), data));
+        BOOST_CHECK(std::vector<uint8_t>(data.begin(), data.end()) == vRaw);
+    }
+
+    // a wrong message start is not taken for a block
+    CMessageHeader::MessageStartChars message_start;
+    memcpy(message_start, Params().MessageStart(), sizeof(message_start));
+    message_start[0] ^= 0xff;
+    BOOST_CHECK(!g_blockfile_reader.MapBlock(pos, message_start, data));
+
+    // the second read is served by the cache
+    g_block_cache.Clear();
+    std::shared_ptr<const CBlock> pblock = ReadBlockFromDisk(pindex, Params().GetConsensus());
+    BOOST_REQUIRE(pblock);
+    BOOST_CHECK(pblock->GetHash() == pindex->GetBlockHash());
+    BOOST_CHECK(ReadBlockFromDisk(pindex, Params().GetConsensus()) == pblock);
+    BOOST_CHECK_EQUAL(g_block_cache.size(), 1U);
+
+    CBlockHeader header;
+    BOOST_CHECK(ReadBlockHeaderFromDisk(header, pindex, Params().GetConsensus()));
+    BOOST_CHECK(header.GetHash() == pindex->GetBlockHash());
+    g_block_cache.Clear();
+}
+
+BOOST_AUTO_TEST_CASE(blockreader_cache_bounds)
+{
+    std::vector<std::shared_ptr<const CBlock>> vBlocks;
+    for (int i = 0; i < 4; i++) {
+        auto block = std::make_shared<CBlock>();
+        block->nNonce = i;
+        vBlocks.push_back(block);
+    }
+
+    CBlockCache cache(300);
+    for (int i = 0; i < 3; i++)
+        cache.Add(vBlocks[i]->GetHash(), FlatFilePos(0, 100 * i), vBlocks[i], 100);
+    BOOST_CHECK_EQUAL(cache.size(), 3U);
+
+    // the position has to match
+    BOOST_CHECK(!cache.Get(vBlocks[0]->GetHash(), FlatFilePos(1, 0)));
+    BOOST_CHECK(cache.Get(vBlocks[0]->GetHash(), FlatFilePos(0, 0)) == vBlocks[0]);
+
+    // the least recently used one goes first
+    cache.Add(vBlocks[3]->GetHash(), FlatFilePos(0, 300), vBlocks[3], 100);
+    BOOST_CHECK_EQUAL(cache.size(), 3U);
+    BOOST_CHECK(cache.Get(vBlocks[0]->GetHash(), FlatFilePos(0, 0)));
+    BOOST_CHECK(!cache.Get(vBlocks[1]->GetHash(), FlatFilePos(0, 100)));
+
+    // blocks larger than the cache are not kept
+    cache.Add(vBlocks[1]->GetHash(), FlatFilePos(0, 100), vBlocks[1], 301);
+    BOOST_CHECK(!cache.Get(vBlocks[1]->GetHash(), FlatFilePos(0, 100)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -878,4 +878,31 @@ BOOST_AUTO_TEST_CASE(ccoins_write)
                     CheckWriteCoins(parent_value, child_value, parent_value, parent_flags, child_flags, parent_flags);
 }
 
+BOOST_AUTO_TEST_CASE(ccoins_add_prefetched)
+{
+    CCoinsView root;
+    CCoinsViewCacheTest cache(&root);
+    COutPoint outpoint(InsecureRand256(), 0);
+
+    // spent coins are not cached
+    cache.AddPrefetchedCoin(outpoint, Coin());
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), 0U);
+
+    // the prefetched coin is clean, so it can be uncached again
+    Coin coin(CTxOut(VALUE1, CScript() << OP_TRUE), 1, false, false);
+    cache.AddPrefetchedCoin(outpoint, Coin(coin));
+    BOOST_CHECK(cache.HaveCoinInCache(outpoint));
+    BOOST_CHECK_EQUAL(cache.map().at(outpoint).flags, 0);
+    cache.SelfTest();
+
+    // a cached entry is never replaced
+    cache.AddPrefetchedCoin(outpoint, Coin(CTxOut(VALUE2, CScript() << OP_TRUE), 2, false, false));
+    BOOST_CHECK(cache.AccessCoin(outpoint) == coin);
+    cache.SelfTest();
+
+    cache.Uncache(outpoint);
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), 0U);
+    cache.SelfTest();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -751,6 +751,27 @@ BOOST_AUTO_TEST_CASE(sha256d64)
     }
 }
 
+BOOST_AUTO_TEST_CASE(sha256d_multi)
+{
+    for (int i = 0; i <= 40; ++i) {
+        // lengths around the block and padding boundaries, and some longer messages
+        std::vector<std::vector<unsigned char>> messages(i);
+        std::vector<const unsigned char*> inputs;
+        std::vector<size_t> lengths;
+        for (auto& message : messages) {
+            message = g_insecure_rand_ctx.randbytes(InsecureRandBool() ? InsecureRandRange(130) : InsecureRandRange(2000));
+            inputs.push_back(message.data());
+            lengths.push_back(message.size());
+        }
+        std::vector<unsigned char> out1(32 * i), out2(32 * i);
+        for (int j = 0; j < i; ++j) {
+            CHash256().Write(messages[j]).Finalize({out1.data() + 32 * j, 32});
+        }
+        SHA256DMulti(out2.data(), inputs.data(), lengths.data(), i);
+        BOOST_CHECK(out1 == out2);
+    }
+}
+
 static void TestSHA3_256(const std::string& input, const std::string& output)
 {
     const auto in_bytes = ParseHex(input);
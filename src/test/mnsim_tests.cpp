@@ -0,0 +1,51 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <masternode/masternode-payments.h>
+#include <masternode/masternodeman.h>
+#include <util/system.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <test/util/mnsim.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(mnsim_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(mnsim_list_ping_winners)
+{
+    gArgs.ForceSetArg("-jumpstart", "1");
+    {
+        MasternodeNetworkSim sim(m_node, 30, 4);
+
+        MasternodeSimStats stats = sim.SyncList();
+        BOOST_TEST_MESSAGE(stats.ToString());
+        BOOST_CHECK_EQUAL(stats.nMessages, 30U);
+        BOOST_CHECK(stats.nBytes > 0);
+        BOOST_CHECK(stats.nPeakMemory > 0);
+        BOOST_CHECK_EQUAL(mnodeman.CountEnabled(), 30);
+
+        stats = sim.PingRound();
+        BOOST_TEST_MESSAGE(stats.ToString());
+        BOOST_CHECK_EQUAL(stats.nMessages, 30U);
+        for (const auto& mn : sim.Masternodes()) {
+            CMasternode* pmn = mnodeman.Find(mn.vin);
+            BOOST_REQUIRE(pmn);
+            BOOST_CHECK_EQUAL(pmn->lastPing.sigTime, GetAdjustedTime());
+        }
+
+        const int nBlockHeight = WITH_LOCK(cs_main, return ::ChainActive().Height()) + 1;
+        stats = sim.PaymentVoteRound(nBlockHeight);
+        BOOST_TEST_MESSAGE(stats.ToString());
+        BOOST_CHECK_EQUAL(stats.nMessages, (uint64_t)MNPAYMENTS_SIGNATURES_TOTAL);
+        std::vector<CMasternodePayee> vPayees = masternodePayments.GetBlockPayees(nBlockHeight);
+        BOOST_REQUIRE_EQUAL(vPayees.size(), 1U);
+        BOOST_CHECK(vPayees[0].nVotes >= MNPAYMENTS_SIGNATURES_REQUIRED);
+    }
+    gArgs.ForceSetArg("-jumpstart", "0");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,48 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <msgstats.h>
+#include <net.h>
+#include <protocol.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(msgstats_tests, BasicTestingSetup)
+
+static CMessageTypeStats FindStats(const CMessageStats& msgstats, const std::string& msg_type)
+{
+    for (const CMessageTypeStats& stats : msgstats.GetStats()) {
+        if (stats.strType == msg_type)
+            return stats;
+    }
+    BOOST_ERROR("message type not found: " + msg_type);
+    return CMessageTypeStats();
+}
+
+BOOST_AUTO_TEST_CASE(msgstats_record)
+{
+    CMessageStats msgstats;
+    msgstats.Record(NetMsgType::MNBROADCAST, 100, std::chrono::microseconds{5});
+    msgstats.Record(NetMsgType::MNBROADCAST, 200, std::chrono::microseconds{2500});
+    msgstats.Record(NetMsgType::MNBROADCAST, 300, std::chrono::microseconds{5000000});
+
+    CMessageTypeStats stats = FindStats(msgstats, NetMsgType::MNBROADCAST);
+    BOOST_CHECK_EQUAL(stats.nCount, 3U);
+    BOOST_CHECK_EQUAL(stats.nBytes, 600U);
+    BOOST_CHECK_EQUAL(stats.nTimeMicros, 5002505U);
+    BOOST_CHECK_EQUAL(stats.nMaxTimeMicros, 5000000U);
+    BOOST_CHECK_EQUAL(stats.vHistogram.size(), MSGSTATS_HISTOGRAM_BUCKETS);
+    BOOST_CHECK_EQUAL(stats.vHistogram[0], 1U); // <10us
+    BOOST_CHECK_EQUAL(stats.vHistogram[3], 1U); // <10ms
+    BOOST_CHECK_EQUAL(stats.vHistogram.back(), 1U);
+
+    // other types are untouched, unknown ones end up in a single bucket
+    BOOST_CHECK_EQUAL(FindStats(msgstats, NetMsgType::MNPING).nCount, 0U);
+    msgstats.Record("notatype", 10, std::chrono::microseconds{1});
+    BOOST_CHECK_EQUAL(FindStats(msgstats, NET_MESSAGE_COMMAND_OTHER).nCount, 1U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,127 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <crown/init.h>
+#include <key.h>
+#include <key_io.h>
+#include <masternode/activemasternode.h>
+#include <masternode/masternodeconfig.h>
+#include <masternode/masternodeman.h>
+#include <pos/stakeminer.h>
+#include <util/system.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+struct NodeHostTestingSetup : public BasicTestingSetup {
+    ~NodeHostTestingSetup()
+    {
+        mnodeman.Clear();
+        masternodeConfig.clear();
+        ClearHostedMasternodes();
+        activeMasternode.keyMasternode = CKey();
+        activeMasternode.pubKeyMasternode = CPubKey();
+        activeMasternode.strAlias.clear();
+        activeMasternode.strAddr.clear();
+        activeMasternode.strCollateralTxHash.clear();
+        activeMasternode.strCollateralOutputIndex.clear();
+        activeMasternode.vin = CTxIn();
+        strMasterNodeAddr.clear();
+        strMasterNodePrivKey.clear();
+        fMasterNode = false;
+    }
+};
+
+static CKey MakeKey()
+{
+    CKey key;
+    key.MakeNewKey(true);
+    return key;
+}
+
+BOOST_FIXTURE_TEST_SUITE(nodehost_tests, NodeHostTestingSetup)
+
+BOOST_AUTO_TEST_CASE(nodehost_parse_identities)
+{
+    gArgs.ForceSetArg("-masternode", "1");
+    gArgs.ForceSetArg("-nodehost", "1");
+    gArgs.ForceSetArg("-mnconflock", "0");
+
+    const CKey key1 = MakeKey();
+    const CKey key2 = MakeKey();
+    const std::string txhash = InsecureRand256().GetHex();
+    masternodeConfig.add("mn1", "1.2.3.4:9340", EncodeSecret(key1), txhash, "0");
+    masternodeConfig.add("mn2", "5.6.7.8:9340", EncodeSecret(key2), txhash, "1");
+    BOOST_CHECK(setupNodeConfiguration());
+
+    // the first entry is run by activeMasternode, the others are added to it
+    const std::vector<CActiveMasternode*> vActive = GetActiveMasternodes();
+    BOOST_REQUIRE_EQUAL(vActive.size(), 2U);
+    BOOST_CHECK(vActive[0] == &activeMasternode);
+    BOOST_CHECK_EQUAL(strMasterNodePrivKey, EncodeSecret(key1));
+    BOOST_CHECK_EQUAL(strMasterNodeAddr, "1.2.3.4:9340");
+
+    BOOST_CHECK_EQUAL(vActive[0]->strAlias, "mn1");
+    BOOST_CHECK(vActive[0]->keyMasternode == key1);
+    BOOST_CHECK(vActive[0]->pubKeyMasternode == key1.GetPubKey());
+    BOOST_CHECK_EQUAL(vActive[0]->strCollateralOutputIndex, "0");
+
+    BOOST_CHECK_EQUAL(vActive[1]->strAlias, "mn2");
+    BOOST_CHECK(vActive[1]->keyMasternode == key2);
+    BOOST_CHECK(vActive[1]->pubKeyMasternode == key2.GetPubKey());
+    BOOST_CHECK_EQUAL(vActive[1]->strAddr, "5.6.7.8:9340");
+    BOOST_CHECK_EQUAL(vActive[1]->strCollateralTxHash, txhash);
+    BOOST_CHECK_EQUAL(vActive[1]->strCollateralOutputIndex, "1");
+
+    // an entry with a bad key fails the setup
+    ClearHostedMasternodes();
+    masternodeConfig.add("mn3", "9.10.11.12:9340", "notakey", txhash, "2");
+    BOOST_CHECK(!setupNodeConfiguration());
+
+    gArgs.ForceSetArg("-masternode", "0");
+    gArgs.ForceSetArg("-nodehost", "0");
+    gArgs.ForceSetArg("-mnconflock", "1");
+}
+
+BOOST_AUTO_TEST_CASE(nodehost_stake_pointer_identity)
+{
+    fMasterNode = true;
+
+    std::vector<CKey> vKeys;
+    std::vector<CActiveMasternode*> vActive{&activeMasternode, &AddHostedMasternode(), &AddHostedMasternode()};
+    for (size_t i = 0; i < vActive.size(); i++) {
+        vKeys.push_back(MakeKey());
+        vActive[i]->keyMasternode = vKeys.back();
+        vActive[i]->pubKeyMasternode = vKeys.back().GetPubKey();
+        vActive[i]->vin = CTxIn(COutPoint(InsecureRand256(), i));
+    }
+    vActive[1]->vchSigSignover = {1, 2, 3};
+
+    // stake pointers pay to the collateral key of the masternode in the list
+    const CKey keyCollateral = MakeKey();
+    CMasternode mn;
+    mn.vin = vActive[2]->vin;
+    mn.pubkey = keyCollateral.GetPubKey();
+    BOOST_REQUIRE(mnodeman.Add(mn));
+
+    CKey keyNode;
+    std::vector<unsigned char> vchSigSignover;
+    BOOST_CHECK(FindStakingKey(keyCollateral.GetPubKey(), keyNode, vchSigSignover));
+    BOOST_CHECK(keyNode == vKeys[2]);
+    BOOST_CHECK(vchSigSignover.empty());
+
+    // or to the operator key of the node itself
+    BOOST_CHECK(FindStakingKey(vKeys[1].GetPubKey(), keyNode, vchSigSignover));
+    BOOST_CHECK(keyNode == vKeys[1]);
+    BOOST_CHECK(vchSigSignover == vActive[1]->vchSigSignover);
+
+    BOOST_CHECK(FindStakingKey(vKeys[0].GetPubKey(), keyNode, vchSigSignover));
+    BOOST_CHECK(keyNode == vKeys[0]);
+
+    // a pointer of a node we don't run has no key
+    BOOST_CHECK(!FindStakingKey(MakeKey().GetPubKey(), keyNode, vchSigSignover));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,36 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <crown/nodesync.h>
+#include <masternode/masternode.h>
+#include <net.h>
+#include <scheduler.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(nodesync_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(nodesync_schedules_tasks)
+{
+    CScheduler scheduler;
+    CConnman connman(0x1337, 0x1337);
+    std::chrono::system_clock::time_point first, last;
+    BOOST_CHECK_EQUAL(scheduler.getQueueInfo(first, last), 0U);
+
+    const std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+    StartNodeSync(scheduler, connman);
+    // a step of each sync state machine, the first status check of the active
+    // nodes, and the list check, status and cleanup tasks
+    BOOST_CHECK_EQUAL(scheduler.getQueueInfo(first, last), 6U);
+    // the sync steps and the first status check don't wait
+    BOOST_CHECK(first < now + std::chrono::seconds{1});
+    BOOST_CHECK(last >= now + std::chrono::seconds{MASTERNODE_PING_SECONDS});
+
+    // the scheduler goes away with the test
+    StopNodeSync();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
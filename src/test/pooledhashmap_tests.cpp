@@ -0,0 +1,154 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <pooledhashmap.h>
+
+#include <test/util/setup_common.h>
+
+#include <string>
+#include <unordered_map>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(pooledhashmap_tests, BasicTestingSetup)
+
+typedef PooledHashMap<uint64_t, std::string, std::hash<uint64_t>> TestMap;
+
+static void CheckEqual(const TestMap& map, const std::unordered_map<uint64_t, std::string>& ref)
+{
+    BOOST_REQUIRE_EQUAL(map.size(), ref.size());
+    size_t nCount = 0;
+    for (const auto& entry : map) {
+        auto it = ref.find(entry.first);
+        BOOST_REQUIRE(it != ref.end());
+        BOOST_CHECK_EQUAL(entry.second, it->second);
+        nCount++;
+    }
+    BOOST_CHECK_EQUAL(nCount, ref.size());
+}
+
+BOOST_AUTO_TEST_CASE(pooledhashmap_random_ops)
+{
+    TestMap map;
+    std::unordered_map<uint64_t, std::string> ref;
+    for (int i = 0; i < 50000; i++) {
+        const uint64_t key = InsecureRandRange(1000);
+        switch (InsecureRandRange(8)) {
+        case 0:
+        case 1:
+        case 2: {
+            auto ret = map.emplace(key, std::to_string(i));
+            auto ret_ref = ref.emplace(key, std::to_string(i));
+            BOOST_CHECK_EQUAL(ret.second, ret_ref.second);
+            BOOST_CHECK_EQUAL(ret.first->second, ret_ref.first->second);
+            break;
+        }
+        case 3:
+        case 4:
+            BOOST_CHECK_EQUAL(map.erase(key), ref.erase(key));
+            break;
+        case 5: {
+            auto it = map.find(key);
+            auto it_ref = ref.find(key);
+            BOOST_REQUIRE_EQUAL(it == map.end(), it_ref == ref.end());
+            if (it != map.end())
+                BOOST_CHECK_EQUAL(it->second, it_ref->second);
+            break;
+        }
+        case 6:
+            map[key] += "x";
+            ref[key] += "x";
+            break;
+        case 7:
+            if (InsecureRandRange(1000) == 0) {
+                map.clear();
+                ref.clear();
+            }
+            break;
+        }
+        BOOST_REQUIRE_EQUAL(map.size(), ref.size());
+    }
+    CheckEqual(map, ref);
+}
+
+BOOST_AUTO_TEST_CASE(pooledhashmap_erase_while_iterating)
+{
+    TestMap map;
+    std::unordered_map<uint64_t, std::string> ref;
+    for (uint64_t i = 0; i < 5000; i++) {
+        map.emplace(i, std::to_string(i));
+        ref.emplace(i, std::to_string(i));
+    }
+
+    // both erase idioms used by the coins views
+    for (TestMap::iterator it = map.begin(); it != map.end();) {
+        if (it->first % 3 == 0) {
+            ref.erase(it->first);
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    CheckEqual(map, ref);
+
+    for (TestMap::iterator it = map.begin(); it != map.end();) {
+        TestMap::iterator itOld = it++;
+        if (itOld->first % 2 == 0) {
+            ref.erase(itOld->first);
+            map.erase(itOld);
+        }
+    }
+    CheckEqual(map, ref);
+
+    for (TestMap::iterator it = map.begin(); it != map.end(); it = map.erase(it)) {}
+    BOOST_CHECK(map.empty());
+    BOOST_CHECK(map.begin() == map.end());
+}
+
+BOOST_AUTO_TEST_CASE(pooledhashmap_stable_entries)
+{
+    TestMap map;
+    std::string& value = map[12345];
+    value = "kept";
+
+    // growing the table and the pool doesn't move the entry
+    for (uint64_t i = 0; i < 20000; i++)
+        map.emplace(i * 7 + 1, std::string());
+    BOOST_CHECK_EQUAL(&map.at(12345), &value);
+    BOOST_CHECK_EQUAL(value, "kept");
+
+    for (uint64_t i = 0; i < 20000; i++)
+        map.erase(i * 7 + 1);
+    BOOST_CHECK_EQUAL(&map.at(12345), &value);
+    BOOST_CHECK_EQUAL(map.size(), 1U);
+}
+
+BOOST_AUTO_TEST_CASE(pooledhashmap_memory)
+{
+    TestMap map;
+    BOOST_CHECK_EQUAL(map.DynamicMemoryUsage(), 0U);
+
+    for (uint64_t i = 0; i < 1000; i++)
+        map.emplace(i, std::string());
+    const size_t nUsage = map.DynamicMemoryUsage();
+    BOOST_CHECK(nUsage > 1000 * sizeof(TestMap::value_type));
+    BOOST_CHECK_EQUAL(memusage::DynamicUsage(map), nUsage);
+
+    // clear() keeps the memory, and the next fill reuses it
+    map.clear();
+    BOOST_CHECK(map.empty());
+    BOOST_CHECK_EQUAL(map.DynamicMemoryUsage(), nUsage);
+    for (uint64_t i = 1000; i < 2000; i++)
+        map.emplace(i, std::string());
+    BOOST_CHECK_EQUAL(map.DynamicMemoryUsage(), nUsage);
+
+    // erased entries are recycled
+    for (uint64_t i = 1000; i < 1500; i++)
+        map.erase(i);
+    for (uint64_t i = 2000; i < 2500; i++)
+        map.emplace(i, std::string());
+    BOOST_CHECK_EQUAL(map.DynamicMemoryUsage(), nUsage);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
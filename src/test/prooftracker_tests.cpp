@@ -0,0 +1,90 @@
+// Copyright (c) 2014-2020 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <pos/blockwitness.h>
+#include <pos/prooftracker.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(prooftracker_tests, BasicTestingSetup)
+
+static void AddWitnesses(ProofTracker& tracker, const uint256& hashBlock, int nCount)
+{
+    for (int i = 0; i < nCount; i++) {
+        tracker.AddWitness(BlockWitness(CTxIn(COutPoint(InsecureRand256(), 0)), hashBlock));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(prooftracker_suspicious)
+{
+    ProofTracker tracker;
+    const uint256 hashStake = InsecureRand256();
+
+    // The same stake may appear in a few blocks before it is considered repackaged
+    for (int i = 0; i < 3; i++) {
+        BOOST_CHECK(!tracker.IsSuspicious(hashStake, InsecureRand256(), 100));
+    }
+    const uint256 hashBlock = InsecureRand256();
+    BOOST_CHECK(tracker.IsSuspicious(hashStake, hashBlock, 100));
+
+    // Duplicate witnesses only count once
+    const CTxIn vin(COutPoint(InsecureRand256(), 1));
+    for (int i = 0; i < 10; i++) {
+        tracker.AddWitness(BlockWitness(vin, hashBlock));
+    }
+    BOOST_CHECK_EQUAL(tracker.GetWitnessCount(hashBlock), 1);
+    BOOST_CHECK(tracker.IsSuspicious(hashStake, hashBlock, 100));
+
+    AddWitnesses(tracker, hashBlock, 5);
+    BOOST_CHECK(tracker.HasSufficientProof(hashBlock));
+    BOOST_CHECK_EQUAL(tracker.GetWitnesses(hashBlock).size(), 6U);
+    BOOST_CHECK(!tracker.IsSuspicious(hashStake, hashBlock, 100));
+}
+
+BOOST_AUTO_TEST_CASE(prooftracker_prune)
+{
+    ProofTracker tracker;
+    const uint256 hashStake = InsecureRand256();
+    const uint256 hashEarlyBlock = InsecureRand256();
+
+    // Witnesses that arrive before any block was checked survive the first prune
+    AddWitnesses(tracker, hashEarlyBlock, 6);
+    for (int i = 0; i < 3; i++) {
+        tracker.IsSuspicious(hashStake, InsecureRand256(), 200);
+    }
+    tracker.EraseBeforeHeight(100);
+    BOOST_CHECK(tracker.HasSufficientProof(hashEarlyBlock));
+
+    const uint256 hashBlock = InsecureRand256();
+    AddWitnesses(tracker, hashBlock, 6);
+    BOOST_CHECK(tracker.HasSufficientProof(hashBlock));
+    BOOST_CHECK(tracker.IsSuspicious(hashStake, InsecureRand256(), 250));
+
+    // Dropping the bucket forgets both the stake and the witnesses filed under it
+    tracker.EraseBeforeHeight(201);
+    BOOST_CHECK_EQUAL(tracker.GetWitnessCount(hashBlock), 0);
+    BOOST_CHECK_EQUAL(tracker.GetWitnessCount(hashEarlyBlock), 0);
+    BOOST_CHECK(!tracker.IsSuspicious(hashStake, InsecureRand256(), 250));
+}
+
+BOOST_AUTO_TEST_CASE(prooftracker_memusage)
+{
+    ProofTracker tracker;
+    const size_t nEmptyUsage = tracker.DynamicMemoryUsage();
+
+    for (int i = 0; i < 100; i++) {
+        AddWitnesses(tracker, InsecureRand256(), 6);
+        tracker.IsSuspicious(InsecureRand256(), InsecureRand256(), 100 + i);
+    }
+    const size_t nUsage = tracker.DynamicMemoryUsage();
+    BOOST_CHECK(nUsage > nEmptyUsage);
+
+    // only the hash table buckets are kept after pruning
+    tracker.EraseBeforeHeight(300);
+    BOOST_CHECK(tracker.DynamicMemoryUsage() < nUsage / 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,123 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <crown/seencache.h>
+#include <clientversion.h>
+#include <streams.h>
+#include <version.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(seencache_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(seencache_evicts_oldest)
+{
+    CSeenCache<int> cache(10);
+    std::vector<uint256> vHashes;
+    for (int i = 0; i < 25; i++) {
+        vHashes.push_back(InsecureRand256());
+        BOOST_CHECK(cache.insert(std::make_pair(vHashes.back(), i)));
+    }
+    BOOST_CHECK(!cache.insert(std::make_pair(vHashes.back(), 0)));
+    BOOST_CHECK_EQUAL(cache.size(), 10U);
+
+    // the oldest objects are gone, the recently evicted ones are still known as seen
+    for (int i = 0; i < 25; i++) {
+        BOOST_CHECK_EQUAL(cache.count(vHashes[i]), i >= 15 ? 1U : 0U);
+        if (i >= 10) BOOST_CHECK(cache.IsSeen(vHashes[i]));
+    }
+    BOOST_CHECK_EQUAL(cache.find(vHashes[20])->second, 20);
+    BOOST_CHECK(!cache.IsSeen(InsecureRand256()));
+
+    // an erased message is not seen anymore
+    cache.erase(vHashes[20]);
+    BOOST_CHECK(!cache.IsSeen(vHashes[20]));
+    BOOST_CHECK(cache.DynamicMemoryUsage() > 0);
+
+    cache.clear();
+    BOOST_CHECK_EQUAL(cache.size(), 0U);
+    BOOST_CHECK(!cache.IsSeen(vHashes[0]));
+}
+
+BOOST_AUTO_TEST_CASE(seencache_erase_reinsert)
+{
+    CSeenCache<int> cache(10);
+    std::vector<uint256> vHashes;
+    for (int i = 0; i < 10; i++) {
+        vHashes.push_back(InsecureRand256());
+        BOOST_CHECK(cache.insert(std::make_pair(vHashes.back(), i)));
+    }
+
+    // a reinserted message is the newest one, not evicted in its old place
+    BOOST_CHECK_EQUAL(cache.erase(vHashes[0]), 1U);
+    BOOST_CHECK_EQUAL(cache.erase(vHashes[0]), 0U);
+    BOOST_CHECK(cache.insert(std::make_pair(vHashes[0], 10)));
+    cache.erase(cache.find(vHashes[1]));
+    BOOST_CHECK(cache.insert(std::make_pair(vHashes[1], 11)));
+    BOOST_CHECK_EQUAL(cache.size(), 10U);
+
+    for (int i = 0; i < 8; i++) {
+        vHashes.push_back(InsecureRand256());
+        BOOST_CHECK(cache.insert(std::make_pair(vHashes.back(), 12 + i)));
+        BOOST_CHECK_EQUAL(cache.size(), 10U);
+    }
+    // the other eight of the first ten are gone, the reinserted ones are kept
+    BOOST_CHECK_EQUAL(cache.find(vHashes[0])->second, 10);
+    BOOST_CHECK_EQUAL(cache.find(vHashes[1])->second, 11);
+    for (int i = 2; i < 10; i++) {
+        BOOST_CHECK_EQUAL(cache.count(vHashes[i]), 0U);
+        if (i >= 5) BOOST_CHECK(cache.IsSeen(vHashes[i]));
+    }
+
+    // and are evicted in their new place
+    for (int i = 0; i < 2; i++) {
+        vHashes.push_back(InsecureRand256());
+        cache.insert(std::make_pair(vHashes.back(), 20 + i));
+    }
+    BOOST_CHECK_EQUAL(cache.count(vHashes[0]), 0U);
+    BOOST_CHECK_EQUAL(cache.count(vHashes[1]), 0U);
+    BOOST_CHECK_EQUAL(cache.size(), 10U);
+
+    // erasing and reinserting many times keeps the order bounded
+    for (int i = 0; i < 1000; i++) {
+        const uint256& hash = vHashes[10 + i % 10];
+        cache.erase(hash);
+        BOOST_CHECK(cache.insert(std::make_pair(hash, i)));
+    }
+    BOOST_CHECK_EQUAL(cache.size(), 10U);
+    for (int i = 10; i < 20; i++) {
+        BOOST_CHECK_EQUAL(cache.count(vHashes[i]), 1U);
+    }
+    BOOST_CHECK(cache.DynamicMemoryUsage() < 8192);
+}
+
+BOOST_AUTO_TEST_CASE(seencache_serialize)
+{
+    CSeenCache<int> cache(100);
+    for (int i = 0; i < 50; i++) {
+        cache.insert(std::make_pair(InsecureRand256(), i));
+    }
+
+    // same format as the std::map it replaced, trimmed to the bound on load
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << cache;
+    std::map<uint256, int> mapObjects;
+    CDataStream(ss) >> mapObjects;
+    BOOST_CHECK_EQUAL(mapObjects.size(), 50U);
+
+    // the entries are loaded in hash order, the first 30 are evicted
+    CSeenCache<int> small(20);
+    ss >> small;
+    BOOST_CHECK_EQUAL(small.size(), 20U);
+    int i = 0;
+    for (const auto& entry : mapObjects) {
+        BOOST_CHECK_EQUAL(small.count(entry.first), i >= 30 ? 1U : 0U);
+        if (i >= 20) BOOST_CHECK(small.IsSeen(entry.first));
+        i++;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -859,4 +859,69 @@ BOOST_AUTO_TEST_CASE(test_IsStandard)
     fIsBareMultisigStd = DEFAULT_PERMIT_BAREMULTISIG;
 }
 
+BOOST_AUTO_TEST_CASE(test_MakeTransactionRefs)
+{
+    CBlock block;
+    for (int i = 0; i < 50; i++) {
+        CMutableTransaction mtx;
+        mtx.vin.resize(1 + InsecureRandRange(5));
+        for (CTxIn& in : mtx.vin) {
+            in.prevout = COutPoint(InsecureRand256(), InsecureRandRange(10));
+            in.scriptSig = CScript() << g_insecure_rand_ctx.randbytes(InsecureRandRange(120));
+            if (InsecureRandBool()) in.scriptWitness.stack.push_back(g_insecure_rand_ctx.randbytes(InsecureRandRange(80)));
+        }
+        mtx.vout.resize(1 + InsecureRandRange(3));
+        for (CTxOut& out : mtx.vout) {
+            out.nValue = InsecureRandRange(1000000);
+            out.scriptPubKey = CScript() << OP_RETURN << g_insecure_rand_ctx.randbytes(InsecureRandRange(40));
+        }
+        if (InsecureRandBool()) {
+            mtx.nVersion = 3;
+            mtx.nType = 1;
+            mtx.extraPayload = g_insecure_rand_ctx.randbytes(InsecureRandRange(200));
+        } else if (InsecureRandRange(4) == 0) {
+            // the version and type don't survive a round trip, the hashes must
+            mtx.nVersion = -1;
+        }
+        block.vtx.push_back(MakeTransactionRef(mtx));
+    }
+
+    std::vector<CMutableTransaction> vtxMutable;
+    for (const CTransactionRef& tx : block.vtx) {
+        vtxMutable.emplace_back(*tx);
+    }
+    std::vector<CTransactionRef> vtx;
+    MakeTransactionRefs(std::move(vtxMutable), vtx);
+    BOOST_REQUIRE_EQUAL(vtx.size(), block.vtx.size());
+    for (size_t i = 0; i < block.vtx.size(); i++) {
+        BOOST_CHECK(vtx[i]->GetHash() == block.vtx[i]->GetHash());
+        BOOST_CHECK(vtx[i]->GetWitnessHash() == block.vtx[i]->GetWitnessHash());
+    }
+
+    // blocks are deserialized through MakeTransactionRefs() when it pays off
+    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+    stream << block;
+    CBlock block2;
+    stream >> block2;
+    BOOST_REQUIRE_EQUAL(block2.vtx.size(), block.vtx.size());
+    for (size_t i = 0; i < block.vtx.size(); i++) {
+        const CTransaction tx(CMutableTransaction(*block2.vtx[i]));
+        BOOST_CHECK(block2.vtx[i]->GetHash() == tx.GetHash());
+        BOOST_CHECK(block2.vtx[i]->GetWitnessHash() == tx.GetWitnessHash());
+        BOOST_CHECK(block2.vtx[i]->GetHash() == block.vtx[i]->GetHash());
+        BOOST_CHECK(block2.vtx[i]->GetWitnessHash() == block.vtx[i]->GetWitnessHash());
+    }
+
+    // without witnesses
+    CDataStream stream_no_witness(SER_NETWORK, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS);
+    stream_no_witness << block;
+    CBlock block3;
+    stream_no_witness >> block3;
+    BOOST_REQUIRE_EQUAL(block3.vtx.size(), block.vtx.size());
+    for (size_t i = 0; i < block.vtx.size(); i++) {
+        BOOST_CHECK(block3.vtx[i]->GetHash() == block.vtx[i]->GetHash());
+        BOOST_CHECK(block3.vtx[i]->GetWitnessHash() == block.vtx[i]->GetHash());
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,212 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <auxpow.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <streams.h>
+#include <txdb.h>
+#include <validation.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(txdb_tests, BasicTestingSetup)
+
+// Write a chain of headers that alternates between proof of work and proof of stake,
+// starting at the first height that stores the proof of stake flag
+static std::vector<uint256> WriteBlockIndexChain(CBlockTreeDB& db, int nCount)
+{
+    std::vector<CBlockIndex> vIndex(nCount);
+    std::vector<uint256> vHashes(nCount);
+    std::vector<const CBlockIndex*> vInfo;
+    const int nStartHeight = Params().GetConsensus().PoSStartHeight();
+    for (int i = 0; i < nCount; i++) {
+        CBlockIndex& index = vIndex[i];
+        index.pprev = i ? &vIndex[i - 1] : nullptr;
+        index.nHeight = nStartHeight + i;
+        index.nTime = 1600000000 + i;
+        index.nBits = 0x207fffff;
+        index.nNonce = i;
+        index.nStatus = BLOCK_VALID_TREE;
+        index.fProofOfStake = i % 2;
+        if (index.fProofOfStake)
+            index.stakeSource = std::make_pair(vHashes[i - 1], 0U);
+        vHashes[i] = CDiskBlockIndex(&index).GetBlockHash();
+        index.phashBlock = &vHashes[i];
+        vInfo.push_back(&index);
+    }
+    BOOST_REQUIRE(db.WriteBatchSync({}, 0, vInfo));
+    return vHashes;
+}
+
+// Load the block index into a map of hash to (previous hash, height)
+static std::map<uint256, std::pair<uint256, int>> LoadBlockIndexLinks(CBlockTreeDB& db, int nThreads)
+{
+    BlockMap mapBlockIndex;
+    auto insertBlockIndex = [&mapBlockIndex](const uint256& hash, bool fProofOfStake) {
+        auto it = mapBlockIndex.find(hash);
+        if (it != mapBlockIndex.end())
+            return it->second;
+        CBlockIndex* pindexNew = new CBlockIndex();
+        it = mapBlockIndex.emplace(hash, pindexNew).first;
+        pindexNew->phashBlock = &it->first;
+        pindexNew->fProofOfStake = fProofOfStake;
+        return pindexNew;
+    };
+    BOOST_REQUIRE(db.LoadBlockIndexGuts(Params().GetConsensus(), insertBlockIndex, nThreads));
+
+    std::map<uint256, std::pair<uint256, int>> mapLinks;
+    for (const auto& entry : mapBlockIndex)
+        mapLinks[entry.first] = std::make_pair(entry.second->pprev ? entry.second->pprev->GetBlockHash() : uint256(), entry.second->nHeight);
+    for (const auto& entry : mapBlockIndex)
+        delete entry.second;
+    return mapLinks;
+}
+
+BOOST_AUTO_TEST_CASE(load_block_index_parallel)
+{
+    CBlockTreeDB db(1 << 20, true);
+    const int nCount = 1000;
+    std::vector<uint256> vHashes = WriteBlockIndexChain(db, nCount);
+
+    mapUsedStakePointers.clear();
+    auto mapSerial = LoadBlockIndexLinks(db, 1);
+    BOOST_CHECK_EQUAL(mapUsedStakePointers.size(), (size_t)nCount / 2);
+
+    mapUsedStakePointers.clear();
+    auto mapParallel = LoadBlockIndexLinks(db, 5);
+    BOOST_CHECK_EQUAL(mapUsedStakePointers.size(), (size_t)nCount / 2);
+    BOOST_CHECK(mapSerial == mapParallel);
+
+    // every entry plus the null hash the genesis block points to
+    BOOST_CHECK_EQUAL(mapParallel.size(), (size_t)nCount + 1);
+    const int nStartHeight = Params().GetConsensus().PoSStartHeight();
+    for (int i = 1; i < nCount; i++) {
+        BOOST_CHECK(mapParallel[vHashes[i]].first == vHashes[i - 1]);
+        BOOST_CHECK_EQUAL(mapParallel[vHashes[i]].second, nStartHeight + i);
+    }
+    mapUsedStakePointers.clear();
+}
+
+static std::shared_ptr<CAuxPow> MakeAuxPow(uint32_t nNonce)
+{
+    CMutableTransaction coinbase;
+    coinbase.nLockTime = nNonce;
+    return std::make_shared<CAuxPow>(MakeTransactionRef(coinbase));
+}
+
+static bool SameAuxPow(const std::shared_ptr<CAuxPow>& a, const std::shared_ptr<CAuxPow>& b)
+{
+    if (!a || !b)
+        return a == b;
+    CDataStream ssA(SER_DISK, CLIENT_VERSION), ssB(SER_DISK, CLIENT_VERSION);
+    ssA << *a;
+    ssB << *b;
+    return ssA.str() == ssB.str();
+}
+
+BOOST_AUTO_TEST_CASE(auxpow_round_trip)
+{
+    std::vector<uint256> vHashes;
+    std::vector<std::shared_ptr<CAuxPow>> vAuxPow;
+    for (uint32_t i = 0; i < 4; i++) {
+        vHashes.push_back(InsecureRand256());
+        vAuxPow.push_back(MakeAuxPow(i));
+    }
+    CBlockIndex failed;
+    failed.phashBlock = &vHashes[3];
+    failed.nStatus = BLOCK_VALID_TREE | BLOCK_FAILED_VALID;
+
+    {
+        CBlockTreeDB db(1 << 20, false, true);
+        for (size_t i = 0; i < vHashes.size(); i++)
+            db.WriteAuxPow(vHashes[i], vAuxPow[i]);
+        // served before they are flushed
+        BOOST_CHECK(db.ReadAuxPow(vHashes[0]) == vAuxPow[0]);
+
+        db.EraseAuxPow(vHashes[1]);
+        BOOST_CHECK(!db.ReadAuxPow(vHashes[1]));
+        BOOST_REQUIRE(db.WriteBatchSync({}, 0, {&failed}));
+        BOOST_CHECK(!db.ReadAuxPow(vHashes[3]));
+    }
+
+    CBlockTreeDB db(1 << 20, false, false);
+    BOOST_CHECK(SameAuxPow(db.ReadAuxPow(vHashes[0]), vAuxPow[0]));
+    BOOST_CHECK(SameAuxPow(db.ReadAuxPow(vHashes[2]), vAuxPow[2]));
+    // erased, and dropped with the header flushed as failed
+    BOOST_CHECK(!db.ReadAuxPow(vHashes[1]));
+    BOOST_CHECK(!db.ReadAuxPow(vHashes[3]));
+    BOOST_CHECK(!db.ReadAuxPow(InsecureRand256()));
+
+    // erasing a flushed auxpow
+    db.EraseAuxPow(vHashes[0]);
+    BOOST_CHECK(!db.ReadAuxPow(vHashes[0]));
+    BOOST_REQUIRE(db.WriteBatchSync({}, 0, {}));
+    BOOST_CHECK(!db.ReadAuxPow(vHashes[0]));
+}
+
+BOOST_AUTO_TEST_CASE(auxpow_after_load_block_index)
+{
+    // merge-mined headers, as indexed by AddToBlockIndex
+    std::vector<CBlockIndex> vIndex(10);
+    std::vector<uint256> vHashes(vIndex.size());
+    std::vector<const CBlockIndex*> vInfo;
+    std::vector<CBlockHeader> vHeaders;
+    {
+        CBlockTreeDB db(1 << 20, false, true);
+        for (size_t i = 0; i < vIndex.size(); i++) {
+            CBlockHeader header;
+            header.nVersion.SetBaseVersion(CBlockHeader::CURRENT_VERSION, Params().GetConsensus().nAuxpowChainId);
+            header.nVersion.SetAuxpow(true);
+            header.hashPrevBlock = i ? vHashes[i - 1] : uint256();
+            header.nTime = 1600000000 + i;
+            header.nBits = 0x207fffff;
+            header.auxpow = MakeAuxPow(i);
+
+            CBlockIndex& index = vIndex[i];
+            index.nVersion = header.nVersion;
+            index.nTime = header.nTime;
+            index.nBits = header.nBits;
+            index.pprev = i ? &vIndex[i - 1] : nullptr;
+            index.nHeight = i;
+            index.nStatus = BLOCK_VALID_TREE;
+            vHashes[i] = header.GetHash();
+            index.phashBlock = &vHashes[i];
+            vInfo.push_back(&index);
+            vHeaders.push_back(header);
+            db.WriteAuxPow(vHashes[i], header.auxpow);
+        }
+        BOOST_REQUIRE(db.WriteBatchSync({}, 0, vInfo));
+    }
+
+    BlockMap mapBlockIndex;
+    auto insertBlockIndex = [&mapBlockIndex](const uint256& hash, bool fProofOfStake) {
+        auto it = mapBlockIndex.find(hash);
+        if (it != mapBlockIndex.end())
+            return it->second;
+        CBlockIndex* pindexNew = new CBlockIndex();
+        it = mapBlockIndex.emplace(hash, pindexNew).first;
+        pindexNew->phashBlock = &it->first;
+        pindexNew->fProofOfStake = fProofOfStake;
+        return pindexNew;
+    };
+    // the headers are rebuilt from the reopened block tree db, without block files
+    pblocktree.reset(new CBlockTreeDB(1 << 20, false, false));
+    BOOST_REQUIRE(pblocktree->LoadBlockIndexGuts(Params().GetConsensus(), insertBlockIndex, 1));
+    for (size_t i = 0; i < vHeaders.size(); i++) {
+        auto it = mapBlockIndex.find(vHashes[i]);
+        BOOST_REQUIRE(it != mapBlockIndex.end());
+        const CBlockHeader header = it->second->GetBlockHeader(Params().GetConsensus());
+        BOOST_CHECK(header.GetHash() == vHashes[i]);
+        BOOST_CHECK(SameAuxPow(header.auxpow, vHeaders[i].auxpow));
+    }
+    pblocktree.reset();
+    for (const auto& entry : mapBlockIndex)
+        delete entry.second;
+    mapUsedStakePointers.clear();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,220 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/mnsim.h>
+
+#include <chainparams.h>
+#include <coins.h>
+#include <index/txindex.h>
+#include <masternode/masternode-payments.h>
+#include <masternode/masternode-sync.h>
+#include <masternode/masternodeman.h>
+#include <msgstats.h>
+#include <net_processing.h>
+#include <netmessagemaker.h>
+#include <node/context.h>
+#include <random.h>
+#include <rpc/blockchain.h>
+#include <script/standard.h>
+#include <test/util/net.h>
+#include <tinyformat.h>
+#include <util/system.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <cassert>
+
+std::string MasternodeSimStats::ToString() const
+{
+    return strprintf("%s: %u messages, %u bytes, %.3f ms wall, %.1f us/message handling, peak memory %u kB",
+        strPhase, nMessages, nBytes, nWallMicros / 1000.0, MicrosPerMessage(), nPeakMemory / 1024);
+}
+
+static int64_t HandlerMicros()
+{
+    int64_t nMicros = 0;
+    for (const CMessageTypeStats& stats : MessageStats().GetStats())
+        nMicros += stats.nTimeMicros;
+    return nMicros;
+}
+
+MasternodeNetworkSim::MasternodeNetworkSim(NodeContext& node, size_t nMasternodes, size_t nPeers)
+    : m_node(node), m_prev_rpc_node(g_rpc_node), nTime(GetTime())
+{
+    assert(gArgs.GetBoolArg("-jumpstart", false));
+    assert(nPeers > 0);
+
+    // the input age checks reach the mempool through the RPC context
+    g_rpc_node = &m_node;
+    if (!g_txindex) {
+        g_txindex = MakeUnique<TxIndex>(1 << 20, true);
+        fOwnTxIndex = true;
+    }
+    SetMockTime(nTime);
+
+    ConnmanTestMsg& connman = *(ConnmanTestMsg*)m_node.connman.get();
+    for (size_t i = 0; i < nPeers; i++) {
+        vPeers.push_back(new CNode(i, NODE_NETWORK, 0, INVALID_SOCKET, CAddress(CService(in_addr{0x0100007f}, 7777), NODE_NETWORK), 0, 0, CAddress(), std::string(), ConnectionType::INBOUND));
+        CNode& peer = *vPeers.back();
+        peer.fSuccessfullyConnected = true;
+        peer.nVersion = PROTOCOL_VERSION;
+        peer.SetCommonVersion(PROTOCOL_VERSION);
+        m_node.peerman->InitializeNode(&peer);
+        connman.AddTestNode(peer);
+    }
+
+    FastRandomContext rng(true);
+    LOCK(cs_main);
+    CCoinsViewCache& coins = ::ChainstateActive().CoinsTip();
+    vMasternodes.resize(nMasternodes);
+    for (size_t i = 0; i < nMasternodes; i++) {
+        SimMasternode& mn = vMasternodes[i];
+        mn.keyCollateral.MakeNewKey(true);
+        mn.keyMasternode.MakeNewKey(true);
+        mn.vin = CTxIn(COutPoint(rng.rand256(), 0));
+
+        // confirmed at the first block, so it is old enough to be paid in a population up to the chain height
+        CTxOut out(Params().GetConsensus().nMasternodeCollateral, GetScriptForDestination(PKHash(mn.keyCollateral.GetPubKey())));
+        coins.AddCoin(mn.vin.prevout, Coin(out, 1, false, false), false);
+
+        CService addr(CNetAddr(in_addr{htonl(0x01000001 + i)}), Params().GetDefaultPort());
+        std::string strError;
+        bool fCreated = CMasternodeBroadcast::Create(mn.vin, addr, mn.keyCollateral, mn.keyCollateral.GetPubKey(), mn.keyMasternode, mn.keyMasternode.GetPubKey(), false, strError, mn.mnb);
+        assert(fCreated);
+        mapMasternodeIndex.emplace(mn.vin.prevout, i);
+    }
+}
+
+MasternodeNetworkSim::~MasternodeNetworkSim()
+{
+    for (CNode* peer : vPeers) {
+        bool fUpdateConnectionTime = false;
+        m_node.peerman->FinalizeNode(*peer, fUpdateConnectionTime);
+    }
+    ((ConnmanTestMsg*)m_node.connman.get())->ClearTestNodes();
+
+    {
+        LOCK(cs_main);
+        for (const SimMasternode& mn : vMasternodes)
+            ::ChainstateActive().CoinsTip().SpendCoin(mn.vin.prevout);
+    }
+    mnodeman.Clear();
+    masternodePayments.Clear();
+    masternodeSync.Reset();
+
+    if (fOwnTxIndex)
+        g_txindex.reset();
+    g_rpc_node = m_prev_rpc_node;
+    SetMockTime(0);
+}
+
+void MasternodeNetworkSim::SampleMemory(MasternodeSimStats& stats) const
+{
+    stats.nPeakMemory = std::max(stats.nPeakMemory, mnodeman.DynamicMemoryUsage() + masternodePayments.DynamicMemoryUsage());
+}
+
+void MasternodeNetworkSim::Finish(MasternodeSimStats& stats, int64_t nStartMicros, int64_t nStartHandlerMicros) const
+{
+    stats.nWallMicros = GetTimeMicros() - nStartMicros;
+    stats.nHandlerMicros = HandlerMicros() - nStartHandlerMicros;
+    SampleMemory(stats);
+}
+
+void MasternodeNetworkSim::Deliver(CSerializedNetMsg&& msg, MasternodeSimStats& stats)
+{
+    ConnmanTestMsg& connman = *(ConnmanTestMsg*)m_node.connman.get();
+    CNode& peer = *vPeers[nNextPeer++ % vPeers.size()];
+
+    stats.nMessages++;
+    stats.nBytes += CMessageHeader::HEADER_SIZE + msg.data.size();
+    connman.ReceiveMsgFrom(peer, msg);
+    peer.fPauseSend = false;
+    connman.ProcessMessagesOnce(peer);
+
+    // the usage is computed by walking the list, don't do it for every message
+    if (stats.nMessages % 64 == 0)
+        SampleMemory(stats);
+}
+
+MasternodeSimStats MasternodeNetworkSim::SyncList()
+{
+    const CNetMsgMaker msgMaker(PROTOCOL_VERSION);
+    std::vector<CSerializedNetMsg> vMessages;
+    for (const SimMasternode& mn : vMasternodes)
+        vMessages.push_back(msgMaker.Make(NetMsgType::MNBROADCAST2, mn.mnb));
+
+    MasternodeSimStats stats;
+    stats.strPhase = "list";
+    const int64_t nStartMicros = GetTimeMicros();
+    const int64_t nStartHandlerMicros = HandlerMicros();
+    for (CSerializedNetMsg& msg : vMessages)
+        Deliver(std::move(msg), stats);
+    Finish(stats, nStartMicros, nStartHandlerMicros);
+    return stats;
+}
+
+MasternodeSimStats MasternodeNetworkSim::PingRound()
+{
+    nTime += MASTERNODE_MIN_MNP_SECONDS;
+    SetMockTime(nTime);
+
+    const CNetMsgMaker msgMaker(PROTOCOL_VERSION);
+    std::vector<CSerializedNetMsg> vMessages;
+    {
+        LOCK(cs_main);
+        for (const SimMasternode& mn : vMasternodes) {
+            CMasternodePing mnp(mn.vin);
+            bool fSigned = mnp.Sign(mn.keyMasternode, mn.keyMasternode.GetPubKey());
+            assert(fSigned);
+            vMessages.push_back(msgMaker.Make(NetMsgType::MNPING2, mnp));
+        }
+    }
+
+    MasternodeSimStats stats;
+    stats.strPhase = "ping";
+    const int64_t nStartMicros = GetTimeMicros();
+    const int64_t nStartHandlerMicros = HandlerMicros();
+    for (CSerializedNetMsg& msg : vMessages)
+        Deliver(std::move(msg), stats);
+    Finish(stats, nStartMicros, nStartHandlerMicros);
+    return stats;
+}
+
+MasternodeSimStats MasternodeNetworkSim::PaymentVoteRound(int nBlockHeight)
+{
+    const CNetMsgMaker msgMaker(PROTOCOL_VERSION);
+    std::vector<CSerializedNetMsg> vMessages;
+
+    int nCount = 0;
+    CMasternode* pmn = mnodeman.GetNextMasternodeInQueueForPayment(nBlockHeight, true, nCount);
+    if (pmn) {
+        CScript payee = GetScriptForDestination(PKHash(pmn->pubkey));
+        for (const auto& rank : mnodeman.GetMasternodeRanks(nBlockHeight - 100, MIN_MNW_PEER_PROTO_VERSION)) {
+            if (rank.first > MNPAYMENTS_SIGNATURES_TOTAL)
+                continue;
+            auto it = mapMasternodeIndex.find(rank.second.vin.prevout);
+            if (it == mapMasternodeIndex.end())
+                continue;
+
+            const SimMasternode& mn = vMasternodes[it->second];
+            CKey keyMasternode = mn.keyMasternode;
+            CPubKey pubKeyMasternode = keyMasternode.GetPubKey();
+            CMasternodePaymentWinner winner(mn.vin);
+            winner.nBlockHeight = nBlockHeight;
+            winner.AddPayee(payee);
+            bool fSigned = winner.Sign(keyMasternode, pubKeyMasternode);
+            assert(fSigned);
+            vMessages.push_back(msgMaker.Make(NetMsgType::MNWINNER, winner));
+        }
+    }
+
+    MasternodeSimStats stats;
+    stats.strPhase = "winners";
+    const int64_t nStartMicros = GetTimeMicros();
+    const int64_t nStartHandlerMicros = HandlerMicros();
+    for (CSerializedNetMsg& msg : vMessages)
+        Deliver(std::move(msg), stats);
+    Finish(stats, nStartMicros, nStartHandlerMicros);
+    return stats;
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_TEST_UTIL_MNSIM_H
+#define BITCOIN_TEST_UTIL_MNSIM_H
+
+#include <key.h>
+#include <masternode/masternode.h>
+#include <net.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+struct NodeContext;
+
+/** Cost of delivering one phase of messages to the node under test */
+struct MasternodeSimStats {
+    std::string strPhase;
+    uint64_t nMessages{0};
+    uint64_t nBytes{0};
+    int64_t nWallMicros{0};
+    //! Time spent in the message handler, as recorded by MessageStats()
+    int64_t nHandlerMicros{0};
+    //! Highest memory usage of the masternode list and payment votes seen during the phase
+    size_t nPeakMemory{0};
+
+    double MicrosPerMessage() const { return nMessages ? (double)nHandlerMicros / nMessages : 0; }
+    std::string ToString() const;
+};
+
+/**
+ * In-process masternode network for load tests and benchmarks.
+ *
+ * The masternode managers are globals, so there is one node under test: the
+ * one of the testing setup. A population of simulated masternodes with their
+ * own keys talks to it through a few inbound test peers and every message
+ * takes the regular PeerManager path. The collaterals are added straight to
+ * the coins cache, so this needs -jumpstart and a txindex that never synced,
+ * which makes the node skip the lookup of the collateral transactions.
+ */
+class MasternodeNetworkSim
+{
+public:
+    struct SimMasternode {
+        CKey keyCollateral;
+        CKey keyMasternode;
+        CTxIn vin;
+        CMasternodeBroadcast mnb;
+    };
+
+    MasternodeNetworkSim(NodeContext& node, size_t nMasternodes, size_t nPeers);
+    ~MasternodeNetworkSim();
+
+    //! Announce the whole population, as a syncing node receives the list
+    MasternodeSimStats SyncList();
+    //! Move the clock past the ping interval and let every masternode ping
+    MasternodeSimStats PingRound();
+    //! Let the masternodes ranked to vote for nBlockHeight send their payment vote
+    MasternodeSimStats PaymentVoteRound(int nBlockHeight);
+
+    const std::vector<SimMasternode>& Masternodes() const { return vMasternodes; }
+
+private:
+    NodeContext& m_node;
+    NodeContext* m_prev_rpc_node;
+    bool fOwnTxIndex{false};
+    std::vector<CNode*> vPeers;
+    std::vector<SimMasternode> vMasternodes;
+    std::map<COutPoint, size_t> mapMasternodeIndex;
+    size_t nNextPeer{0};
+    int64_t nTime;
+
+    void SampleMemory(MasternodeSimStats& stats) const;
+    void Finish(MasternodeSimStats& stats, int64_t nStartMicros, int64_t nStartHandlerMicros) const;
+    void Deliver(CSerializedNetMsg&& msg, MasternodeSimStats& stats);
+};
+
+#endif // BITCOIN_TEST_UTIL_MNSIM_H
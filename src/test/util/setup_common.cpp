@@ -164,8 +164,12 @@ TestingSetup::TestingSetup(const std::string& chainName, const std::vector<const
     constexpr int script_check_threads = 2;
     for (int i = 0; i < script_check_threads; ++i) {
         threadGroup.create_thread([i]() { return ThreadScriptCheck(i); });
+        if (gArgs.GetBoolArg("-neckbeard", DEFAULT_CHECKBLOCKPOW))
+            threadGroup.create_thread([i]() { return ThreadHeaderCheck(i); });
+        threadGroup.create_thread([i]() { return ThreadCoinsPrefetch(i); });
     }
     g_parallel_script_checks = true;
+    g_coins_prefetch = true;
 
     m_node.banman = MakeUnique<BanMan>(GetDataDir() / "banlist.dat", nullptr, DEFAULT_MISBEHAVING_BANTIME);
     m_node.connman = MakeUnique<CConnman>(0x1337, 0x1337); // Deterministic randomness for tests.
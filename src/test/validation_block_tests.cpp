@@ -371,4 +371,49 @@ BOOST_AUTO_TEST_CASE(witness_commitment_index)
 
     BOOST_CHECK_EQUAL(GetWitnessCommitmentIndex(pblock), 2);
 }
+
+BOOST_AUTO_TEST_CASE(processnewblockheaders_parallel_pow)
+{
+    // the header proof of work is only checked with -neckbeard, which is
+    // also when the header check threads are started
+    gArgs.ForceSetArg("-neckbeard", "1");
+    for (int i = 0; i < 2; ++i) {
+        threadGroup.create_thread([i]() { return ThreadHeaderCheck(i); });
+    }
+
+    // a valid header, one that fails its proof of work and a valid one on top of that
+    auto make_headers = [&] {
+        std::vector<CBlockHeader> headers;
+        headers.push_back(GoodBlock(Params().GenesisBlock().GetHash())->GetBlockHeader());
+        auto pbad = Block(headers[0].GetHash());
+        pbad->hashMerkleRoot = BlockMerkleRoot(*pbad);
+        do {
+            ++(pbad->nNonce);
+        } while (CheckProofOfWork(pbad->GetHash(), pbad->nBits, Params().GetConsensus()));
+        headers.push_back(pbad->GetBlockHeader());
+        headers.push_back(GoodBlock(headers[1].GetHash())->GetBlockHeader());
+        return headers;
+    };
+
+    // the serial checks and the header check threads must give the same result
+    for (const bool parallel : {false, true}) {
+        g_parallel_script_checks = parallel;
+        const std::vector<CBlockHeader> headers = make_headers();
+
+        BlockValidationState state;
+        const CBlockIndex* pindex = nullptr;
+        BOOST_CHECK(!Assert(m_node.chainman)->ProcessNewBlockHeaders(headers, state, Params(), &pindex));
+        BOOST_CHECK_EQUAL(state.GetRejectReason(), "high-hash");
+
+        // the header in front of the bad one is accepted all the same
+        LOCK(cs_main);
+        BOOST_CHECK(pindex != nullptr && pindex->GetBlockHash() == headers[0].GetHash());
+        BOOST_CHECK(LookupBlockIndex(headers[0].GetHash()) != nullptr);
+        BOOST_CHECK(LookupBlockIndex(headers[1].GetHash()) == nullptr);
+        BOOST_CHECK(LookupBlockIndex(headers[2].GetHash()) == nullptr);
+    }
+
+    g_parallel_script_checks = true;
+    gArgs.ForceSetArg("-neckbeard", "0");
+}
 BOOST_AUTO_TEST_SUITE_END()
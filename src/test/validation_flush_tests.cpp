@@ -4,6 +4,7 @@
 //
 #include <sync.h>
 #include <test/util/setup_common.h>
+#include <txdb.h>
 #include <txmempool.h>
 #include <validation.h>
 
@@ -60,10 +61,10 @@ BOOST_AUTO_TEST_CASE(getcoinscachesizestate)
         chainstate.GetCoinsCacheSizeState(&tx_pool, MAX_COINS_CACHE_BYTES, /*max_mempool_size_bytes*/ 0),
         CoinsCacheSizeState::OK);
 
-    // If the initial memory allocations of cacheCoins don't match these common
-    // cases, we can't really continue to make assertions about memory usage.
-    // End the test early.
-    if (view.DynamicMemoryUsage() != 32 && view.DynamicMemoryUsage() != 16) {
+    // cacheCoins allocates nothing up front. The counts below are for the
+    // entry and slot sizes of 64 bit hosts, on others only check that the
+    // cache goes CRITICAL. End the test early.
+    if (view.DynamicMemoryUsage() != 0 || !is_64_bit) {
         // Add a bunch of coins to see that we at least flip over to CRITICAL.
 
         for (int i{0}; i < 1000; ++i) {
@@ -80,12 +81,13 @@ BOOST_AUTO_TEST_CASE(getcoinscachesizestate)
     }
 
     print_view_mem_usage(view);
-    BOOST_CHECK_EQUAL(view.DynamicMemoryUsage(), is_64_bit ? 32U : 16U);
+    BOOST_CHECK_EQUAL(view.DynamicMemoryUsage(), 0U);
 
     // We should be able to add COINS_UNTIL_CRITICAL coins to the cache before going CRITICAL.
     // This is contingent not only on the dynamic memory usage of the Coins
     // that we're adding (COIN_SIZE bytes per), but also on how much memory the
-    // cacheCoins (unordered_map) preallocates.
+    // cacheCoins (PooledHashMap) allocates for its slots and entries. With a
+    // budget of 1 KiB its pool allocates the entries one by one.
     constexpr int COINS_UNTIL_CRITICAL{3};
 
     for (int i{0}; i < COINS_UNTIL_CRITICAL; ++i) {
@@ -116,7 +118,10 @@ BOOST_AUTO_TEST_CASE(getcoinscachesizestate)
         chainstate.GetCoinsCacheSizeState(&tx_pool, MAX_COINS_CACHE_BYTES, /*max_mempool_size_bytes*/ 1 << 10),
         CoinsCacheSizeState::OK);
 
-    for (int i{0}; i < 3; ++i) {
+    // Each coin grows the cache by about 210 to 270 bytes on 64 bit hosts, so
+    // from 1200 bytes two more coins stay below 90% of the 2 KiB budget (1408
+    // and 1680 bytes) and the third one lands between 90% and 100% (1888).
+    for (int i{0}; i < 2; ++i) {
         add_coin(view);
         print_view_mem_usage(view);
         BOOST_CHECK_EQUAL(
@@ -148,8 +153,8 @@ BOOST_AUTO_TEST_CASE(getcoinscachesizestate)
             CoinsCacheSizeState::OK);
     }
 
-    // Flushing the view doesn't take us back to OK because cacheCoins has
-    // preallocated memory that doesn't get reclaimed even after flush.
+    // Flushing the view doesn't take us back to OK because cacheCoins keeps
+    // its slots and entry pool for the next fill.
 
     BOOST_CHECK_EQUAL(
         chainstate.GetCoinsCacheSizeState(&tx_pool, MAX_COINS_CACHE_BYTES, 0),
@@ -164,4 +169,66 @@ BOOST_AUTO_TEST_CASE(getcoinscachesizestate)
         CoinsCacheSizeState::CRITICAL);
 }
 
+//! Coins handed over to a background write are served by the database until
+//! they are written, which leaves the database as a synchronous flush would.
+BOOST_AUTO_TEST_CASE(background_coins_write)
+{
+    CCoinsViewDB db{"background_write", /*nCacheSize*/ 1 << 20, /*fMemory*/ true, /*fWipe*/ false};
+    CCoinsViewCache cache{&db};
+
+    std::vector<COutPoint> outpoints;
+    auto add_coins = [&](int count) {
+        for (int i = 0; i < count; i++) {
+            Coin coin;
+            coin.nHeight = 1;
+            coin.out.nValue = outpoints.size() + 1;
+            coin.out.scriptPubKey.assign((uint32_t)25, 1);
+            outpoints.emplace_back(InsecureRand256(), 0);
+            cache.AddCoin(outpoints.back(), std::move(coin), false);
+        }
+    };
+    // the first `spent` outpoints are spent, the others hold their index plus one
+    auto check_db = [&](size_t spent) {
+        for (size_t i = 0; i < outpoints.size(); i++) {
+            Coin coin;
+            BOOST_CHECK_EQUAL(db.HaveCoin(outpoints[i]), i >= spent);
+            BOOST_CHECK_EQUAL(db.GetCoin(outpoints[i], coin), i >= spent);
+            if (i >= spent) BOOST_CHECK_EQUAL(coin.out.nValue, (CAmount)i + 1);
+        }
+    };
+
+    add_coins(1000);
+    const uint256 block1 = InsecureRand256();
+    cache.SetBestBlock(block1);
+    BOOST_REQUIRE(cache.Flush());
+
+    for (size_t i = 0; i < 500; i++)
+        BOOST_CHECK(cache.SpendCoin(outpoints[i]));
+    add_coins(500);
+    const uint256 block2 = InsecureRand256();
+    cache.SetBestBlock(block2);
+    BOOST_REQUIRE(db.BatchWriteBackground(cache.ReleaseCoins(), block2));
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), 0U);
+    BOOST_CHECK_EQUAL(cache.DynamicMemoryUsage(), 0U);
+    BOOST_CHECK(cache.GetBestBlock() == block2);
+
+    // the same answers while the write is pending and after it completed
+    BOOST_CHECK(db.GetBestBlock() == block2);
+    check_db(500);
+    BOOST_REQUIRE(db.WaitForBackgroundWrite());
+    BOOST_CHECK(db.GetBestBlock() == block2);
+    BOOST_CHECK(db.GetHeadBlocks().empty());
+    check_db(500);
+
+    // a synchronous flush can follow
+    for (size_t i = 500; i < 1000; i++)
+        BOOST_CHECK(cache.SpendCoin(outpoints[i]));
+    const uint256 block3 = InsecureRand256();
+    cache.SetBestBlock(block3);
+    BOOST_REQUIRE(db.BatchWriteBackground(cache.ReleaseCoins(), block3));
+    BOOST_REQUIRE(cache.Flush());
+    BOOST_CHECK(db.GetBestBlock() == block3);
+    check_db(1000);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,111 @@
+// Copyright (c) 2014-2021 The Crown developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <key.h>
+#include <masternode/masternode-payments.h>
+#include <masternode/masternode.h>
+#include <masternode/masternodeman.h>
+#include <script/standard.h>
+#include <sync.h>
+#include <validationinterface.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+// The ZMQ notifiers publish these validation interface events as they come.
+struct NodeEventSubscriber final : public CValidationInterface {
+    Mutex cs;
+    std::vector<std::pair<COutPoint, NodeListChange>> vListChanges GUARDED_BY(cs);
+    std::vector<std::pair<int, CScript>> vPaymentWinners GUARDED_BY(cs);
+
+    void MasternodeListChanged(const COutPoint& outpoint, NodeListChange change) override
+    {
+        LOCK(cs);
+        vListChanges.emplace_back(outpoint, change);
+    }
+    void MasternodePaymentWinner(int nBlockHeight, const CScript& payee) override
+    {
+        LOCK(cs);
+        vPaymentWinners.emplace_back(nBlockHeight, payee);
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(zmq_tests, TestingSetup)
+
+BOOST_AUTO_TEST_CASE(zmq_masternode_list_events)
+{
+    auto sub = std::make_shared<NodeEventSubscriber>();
+    RegisterSharedValidationInterface(sub);
+
+    std::vector<COutPoint> vOutpoints;
+    for (int i = 0; i < 3; i++) {
+        CMasternode mn;
+        mn.vin = CTxIn(COutPoint(InsecureRand256(), i));
+        BOOST_REQUIRE(mnodeman.Add(mn));
+        vOutpoints.push_back(mn.vin.prevout);
+    }
+    // clearing the list removes each entry
+    mnodeman.Clear();
+    SyncWithValidationInterfaceQueue();
+
+    {
+        LOCK(sub->cs);
+        BOOST_REQUIRE_EQUAL(sub->vListChanges.size(), 6U);
+        for (size_t i = 0; i < 3; i++) {
+            BOOST_CHECK(sub->vListChanges[i].first == vOutpoints[i]);
+            BOOST_CHECK(sub->vListChanges[i].second == NodeListChange::ADDED);
+            BOOST_CHECK(sub->vListChanges[3 + i].first == vOutpoints[i]);
+            BOOST_CHECK(sub->vListChanges[3 + i].second == NodeListChange::REMOVED);
+        }
+    }
+    UnregisterSharedValidationInterface(sub);
+}
+
+BOOST_AUTO_TEST_CASE(zmq_masternode_payment_winner_events)
+{
+    auto sub = std::make_shared<NodeEventSubscriber>();
+    RegisterSharedValidationInterface(sub);
+
+    // votes are only accepted for heights with a known block 100 below them
+    const int nBlockHeight = 101;
+    mapCacheBlockHashes[nBlockHeight - 100] = InsecureRand256();
+    CKey key;
+    key.MakeNewKey(true);
+    const CScript payee = GetScriptForDestination(PKHash(key.GetPubKey()));
+    const CScript payeeOther = GetScriptForRawPubKey(key.GetPubKey());
+    auto vote = [&](const CScript& script) {
+        CMasternodePaymentWinner winner(CTxIn(COutPoint(InsecureRand256(), 0)));
+        winner.nBlockHeight = nBlockHeight;
+        winner.AddPayee(script);
+        BOOST_CHECK(masternodePayments.AddWinningMasternode(winner));
+        SyncWithValidationInterfaceQueue();
+        LOCK(sub->cs);
+        return sub->vPaymentWinners.size();
+    };
+
+    // the payee is only published once it has the required votes
+    for (int i = 1; i < MNPAYMENTS_SIGNATURES_REQUIRED; i++) {
+        BOOST_CHECK_EQUAL(vote(payee), 0U);
+        BOOST_CHECK_EQUAL(vote(payeeOther), 0U);
+    }
+    BOOST_CHECK_EQUAL(vote(payee), 1U);
+    // and not again for the votes that follow
+    BOOST_CHECK_EQUAL(vote(payee), 1U);
+    BOOST_CHECK_EQUAL(vote(payeeOther), 2U);
+    BOOST_CHECK_EQUAL(vote(payeeOther), 2U);
+
+    {
+        LOCK(sub->cs);
+        BOOST_CHECK_EQUAL(sub->vPaymentWinners[0].first, nBlockHeight);
+        BOOST_CHECK(sub->vPaymentWinners[0].second == payee);
+        BOOST_CHECK_EQUAL(sub->vPaymentWinners[1].first, nBlockHeight);
+        BOOST_CHECK(sub->vPaymentWinners[1].second == payeeOther);
+    }
+    UnregisterSharedValidationInterface(sub);
+    masternodePayments.Clear();
+    mapCacheBlockHashes.clear();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -12,11 +12,13 @@
 #include <uint256.h>
 #include <util/memory.h>
 #include <util/system.h>
+#include <util/threadnames.h>
 #include <util/translation.h>
 #include <util/vector.h>
 #include <validation.h>
 
 #include <stdint.h>
+#include <thread>
 
 static const char DB_COIN = 'C';
 static const char DB_COINS = 'c';
@@ -28,6 +30,7 @@ static const char DB_HEAD_BLOCKS = 'H';
 static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
+static const char DB_AUXPOW = 'a';
 
 namespace {
 
@@ -46,8 +49,16 @@ CCoinsViewDB::CCoinsViewDB(fs::path ldb_path, size_t nCacheSize, bool fMemory, b
     m_ldb_path(ldb_path),
     m_is_memory(fMemory) { }
 
+CCoinsViewDB::~CCoinsViewDB()
+{
+    WaitForBackgroundWrite();
+    if (m_writer.joinable())
+        m_writer.join();
+}
+
 void CCoinsViewDB::ResizeCache(size_t new_cache_size)
 {
+    WaitForBackgroundWrite();
     // Have to do a reset first to get the original `m_db` state to release its
     // filesystem lock.
     m_db.reset();
@@ -56,14 +67,44 @@ void CCoinsViewDB::ResizeCache(size_t new_cache_size)
 }
 
 bool CCoinsViewDB::GetCoin(const COutPoint &outpoint, Coin &coin) const {
+    {
+        // outpoints that aren't pending are not touched by the background write
+        LOCK(m_pending_mutex);
+        if (m_pending) {
+            CCoinsMap::const_iterator it = m_pending->find(outpoint);
+            if (it != m_pending->end()) {
+                if (it->second.coin.IsSpent())
+                    return false;
+                coin = it->second.coin;
+                return true;
+            }
+        }
+    }
     return m_db->Read(CoinEntry(&outpoint), coin);
 }
 
 bool CCoinsViewDB::HaveCoin(const COutPoint &outpoint) const {
+    {
+        LOCK(m_pending_mutex);
+        if (m_pending) {
+            CCoinsMap::const_iterator it = m_pending->find(outpoint);
+            if (it != m_pending->end())
+                return !it->second.coin.IsSpent();
+        }
+    }
     return m_db->Exists(CoinEntry(&outpoint));
 }
 
 uint256 CCoinsViewDB::GetBestBlock() const {
+    {
+        LOCK(m_pending_mutex);
+        if (m_pending)
+            return m_pending_block;
+    }
+    return ReadBestBlock();
+}
+
+uint256 CCoinsViewDB::ReadBestBlock() const {
     uint256 hashBestChain;
     if (!m_db->Read(DB_BEST_BLOCK, hashBestChain))
         return uint256();
@@ -79,6 +120,67 @@ std::vector<uint256> CCoinsViewDB::GetHeadBlocks() const {
 }
 
 bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
+    if (!WaitForBackgroundWrite())
+        return false;
+    return WriteCoins(mapCoins, hashBlock, true);
+}
+
+bool CCoinsViewDB::BatchWriteBackground(std::unique_ptr<CCoinsMap> mapCoins, const uint256& hashBlock) {
+    if (!WaitForBackgroundWrite())
+        return false;
+    if (m_writer.joinable())
+        m_writer.join();
+
+    {
+        LOCK(m_pending_mutex);
+        m_pending = std::move(mapCoins);
+        m_pending_block = hashBlock;
+    }
+    m_writer = std::thread(&CCoinsViewDB::ThreadWrite, this);
+    return true;
+}
+
+bool CCoinsViewDB::WaitForBackgroundWrite() const {
+    WAIT_LOCK(m_pending_mutex, lock);
+    while (m_pending && !m_pending_failed)
+        m_pending_cv.wait(lock);
+    return !m_pending_failed;
+}
+
+void CCoinsViewDB::ThreadWrite() {
+    util::ThreadRename("coinswrite");
+
+    CCoinsMap* pending;
+    uint256 hashBlock;
+    {
+        LOCK(m_pending_mutex);
+        pending = m_pending.get();
+        hashBlock = m_pending_block;
+    }
+
+    // the map isn't modified while it is written, so reads can go on
+    bool fOk = false;
+    try {
+        fOk = WriteCoins(*pending, hashBlock, false);
+    } catch (const std::exception& e) {
+        LogPrintf("%s: %s\n", __func__, e.what());
+    }
+
+    // freed once the lock is released
+    std::unique_ptr<CCoinsMap> written;
+    {
+        LOCK(m_pending_mutex);
+        if (fOk) {
+            written = std::move(m_pending);
+        } else {
+            // keep serving the pending coins, the node shuts down on the failure
+            m_pending_failed = true;
+        }
+    }
+    m_pending_cv.notify_all();
+}
+
+bool CCoinsViewDB::WriteCoins(CCoinsMap& mapCoins, const uint256& hashBlock, bool fErase) {
     CDBBatch batch(*m_db);
     size_t count = 0;
     size_t changed = 0;
@@ -86,7 +188,7 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
     int crash_simulate = gArgs.GetArg("-dbcrashratio", 0);
     assert(!hashBlock.IsNull());
 
-    uint256 old_tip = GetBestBlock();
+    uint256 old_tip = ReadBestBlock();
     if (old_tip.IsNull()) {
         // We may be in the middle of replaying.
         std::vector<uint256> old_heads = GetHeadBlocks();
@@ -114,7 +216,8 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
         }
         count++;
         CCoinsMap::iterator itOld = it++;
-        mapCoins.erase(itOld);
+        if (fErase)
+            mapCoins.erase(itOld);
         if (batch.SizeEstimate() > batch_size) {
             LogPrint(BCLog::COINDB, "Writing partial batch of %.2f MiB\n", batch.SizeEstimate() * (1.0 / 1048576.0));
             m_db->WriteBatch(batch);
@@ -168,6 +271,7 @@ bool CBlockTreeDB::ReadLastBlockFile(int &nFile) {
 
 CCoinsViewCursor *CCoinsViewDB::Cursor() const
 {
+    WaitForBackgroundWrite();
     CCoinsViewDBCursor *i = new CCoinsViewDBCursor(const_cast<CDBWrapper&>(*m_db).NewIterator(), GetBestBlock());
     /* It seems that there are no "const iterators" for LevelDB.  Since we
        only need read operations on it, use a const-cast to get around
@@ -229,9 +333,95 @@ bool CBlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockF
     for (std::vector<const CBlockIndex*>::const_iterator it=blockinfo.begin(); it != blockinfo.end(); it++) {
         batch.Write(std::make_pair(DB_BLOCK_INDEX, (*it)->GetBlockHash()), CDiskBlockIndex(*it));
     }
+    std::map<uint256, std::shared_ptr<CAuxPow>> mapAuxPow;
+    std::set<uint256> setErased;
+    {
+        LOCK(cs_auxpow);
+        // invalid headers are never served, don't keep their auxpow
+        for (const CBlockIndex* pindex : blockinfo) {
+            if (pindex->nStatus & BLOCK_FAILED_MASK)
+                EraseAuxPowLocked(pindex->GetBlockHash());
+        }
+        mapAuxPow.swap(m_auxpow_pending);
+        setErased.swap(m_auxpow_erased);
+        // keep them around, the newest headers are the ones peers ask for
+        for (const auto& entry : mapAuxPow)
+            CacheAuxPow(entry.first, entry.second);
+    }
+    for (const uint256& hash : setErased) {
+        batch.Erase(std::make_pair(DB_AUXPOW, hash));
+    }
+    for (const auto& entry : mapAuxPow) {
+        batch.Write(std::make_pair(DB_AUXPOW, entry.first), *entry.second);
+    }
     return WriteBatch(batch, true);
 }
 
+void CBlockTreeDB::EraseAuxPowLocked(const uint256& hash)
+{
+    m_auxpow_pending.erase(hash);
+    auto it = m_auxpow_cache.find(hash);
+    if (it != m_auxpow_cache.end()) {
+        m_auxpow_lru.erase(it->second);
+        m_auxpow_cache.erase(it);
+    }
+    m_auxpow_erased.insert(hash);
+}
+
+void CBlockTreeDB::EraseAuxPow(const uint256& hash)
+{
+    LOCK(cs_auxpow);
+    EraseAuxPowLocked(hash);
+}
+
+void CBlockTreeDB::CacheAuxPow(const uint256& hash, const std::shared_ptr<CAuxPow>& auxpow)
+{
+    auto it = m_auxpow_cache.find(hash);
+    if (it != m_auxpow_cache.end()) {
+        m_auxpow_lru.splice(m_auxpow_lru.begin(), m_auxpow_lru, it->second);
+        return;
+    }
+
+    m_auxpow_lru.emplace_front(hash, auxpow);
+    m_auxpow_cache.emplace(hash, m_auxpow_lru.begin());
+    if (m_auxpow_lru.size() > AUXPOW_CACHE_SIZE) {
+        m_auxpow_cache.erase(m_auxpow_lru.back().first);
+        m_auxpow_lru.pop_back();
+    }
+}
+
+void CBlockTreeDB::WriteAuxPow(const uint256& hash, const std::shared_ptr<CAuxPow>& auxpow)
+{
+    LOCK(cs_auxpow);
+    m_auxpow_erased.erase(hash);
+    m_auxpow_pending[hash] = auxpow;
+}
+
+std::shared_ptr<CAuxPow> CBlockTreeDB::ReadAuxPow(const uint256& hash)
+{
+    {
+        LOCK(cs_auxpow);
+        auto it = m_auxpow_cache.find(hash);
+        if (it != m_auxpow_cache.end()) {
+            m_auxpow_lru.splice(m_auxpow_lru.begin(), m_auxpow_lru, it->second);
+            return it->second->second;
+        }
+        auto itPending = m_auxpow_pending.find(hash);
+        if (itPending != m_auxpow_pending.end())
+            return itPending->second;
+        if (m_auxpow_erased.count(hash))
+            return nullptr;
+    }
+
+    auto auxpow = std::make_shared<CAuxPow>();
+    if (!Read(std::make_pair(DB_AUXPOW, hash), *auxpow))
+        return nullptr;
+
+    LOCK(cs_auxpow);
+    CacheAuxPow(hash, auxpow);
+    return auxpow;
+}
+
 bool CBlockTreeDB::ReadTxIndex(const uint256 &txid, CDiskTxPos &pos) {
     return Read(std::make_pair(DB_TXINDEX, txid), pos);
 }
@@ -255,49 +445,100 @@ bool CBlockTreeDB::ReadFlag(const std::string &name, bool &fValue) {
     return true;
 }
 
-bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&, bool&)> insertBlockIndex)
+namespace {
+
+//! A block index entry decoded by one of the loader threads
+struct LoadedBlockIndex {
+    uint256 hash;
+    CDiskBlockIndex diskindex;
+    PointerHash hashStakePointer;
+};
+
+} // namespace
+
+//! Decode the block index entries whose hash starts with a byte in [nBegin, nEnd)
+static bool ReadBlockIndexRange(CBlockTreeDB& db, int nBegin, int nEnd, std::vector<LoadedBlockIndex>& vLoaded)
 {
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
 
-    pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
+    uint256 hashBegin;
+    *hashBegin.begin() = nBegin;
+    pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, hashBegin));
 
-    // Load m_block_index
     while (pcursor->Valid()) {
         if (ShutdownRequested()) return false;
         std::pair<char, uint256> key;
-        if (pcursor->GetKey(key) && key.first == DB_BLOCK_INDEX) {
-            CDiskBlockIndex diskindex;
-            if (pcursor->GetValue(diskindex)) {
-                // Construct block index object
-                CBlockIndex* pindexNew = insertBlockIndex(diskindex.GetBlockHash(), diskindex.fProofOfStake);
-                pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev, diskindex.fProofOfStake);
-                pindexNew->nHeight        = diskindex.nHeight;
-                pindexNew->nFile          = diskindex.nFile;
-                pindexNew->nDataPos       = diskindex.nDataPos;
-                pindexNew->nUndoPos       = diskindex.nUndoPos;
-                pindexNew->nVersion       = diskindex.nVersion;
-                pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
-                pindexNew->nTime          = diskindex.nTime;
-                pindexNew->nBits          = diskindex.nBits;
-                pindexNew->nNonce         = diskindex.nNonce;
-                pindexNew->nStatus        = diskindex.nStatus;
-                pindexNew->nTx            = diskindex.nTx;
-                pindexNew->fProofOfStake  = diskindex.fProofOfStake;
-                pindexNew->stakeSource    = diskindex.stakeSource;
-                if (pindexNew->fProofOfStake) {
-                    COutPoint stakeSource(diskindex.stakeSource.first, diskindex.stakeSource.second);
-                    mapUsedStakePointers.emplace(stakeSource.GetHash(), diskindex.GetBlockHash());
-                }
-
-                pcursor->Next();
-            } else {
-                return error("%s: failed to read value", __func__);
-            }
-        } else {
+        if (!pcursor->GetKey(key) || key.first != DB_BLOCK_INDEX || *key.second.begin() >= nEnd)
             break;
+
+        LoadedBlockIndex entry;
+        if (!pcursor->GetValue(entry.diskindex))
+            return error("%s: failed to read value", __func__);
+        entry.hash = entry.diskindex.GetBlockHash();
+        if (entry.diskindex.fProofOfStake)
+            entry.hashStakePointer = COutPoint(entry.diskindex.stakeSource.first, entry.diskindex.stakeSource.second).GetHash();
+        vLoaded.push_back(std::move(entry));
+        pcursor->Next();
+    }
+
+    return true;
+}
+
+bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&, bool&)> insertBlockIndex, int nThreads)
+{
+    if (nThreads <= 0)
+        nThreads = std::max(1, std::min(GetNumCores(), MAX_BLOCK_INDEX_LOAD_THREADS));
+
+    // Decoding and hashing the headers is most of the work, split it by the
+    // first byte of the block hash. The keys are uniformly distributed.
+    const int64_t nStart = GetTimeMillis();
+    std::vector<std::vector<LoadedBlockIndex>> vRanges(nThreads);
+    std::unique_ptr<bool[]> vResults(new bool[nThreads]);
+    std::vector<std::thread> vThreads;
+    for (int i = 0; i < nThreads; i++) {
+        vThreads.emplace_back([this, i, nThreads, &vRanges, &vResults] {
+            vResults[i] = ReadBlockIndexRange(*this, 256 * i / nThreads, 256 * (i + 1) / nThreads, vRanges[i]);
+        });
+    }
+    for (std::thread& thread : vThreads)
+        thread.join();
+    for (int i = 0; i < nThreads; i++) {
+        if (!vResults[i]) return false;
+    }
+    const int64_t nDecoded = GetTimeMillis();
+
+    // Load m_block_index
+    size_t nEntries = 0;
+    for (std::vector<LoadedBlockIndex>& vLoaded : vRanges) {
+        for (LoadedBlockIndex& entry : vLoaded) {
+            CDiskBlockIndex& diskindex = entry.diskindex;
+
+            // Construct block index object
+            CBlockIndex* pindexNew = insertBlockIndex(entry.hash, diskindex.fProofOfStake);
+            pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev, diskindex.fProofOfStake);
+            pindexNew->nHeight        = diskindex.nHeight;
+            pindexNew->nFile          = diskindex.nFile;
+            pindexNew->nDataPos       = diskindex.nDataPos;
+            pindexNew->nUndoPos       = diskindex.nUndoPos;
+            pindexNew->nVersion       = diskindex.nVersion;
+            pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
+            pindexNew->nTime          = diskindex.nTime;
+            pindexNew->nBits          = diskindex.nBits;
+            pindexNew->nNonce         = diskindex.nNonce;
+            pindexNew->nStatus        = diskindex.nStatus;
+            pindexNew->nTx            = diskindex.nTx;
+            pindexNew->fProofOfStake  = diskindex.fProofOfStake;
+            pindexNew->stakeSource    = diskindex.stakeSource;
+            if (pindexNew->fProofOfStake)
+                mapUsedStakePointers.emplace(entry.hashStakePointer, entry.hash);
         }
+        nEntries += vLoaded.size();
+        // release the decoded entries as we go
+        std::vector<LoadedBlockIndex>().swap(vLoaded);
     }
 
+    LogPrintf("%s: decoded %u block index entries with %d threads in %dms, inserted in %dms\n",
+        __func__, nEntries, nThreads, nDecoded - nStart, GetTimeMillis() - nDecoded);
     return true;
 }
 
@@ -11,9 +11,15 @@
 #include <chain.h>
 #include <index/disktxpos.h>
 #include <primitives/block.h>
+#include <sync.h>
 
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <set>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -50,11 +56,24 @@ protected:
     std::unique_ptr<CDBWrapper> m_db;
     fs::path m_ldb_path;
     bool m_is_memory;
+
+    mutable Mutex m_pending_mutex;
+    mutable std::condition_variable m_pending_cv;
+    //! Coins being written by m_writer, reads look here first until the write completes
+    std::unique_ptr<CCoinsMap> m_pending GUARDED_BY(m_pending_mutex);
+    uint256 m_pending_block GUARDED_BY(m_pending_mutex);
+    bool m_pending_failed GUARDED_BY(m_pending_mutex){false};
+    std::thread m_writer;
+
+    uint256 ReadBestBlock() const;
+    bool WriteCoins(CCoinsMap& mapCoins, const uint256& hashBlock, bool fErase);
+    void ThreadWrite();
 public:
     /**
      * @param[in] ldb_path    Location in the filesystem where leveldb data will be stored.
      */
     explicit CCoinsViewDB(fs::path ldb_path, size_t nCacheSize, bool fMemory, bool fWipe);
+    ~CCoinsViewDB();
 
     bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
@@ -63,6 +82,18 @@ public:
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
     CCoinsViewCursor *Cursor() const override;
 
+    /**
+     * Write the modified coins of mapCoins as BatchWrite does, but on a
+     * background thread. Until the write completes, the coins are read from
+     * mapCoins and GetBestBlock() returns hashBlock. The head blocks marker
+     * keeps the database recoverable if the write is interrupted. Waits for
+     * the previous background write first, and returns false if it failed.
+     */
+    bool BatchWriteBackground(std::unique_ptr<CCoinsMap> mapCoins, const uint256& hashBlock);
+
+    //! Wait until no background write is pending, false if it failed
+    bool WaitForBackgroundWrite() const;
+
     //! Attempt to update from an older database format. Returns whether an error occurred.
     bool Upgrade();
     size_t EstimateSize() const override;
@@ -93,9 +124,27 @@ private:
     friend class CCoinsViewDB;
 };
 
+//! Number of auxpows kept in memory, enough for a few getheaders replies
+static const size_t AUXPOW_CACHE_SIZE = 8192;
+//! Maximum number of threads decoding the block index at startup
+static const int MAX_BLOCK_INDEX_LOAD_THREADS = 8;
+
 /** Access to the block database (blocks/index/) */
 class CBlockTreeDB : public CDBWrapper
 {
+private:
+    // auxpows of merge-mined headers, written with the next block index flush
+    Mutex cs_auxpow;
+    std::map<uint256, std::shared_ptr<CAuxPow>> m_auxpow_pending GUARDED_BY(cs_auxpow);
+    // recently used auxpows, most recent first
+    std::list<std::pair<uint256, std::shared_ptr<CAuxPow>>> m_auxpow_lru GUARDED_BY(cs_auxpow);
+    std::map<uint256, std::list<std::pair<uint256, std::shared_ptr<CAuxPow>>>::iterator> m_auxpow_cache GUARDED_BY(cs_auxpow);
+    // auxpows deleted with the next block index flush
+    std::set<uint256> m_auxpow_erased GUARDED_BY(cs_auxpow);
+
+    void CacheAuxPow(const uint256& hash, const std::shared_ptr<CAuxPow>& auxpow) EXCLUSIVE_LOCKS_REQUIRED(cs_auxpow);
+    void EraseAuxPowLocked(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_auxpow);
+
 public:
     explicit CBlockTreeDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
 
@@ -108,7 +157,15 @@ public:
     bool WriteTxIndex(const std::vector<std::pair<uint256, CDiskTxPos> > &vect);
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
-    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&, bool&)> insertBlockIndex);
+    //! Load all block index entries, decoded by nThreads threads or one per core (up to MAX_BLOCK_INDEX_LOAD_THREADS) if not positive
+    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&, bool&)> insertBlockIndex, int nThreads = 0);
+    //! Store the auxpow of a merge-mined header, so its header can be served without reading the block file
+    void WriteAuxPow(const uint256& hash, const std::shared_ptr<CAuxPow>& auxpow);
+    //! Get the auxpow of a merge-mined header, nullptr if it was never stored
+    std::shared_ptr<CAuxPow> ReadAuxPow(const uint256& hash);
+    //! Delete the auxpow of a header that won't be served any more. Those of
+    //! headers flushed as failed are deleted by WriteBatchSync().
+    void EraseAuxPow(const uint256& hash);
 };
 
 #endif // BITCOIN_TXDB_H
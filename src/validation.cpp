@@ -6,6 +6,8 @@
 #include <validation.h>
 
 #include <arith_uint256.h>
+#include <blockimport.h>
+#include <blockreader.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <checkqueue.h>
@@ -148,12 +150,14 @@ Mutex g_best_block_mutex;
 std::condition_variable g_best_block_cv;
 uint256 g_best_block;
 bool g_parallel_script_checks{false};
+bool g_coins_prefetch{false};
 std::atomic_bool fImporting(false);
 std::atomic_bool fReindex(false);
 bool fHavePruned = false;
 bool fPruneMode = false;
 bool fRequireStandard = true;
 bool fCheckBlockIndex = false;
+bool g_background_flush = DEFAULT_BACKGROUND_FLUSH;
 bool fCheckpointsEnabled = DEFAULT_CHECKPOINTS_ENABLED;
 uint64_t nPruneTarget = 0;
 int64_t nMaxTipAge = DEFAULT_MAX_TIP_AGE;
@@ -1186,17 +1190,30 @@ static bool ReadBlockOrHeader(T& block, const FlatFilePos& pos, bool fProofOfSta
 {
     block.SetNull();
 
-    // Open history file to read
-    CAutoFile filein(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
-    if (filein.IsNull())
-        return error("ReadBlockFromDisk: OpenBlockFile failed for %s", pos.ToString());
+    // Deserialize straight from the mapped file when possible
+    Span<const uint8_t> data;
+    std::shared_ptr<const CBlockFileMapping> mapping = g_blockfile_reader.MapBlock(pos, Params().MessageStart(), data);
+    if (mapping) {
+        try {
+            SpanReader reader(SER_DISK, CLIENT_VERSION, data);
+            reader >> block;
+        }
+        catch (const std::exception& e) {
+            return error("%s: Deserialize error - %s at %s", __func__, e.what(), pos.ToString());
+        }
+    } else {
+        // Open history file to read
+        CAutoFile filein(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
+        if (filein.IsNull())
+            return error("ReadBlockFromDisk: OpenBlockFile failed for %s", pos.ToString());
 
-    // Read block
-    try {
-        filein >> block;
-    }
-    catch (const std::exception& e) {
-        return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
+        // Read block
+        try {
+            filein >> block;
+        }
+        catch (const std::exception& e) {
+            return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
+        }
     }
 
     // Check the header
@@ -1220,6 +1237,13 @@ static bool ReadBlockOrHeader(T& block, const CBlockIndex* pindex, const Consens
         blockPos = pindex->GetBlockPos();
     }
 
+    // a recently decoded block holds the header as well
+    std::shared_ptr<const CBlock> pblockCached = g_block_cache.Get(pindex->GetBlockHash(), blockPos);
+    if (pblockCached) {
+        block = *pblockCached;
+        return true;
+    }
+
     if (!ReadBlockOrHeader(block, blockPos, pindex->IsProofOfStake(), consensusParams))
         return false;
     if (block.GetHash() != pindex->GetBlockHash())
@@ -1235,7 +1259,31 @@ bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::P
 
  bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams)
 {
-    return ReadBlockOrHeader(block, pindex, consensusParams);
+    std::shared_ptr<const CBlock> pblock = ReadBlockFromDisk(pindex, consensusParams);
+    if (!pblock)
+        return false;
+    block = *pblock;
+    return true;
+}
+
+std::shared_ptr<const CBlock> ReadBlockFromDisk(const CBlockIndex* pindex, const Consensus::Params& consensusParams)
+{
+    FlatFilePos blockPos;
+    {
+        LOCK(cs_main);
+        blockPos = pindex->GetBlockPos();
+    }
+
+    const uint256 hash = pindex->GetBlockHash();
+    std::shared_ptr<const CBlock> pblock = g_block_cache.Get(hash, blockPos);
+    if (pblock)
+        return pblock;
+
+    std::shared_ptr<CBlock> pblockNew = std::make_shared<CBlock>();
+    if (!ReadBlockOrHeader(*pblockNew, pindex, consensusParams))
+        return nullptr;
+    g_block_cache.Add(hash, blockPos, pblockNew, ::GetSerializeSize(*pblockNew, CLIENT_VERSION));
+    return pblockNew;
 }
 
  bool ReadBlockHeaderFromDisk(CBlockHeader& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams)
@@ -1243,8 +1291,31 @@ bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::P
     return ReadBlockOrHeader(block, pindex, consensusParams);
 }
 
+std::shared_ptr<CAuxPow> ReadBlockAuxPow(const CBlockIndex* pindex, const Consensus::Params& consensusParams)
+{
+    const uint256 hash = pindex->GetBlockHash();
+    std::shared_ptr<CAuxPow> auxpow = pblocktree->ReadAuxPow(hash);
+    if (auxpow)
+        return auxpow;
+
+    // Indexed before the auxpow store existed, take it from the block file once and store it
+    CBlockHeader block;
+    if (!(pindex->nStatus & BLOCK_HAVE_DATA) || !ReadBlockHeaderFromDisk(block, pindex, consensusParams) || !block.auxpow)
+        return nullptr;
+    if (!(pindex->nStatus & BLOCK_FAILED_MASK))
+        pblocktree->WriteAuxPow(hash, block.auxpow);
+    return block.auxpow;
+}
+
 bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const FlatFilePos& pos, const CMessageHeader::MessageStartChars& message_start)
 {
+    // Copy it out of the mapped file when possible, the mapping checked the meta header
+    Span<const uint8_t> data;
+    if (g_blockfile_reader.MapBlock(pos, message_start, data)) {
+        block.assign(data.begin(), data.end());
+        return true;
+    }
+
     FlatFilePos hpos = pos;
     hpos.nPos -= 8; // Seek back 8 bytes for meta header
     CAutoFile filein(OpenBlockFile(hpos, true), SER_DISK, CLIENT_VERSION);
@@ -1379,6 +1450,7 @@ void CChainState::InitCoinsCache(size_t cache_size_bytes)
     assert(m_coins_views != nullptr);
     m_coinstip_cache_size_bytes = cache_size_bytes;
     m_coins_views->InitCache();
+    CoinsTip().SetCacheBudget(cache_size_bytes);
 }
 
 // Note that though this is marked const, we may end up modifying `m_cached_finished_ibd`, which
@@ -2661,6 +2733,10 @@ bool CChainState::FlushStateToDisk(
             if (fFlushForPrune) {
                 LOG_TIME_MILLIS_WITH_CATEGORY("unlink pruned files", BCLog::BENCH);
 
+                // A pending background write may need these blocks to be replayed after a crash
+                if (!CoinsDB().WaitForBackgroundWrite()) {
+                    return AbortNode(state, "Failed to write to coin database");
+                }
                 UnlinkPrunedFiles(setFilesToPrune);
             }
             nLastWrite = nNow;
@@ -2679,8 +2755,16 @@ bool CChainState::FlushStateToDisk(
                 return AbortNode(state, "Disk space is too low!", _("Disk space is too low!"));
             }
             // Flush the chainstate (which may refer to block index entries).
-            if (!CoinsTip().Flush())
+            // Unless we have to be done with it now, hand the cache over to
+            // the coins database to be written while validation continues on
+            // an empty cache. Until then the database serves the handed over
+            // coins, and a crash is recovered from by ReplayBlocks.
+            if (g_background_flush && mode != FlushStateMode::ALWAYS && !fFlushForPrune) {
+                if (!CoinsDB().BatchWriteBackground(CoinsTip().ReleaseCoins(), CoinsTip().GetBestBlock()))
+                    return AbortNode(state, "Failed to write to coin database");
+            } else if (!CoinsTip().Flush()) {
                 return AbortNode(state, "Failed to write to coin database");
+            }
             nLastFlush = nNow;
             full_flush_completed = true;
         }
@@ -2840,7 +2924,94 @@ bool CChainState::DisconnectTip(BlockValidationState& state, const CChainParams&
     return true;
 }
 
+/** Closure reading one coin from the database ahead of ConnectBlock */
+class CCoinPrefetch
+{
+private:
+    const CCoinsView* pdb{nullptr};
+    const COutPoint* poutpoint{nullptr};
+    Coin* pcoin{nullptr};
+
+public:
+    CCoinPrefetch() {}
+    CCoinPrefetch(const CCoinsView& db, const COutPoint& outpoint, Coin& coin) : pdb(&db), poutpoint(&outpoint), pcoin(&coin) {}
+
+    bool operator()()
+    {
+        try {
+            pdb->GetCoin(*poutpoint, *pcoin);
+        } catch (const std::runtime_error&) {
+            // read again, and reported, when ConnectBlock needs the coin
+            pcoin->Clear();
+        }
+        return true;
+    }
+
+    void swap(CCoinPrefetch& check)
+    {
+        std::swap(pdb, check.pdb);
+        std::swap(poutpoint, check.poutpoint);
+        std::swap(pcoin, check.pcoin);
+    }
+};
+
+static CCheckQueue<CCoinPrefetch> coinsprefetchqueue(128);
+
+void ThreadCoinsPrefetch(int worker_num)
+{
+    util::ThreadRename(strprintf("coinsfetch.%i", worker_num));
+    coinsprefetchqueue.Thread();
+}
+
+CoinsPrefetchStats g_coins_prefetch_stats;
+
+void CChainState::PrefetchCoins(const CBlock& block)
+{
+    AssertLockHeld(cs_main);
+
+    // outputs created within the block are not in the database
+    std::set<uint256> setBlockTxids;
+    for (const CTransactionRef& tx : block.vtx)
+        setBlockTxids.insert(tx->GetHash());
+
+    std::vector<COutPoint> vOutpoints;
+    for (const CTransactionRef& tx : block.vtx) {
+        if (tx->IsCoinBase())
+            continue;
+        for (const CTxIn& txin : tx->vin) {
+            if (setBlockTxids.count(txin.prevout.hash))
+                continue;
+            if (CoinsTip().HaveCoinInCache(txin.prevout)) {
+                g_coins_prefetch_stats.nHits++;
+                continue;
+            }
+            vOutpoints.push_back(txin.prevout);
+        }
+    }
+
+    // without worker threads the coins are read on demand, as fast as here
+    if (vOutpoints.empty() || !g_coins_prefetch)
+        return;
+    g_coins_prefetch_stats.nMisses += vOutpoints.size();
+
+    // the cache sits right on top of the database, what it misses is read from there
+    std::vector<Coin> vCoins(vOutpoints.size());
+    std::vector<CCoinPrefetch> vChecks;
+    vChecks.reserve(vOutpoints.size());
+    for (size_t i = 0; i < vOutpoints.size(); i++)
+        vChecks.emplace_back(CoinsDB(), vOutpoints[i], vCoins[i]);
+    {
+        CCheckQueueControl<CCoinPrefetch> control(&coinsprefetchqueue);
+        control.Add(vChecks);
+        control.Wait();
+    }
+
+    for (size_t i = 0; i < vOutpoints.size(); i++)
+        CoinsTip().AddPrefetchedCoin(vOutpoints[i], std::move(vCoins[i]));
+}
+
 static int64_t nTimeReadFromDisk = 0;
+static int64_t nTimePrefetch = 0;
 static int64_t nTimeConnectTotal = 0;
 static int64_t nTimeFlush = 0;
 static int64_t nTimeChainState = 0;
@@ -2901,10 +3072,9 @@ bool CChainState::ConnectTip(BlockValidationState& state, const CChainParams& ch
     int64_t nTime1 = GetTimeMicros();
     std::shared_ptr<const CBlock> pthisBlock;
     if (!pblock) {
-        std::shared_ptr<CBlock> pblockNew = std::make_shared<CBlock>();
-        if (!ReadBlockFromDisk(*pblockNew, pindexNew, chainparams.GetConsensus()))
+        pthisBlock = ReadBlockFromDisk(pindexNew, chainparams.GetConsensus());
+        if (!pthisBlock)
             return AbortNode(state, "Failed to read block");
-        pthisBlock = pblockNew;
     } else {
         pthisBlock = pblock;
     }
@@ -2913,6 +3083,11 @@ bool CChainState::ConnectTip(BlockValidationState& state, const CChainParams& ch
     int64_t nTime2 = GetTimeMicros(); nTimeReadFromDisk += nTime2 - nTime1;
     int64_t nTime3;
     LogPrint(BCLog::BENCH, "  - Load block from disk: %.2fms [%.2fs]\n", (nTime2 - nTime1) * MILLI, nTimeReadFromDisk * MICRO);
+    PrefetchCoins(blockConnecting);
+    int64_t nTimePrefetched = GetTimeMicros(); nTimePrefetch += nTimePrefetched - nTime2;
+    LogPrint(BCLog::BENCH, "  - Prefetch coins: %.2fms [%.2fs] (%u hits, %u misses in total)\n", (nTimePrefetched - nTime2) * MILLI, nTimePrefetch * MICRO,
+        g_coins_prefetch_stats.nHits, g_coins_prefetch_stats.nMisses);
+    nTime2 = nTimePrefetched;
     {
         CCoinsViewCache view(&CoinsTip());
         bool rv = ConnectBlock(blockConnecting, state, pindexNew, view, chainparams);
@@ -3483,6 +3658,10 @@ CBlockIndex* BlockManager::AddToBlockIndex(const CBlockHeader& block, bool fProo
     if (pindexBestHeader == nullptr || pindexBestHeader->nChainWork < pindexNew->nChainWork)
         pindexBestHeader = pindexNew;
 
+    // The index has no room for the auxpow, keep it next to it so the header can be rebuilt without the block
+    if (block.nVersion.IsAuxpow() && block.auxpow && pblocktree)
+        pblocktree->WriteAuxPow(hash, block.auxpow);
+
     setDirtyBlockIndex.insert(pindexNew);
 
     return pindexNew;
@@ -3611,12 +3790,21 @@ static bool FindUndoPos(BlockValidationState &state, int nFile, FlatFilePos &pos
     return true;
 }
 
-static bool CheckBlockHeader(const CBlockHeader& block, BlockValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true)
+static bool CheckBlockHeader(const CBlockHeader& block, BlockValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, const Optional<bool>& pow_valid = nullopt)
 {
     // Check proof of work matches claimed amount
-    if (gArgs.GetBoolArg("-neckbeard", DEFAULT_CHECKBLOCKPOW))
-        if (!block.IsProofOfStake() && !CheckProofOfWork(block.GetHash(), block.nBits, consensusParams))
+    if (gArgs.GetBoolArg("-neckbeard", DEFAULT_CHECKBLOCKPOW) && !block.IsProofOfStake()) {
+        bool fValid;
+        if (pow_valid) {
+            // the target was checked by the header check threads already
+            UpdateProofOfWorkLimit(consensusParams);
+            fValid = *pow_valid;
+        } else {
+            fValid = CheckProofOfWork(block.GetHash(), block.nBits, consensusParams);
+        }
+        if (!fValid)
             return state.Invalid(BlockValidationResult::BLOCK_INVALID_HEADER, "high-hash", "proof of work failed");
+    }
 
     return true;
 }
@@ -3912,7 +4100,7 @@ static bool ContextualCheckBlock(const CBlock& block, BlockValidationState& stat
     return true;
 }
 
-bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fProofOfStake)
+bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fProofOfStake, const Optional<bool>& pow_valid)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
@@ -3932,7 +4120,7 @@ bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationS
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus())) {
+        if (!CheckBlockHeader(block, state, chainparams.GetConsensus(), true, pow_valid)) {
             LogPrint(BCLog::VALIDATION, "%s: Consensus::CheckBlockHeader: %s, %s\n", __func__, hash.ToString(), state.ToString());
             return false;
         }
@@ -4000,13 +4188,68 @@ bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationS
     return true;
 }
 
+/**
+ * Closure representing the target check of one header's proof of work,
+ * the part of CheckProofOfWork that needs no chain state. It stores its
+ * result instead of failing, so that the headers in front of a bad one
+ * can still be accepted.
+ */
+class CHeaderCheck
+{
+private:
+    const CBlockHeader* pheader{nullptr};
+    unsigned char* pfValid{nullptr};
+
+public:
+    CHeaderCheck() {}
+    CHeaderCheck(const CBlockHeader& header, unsigned char& fValid) : pheader(&header), pfValid(&fValid) {}
+
+    bool operator()()
+    {
+        *pfValid = CheckProofOfWorkTarget(pheader->GetHash(), pheader->nBits);
+        return true;
+    }
+
+    void swap(CHeaderCheck& check)
+    {
+        std::swap(pheader, check.pheader);
+        std::swap(pfValid, check.pfValid);
+    }
+};
+
+static CCheckQueue<CHeaderCheck> headercheckqueue(128);
+
+void ThreadHeaderCheck(int worker_num)
+{
+    util::ThreadRename(strprintf("headerch.%i", worker_num));
+    headercheckqueue.Thread();
+}
+
 // Exposed wrapper for AcceptBlockHeader
 bool ChainstateManager::ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, BlockValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex)
 {
     AssertLockNotHeld(cs_main);
+
+    // The proof of work target of a header does not depend on the chain, so
+    // check the whole batch on the header check threads before taking cs_main
+    std::vector<unsigned char> vPowValid;
+    if (g_parallel_script_checks && gArgs.GetBoolArg("-neckbeard", DEFAULT_CHECKBLOCKPOW)) {
+        vPowValid.resize(headers.size());
+        std::vector<CHeaderCheck> vChecks;
+        vChecks.reserve(headers.size());
+        for (size_t i = 0; i < headers.size(); i++) {
+            if (!headers[i].IsProofOfStake())
+                vChecks.emplace_back(headers[i], vPowValid[i]);
+        }
+        CCheckQueueControl<CHeaderCheck> control(&headercheckqueue);
+        control.Add(vChecks);
+        control.Wait();
+    }
+
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        for (size_t i = 0; i < headers.size(); i++) {
+            const CBlockHeader& header = headers[i];
             CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
 
             //! no other way to know..
@@ -4017,8 +4260,11 @@ bool ChainstateManager::ProcessNewBlockHeaders(const std::vector<CBlockHeader>&
                 nHeight = pindexTest->nHeight + 1;
             bool fProofOfStake = nHeight >= chainparams.GetConsensus().PoSStartHeight();
 
+            Optional<bool> pow_valid;
+            if (!vPowValid.empty())
+                pow_valid = vPowValid[i] != 0;
             bool accepted = m_blockman.AcceptBlockHeader(
-                header, state, chainparams, &pindex, fProofOfStake);
+                header, state, chainparams, &pindex, fProofOfStake, pow_valid);
             ::ChainstateActive().CheckBlockIndex(chainparams.GetConsensus());
 
             if (!accepted) {
@@ -4269,6 +4515,11 @@ void BlockManager::PruneOneBlockFile(const int fileNumber)
             pindex->nUndoPos = 0;
             setDirtyBlockIndex.insert(pindex);
 
+            // Headers of the active chain are still served, those of the
+            // blocks a reorg left behind aren't worth keeping an auxpow for
+            if (pindex->nVersion.IsAuxpow() && !::ChainActive().Contains(pindex))
+                pblocktree->EraseAuxPow(pindex->GetBlockHash());
+
             // Prune from m_blocks_unlinked -- any block we prune would have
             // to be downloaded again in order to consider its chain, at which
             // point it would be considered as a candidate for
@@ -4291,6 +4542,7 @@ void BlockManager::PruneOneBlockFile(const int fileNumber)
 
 void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune)
 {
+    g_blockfile_reader.CloseFiles(setFilesToPrune);
     for (std::set<int>::iterator it = setFilesToPrune.begin(); it != setFilesToPrune.end(); ++it) {
         FlatFilePos pos(*it, 0);
         fs::remove(BlockFileSeq().FileName(pos));
@@ -4446,6 +4698,7 @@ bool BlockManager::LoadBlockIndex(
         return false;
 
     // Calculate nChainWork
+    const int64_t nStart = GetTimeMillis();
     std::vector<std::pair<int, CBlockIndex*> > vSortedByHeight;
     vSortedByHeight.reserve(m_block_index.size());
     for (const std::pair<const uint256, CBlockIndex*>& item : m_block_index)
@@ -4488,6 +4741,7 @@ bool BlockManager::LoadBlockIndex(
         if (pindex->IsValid(BLOCK_VALID_TREE) && (pindexBestHeader == nullptr || CBlockIndexWorkComparator()(pindexBestHeader, pindex)))
             pindexBestHeader = pindex;
     }
+    LogPrintf("%s: computed the chain work of %u entries in %dms\n", __func__, vSortedByHeight.size(), GetTimeMillis() - nStart);
 
     return true;
 }
@@ -5016,44 +5270,28 @@ void LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, FlatFi
 
     int nLoaded = 0;
     try {
-        // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor
-        CBufferedFile blkdat(fileIn, 2*MAX_BLOCK_SERIALIZED_SIZE, MAX_BLOCK_SERIALIZED_SIZE+8, SER_DISK, CLIENT_VERSION);
-        uint64_t nRewind = blkdat.GetPos();
-        while (!blkdat.eof()) {
+        // This takes over fileIn and calls fclose() on it when done
+        const int nThreads = std::max(1, std::min(GetNumCores() - 1, MAX_IMPORT_DECODE_THREADS));
+        CBlockImporter importer(fileIn, chainparams.MessageStart(), chainparams.GetConsensus(), nThreads);
+        while (true) {
             if (ShutdownRequested()) return;
 
-            blkdat.SetPos(nRewind);
-            nRewind++; // start one byte further next time, in case of failure
-            blkdat.SetLimit(); // remove former limit
-            unsigned int nSize = 0;
-            try {
-                // locate a header
-                unsigned char buf[CMessageHeader::MESSAGE_START_SIZE];
-                blkdat.FindByte(chainparams.MessageStart()[0]);
-                nRewind = blkdat.GetPos()+1;
-                blkdat >> buf;
-                if (memcmp(buf, chainparams.MessageStart(), CMessageHeader::MESSAGE_START_SIZE))
-                    continue;
-                // read size
-                blkdat >> nSize;
-                if (nSize < 80 || nSize > MAX_BLOCK_SERIALIZED_SIZE)
-                    continue;
-            } catch (const std::exception&) {
-                // no valid block header found; don't complain
+            std::shared_ptr<ImportedBlock> imported = importer.Next();
+            if (!imported)
                 break;
+            if (!imported->pblock) {
+                LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, imported->strError);
+                // start one byte past the message start, in case a block is hidden in the bad one
+                importer.Restart(imported->nPos - CMessageHeader::MESSAGE_START_SIZE - sizeof(uint32_t) + 1);
+                continue;
             }
             try {
-                // read block
-                uint64_t nBlockPos = blkdat.GetPos();
                 if (dbp)
-                    dbp->nPos = nBlockPos;
-                blkdat.SetLimit(nBlockPos + nSize);
-                std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+                    dbp->nPos = imported->nPos;
+                std::shared_ptr<CBlock> pblock = imported->pblock;
                 CBlock& block = *pblock;
-                blkdat >> block;
-                nRewind = blkdat.GetPos();
 
-                uint256 hash = block.GetHash();
+                const uint256& hash = imported->hash;
                 {
                     LOCK(cs_main);
                     // detect out of order blocks, and store them for later
@@ -5350,6 +5588,7 @@ bool CChainState::ResizeCoinsCaches(size_t coinstip_size, size_t coinsdb_size)
         ret = FlushStateToDisk(chainparams, state, FlushStateMode::ALWAYS);
         CoinsTip().ReallocateCache();
     }
+    CoinsTip().SetCacheBudget(coinstip_size);
     return ret;
 }
 
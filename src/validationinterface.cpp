@@ -254,3 +254,68 @@ void CMainSignals::NewPoWValidBlock(const CBlockIndex *pindex, const std::shared
     LOG_EVENT("%s: block hash=%s", __func__, block->GetHash().ToString());
     m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.NewPoWValidBlock(pindex, block); });
 }
+
+// The Crown managers also change while no scheduler is registered (during
+// startup, shutdown and in unit tests), those events are dropped.
+void CMainSignals::MasternodeListChanged(const COutPoint& outpoint, NodeListChange change)
+{
+    if (!m_internals) return;
+    auto event = [outpoint, change, this] {
+        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.MasternodeListChanged(outpoint, change); });
+    };
+    ENQUEUE_AND_LOG_EVENT(event, "%s: outpoint=%s change=%d", __func__, outpoint.ToString(), (int)change);
+}
+
+void CMainSignals::SystemnodeListChanged(const COutPoint& outpoint, NodeListChange change)
+{
+    if (!m_internals) return;
+    auto event = [outpoint, change, this] {
+        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.SystemnodeListChanged(outpoint, change); });
+    };
+    ENQUEUE_AND_LOG_EVENT(event, "%s: outpoint=%s change=%d", __func__, outpoint.ToString(), (int)change);
+}
+
+void CMainSignals::MasternodePaymentWinner(int nBlockHeight, const CScript& payee)
+{
+    if (!m_internals) return;
+    auto event = [nBlockHeight, payee, this] {
+        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.MasternodePaymentWinner(nBlockHeight, payee); });
+    };
+    ENQUEUE_AND_LOG_EVENT(event, "%s: height=%d", __func__, nBlockHeight);
+}
+
+void CMainSignals::SystemnodePaymentWinner(int nBlockHeight, const CScript& payee)
+{
+    if (!m_internals) return;
+    auto event = [nBlockHeight, payee, this] {
+        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.SystemnodePaymentWinner(nBlockHeight, payee); });
+    };
+    ENQUEUE_AND_LOG_EVENT(event, "%s: height=%d", __func__, nBlockHeight);
+}
+
+void CMainSignals::BudgetProposalAdded(const uint256& hashProposal)
+{
+    if (!m_internals) return;
+    auto event = [hashProposal, this] {
+        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BudgetProposalAdded(hashProposal); });
+    };
+    ENQUEUE_AND_LOG_EVENT(event, "%s: proposal=%s", __func__, hashProposal.ToString());
+}
+
+void CMainSignals::BudgetProposalVote(const uint256& hashProposal, const COutPoint& voter, int nVote)
+{
+    if (!m_internals) return;
+    auto event = [hashProposal, voter, nVote, this] {
+        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BudgetProposalVote(hashProposal, voter, nVote); });
+    };
+    ENQUEUE_AND_LOG_EVENT(event, "%s: proposal=%s voter=%s vote=%d", __func__, hashProposal.ToString(), voter.ToString(), nVote);
+}
+
+void CMainSignals::InstantSendLockCompleted(const uint256& txid)
+{
+    if (!m_internals) return;
+    auto event = [txid, this] {
+        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.InstantSendLockCompleted(txid); });
+    };
+    ENQUEUE_AND_LOG_EVENT(event, "%s: txid=%s", __func__, txid.ToString());
+}
@@ -23,6 +23,14 @@ class uint256;
 class CScheduler;
 enum class MemPoolRemovalReason;
 
+/** Kind of change of a masternode or systemnode list entry */
+enum class NodeListChange {
+    ADDED,
+    UPDATED,
+    EXPIRED,
+    REMOVED,
+};
+
 /** Register subscriber */
 void RegisterValidationInterface(CValidationInterface* callbacks);
 /** Unregister subscriber. DEPRECATED. This is not safe to use when the RPC server or main message handler thread is running. */
@@ -173,6 +181,29 @@ protected:
      * Notifies listeners that a block which builds directly on our current tip
      * has been received and connected to the headers tree, though not validated yet */
     virtual void NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock>& block) {};
+    /**
+     * Notifies listeners of a change of a masternode list entry.
+     *
+     * Called on a background thread.
+     */
+    virtual void MasternodeListChanged(const COutPoint& outpoint, NodeListChange change) {}
+    /** Same as MasternodeListChanged for the systemnode list */
+    virtual void SystemnodeListChanged(const COutPoint& outpoint, NodeListChange change) {}
+    /**
+     * Notifies listeners that a payee was elected for the block at the given
+     * height, once its winner votes reach the signatures required to
+     * enforce the payment.
+     *
+     * Called on a background thread.
+     */
+    virtual void MasternodePaymentWinner(int nBlockHeight, const CScript& payee) {}
+    virtual void SystemnodePaymentWinner(int nBlockHeight, const CScript& payee) {}
+    /** Notifies listeners of a new budget proposal. Called on a background thread. */
+    virtual void BudgetProposalAdded(const uint256& hashProposal) {}
+    /** Notifies listeners of a new or changed masternode vote on a budget proposal. Called on a background thread. */
+    virtual void BudgetProposalVote(const uint256& hashProposal, const COutPoint& voter, int nVote) {}
+    /** Notifies listeners that a transaction lock collected enough signatures. Called on a background thread. */
+    virtual void InstantSendLockCompleted(const uint256& txid) {}
     friend class CMainSignals;
 };
 
@@ -205,6 +236,13 @@ public:
     void ChainStateFlushed(const CBlockLocator &);
     void BlockChecked(const CBlock&, const BlockValidationState&);
     void NewPoWValidBlock(const CBlockIndex *, const std::shared_ptr<const CBlock>&);
+    void MasternodeListChanged(const COutPoint&, NodeListChange);
+    void SystemnodeListChanged(const COutPoint&, NodeListChange);
+    void MasternodePaymentWinner(int nBlockHeight, const CScript&);
+    void SystemnodePaymentWinner(int nBlockHeight, const CScript&);
+    void BudgetProposalAdded(const uint256&);
+    void BudgetProposalVote(const uint256&, const COutPoint&, int nVote);
+    void InstantSendLockCompleted(const uint256&);
 };
 
 CMainSignals& GetMainSignals();
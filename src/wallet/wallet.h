@@ -1297,8 +1297,8 @@ public:
     bool GetVinAndKeysFromOutput(COutput out, CTxIn& txinRet, CPubKey& pubkeyRet, CKey& keyRet);
     bool GetMasternodeVinAndKeys(CTxIn& txinRet, CPubKey& pubKeyRet, CKey& keyRet, std::string strTxHash = "", std::string strOutputIndex = "");
     bool GetSystemnodeVinAndKeys(CTxIn& txinRet, CPubKey& pubKeyRet, CKey& keyRet, std::string strTxHash = "", std::string strOutputIndex = "");
-    bool GetActiveMasternode(CMasternode*& activeStakingNode);
-    bool GetActiveSystemnode(CSystemnode*& activeStakingNode);
+    bool GetStakingMasternodes(std::vector<CMasternode*>& vStakingNodes);
+    bool GetStakingSystemnodes(std::vector<CSystemnode*>& vStakingNodes);
     uint256 GenerateStakeModifier(const CBlockIndex* prewardBlockIndex) const;
     bool CreateCoinStake(const int nHeight, const uint32_t& nBits, const uint32_t& nTime, CMutableTransaction& txCoinStake, uint32_t& nTxNewTime, StakePointer& stakePointer);
     bool GetRecentStakePointers(std::vector<StakePointer>& vStakePointers);
@@ -42,3 +42,38 @@ bool CZMQAbstractNotifier::NotifyTransactionRemoval(const CTransaction &/*transa
 {
     return true;
 }
+
+bool CZMQAbstractNotifier::NotifyMasternodeChanged(const COutPoint &/*outpoint*/, NodeListChange /*change*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifySystemnodeChanged(const COutPoint &/*outpoint*/, NodeListChange /*change*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyMasternodePaymentWinner(int /*nBlockHeight*/, const CScript &/*payee*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifySystemnodePaymentWinner(int /*nBlockHeight*/, const CScript &/*payee*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyBudgetProposal(const uint256 &/*hashProposal*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyBudgetVote(const uint256 &/*hashProposal*/, const COutPoint &/*voter*/, int /*nVote*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyInstantSendLock(const uint256 &/*txid*/)
+{
+    return true;
+}
@@ -11,8 +11,12 @@
 #include <string>
 
 class CBlockIndex;
+class COutPoint;
+class CScript;
 class CTransaction;
 class CZMQAbstractNotifier;
+class uint256;
+enum class NodeListChange;
 
 using CZMQNotifierFactory = std::unique_ptr<CZMQAbstractNotifier> (*)();
 
@@ -56,6 +60,17 @@ public:
     virtual bool NotifyTransactionRemoval(const CTransaction &transaction, uint64_t mempool_sequence);
     // Notifies of transactions added to mempool or appearing in blocks
     virtual bool NotifyTransaction(const CTransaction &transaction);
+    // Notifies of masternode and systemnode list changes
+    virtual bool NotifyMasternodeChanged(const COutPoint &outpoint, NodeListChange change);
+    virtual bool NotifySystemnodeChanged(const COutPoint &outpoint, NodeListChange change);
+    // Notifies of accepted payment winner votes
+    virtual bool NotifyMasternodePaymentWinner(int nBlockHeight, const CScript &payee);
+    virtual bool NotifySystemnodePaymentWinner(int nBlockHeight, const CScript &payee);
+    // Notifies of new budget proposals and votes on them
+    virtual bool NotifyBudgetProposal(const uint256 &hashProposal);
+    virtual bool NotifyBudgetVote(const uint256 &hashProposal, const COutPoint &voter, int nVote);
+    // Notifies of completed InstantSend transaction locks
+    virtual bool NotifyInstantSendLock(const uint256 &txid);
 
 protected:
     void *psocket;
@@ -37,6 +37,12 @@ CZMQNotificationInterface* CZMQNotificationInterface::Create()
     factories["pubrawblock"] = CZMQAbstractNotifier::Create<CZMQPublishRawBlockNotifier>;
     factories["pubrawtx"] = CZMQAbstractNotifier::Create<CZMQPublishRawTransactionNotifier>;
     factories["pubsequence"] = CZMQAbstractNotifier::Create<CZMQPublishSequenceNotifier>;
+    factories["pubmasternode"] = CZMQAbstractNotifier::Create<CZMQPublishMasternodeNotifier>;
+    factories["pubsystemnode"] = CZMQAbstractNotifier::Create<CZMQPublishSystemnodeNotifier>;
+    factories["pubmnpayment"] = CZMQAbstractNotifier::Create<CZMQPublishMasternodePaymentNotifier>;
+    factories["pubsnpayment"] = CZMQAbstractNotifier::Create<CZMQPublishSystemnodePaymentNotifier>;
+    factories["pubbudget"] = CZMQAbstractNotifier::Create<CZMQPublishBudgetNotifier>;
+    factories["pubixlock"] = CZMQAbstractNotifier::Create<CZMQPublishInstantSendLockNotifier>;
 
     std::list<std::unique_ptr<CZMQAbstractNotifier>> notifiers;
     for (const auto& entry : factories)
@@ -188,4 +194,53 @@ void CZMQNotificationInterface::BlockDisconnected(const std::shared_ptr<const CB
     });
 }
 
+void CZMQNotificationInterface::MasternodeListChanged(const COutPoint& outpoint, NodeListChange change)
+{
+    TryForEachAndRemoveFailed(notifiers, [&outpoint, change](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyMasternodeChanged(outpoint, change);
+    });
+}
+
+void CZMQNotificationInterface::SystemnodeListChanged(const COutPoint& outpoint, NodeListChange change)
+{
+    TryForEachAndRemoveFailed(notifiers, [&outpoint, change](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifySystemnodeChanged(outpoint, change);
+    });
+}
+
+void CZMQNotificationInterface::MasternodePaymentWinner(int nBlockHeight, const CScript& payee)
+{
+    TryForEachAndRemoveFailed(notifiers, [nBlockHeight, &payee](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyMasternodePaymentWinner(nBlockHeight, payee);
+    });
+}
+
+void CZMQNotificationInterface::SystemnodePaymentWinner(int nBlockHeight, const CScript& payee)
+{
+    TryForEachAndRemoveFailed(notifiers, [nBlockHeight, &payee](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifySystemnodePaymentWinner(nBlockHeight, payee);
+    });
+}
+
+void CZMQNotificationInterface::BudgetProposalAdded(const uint256& hashProposal)
+{
+    TryForEachAndRemoveFailed(notifiers, [&hashProposal](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyBudgetProposal(hashProposal);
+    });
+}
+
+void CZMQNotificationInterface::BudgetProposalVote(const uint256& hashProposal, const COutPoint& voter, int nVote)
+{
+    TryForEachAndRemoveFailed(notifiers, [&hashProposal, &voter, nVote](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyBudgetVote(hashProposal, voter, nVote);
+    });
+}
+
+void CZMQNotificationInterface::InstantSendLockCompleted(const uint256& txid)
+{
+    TryForEachAndRemoveFailed(notifiers, [&txid](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyInstantSendLock(txid);
+    });
+}
+
 CZMQNotificationInterface* g_zmq_notification_interface = nullptr;
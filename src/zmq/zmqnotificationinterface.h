@@ -31,6 +31,13 @@ protected:
     void BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexConnected) override;
     void BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexDisconnected) override;
     void UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) override;
+    void MasternodeListChanged(const COutPoint& outpoint, NodeListChange change) override;
+    void SystemnodeListChanged(const COutPoint& outpoint, NodeListChange change) override;
+    void MasternodePaymentWinner(int nBlockHeight, const CScript& payee) override;
+    void SystemnodePaymentWinner(int nBlockHeight, const CScript& payee) override;
+    void BudgetProposalAdded(const uint256& hashProposal) override;
+    void BudgetProposalVote(const uint256& hashProposal, const COutPoint& voter, int nVote) override;
+    void InstantSendLockCompleted(const uint256& txid) override;
 
 private:
     CZMQNotificationInterface();
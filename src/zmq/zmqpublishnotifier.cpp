@@ -10,6 +10,7 @@
 #include <streams.h>
 #include <util/system.h>
 #include <validation.h>
+#include <validationinterface.h>
 #include <zmq/zmqutil.h>
 
 #include <zmq.h>
@@ -19,6 +20,7 @@
 #include <map>
 #include <string>
 #include <utility>
+#include <vector>
 
 static std::multimap<std::string, CZMQAbstractPublishNotifier*> mapPublishNotifiers;
 
@@ -27,6 +29,12 @@ static const char *MSG_HASHTX    = "hashtx";
 static const char *MSG_RAWBLOCK  = "rawblock";
 static const char *MSG_RAWTX     = "rawtx";
 static const char *MSG_SEQUENCE  = "sequence";
+static const char *MSG_MASTERNODE = "masternode";
+static const char *MSG_SYSTEMNODE = "systemnode";
+static const char *MSG_MNPAYMENT  = "mnpayment";
+static const char *MSG_SNPAYMENT  = "snpayment";
+static const char *MSG_BUDGET     = "budget";
+static const char *MSG_IXLOCK     = "ixlock";
 
 // Internal function to send multipart message
 static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
@@ -274,3 +282,96 @@ bool CZMQPublishSequenceNotifier::NotifyTransactionRemoval(const CTransaction &t
     WriteLE64(data+sizeof(uint256)+1, mempool_sequence);
     return SendZmqMessage(MSG_SEQUENCE, data, sizeof(data));
 }
+
+// Crown notifiers: hashes are sent reversed like the ones above, outpoints as
+// hash followed by the LE 4byte output index.
+static void WriteHashReversed(unsigned char *data, const uint256 &hash)
+{
+    for (unsigned int i = 0; i < sizeof(uint256); i++)
+        data[sizeof(uint256) - 1 - i] = hash.begin()[i];
+}
+
+static void WriteOutPoint(unsigned char *data, const COutPoint &outpoint)
+{
+    WriteHashReversed(data, outpoint.hash);
+    WriteLE32(data + sizeof(uint256), outpoint.n);
+}
+
+static char NodeListChangeLabel(NodeListChange change)
+{
+    switch (change) {
+    case NodeListChange::ADDED: return 'A';
+    case NodeListChange::UPDATED: return 'U';
+    case NodeListChange::EXPIRED: return 'E';
+    case NodeListChange::REMOVED: return 'R';
+    } // no default case, so the compiler can warn about missing cases
+    assert(false);
+}
+
+static bool SendNodeListChange(CZMQAbstractPublishNotifier *notifier, const char *command, const COutPoint &outpoint, NodeListChange change)
+{
+    unsigned char data[sizeof(uint256) + sizeof(uint32_t) + 1];
+    WriteOutPoint(data, outpoint);
+    data[sizeof(data) - 1] = NodeListChangeLabel(change);
+    return notifier->SendZmqMessage(command, data, sizeof(data));
+}
+
+static bool SendPaymentWinner(CZMQAbstractPublishNotifier *notifier, const char *command, int nBlockHeight, const CScript &payee)
+{
+    std::vector<unsigned char> data(sizeof(uint32_t));
+    WriteLE32(data.data(), nBlockHeight);
+    data.insert(data.end(), payee.begin(), payee.end());
+    return notifier->SendZmqMessage(command, data.data(), data.size());
+}
+
+bool CZMQPublishMasternodeNotifier::NotifyMasternodeChanged(const COutPoint &outpoint, NodeListChange change)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish masternode %s %c to %s\n", outpoint.ToString(), NodeListChangeLabel(change), this->address);
+    return SendNodeListChange(this, MSG_MASTERNODE, outpoint, change);
+}
+
+bool CZMQPublishSystemnodeNotifier::NotifySystemnodeChanged(const COutPoint &outpoint, NodeListChange change)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish systemnode %s %c to %s\n", outpoint.ToString(), NodeListChangeLabel(change), this->address);
+    return SendNodeListChange(this, MSG_SYSTEMNODE, outpoint, change);
+}
+
+bool CZMQPublishMasternodePaymentNotifier::NotifyMasternodePaymentWinner(int nBlockHeight, const CScript &payee)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish mnpayment %d to %s\n", nBlockHeight, this->address);
+    return SendPaymentWinner(this, MSG_MNPAYMENT, nBlockHeight, payee);
+}
+
+bool CZMQPublishSystemnodePaymentNotifier::NotifySystemnodePaymentWinner(int nBlockHeight, const CScript &payee)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish snpayment %d to %s\n", nBlockHeight, this->address);
+    return SendPaymentWinner(this, MSG_SNPAYMENT, nBlockHeight, payee);
+}
+
+bool CZMQPublishBudgetNotifier::NotifyBudgetProposal(const uint256 &hashProposal)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish budget proposal %s to %s\n", hashProposal.GetHex(), this->address);
+    unsigned char data[sizeof(uint256) + 1];
+    WriteHashReversed(data, hashProposal);
+    data[sizeof(uint256)] = 'P'; // new (P)roposal
+    return SendZmqMessage(MSG_BUDGET, data, sizeof(data));
+}
+
+bool CZMQPublishBudgetNotifier::NotifyBudgetVote(const uint256 &hashProposal, const COutPoint &voter, int nVote)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish budget vote %s by %s to %s\n", hashProposal.GetHex(), voter.ToString(), this->address);
+    unsigned char data[sizeof(uint256) + 1 + sizeof(uint256) + sizeof(uint32_t) + 1];
+    WriteHashReversed(data, hashProposal);
+    data[sizeof(uint256)] = 'V'; // (V)ote
+    WriteOutPoint(data + sizeof(uint256) + 1, voter);
+    data[sizeof(data) - 1] = (unsigned char)nVote;
+    return SendZmqMessage(MSG_BUDGET, data, sizeof(data));
+}
+
+bool CZMQPublishInstantSendLockNotifier::NotifyInstantSendLock(const uint256 &txid)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish ixlock %s to %s\n", txid.GetHex(), this->address);
+    unsigned char data[sizeof(uint256)];
+    WriteHashReversed(data, txid);
+    return SendZmqMessage(MSG_IXLOCK, data, sizeof(data));
+}
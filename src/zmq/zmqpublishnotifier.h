@@ -61,4 +61,41 @@ public:
     bool NotifyTransactionRemoval(const CTransaction &transaction, uint64_t mempool_sequence) override;
 };
 
+class CZMQPublishMasternodeNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyMasternodeChanged(const COutPoint &outpoint, NodeListChange change) override;
+};
+
+class CZMQPublishSystemnodeNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifySystemnodeChanged(const COutPoint &outpoint, NodeListChange change) override;
+};
+
+class CZMQPublishMasternodePaymentNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyMasternodePaymentWinner(int nBlockHeight, const CScript &payee) override;
+};
+
+class CZMQPublishSystemnodePaymentNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifySystemnodePaymentWinner(int nBlockHeight, const CScript &payee) override;
+};
+
+class CZMQPublishBudgetNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyBudgetProposal(const uint256 &hashProposal) override;
+    bool NotifyBudgetVote(const uint256 &hashProposal, const COutPoint &voter, int nVote) override;
+};
+
+class CZMQPublishInstantSendLockNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyInstantSendLock(const uint256 &txid) override;
+};
+
 #endif // BITCOIN_ZMQ_ZMQPUBLISHNOTIFIER_H
@@ -325,5 +325,32 @@ class RESTTest (BitcoinTestFramework):
         json_obj = self.test_rest_request("/chaininfo")
         assert_equal(json_obj['bestblockhash'], bb_hash)
 
+        self.log.info("Test the /masternodes, /systemnodes, /budget and /mnpayments URIs")
+
+        # There are no masternodes on regtest, so the lists never finish syncing
+        for uri, node_type in [("/masternodes", "Masternode"), ("/systemnodes", "Systemnode"), ("/budget", "Masternode")]:
+            for req_type in [ReqType.JSON, ReqType.HEX, ReqType.BIN]:
+                resp = self.test_rest_request(uri, req_type=req_type, status=503, ret_type=RetType.OBJ)
+                assert_equal(resp.read().decode('utf-8').rstrip(), "{} sync has not yet completed".format(node_type))
+            resp = self.test_rest_request(uri + ".xyz", req_type=None, status=404, ret_type=RetType.OBJ)
+            assert resp.read().decode('utf-8').startswith("output format not found")
+
+        height = self.nodes[0].getblockcount()
+        json_obj = self.test_rest_request("/mnpayments/{}".format(height))
+        assert_equal(json_obj, {'height': height, 'masternodes': [], 'systemnodes': []})
+        resp_hex = self.test_rest_request("/mnpayments/{}".format(height), req_type=ReqType.HEX, ret_type=RetType.OBJ)
+        assert_equal(resp_hex.read().decode('utf-8').rstrip(), height.to_bytes(4, 'little').hex() + "0000")
+        resp_bytes = self.test_rest_request("/mnpayments/{}".format(height), req_type=ReqType.BIN, ret_type=RetType.BYTES)
+        assert_equal(resp_bytes, height.to_bytes(4, 'little') + b'\x00\x00')
+
+        # Check invalid mnpayments requests
+        resp = self.test_rest_request("/mnpayments/abc", status=400, ret_type=RetType.OBJ)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Invalid height: abc")
+        self.test_rest_request("/mnpayments/-1", status=400, ret_type=RetType.OBJ)
+        self.test_rest_request("/mnpayments/", status=400, ret_type=RetType.OBJ)
+        self.test_rest_request("/mnpayments/{}.xyz".format(height), req_type=None, status=400, ret_type=RetType.OBJ)
+        resp = self.test_rest_request("/mnpayments/{}".format(height), req_type=None, status=404, ret_type=RetType.OBJ)
+        assert resp.read().decode('utf-8').startswith("output format not found")
+
 if __name__ == '__main__':
     RESTTest().main()
@@ -82,6 +82,7 @@ class BlockchainTest(BitcoinTestFramework):
             'blocks',
             'chain',
             'chainwork',
+            'coinsprefetch',
             'difficulty',
             'headers',
             'initialblockdownload',